@@ -0,0 +1,156 @@
+#include "adc_dma_source.hpp"
+#include <driver/adc.h>
+#include "esp_log.h"
+
+/**
+ * @brief Install the I2S driver in built-in ADC mode and start DMA sampling.
+ * @param sample_rate_hz The acquisition rate, 8-48kHz.
+ * @return True if the peripheral is running, false otherwise.
+ */
+bool AdcDmaSource::begin(uint32_t sample_rate_hz)
+{
+    if (m_running)
+    {
+        return true;
+    }
+
+    if (sample_rate_hz < config::adc::acquisition::MIN_SAMPLE_RATE_HZ ||
+        sample_rate_hz > config::adc::acquisition::MAX_SAMPLE_RATE_HZ)
+    {
+        ESP_LOGE(TAG, "Unsupported sample rate: %u Hz", sample_rate_hz);
+        return false;
+    }
+
+    // The I2S ADC path is wired to ADC1 only (GPIO32-39)
+    int8_t channel = digitalPinToAnalogChannel(config::hardware::pins::analog::SOUND_SENSOR);
+    if (channel < 0 || channel >= ADC1_CHANNEL_MAX)
+    {
+        ESP_LOGE(TAG, "Sound sensor pin is not an ADC1 channel");
+        return false;
+    }
+
+    i2s_config_t i2s_config = {};
+    i2s_config.mode = static_cast<i2s_mode_t>(I2S_MODE_MASTER | I2S_MODE_RX | I2S_MODE_ADC_BUILT_IN);
+    i2s_config.sample_rate = sample_rate_hz;
+    i2s_config.bits_per_sample = I2S_BITS_PER_SAMPLE_16BIT;
+    i2s_config.channel_format = I2S_CHANNEL_FMT_ONLY_LEFT;
+    i2s_config.communication_format = I2S_COMM_FORMAT_STAND_MSB;
+    i2s_config.intr_alloc_flags = ESP_INTR_FLAG_LEVEL1;
+    i2s_config.dma_buf_count = config::adc::acquisition::NUM_BLOCKS;
+    i2s_config.dma_buf_len = config::adc::acquisition::BLOCK_SIZE;
+    i2s_config.use_apll = false;
+
+    // No event queue: overflows are counted from the sample clock, see count_overwritten()
+    if (i2s_driver_install(I2S_PORT, &i2s_config, 0, nullptr) != ESP_OK)
+    {
+        ESP_LOGE(TAG, "Failed to install I2S driver");
+        return false;
+    }
+
+    adc1_channel_t adc_channel = static_cast<adc1_channel_t>(channel);
+    adc1_config_width(ADC_WIDTH_BIT_12);
+    adc1_config_channel_atten(adc_channel, static_cast<adc_atten_t>(config::adc::sound_sensor::ATTENUATION));
+    if (i2s_set_adc_mode(ADC_UNIT_1, adc_channel) != ESP_OK ||
+        i2s_adc_enable(I2S_PORT) != ESP_OK)
+    {
+        ESP_LOGE(TAG, "Failed to enable I2S ADC mode");
+        i2s_driver_uninstall(I2S_PORT);
+        return false;
+    }
+
+    m_sample_rate_hz = sample_rate_hz;
+    m_fill = 0;
+    m_start_ms = millis();
+    m_start_sequence = m_next_sequence;
+    m_running = true;
+    ESP_LOGI(TAG, "Continuous acquisition at %u Hz, %u x %zu sample DMA ring",
+             sample_rate_hz, config::adc::acquisition::NUM_BLOCKS,
+             config::adc::acquisition::BLOCK_SIZE);
+    return true;
+}
+
+/**
+ * @brief Stop DMA sampling and release the I2S driver.
+ */
+void AdcDmaSource::end()
+{
+    if (!m_running)
+    {
+        return;
+    }
+
+    i2s_adc_disable(I2S_PORT);
+    i2s_driver_uninstall(I2S_PORT);
+    m_running = false;
+}
+
+/**
+ * @brief Assemble the next block from whatever the DMA ring holds, without waiting.
+ *
+ * Partial reads accumulate in @p block, so callers keep passing the same block
+ * until a complete one is returned.
+ * @param block The block to fill.
+ * @return True if a complete block was produced, false otherwise.
+ */
+bool AdcDmaSource::read_block(SampleBlock &block)
+{
+    if (!m_running)
+    {
+        return false;
+    }
+
+    size_t bytes_read = 0;
+    size_t bytes_wanted = (config::adc::acquisition::BLOCK_SIZE - m_fill) * sizeof(uint16_t);
+    i2s_read(I2S_PORT, &block.samples[m_fill], bytes_wanted, &bytes_read, 0);
+
+    size_t samples_read = bytes_read / sizeof(uint16_t);
+    for (size_t i = m_fill; i < m_fill + samples_read; i++)
+    {
+        block.samples[i] &= SAMPLE_MASK;
+    }
+    m_fill += samples_read;
+
+    if (m_fill < config::adc::acquisition::BLOCK_SIZE)
+    {
+        return false;
+    }
+
+    count_overwritten();
+
+    // Several blocks can wait in the ring, so the read time says little about when
+    // a block was sampled; count sample periods from the start instead. Dropped
+    // blocks advance the sequence and keep later timestamps in step.
+    uint64_t samples_before = uint64_t(m_next_sequence - m_start_sequence) * config::adc::acquisition::BLOCK_SIZE;
+    unsigned long timestamp_ms = m_start_ms + static_cast<unsigned long>(samples_before * 1000 / m_sample_rate_hz);
+
+    block.count = m_fill;
+    m_fill = 0;
+    complete_block(block, timestamp_ms);
+    return true;
+}
+
+/**
+ * @brief Count blocks the DMA ring overwrote before they were read.
+ *
+ * The driver reports overflows through a short event queue that discards
+ * events once it is full, so they get lost in exactly the long stalls that
+ * lose the most blocks. The sample clock cannot be lost: the driver queues at
+ * most QUEUED_BLOCKS filled buffers, so no more than that many blocks can
+ * have completed since the one just read, and any beyond that pushed older
+ * ones out. A sample clock running slower than nominal shows up as an
+ * occasional dropped block, which keeps the timestamps on wall time.
+ */
+void AdcDmaSource::count_overwritten()
+{
+    constexpr uint64_t BLOCK_SIZE = config::adc::acquisition::BLOCK_SIZE;
+    constexpr uint64_t QUEUED_BLOCKS = config::adc::acquisition::QUEUED_BLOCKS;
+
+    // Whole blocks sampled since the start of this one, including it
+    uint64_t elapsed = uint64_t(millis() - m_start_ms) * m_sample_rate_hz / 1000;
+    uint64_t before = uint64_t(m_next_sequence - m_start_sequence) * BLOCK_SIZE;
+    uint64_t spanned = elapsed > before ? (elapsed - before) / BLOCK_SIZE : 0;
+    if (spanned > QUEUED_BLOCKS)
+    {
+        note_dropped(static_cast<uint32_t>(spanned - QUEUED_BLOCKS));
+    }
+}
\ No newline at end of file
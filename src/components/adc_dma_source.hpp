@@ -0,0 +1,34 @@
+#pragma once
+
+#include <Arduino.h>
+#include <driver/i2s.h>
+#include "audio_source.hpp"
+
+/**
+ * @brief Continuous ADC acquisition through the ESP32 I2S built-in ADC mode.
+ *
+ * The I2S peripheral clocks ADC1 and writes into a ring of DMA buffers in the
+ * background, so sampling carries on while the main loop is busy.
+ */
+class AdcDmaSource : public AudioSource
+{
+public:
+    AdcDmaSource() = default;
+    ~AdcDmaSource() override { end(); }
+
+    bool begin(uint32_t sample_rate_hz) override;
+    void end() override;
+    bool read_block(SampleBlock &block) override;
+
+private:
+    static constexpr i2s_port_t I2S_PORT = I2S_NUM_0;
+    static constexpr uint16_t SAMPLE_MASK = 0x0FFF; // Upper nibble carries the channel
+    static constexpr char const *TAG = "AdcDmaSource";
+
+    bool m_running{false};
+    size_t m_fill{0}; // Samples already copied into the block being assembled
+    unsigned long m_start_ms{0}; // millis() when sampling started
+    uint32_t m_start_sequence{0};
+
+    void count_overwritten();
+};
\ No newline at end of file
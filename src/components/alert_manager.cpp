@@ -1,18 +1,38 @@
 #include "alert_manager.hpp"
-#include "driver/dac.h"
+
+namespace
+{
+    constexpr ToneStep ALERT_STEPS[] = {
+        {config::alert::ALARM_FREQUENCY, config::alert::BEEP_TONE_MS},
+        {0, config::alert::BEEP_GAP_MS}};
+
+    // Rapid re-triggers escalate to a two-tone warble
+    constexpr ToneStep RAPID_ALERT_STEPS[] = {
+        {config::alert::ALARM_FREQUENCY, config::alert::BEEP_TONE_MS},
+        {0, config::alert::BEEP_GAP_MS},
+        {config::alert::ALARM_FREQUENCY_2, config::alert::BEEP_TONE_MS},
+        {0, config::alert::BEEP_GAP_MS}};
+
+    constexpr TonePattern ALERT_PATTERN = make_tone_pattern(ALERT_STEPS, config::alert::ALERT_BEEPS);
+    constexpr TonePattern RAPID_ALERT_PATTERN =
+        make_tone_pattern(RAPID_ALERT_STEPS, config::alert::RAPID_ALERT_BEEPS / 2);
+}
 
 AlertManager::AlertManager() = default;
 
 void AlertManager::begin()
 {
-    pinMode(config::alert::SPEAKER_PIN, OUTPUT);
-    // Initialize DAC for maximum amplitude
-    dac_output_enable(DAC_CHANNEL_1);       // GPIO26 is DAC channel 1
-    dac_output_voltage(DAC_CHANNEL_1, 255); // Set to maximum voltage
+    if (!m_tone_output.begin())
+    {
+        Serial.println("Speaker init failed!");
+    }
 }
 
-void AlertManager::update(const SignalProcessor &signal_processor)
+void AlertManager::update(const SignalFrame &frame)
 {
+    // Step the tone pattern first; it keeps playing through a cooldown
+    m_tone_engine.update();
+
     // First check if we're in cooldown
     if (m_in_cooldown)
     {
@@ -22,7 +42,7 @@ void AlertManager::update(const SignalProcessor &signal_processor)
         }
     }
 
-    bool is_currently_elevated = signal_processor.get_noise_category() >= SignalProcessor::NoiseLevel::ELEVATED;
+    bool is_currently_elevated = frame.category >= SignalProcessor::NoiseLevel::ELEVATED;
 
     // Check for state changes
     if (is_currently_elevated && !m_is_elevated)
@@ -54,23 +74,11 @@ void AlertManager::handle_alert()
 
     unsigned long current_time = millis();
 
-    if (current_time - m_last_beep_time >= config::alert::BEEP_INTERVAL_MS)
+    if (!m_tone_engine.is_playing() &&
+        current_time - m_last_beep_time >= config::alert::BEEP_INTERVAL_MS)
     {
         // Number of beeps increases with rapid triggers
-        int num_beeps = (m_rapid_trigger_count > 0) ? 8 : 4;
-
-        // Generate maximum amplitude square wave
-        for (int i = 0; i < num_beeps; i++)
-        {
-            for (int j = 0; j < config::alert::ALARM_FREQUENCY / 10; j++)
-            { // Generate for 100ms
-                digitalWrite(config::alert::SPEAKER_PIN, HIGH);
-                delayMicroseconds(500000 / config::alert::ALARM_FREQUENCY);
-                digitalWrite(config::alert::SPEAKER_PIN, LOW);
-                delayMicroseconds(500000 / config::alert::ALARM_FREQUENCY);
-            }
-            delay(50); // Gap between beeps
-        }
+        m_tone_engine.play(m_rapid_trigger_count > 0 ? RAPID_ALERT_PATTERN : ALERT_PATTERN);
 
         m_last_beep_time = current_time;
         m_alert_count++;
@@ -1,16 +1,21 @@
 #pragma once
 #include "config/config.h"
-#include "signal_processor.hpp"
+#include "signal_frame.hpp"
+#include "tone_engine.hpp"
+#include "ledc_tone_output.hpp"
 
 class AlertManager
 {
 public:
     AlertManager();
     void begin();
-    void update(const SignalProcessor &signal_processor);
+    void update(const SignalFrame &frame);
     bool is_in_cooldown() const { return m_in_cooldown; }
+    bool is_sounding() const { return m_tone_engine.is_playing(); }
 
 private:
+    LedcToneOutput m_tone_output{config::alert::SPEAKER_PIN};
+    ToneEngine m_tone_engine{m_tone_output, millis};
     bool m_is_elevated{false};
     bool m_in_cooldown{false};
     uint8_t m_alert_count{0};
@@ -1,15 +1,17 @@
 #include "api_handler.hpp"
 #include "wifi_manager.hpp"
 #include "esp_log.h"
-#include <ArduinoJson.h>
+
+ApiHandler::ApiHandler()
+    : m_worker(send_batch, this, millis, esp_random()),
+      m_backlog(config::thingspeak::upload::BACKLOG_PATH, config::thingspeak::upload::BACKLOG_CAPACITY)
+{
+}
 
 void ApiHandler::begin()
 {
     ESP_LOGI(TAG, "Initializing API handler");
 
-    // Initialize HTTP client with SSL
-    m_secure_client.setInsecure(); // For ThingSpeak we can use insecure mode
-
     // Verify channel exists and API keys are set
     if (!config::thingspeak::NOISE_CHANNEL_ID ||
         !config::thingspeak::NOISE_API_KEY)
@@ -28,8 +30,22 @@ void ApiHandler::begin()
         return;
     }
 
+    // Use the NOISE_API_KEY for writing, not the USER_API_KEY
+    if (!m_client.begin(config::thingspeak::NOISE_CHANNEL_ID, config::thingspeak::NOISE_API_KEY))
+    {
+        ESP_LOGE(TAG, "ThingSpeak channel id too long");
+        m_available = false;
+        return;
+    }
+
     // If we get here, configuration is valid
-    m_available = true;
+    m_available = xTaskCreatePinnedToCore(worker_task,
+                                          "upload",
+                                          config::thingspeak::upload::WORKER_STACK_SIZE,
+                                          this,
+                                          config::thingspeak::upload::WORKER_PRIORITY,
+                                          &m_worker_task,
+                                          config::thingspeak::upload::WORKER_CORE) == pdPASS;
     ESP_LOGI(TAG, "API handler initialization %s", m_available ? "successful" : "failed");
 }
 
@@ -50,122 +66,88 @@ bool ApiHandler::ensure_channel_exists()
     return true;
 }
 
-bool ApiHandler::send_noise_data(const JsonDocument &doc)
+/**
+ * @brief Keep undeliverable uploads on the SD card. Call once the card is mounted.
+ * @return True if the backlog file is open, false otherwise.
+ */
+bool ApiHandler::enable_backlog()
 {
-    if (!m_available)
+    if (!m_backlog.begin())
     {
-        ESP_LOGW(TAG, "Handler not available, skipping");
+        ESP_LOGW(TAG, "Upload backlog unavailable at %s", config::thingspeak::upload::BACKLOG_PATH);
         return false;
     }
 
-    // Check rate limiting - ThingSpeak requires 15 seconds between updates
-    unsigned long now = millis();
-    if (now - m_last_request < config::thingspeak::UPDATE_INTERVAL_MS)
+    ESP_LOGI(TAG, "Upload backlog holds %zu records", m_backlog.size());
+    m_worker.set_backlog(&m_backlog);
+    if (m_worker_task)
     {
-        ESP_LOGD(TAG, "Rate limited, skipping request. Next update in %lu ms",
-                 config::thingspeak::UPDATE_INTERVAL_MS - (now - m_last_request));
-        return false;
+        xTaskNotifyGive(m_worker_task);
     }
-    m_last_request = now;
+    return true;
+}
 
-    if (!wifi::WiFiManager::instance().ensure_connected())
+/**
+ * @brief Queue a record for upload. Never blocks.
+ * @param record The data point.
+ * @return True if queued, false if the handler is unavailable or the queue is full.
+ */
+bool ApiHandler::enqueue(const UploadRecord &record)
+{
+    if (!m_available)
     {
-        m_last_error = "WiFi connection lost";
-        ESP_LOGE(TAG, "%s", m_last_error.c_str());
+        ESP_LOGW(TAG, "Handler not available, skipping");
         return false;
     }
 
-    // Create bulk update payload following ThingSpeak format
-    JsonDocument payload_doc;
-
-    // Use the NOISE_API_KEY for writing, not the USER_API_KEY
-    payload_doc["write_api_key"] = config::thingspeak::NOISE_API_KEY;
-    JsonArray updates = payload_doc["updates"].to<JsonArray>();
-
-    // Add the update object
-    JsonObject update = updates.add<JsonObject>();
-
-    // Get current timestamp
-    struct tm timeinfo;
-    if (!getLocalTime(&timeinfo))
+    if (!m_worker.enqueue(record))
     {
-        ESP_LOGE(TAG, "Failed to obtain time");
+        ESP_LOGW(TAG, "Upload queue full, dropping record");
         return false;
     }
 
-    char timestamp[30];
-    strftime(timestamp, sizeof(timestamp), "%Y-%m-%d %H:%M:%S", &timeinfo);
-    update["created_at"] = timestamp;
-
-    // Copy fields from input document
-    for (JsonPairConst kv : doc.as<JsonObjectConst>())
-    {
-        update[kv.key()] = kv.value();
-    }
-
-    String payload;
-    serializeJson(payload_doc, payload);
-    ESP_LOGD(TAG, "Sending payload: %s", payload.c_str());
-
-    // Construct URL for bulk update
-    String url = String(config::thingspeak::ENDPOINT) + "/channels/" +
-                 String(config::thingspeak::NOISE_CHANNEL_ID) +
-                 "/bulk_update.json";
-
-    ESP_LOGD(TAG, "Sending to URL: %s", url.c_str());
-
-    // Ensure we end any previous connection
-    m_http_client.end();
+    xTaskNotifyGive(m_worker_task);
+    return true;
+}
 
-    // Configure secure client
-    m_secure_client.setInsecure();
+/**
+ * @brief Upload task body: run the worker, sleeping until it has work or a record arrives.
+ * @param param The ApiHandler instance.
+ */
+void ApiHandler::worker_task(void *param)
+{
+    ApiHandler *handler = static_cast<ApiHandler *>(param);
 
-    // Begin new connection with retry logic
-    int retries = 3;
-    while (retries > 0)
+    for (;;)
     {
-        if (m_http_client.begin(m_secure_client, url))
+        uint32_t wait_ms = handler->m_worker.poll();
+        if (wait_ms > 0)
         {
-            m_http_client.addHeader("Content-Type", "application/json");
-
-            int httpCode = m_http_client.POST(payload);
-
-            if (httpCode == HTTP_CODE_OK || httpCode == HTTP_CODE_ACCEPTED)
-            {
-                String response = m_http_client.getString();
-                ESP_LOGD(TAG, "ThingSpeak Response: %s", response.c_str());
-                m_http_client.end();
-                return true;
-            }
-
-            if (httpCode == 429)
-            { // Too Many Requests
-                ESP_LOGW(TAG, "Rate limit exceeded, waiting for 15 seconds...");
-                m_http_client.end();
-                delay(15000); // Wait full 15 seconds before retry
-                retries--;
-                continue;
-            }
-
-            if (httpCode == -11)
-            { // Timeout
-                ESP_LOGW(TAG, "HTTP POST timeout, retrying... (%d attempts left)", retries - 1);
-                retries--;
-                m_http_client.end();
-                delay(1000);
-                continue;
-            }
-
-            ESP_LOGE(TAG, "HTTP POST failed, code: %d", httpCode);
-            break;
+            TickType_t ticks = wait_ms == UploadWorker::WAIT_FOREVER ? portMAX_DELAY : pdMS_TO_TICKS(wait_ms);
+            ulTaskNotifyTake(pdTRUE, ticks);
         }
+    }
+}
+
+int ApiHandler::send_batch(void *context, const UploadRecord *records, size_t count)
+{
+    return static_cast<ApiHandler *>(context)->post_batch(records, count);
+}
 
-        ESP_LOGE(TAG, "Failed to begin HTTP client");
-        retries--;
-        delay(1000);
+/**
+ * @brief POST a batch of records as one bulk update. Runs on the upload task.
+ * @param records The data points, oldest first.
+ * @param count The number of records.
+ * @return The HTTP status code, or a negative HTTPClient error.
+ */
+int ApiHandler::post_batch(const UploadRecord *records, size_t count)
+{
+    if (!wifi::WiFiManager::instance().ensure_connected())
+    {
+        m_last_error = "WiFi connection lost";
+        ESP_LOGE(TAG, "%s", m_last_error.c_str());
+        return HTTPC_ERROR_NOT_CONNECTED;
     }
 
-    m_http_client.end();
-    delay(100);
-    return false;
+    return m_client.post_batch(records, count);
 }
\ No newline at end of file
@@ -1,13 +1,23 @@
 #pragma once
 
 #include <Arduino.h>
-#include <HTTPClient.h>
-#include <WiFiClientSecure.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
 #include <map>
 #include <string>
 #include "config/config.h"
-#include <ArduinoJson.h>
-
+#include "upload_worker.hpp"
+#include "upload_client.hpp"
+#include "offline_queue.hpp"
+
+/**
+ * @brief ThingSpeak uploader.
+ *
+ * enqueue() hands records to an UploadWorker and returns immediately; a
+ * background task owns the UploadClient and uploads them in batches, one
+ * bulk_update request per flush, backing off on failures without holding up
+ * the caller.
+ */
 class ApiHandler
 {
 public:
@@ -18,11 +28,17 @@ public:
     }
 
     void begin();
-    bool send_noise_data(const JsonDocument &doc);
+    bool enable_backlog();
+    bool enqueue(const UploadRecord &record);
     bool is_available() const { return m_available; }
 
+    UploadWorker::Stats get_upload_stats() const { return m_worker.get_stats(); }
+    size_t get_queue_depth() const { return m_worker.get_queue_depth(); }
+    size_t get_backlog_size() const { return m_backlog.size(); }
+    const UploadClient::ConnectionStats &get_connection_stats() const { return m_client.get_stats(); }
+
 private:
-    ApiHandler() = default;
+    ApiHandler();
 
     struct ChannelInfo
     {
@@ -30,13 +46,18 @@ private:
         std::string read_api_key;
     };
 
-    HTTPClient m_http_client;
-    WiFiClientSecure m_secure_client;
-    unsigned long m_last_request{0};
+    UploadClient m_client;
     std::string m_last_error;
     bool m_available{false};
 
+    UploadWorker m_worker;
+    OfflineQueue m_backlog;
+    TaskHandle_t m_worker_task{nullptr};
+
     static constexpr char const *TAG = "ApiHandler";
 
     bool ensure_channel_exists();
+    static void worker_task(void *param);
+    static int send_batch(void *context, const UploadRecord *records, size_t count);
+    int post_batch(const UploadRecord *records, size_t count);
 };
\ No newline at end of file
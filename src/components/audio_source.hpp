@@ -0,0 +1,72 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "config/config.h"
+
+/**
+ * @brief One contiguous block of raw ADC samples handed out by an AudioSource.
+ */
+struct SampleBlock
+{
+    uint16_t samples[config::adc::acquisition::BLOCK_SIZE];
+    size_t count{0};
+    uint32_t sequence{0};          // Monotonic block number, gaps mean dropped blocks
+    unsigned long timestamp_ms{0}; // Time of the first sample in the block
+};
+
+/**
+ * @brief Hardware-abstraction seam for continuous sample acquisition.
+ *
+ * The device implementation is fed by DMA; host builds replay recorded
+ * sessions through the same block interface.
+ */
+class AudioSource
+{
+public:
+    struct Stats
+    {
+        uint32_t blocks_read{0};
+        uint32_t blocks_dropped{0};
+        uint64_t samples_read{0};
+    };
+
+    virtual ~AudioSource() = default;
+
+    virtual bool begin(uint32_t sample_rate_hz) = 0;
+    virtual void end() = 0;
+
+    // Non-blocking: returns false if no complete block is available yet
+    virtual bool read_block(SampleBlock &block) = 0;
+
+    uint32_t get_sample_rate() const { return m_sample_rate_hz; }
+    const Stats &get_stats() const { return m_stats; }
+
+protected:
+    uint32_t m_sample_rate_hz{0};
+    uint32_t m_next_sequence{0};
+    Stats m_stats;
+
+    /**
+     * @brief Stamp a completed block and account for it in the statistics.
+     * @param block The block that was just filled.
+     * @param timestamp_ms Time of the first sample in the block.
+     */
+    void complete_block(SampleBlock &block, unsigned long timestamp_ms)
+    {
+        block.sequence = m_next_sequence++;
+        block.timestamp_ms = timestamp_ms;
+        m_stats.blocks_read++;
+        m_stats.samples_read += block.count;
+    }
+
+    /**
+     * @brief Record blocks lost to a ring overflow, keeping sequence gaps visible.
+     * @param count Number of blocks that were overwritten before being read.
+     */
+    void note_dropped(uint32_t count)
+    {
+        m_stats.blocks_dropped += count;
+        m_next_sequence += count;
+    }
+};
\ No newline at end of file
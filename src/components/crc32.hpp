@@ -0,0 +1,26 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief CRC-32 (IEEE 802.3, reflected), bitwise to keep it table-free.
+ * @param data The bytes to check.
+ * @param length The number of bytes.
+ * @param crc Result of a previous call, to continue over several buffers.
+ * @return The CRC of all bytes so far.
+ */
+inline uint32_t crc32(const void *data, size_t length, uint32_t crc = 0)
+{
+    const uint8_t *bytes = static_cast<const uint8_t *>(data);
+    crc = ~crc;
+    for (size_t i = 0; i < length; i++)
+    {
+        crc ^= bytes[i];
+        for (int bit = 0; bit < 8; bit++)
+        {
+            crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+        }
+    }
+    return ~crc;
+}
\ No newline at end of file
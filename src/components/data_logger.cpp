@@ -1,5 +1,14 @@
 #include "data_logger.hpp"
+#include <math.h>
 #include <time.h>
+#include "esp_log.h"
+#include "esp_system.h"
+#include "spi_arbiter.hpp"
+
+namespace
+{
+    DataLogger *s_shutdown_logger = nullptr;
+}
 
 DataLogger::DataLogger() = default;
 
@@ -9,7 +18,12 @@ DataLogger::DataLogger() = default;
  */
 bool DataLogger::begin()
 {
-    if (!SD.begin(config::hardware::pins::sd::CS))
+    bool mounted;
+    {
+        SpiArbiter::Lease lease(SpiArbiter::Device::SD);
+        mounted = SD.begin(config::hardware::pins::sd::CS);
+    }
+    if (!mounted)
     {
         Serial.println("SD card initialization failed!");
         return false;
@@ -17,98 +31,264 @@ bool DataLogger::begin()
 
     Serial.println("SD card initialized.");
     m_initialized = true;
+
+    // Buffered records are written out before a software restart
+    s_shutdown_logger = this;
+    esp_register_shutdown_handler(shutdown_handler);
     return true;
 }
 
-String DataLogger::get_current_filename()
+/**
+ * @brief Write out buffered records and close the log file.
+ */
+void DataLogger::end()
+{
+    write_block();
+    write_index();
+    m_writer.close();
+    m_day = NO_DAY;
+}
+
+/**
+ * @brief Flush the log before esp_restart().
+ */
+void DataLogger::shutdown_handler()
+{
+    if (s_shutdown_logger)
+    {
+        s_shutdown_logger->end();
+    }
+}
+
+/**
+ * @brief Make sure the file for the current day is open, rolling over if needed.
+ * @return True if a log file is open, false otherwise.
+ */
+bool DataLogger::open_current_file()
 {
     char filename[32];
-    time_t now;
-    time(&now);
     struct tm timeinfo;
+    int day = NO_DAY;
+
+    // Never wait for NTP here; a fallback file is used until the clock is set
+    if (getLocalTime(&timeinfo, 0))
+    {
+        day = (timeinfo.tm_year + 1900) * 1000 + timeinfo.tm_yday;
+    }
+
+    if (m_writer.is_open() && (day == m_day || day == NO_DAY))
+    {
+        return true;
+    }
 
-    if (getLocalTime(&timeinfo))
+    const char *extension = config::logging::BINARY_FORMAT ? "bin" : "csv";
+    if (day != NO_DAY)
     {
         // Format: YYMMDD.csv (e.g., 240315.csv for March 15, 2024)
-        strftime(filename, sizeof(filename), "%y%m%d.csv", &timeinfo);
+        char date[8];
+        strftime(date, sizeof(date), "%y%m%d", &timeinfo);
+        snprintf(filename, sizeof(filename), "%s/%s.%s", config::logging::MOUNT_POINT, date, extension);
     }
     else
     {
         // Fallback if time is not set: use counter
-        sprintf(filename, "LOG%03d.csv", m_file_counter++);
+        snprintf(filename, sizeof(filename), "%s/LOG%03d.%s", config::logging::MOUNT_POINT, m_file_counter++,
+                 extension);
         if (m_file_counter > 999)
             m_file_counter = 0;
     }
 
-    return String(filename);
+    // Rollover: the previous file gets its pending records and is synced before the new one is opened
+    write_block();
+    write_index();
+    m_writer.close();
+    if (!m_writer.open(filename))
+    {
+        ESP_LOGE(TAG, "Cannot open %s", filename);
+        return false;
+    }
+    m_day = day;
+    log_format::make_index_path(filename, m_index_path, sizeof(m_index_path));
+    m_index_bucket = UINT32_MAX;
+    ESP_LOGI(TAG, "Logging to %s", filename);
+
+    return create_headers();
 }
 
 /**
- * @brief Create the headers for the data file.
+ * @brief Create the headers for a new data file.
  * @return True if the headers are created successfully, false otherwise.
  */
-bool DataLogger::create_headers(const String &filename)
+bool DataLogger::create_headers()
 {
-    if (!m_initialized || SD.exists(filename))
+    if (m_writer.size() > 0)
     {
         return true;
     }
 
-    File dataFile = SD.open(filename, FILE_WRITE);
-    if (!dataFile)
+    if (config::logging::BINARY_FORMAT)
     {
-        return false;
+        log_format::FileHeader header = log_format::make_file_header(static_cast<uint32_t>(time(nullptr)));
+        return m_writer.append(&header, sizeof(header));
     }
 
     // Use Unix timestamp in headers
-    dataFile.println("timestamp,noise,baseline,category,1min_avg,15min_avg");
-    dataFile.close();
-    return true;
+    static constexpr char HEADER[] =
+        "timestamp,noise,baseline,category,1min_avg,15min_avg,laeq,lcpeak,1min_l10,1min_l50,1min_l90,1min_max\r\n";
+    return m_writer.append(HEADER, sizeof(HEADER) - 1);
 }
 
 /**
  * @brief Log the data to the file.
- * @param signal_processor The signal processor instance.
+ * @param frame The latest signal frame.
  * @return True if the data is logged successfully, false otherwise.
  */
-bool DataLogger::log_data(const SignalProcessor &signal_processor)
+bool DataLogger::log_data(const SignalFrame &frame)
+{
+    if (!m_initialized || !open_current_file())
+    {
+        return false;
+    }
+
+    time_t now = time(nullptr);
+    bool ok = config::logging::BINARY_FORMAT ? append_binary(frame, now) : append_csv(frame, now);
+
+    // Sector writes and syncs happen here, paced by the writer
+    return m_writer.poll() && ok;
+}
+
+/**
+ * @brief Append one CSV row.
+ * @param frame The latest signal frame.
+ * @param now The Unix timestamp of the row.
+ * @return True if the row was buffered, false otherwise.
+ */
+bool DataLogger::append_csv(const SignalFrame &frame, time_t now)
 {
-    if (!m_initialized)
+    // Format: unix_timestamp,current_noise,baseline,category,1min_avg,15min_avg,laeq,lcpeak,
+    //         1min_l10,1min_l50,1min_l90,1min_max
+    const auto &one_min = frame.one_min;
+    char line[192];
+    int length = snprintf(line, sizeof(line), "%ld,%.2f,%.2f,%d,%.2f,%.2f,%.2f,%.2f,%u,%u,%u,%u\r\n",
+                          static_cast<long>(now), frame.value, frame.baseline,
+                          static_cast<int>(frame.category), one_min.avg, frame.fifteen_min.avg,
+                          frame.laeq, frame.lcpeak, one_min.l10, one_min.l50, one_min.l90, one_min.max);
+    if (length <= 0 || length >= static_cast<int>(sizeof(line)))
     {
         return false;
     }
+    note_index(static_cast<uint32_t>(now));
+    return m_writer.append(line, length);
+}
 
-    String current_filename = get_current_filename();
+/**
+ * @brief Add one record to the current binary block, writing the block once full.
+ * @param frame The latest signal frame.
+ * @param now The Unix timestamp of the record.
+ * @return True if the record was stored, false otherwise.
+ */
+bool DataLogger::append_binary(const SignalFrame &frame, time_t now)
+{
+    using namespace log_format;
 
-    // Create headers if this is a new file
-    if (!create_headers(current_filename))
+    auto fixed = [](float value, Field field)
+    {
+        return isfinite(value) ? static_cast<int32_t>(lroundf(value * FIELDS[field].scale)) : 0;
+    };
+
+    const auto &one_min = frame.one_min;
+    Record record;
+    record[TIMESTAMP] = static_cast<int32_t>(now);
+    record[NOISE] = fixed(frame.value, NOISE);
+    record[BASELINE] = fixed(frame.baseline, BASELINE);
+    record[CATEGORY] = static_cast<int32_t>(frame.category);
+    record[ONE_MIN_AVG] = fixed(one_min.avg, ONE_MIN_AVG);
+    record[FIFTEEN_MIN_AVG] = fixed(frame.fifteen_min.avg, FIFTEEN_MIN_AVG);
+    record[LAEQ] = fixed(frame.laeq, LAEQ);
+    record[LCPEAK] = fixed(frame.lcpeak, LCPEAK);
+    record[ONE_MIN_L10] = one_min.l10;
+    record[ONE_MIN_L50] = one_min.l50;
+    record[ONE_MIN_L90] = one_min.l90;
+    record[ONE_MIN_MAX] = one_min.max;
+
+    if (!m_encoder.add(record) && !(write_block() && m_encoder.add(record)))
     {
         return false;
     }
+    return m_encoder.get_count() < config::logging::BLOCK_RECORDS || write_block();
+}
+
+static_assert(log_format::MAX_BLOCK_SIZE <= LogWriter::MAX_APPEND, "A block must fit the writer in one append");
+
+/**
+ * @brief Seal the pending binary block and hand it to the writer.
+ * @return True if there was nothing to write or the block was buffered.
+ */
+bool DataLogger::write_block()
+{
+    if (m_encoder.is_empty())
+    {
+        return true;
+    }
+
+    note_index(m_encoder.get_first_timestamp());
+    size_t size;
+    const uint8_t *block = m_encoder.finish(size);
+    return m_writer.append(block, size);
+}
+
+/**
+ * @brief Add an index entry if the row or block about to be written starts a new bucket.
+ * @param timestamp The first timestamp of the row or block.
+ */
+void DataLogger::note_index(uint32_t timestamp)
+{
+    uint32_t bucket = timestamp / config::logging::INDEX_INTERVAL_S;
+    if (bucket == m_index_bucket)
+    {
+        return;
+    }
+    m_index_bucket = bucket;
 
-    File dataFile = SD.open(current_filename, FILE_WRITE);
-    if (!dataFile)
+    if (m_index_pending == config::logging::INDEX_PENDING)
+    {
+        write_index();
+    }
+    if (m_index_pending < config::logging::INDEX_PENDING)
     {
+        m_index[m_index_pending++] = {timestamp, m_writer.size()};
+    }
+}
+
+/**
+ * @brief Append the pending index entries to the index file.
+ * @return True if there was nothing to write or the entries were written.
+ */
+bool DataLogger::write_index()
+{
+    if (m_index_pending == 0)
+    {
+        return true;
+    }
+
+    SpiArbiter::Lease lease(SpiArbiter::Device::SD);
+    FILE *file = fopen(m_index_path, "ab");
+    if (!file)
+    {
+        ESP_LOGW(TAG, "Cannot open %s", m_index_path);
         return false;
     }
 
-    // Get current timestamp
-    time_t now;
-    time(&now); // Get current time as Unix timestamp
-
-    // Format: unix_timestamp,current_noise,baseline,category,1min_avg,15min_avg
-    dataFile.print(now);
-    dataFile.print(",");
-    dataFile.print(signal_processor.get_current_value());
-    dataFile.print(",");
-    dataFile.print(signal_processor.get_baseline());
-    dataFile.print(",");
-    dataFile.print(static_cast<int>(signal_processor.get_noise_category()));
-    dataFile.print(",");
-    dataFile.print(signal_processor.get_one_min_stats().avg);
-    dataFile.print(",");
-    dataFile.println(signal_processor.get_fifteen_min_stats().avg);
-
-    dataFile.close();
-    return true;
+    bool ok = true;
+    if (ftell(file) == 0)
+    {
+        log_format::IndexHeader header = log_format::make_index_header(config::logging::INDEX_INTERVAL_S);
+        ok = fwrite(&header, sizeof(header), 1, file) == 1;
+    }
+    ok = ok && fwrite(m_index, sizeof(m_index[0]), m_index_pending, file) == m_index_pending;
+    ok = fclose(file) == 0 && ok;
+
+    // A failed index only slows queries down, the log itself is unaffected
+    m_index_pending = 0;
+    return ok;
 }
\ No newline at end of file
@@ -2,23 +2,50 @@
 
 #include <Arduino.h>
 #include <SD.h>
-#include "signal_processor.hpp"
+#include "log_writer.hpp"
+#include "log_format.hpp"
+#include "signal_frame.hpp"
 #include "config/config.h"
 
 /**
  * @brief Class representing the data logger.
+ *
+ * Keeps the day's file open and appends records through a buffered
+ * LogWriter; the file is synced and closed when the day rolls over.
+ * Records are CSV rows, or delta-encoded blocks with BINARY_FORMAT. A
+ * sparse time index goes to a .idx file next to the log, for LogReader.
  */
 class DataLogger
 {
 public:
     DataLogger();
     bool begin();
-    bool log_data(const SignalProcessor &signal_processor);
+    void end();
+    bool log_data(const SignalFrame &frame);
+
+    const LogWriter::Stats &get_writer_stats() const { return m_writer.get_stats(); }
 
 private:
+    static constexpr char const *TAG = "DataLogger";
+    static constexpr int NO_DAY = -1;
+
     bool m_initialized{false};
     uint16_t m_file_counter{0};  // For fallback filename generation
+    int m_day{NO_DAY};           // Day of the open file, NO_DAY for a fallback file
+    LogWriter m_writer{millis};
+    log_format::BlockEncoder m_encoder{config::logging::BLOCK_RECORDS};
+
+    char m_index_path[32]{};
+    log_format::IndexEntry m_index[config::logging::INDEX_PENDING];
+    size_t m_index_pending{0};
+    uint32_t m_index_bucket{UINT32_MAX}; // Bucket of the newest entry
 
-    String get_current_filename();
-    bool create_headers(const String& filename);
+    static void shutdown_handler();
+    bool open_current_file();
+    bool create_headers();
+    bool append_csv(const SignalFrame &frame, time_t now);
+    bool append_binary(const SignalFrame &frame, time_t now);
+    bool write_block();
+    void note_index(uint32_t timestamp);
+    bool write_index();
 };
\ No newline at end of file
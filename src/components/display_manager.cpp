@@ -1,17 +1,18 @@
 #include "display_manager.hpp"
+#include "spi_arbiter.hpp"
+#include <algorithm>
 
 /**
  * @brief Constructor for the DisplayManager class.
  */
 DisplayManager::DisplayManager(const AlertManager &alert_manager)
-    : m_u8g2(U8G2_ST7565_ERC12864_ALT_F_4W_HW_SPI(
+    : m_alert_manager(alert_manager),
+      m_u8g2(U8G2_ST7565_ERC12864_ALT_F_4W_HW_SPI(
           U8G2_R0,
           config::hardware::pins::display::CS,
           config::hardware::pins::display::DC,
-          config::hardware::pins::display::RESET)),
-      m_alert_manager(alert_manager)
+          config::hardware::pins::display::RESET))
 {
-    memset(m_plot_buffer, 0, sizeof(m_plot_buffer));
 }
 
 /**
@@ -29,6 +30,7 @@ void DisplayManager::begin()
     delay(100); // Wait for reset to complete
 
     // Initialize display
+    SpiArbiter::Lease lease(SpiArbiter::Device::DISPLAY);
     if (!m_u8g2.begin())
     {
         Serial.println("Display init failed!");
@@ -54,40 +56,116 @@ void DisplayManager::begin()
 }
 
 /**
- * @brief Update the display with the current signal processor values.
- * @param signal_processor The signal processor instance.
+ * @brief Update the display with the latest signal frame.
+ * @param frame The latest signal frame.
  */
-void DisplayManager::update(const SignalProcessor &signal_processor)
+void DisplayManager::update(const SignalFrame &frame)
 {
-    m_u8g2.clearBuffer();
-    draw_stats(signal_processor);
+    if (!m_layout_ready)
+    {
+        // Replace the splash screen once, from then on only changed parts are redrawn
+        m_u8g2.clearBuffer();
+        memset(m_row_text, 0, sizeof(m_row_text));
+        m_frame_diff.invalidate();
+        m_layout_ready = true;
+    }
+
+    draw_stats(frame);
     draw_plot();
-    m_u8g2.sendBuffer();
+    send_changes();
+}
+
+/**
+ * @brief Send the tiles that differ from what the panel shows.
+ *
+ * If the SD card keeps the bus longer than DISPLAY_TIMEOUT_MS the frame is
+ * skipped; the tiles stay marked as changed and go out with the next one.
+ */
+void DisplayManager::send_changes()
+{
+    SpiArbiter::Lease lease(SpiArbiter::Device::DISPLAY, config::spi::DISPLAY_TIMEOUT_MS);
+    if (!lease.is_held())
+    {
+        m_stats.frames_skipped++;
+        return;
+    }
+
+    size_t tiles = m_frame_diff.update(m_u8g2.getBufferPtr(), [this](uint8_t tx, uint8_t ty, uint8_t tw)
+                                       { m_u8g2.updateDisplayArea(tx, ty, tw, 1); });
+
+    m_stats.frames++;
+    m_stats.tiles_sent += tiles;
+    m_stats.last_frame_bytes = tiles * 8;
+    m_stats.bytes_sent += m_stats.last_frame_bytes;
+}
+
+/**
+ * @brief Check a text row against what it shows and clear it for redrawing if it differs.
+ * @param row The row number.
+ * @param text The row's new contents.
+ * @return True if the row has to be redrawn.
+ */
+bool DisplayManager::row_changed(uint8_t row, const char *text)
+{
+    if (strncmp(m_row_text[row], text, ROW_TEXT_SIZE) == 0)
+    {
+        return false;
+    }
+    strncpy(m_row_text[row], text, ROW_TEXT_SIZE - 1);
+    clear_band(config::display::ROW_TOP[row], config::display::ROW_HEIGHT[row]);
+    m_stats.rows_rendered++;
+    return true;
 }
 
 /**
- * @brief Add a point to the plot buffer.
- * @param value The value to add to the plot buffer.
+ * @brief Clear a full-width horizontal band of the frame buffer.
+ * @param top The first pixel row.
+ * @param height The number of pixel rows.
  */
-void DisplayManager::add_plot_point(int value)
+void DisplayManager::clear_band(uint8_t top, uint8_t height)
 {
-    m_plot_buffer[m_plot_index] = value;
-    m_plot_index = (m_plot_index + 1) % config::display::plot::PLOT_POINTS;
+    m_u8g2.setDrawColor(0);
+    m_u8g2.drawBox(0, top, m_u8g2.getWidth(), height);
+    m_u8g2.setDrawColor(1);
+}
+
+/**
+ * @brief Add a point to the plot.
+ * @param value The value to add to the plot.
+ * @param timestamp_ms When the value was measured.
+ */
+void DisplayManager::add_plot_point(uint16_t value, unsigned long timestamp_ms)
+{
+    m_plot.add(value, timestamp_ms);
+}
+
+/**
+ * @brief Select the time span shown by the plot.
+ * @param span The span; the plot starts over empty.
+ */
+void DisplayManager::set_plot_span(PlotEnvelope::Span span)
+{
+    m_plot.set_span(span);
 }
 
 /**
  * @brief Draw the statistics on the display.
- * @param signal_processor The signal processor instance.
+ * @param frame The latest signal frame.
  */
-void DisplayManager::draw_stats(const SignalProcessor &signal_processor)
+void DisplayManager::draw_stats(const SignalFrame &frame)
 {
     m_u8g2.setFont(u8g2_font_6x10_tf);
 
-    // Draw current noise level and category
-    char noise_str[32];
-    snprintf(noise_str, sizeof(noise_str), "ADC: %d",
-             static_cast<int>(signal_processor.get_current_value()));
-    m_u8g2.drawStr(0, 10, noise_str);
+    // Draw current noise level and category; the panel has room for ten characters left of the category
+    char noise_str[12];
+    if (frame.has_levels)
+    {
+        snprintf(noise_str, sizeof(noise_str), "%.1fdBA", frame.laeq);
+    }
+    else
+    {
+        snprintf(noise_str, sizeof(noise_str), "ADC: %d", static_cast<int>(frame.value));
+    }
 
     // Draw WiFi and ThingSpeak status in top right
     char status[5] = "    "; // 4 spaces + null terminator
@@ -99,44 +177,56 @@ void DisplayManager::draw_stats(const SignalProcessor &signal_processor)
     {
         status[2] = 'T';
     }
-    m_u8g2.drawStr(110, 10, status);
 
-    // Draw noise category
-    const char *category = noise_level_to_string(signal_processor.get_noise_category());
-    if (signal_processor.get_noise_category() >= SignalProcessor::NoiseLevel::ELEVATED)
-    {
-        uint8_t category_width = m_u8g2.getStrWidth(category);
-        m_u8g2.setDrawColor(1);
-        m_u8g2.drawBox(64, 2, category_width, 10);
-        m_u8g2.setDrawColor(0);
-        m_u8g2.drawStr(64, 10, category);
-        m_u8g2.setDrawColor(1);
-    }
-    else
+    const char *category = noise_level_to_string(frame.category);
+    bool highlighted = frame.category >= SignalProcessor::NoiseLevel::ELEVATED;
+
+    // The whole status line is one cached row
+    char status_row[ROW_TEXT_SIZE];
+    snprintf(status_row, sizeof(status_row), "%s|%.8s%c|%s", noise_str, category, highlighted ? '!' : ' ', status);
+    if (row_changed(0, status_row))
     {
-        m_u8g2.drawStr(64, 10, category);
+        m_u8g2.drawStr(0, 10, noise_str);
+        m_u8g2.drawStr(110, 10, status);
+
+        // Draw noise category
+        if (highlighted)
+        {
+            uint8_t category_width = m_u8g2.getStrWidth(category);
+            m_u8g2.setDrawColor(1);
+            m_u8g2.drawBox(64, 2, category_width, 10);
+            m_u8g2.setDrawColor(0);
+            m_u8g2.drawStr(64, 10, category);
+            m_u8g2.setDrawColor(1);
+        }
+        else
+        {
+            m_u8g2.drawStr(64, 10, category);
+        }
     }
 
     // Draw statistics with proper alignment
-    const auto &one_min = signal_processor.get_one_min_stats();
-    const auto &fifteen_min = signal_processor.get_fifteen_min_stats();
+    const auto &one_min = frame.one_min;
+    const auto &fifteen_min = frame.fifteen_min;
 
     char stats_str[32];
     snprintf(stats_str, sizeof(stats_str), "1m:  %4d [%4d-%4d]",
              static_cast<int>(one_min.avg),
              one_min.min,
              one_min.max);
-    m_u8g2.drawStr(0, 20, stats_str);
+    if (row_changed(1, stats_str))
+    {
+        m_u8g2.drawStr(0, 20, stats_str);
+    }
 
     snprintf(stats_str, sizeof(stats_str), "15m: %4d [%4d-%4d]",
              static_cast<int>(fifteen_min.avg),
              fifteen_min.min,
              fifteen_min.max);
-    m_u8g2.drawStr(0, 30, stats_str);
-
-    // // Draw chart grid and labels
-    // m_u8g2.drawHLine(0, 40, 128); // Baseline
-    // m_u8g2.drawVLine(0, 40, -30); // Y-axis
+    if (row_changed(2, stats_str))
+    {
+        m_u8g2.drawStr(0, 30, stats_str);
+    }
 }
 
 /**
@@ -144,27 +234,45 @@ void DisplayManager::draw_stats(const SignalProcessor &signal_processor)
  */
 void DisplayManager::draw_plot()
 {
-    // Draw the actual plot points with increased sensitivity
-    for (int i = 0; i < config::display::plot::PLOT_POINTS - 1; i++)
-    {
-        int x1 = i * 2;
-        int x2 = (i + 1) * 2;
+    clear_band(config::display::plot::PLOT_BASELINE_Y_POSITION - config::display::plot::PLOT_HEIGHT,
+               config::display::plot::PLOT_HEIGHT + 1);
 
-        // Shows the value of the plot buffer as a line on the display
-        int y1 = map(m_plot_buffer[i], 0, config::signal_processing::ranges::MAX,
-                     config::display::plot::PLOT_BASELINE_Y_POSITION,
-                     config::display::plot::PLOT_BASELINE_Y_POSITION - config::display::plot::PLOT_HEIGHT);
+    // Oldest column on the left, one envelope column per pixel
+    for (uint8_t x = 0; x < PlotEnvelope::COLUMNS; x++)
+    {
+        const PlotEnvelope::Column &column = m_plot.column(x);
+        if (column.is_empty())
+        {
+            continue;
+        }
 
-        // Draws a line between the current and next point
-        int y2 = map(m_plot_buffer[(i + 1)], 0, config::signal_processing::ranges::MAX,
-                     config::display::plot::PLOT_BASELINE_Y_POSITION,
-                     config::display::plot::PLOT_BASELINE_Y_POSITION - config::display::plot::PLOT_HEIGHT);
+        int y_min = plot_y(column.min);
+        int y_max = plot_y(column.max);
+        m_u8g2.drawVLine(x, y_max, y_min - y_max + 1);
 
-        // Draws the line between the current and next point
-        m_u8g2.drawLine(x1, y1, x2, y2);
+        // Mark the mean inside envelopes tall enough to show it
+        if (y_min - y_max >= 4)
+        {
+            m_u8g2.setDrawColor(0);
+            m_u8g2.drawPixel(x, plot_y(column.mean()));
+            m_u8g2.setDrawColor(1);
+        }
     }
 }
 
+/**
+ * @brief Map a value to its plot row.
+ * @param value The value.
+ * @return The pixel row, clamped to the plot band.
+ */
+int DisplayManager::plot_y(uint16_t value) const
+{
+    int clamped = std::min<int>(value, config::signal_processing::ranges::MAX);
+    return map(clamped, 0, config::signal_processing::ranges::MAX,
+               config::display::plot::PLOT_BASELINE_Y_POSITION,
+               config::display::plot::PLOT_BASELINE_Y_POSITION - config::display::plot::PLOT_HEIGHT);
+}
+
 /**
  * @brief Convert a noise level to a string.
  * @param level The noise level to convert.
@@ -185,4 +293,4 @@ const char *DisplayManager::noise_level_to_string(SignalProcessor::NoiseLevel le
     default:
         return "???";
     }
-}
+}
\ No newline at end of file
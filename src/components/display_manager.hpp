@@ -1,7 +1,9 @@
 #pragma once
 
 #include <U8g2lib.h>
-#include "signal_processor.hpp"
+#include "signal_frame.hpp"
+#include "frame_diff.hpp"
+#include "plot_envelope.hpp"
 #include "config/config.h"
 #include "alert_manager.hpp"
 #include "wifi_manager.hpp"
@@ -9,22 +11,50 @@
 
 /**
  * @brief Class representing the display manager.
+ *
+ * Text rows are only re-rendered when their text changes and only the 8x8
+ * tiles that differ from what the panel shows are sent, so an unchanged
+ * frame costs no SPI traffic.
  */
 class DisplayManager
 {
 public:
+    struct Stats
+    {
+        uint32_t frames{0};
+        uint32_t rows_rendered{0}; // Text rows whose contents changed
+        uint32_t tiles_sent{0};
+        uint32_t bytes_sent{0};    // Display RAM bytes, without addressing commands
+        uint32_t last_frame_bytes{0};
+        uint32_t frames_skipped{0}; // Frames not sent because the SD card held the bus
+    };
+
     DisplayManager(const AlertManager &alert_manager);
     void begin();
-    void update(const SignalProcessor &signal_processor);
-    void add_plot_point(int value);
+    void update(const SignalFrame &frame);
+    void add_plot_point(uint16_t value, unsigned long timestamp_ms);
+    void set_plot_span(PlotEnvelope::Span span);
+
+    const Stats &get_stats() const { return m_stats; }
 
 private:
+    static constexpr uint8_t NUM_ROWS = 3;
+    static constexpr uint8_t ROW_TEXT_SIZE = 32;
+
     const AlertManager &m_alert_manager;
     U8G2_ST7565_ERC12864_ALT_F_4W_HW_SPI m_u8g2;
-    int m_plot_buffer[config::display::plot::PLOT_POINTS];
-    int m_plot_index{0};
+    PlotEnvelope m_plot;
+
+    FrameDiff<config::display::TILE_COLUMNS, config::display::TILE_ROWS> m_frame_diff;
+    char m_row_text[NUM_ROWS][ROW_TEXT_SIZE]{}; // What each text row currently shows
+    bool m_layout_ready{false};
+    Stats m_stats;
 
-    void draw_stats(const SignalProcessor &signal_processor);
+    void draw_stats(const SignalFrame &frame);
+    bool row_changed(uint8_t row, const char *text);
+    void clear_band(uint8_t top, uint8_t height);
     void draw_plot();
+    int plot_y(uint16_t value) const;
+    void send_changes();
     const char *noise_level_to_string(SignalProcessor::NoiseLevel level) const;
 };
\ No newline at end of file
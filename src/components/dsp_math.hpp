@@ -0,0 +1,62 @@
+#pragma once
+
+/**
+ * @brief Constexpr math used to build filter coefficients and DSP tables at
+ * compile time, where <cmath> is not usable.
+ */
+namespace dsp_math
+{
+    constexpr double PI = 3.14159265358979323846;
+    constexpr double LN2 = 0.69314718055994530942;
+
+    // Taylor series after reduction to [-pi, pi]
+    constexpr double cos(double x)
+    {
+        double turns = x / (2.0 * PI);
+        long whole = static_cast<long>(turns < 0 ? turns - 0.5 : turns + 0.5);
+        x -= whole * 2.0 * PI;
+
+        double term = 1.0;
+        double sum = 1.0;
+        for (int n = 1; n < 20; n++)
+        {
+            term *= -x * x / ((2 * n - 1) * (2 * n));
+            sum += term;
+        }
+        return sum;
+    }
+
+    constexpr double sin(double x)
+    {
+        return cos(x - PI / 2.0);
+    }
+
+    constexpr double exp(double x)
+    {
+        // Sum for |x| and invert, avoiding the cancellation of an alternating series
+        double ax = x < 0 ? -x : x;
+        double term = 1.0;
+        double sum = 1.0;
+        for (int n = 1; n < 60; n++)
+        {
+            term *= ax / n;
+            sum += term;
+        }
+        return x < 0 ? 1.0 / sum : sum;
+    }
+
+    constexpr double exp2(double x)
+    {
+        return exp(x * LN2);
+    }
+
+    constexpr double sqrt(double x)
+    {
+        double r = x > 1.0 ? x : 1.0;
+        for (int i = 0; i < 64; i++)
+        {
+            r = 0.5 * (r + x / r);
+        }
+        return r;
+    }
+}
\ No newline at end of file
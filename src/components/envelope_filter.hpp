@@ -0,0 +1,95 @@
+#pragma once
+
+#include <stdint.h>
+#include "config/config.h"
+
+namespace fixed_point
+{
+    constexpr int Q15_FRAC_BITS = 15;
+
+    // Round a coefficient in [0, 1] to Q15
+    constexpr int32_t to_q15(float value)
+    {
+        return static_cast<int32_t>(value * (1 << Q15_FRAC_BITS) + 0.5f);
+    }
+}
+
+/**
+ * @brief Float implementation of the fast envelope EMA and the slow baseline EMA.
+ */
+class FloatEnvelopeFilter
+{
+public:
+    void update(uint16_t raw_value)
+    {
+        // Calculate fast EMA for current noise
+        m_ema = (config::signal_processing::EMA_ALPHA * raw_value) +
+                ((1.0f - config::signal_processing::EMA_ALPHA) * m_ema);
+
+        // Update baseline (very slow EMA)
+        if (m_baseline == 0)
+        {
+            m_baseline = m_ema; // Initialize baseline
+        }
+        m_baseline = (config::signal_processing::BASELINE_ALPHA * m_ema) +
+                     ((1.0f - config::signal_processing::BASELINE_ALPHA) * m_baseline);
+    }
+
+    float value() const { return m_ema; }
+    float baseline() const { return m_baseline; }
+
+private:
+    float m_ema{0.0f};
+    float m_baseline{0.0f};
+};
+
+/**
+ * @brief Fixed-point implementation of the same filters.
+ *
+ * Coefficients are Q15. The envelope is held with 16 fractional bits in 32 bits
+ * and the baseline with 31 fractional bits in 64 bits, so the tiny baseline
+ * step never rounds to zero the way a float baseline around a few hundred ADC
+ * units does. Integer-only, hence bit-identical on device and host.
+ */
+class FixedEnvelopeFilter
+{
+public:
+    static constexpr int COEFF_FRAC_BITS = fixed_point::Q15_FRAC_BITS;
+    static constexpr int EMA_FRAC_BITS = 16;
+    static constexpr int BASELINE_FRAC_BITS = 31;
+
+    static constexpr int32_t EMA_ALPHA_Q15 = fixed_point::to_q15(config::signal_processing::EMA_ALPHA);
+    static constexpr int32_t BASELINE_ALPHA_Q15 = fixed_point::to_q15(config::signal_processing::BASELINE_ALPHA);
+
+    static_assert(EMA_ALPHA_Q15 > 0 && EMA_ALPHA_Q15 <= (1 << COEFF_FRAC_BITS),
+                  "EMA_ALPHA is not representable in Q15");
+    static_assert(BASELINE_ALPHA_Q15 > 0,
+                  "BASELINE_ALPHA underflows Q15");
+    static_assert((int64_t(config::adc::MAX_VALUE) << EMA_FRAC_BITS) <= INT32_MAX,
+                  "Envelope state must fit 32 bits");
+
+    void update(uint16_t raw_value)
+    {
+        // ema += alpha * (x - ema), with the product in 64 bits and rounded
+        int32_t target = static_cast<int32_t>(raw_value) << EMA_FRAC_BITS;
+        int64_t step = int64_t(EMA_ALPHA_Q15) * (target - m_ema);
+        m_ema += static_cast<int32_t>((step + ROUNDING) >> COEFF_FRAC_BITS);
+
+        int64_t ema_wide = int64_t(m_ema) << (BASELINE_FRAC_BITS - EMA_FRAC_BITS);
+        if (m_baseline == 0)
+        {
+            m_baseline = ema_wide; // Initialize baseline
+        }
+        m_baseline += (int64_t(BASELINE_ALPHA_Q15) * (ema_wide - m_baseline) + ROUNDING) >>
+                      COEFF_FRAC_BITS;
+    }
+
+    float value() const { return m_ema * (1.0f / (1 << EMA_FRAC_BITS)); }
+    float baseline() const { return static_cast<float>(m_baseline * (1.0 / (int64_t(1) << BASELINE_FRAC_BITS))); }
+
+private:
+    static constexpr int64_t ROUNDING = int64_t(1) << (COEFF_FRAC_BITS - 1);
+
+    int32_t m_ema{0};
+    int64_t m_baseline{0};
+};
\ No newline at end of file
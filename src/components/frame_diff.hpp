@@ -0,0 +1,83 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+/**
+ * @brief Finds the 8x8 tiles of a page-organised frame buffer that changed.
+ *
+ * Keeps a copy of what the panel shows. update() compares a new frame against
+ * it tile by tile, reports each horizontal run of changed tiles per page and
+ * takes the new contents over, so only those runs have to be sent. Runs that
+ * are separated by fewer than MERGE_GAP clean tiles are sent as one, since
+ * every run costs an address command on the bus.
+ *
+ * The layout is U8g2's full buffer: page-major, one byte per 8-pixel column.
+ */
+template <uint8_t TILE_WIDTH, uint8_t TILE_HEIGHT>
+class FrameDiff
+{
+public:
+    static constexpr size_t TILE_BYTES = 8;
+    static constexpr size_t PAGE_BYTES = TILE_WIDTH * TILE_BYTES;
+    static constexpr size_t FRAME_BYTES = TILE_HEIGHT * PAGE_BYTES;
+    static constexpr uint8_t MERGE_GAP = 2;
+
+    /**
+     * @brief Report the changed tile runs of a frame and remember it as sent.
+     * @param frame The frame buffer, FRAME_BYTES long.
+     * @param send Called as send(tile_x, tile_y, tile_count) for every run.
+     * @return The number of tiles reported.
+     */
+    template <typename SendFn>
+    size_t update(const uint8_t *frame, SendFn &&send)
+    {
+        size_t tiles = 0;
+        for (uint8_t ty = 0; ty < TILE_HEIGHT; ty++)
+        {
+            const size_t page = ty * PAGE_BYTES;
+            int run_start = -1;
+            int run_end = -1; // One past the last dirty tile of the run
+
+            for (uint8_t tx = 0; tx < TILE_WIDTH; tx++)
+            {
+                const size_t offset = page + tx * TILE_BYTES;
+                if (m_valid && memcmp(frame + offset, m_shadow + offset, TILE_BYTES) == 0)
+                {
+                    continue;
+                }
+                memcpy(m_shadow + offset, frame + offset, TILE_BYTES);
+
+                if (run_start >= 0 && tx - run_end >= MERGE_GAP)
+                {
+                    send(static_cast<uint8_t>(run_start), ty, static_cast<uint8_t>(run_end - run_start));
+                    tiles += run_end - run_start;
+                    run_start = -1;
+                }
+                if (run_start < 0)
+                {
+                    run_start = tx;
+                }
+                run_end = tx + 1;
+            }
+
+            if (run_start >= 0)
+            {
+                send(static_cast<uint8_t>(run_start), ty, static_cast<uint8_t>(run_end - run_start));
+                tiles += run_end - run_start;
+            }
+        }
+        m_valid = true;
+        return tiles;
+    }
+
+    /**
+     * @brief Forget what the panel shows, so the next update sends everything.
+     */
+    void invalidate() { m_valid = false; }
+
+private:
+    uint8_t m_shadow[FRAME_BYTES];
+    bool m_valid{false};
+};
\ No newline at end of file
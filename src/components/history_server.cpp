@@ -0,0 +1,81 @@
+#include "history_server.hpp"
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <unistd.h>
+#include "esp_log.h"
+
+/**
+ * @brief Open the listening socket and start the server task.
+ * @return True if the server is running, false otherwise.
+ */
+bool HistoryServer::begin()
+{
+    if (m_task)
+    {
+        return true;
+    }
+
+    m_listen_socket = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (m_listen_socket < 0)
+    {
+        ESP_LOGE(TAG, "Cannot create socket");
+        return false;
+    }
+
+    int reuse = 1;
+    setsockopt(m_listen_socket, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    struct sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+    address.sin_port = htons(config::history::PORT);
+    if (bind(m_listen_socket, reinterpret_cast<struct sockaddr *>(&address), sizeof(address)) != 0 ||
+        listen(m_listen_socket, 1) != 0)
+    {
+        ESP_LOGE(TAG, "Cannot listen on port %u", config::history::PORT);
+        close(m_listen_socket);
+        m_listen_socket = -1;
+        return false;
+    }
+
+    if (xTaskCreatePinnedToCore(server_task,
+                                "history",
+                                config::history::SERVER_STACK_SIZE,
+                                this,
+                                config::history::SERVER_PRIORITY,
+                                &m_task,
+                                config::history::SERVER_CORE) != pdPASS)
+    {
+        ESP_LOGE(TAG, "Cannot start server task");
+        close(m_listen_socket);
+        m_listen_socket = -1;
+        m_task = nullptr;
+        return false;
+    }
+
+    ESP_LOGI(TAG, "Serving /history on port %u", config::history::PORT);
+    return true;
+}
+
+/**
+ * @brief Server task: accept connections and answer them one at a time.
+ * @param param The HistoryServer.
+ */
+void HistoryServer::server_task(void *param)
+{
+    HistoryServer *server = static_cast<HistoryServer *>(param);
+
+    while (true)
+    {
+        int client = accept(server->m_listen_socket, nullptr, nullptr);
+        if (client < 0)
+        {
+            vTaskDelay(pdMS_TO_TICKS(100));
+            continue;
+        }
+
+        server->m_stream.handle_client(client);
+        shutdown(client, SHUT_RDWR);
+        close(client);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include "history_stream.hpp"
+#include "config/config.h"
+
+/**
+ * @brief HTTP server for logged history, one client at a time.
+ *
+ * A low-priority task blocks in accept() and hands each connection to a
+ * HistoryStream, so long downloads never hold up the main loop.
+ */
+class HistoryServer
+{
+public:
+    static HistoryServer &instance()
+    {
+        static HistoryServer instance;
+        return instance;
+    }
+
+    bool begin();
+    bool is_running() const { return m_task != nullptr; }
+    const HistoryStream::Stats &get_stats() const { return m_stream.get_stats(); }
+
+private:
+    static constexpr char const *TAG = "HistoryServer";
+
+    int m_listen_socket{-1};
+    TaskHandle_t m_task{nullptr};
+    HistoryStream m_stream{config::logging::MOUNT_POINT};
+
+    HistoryServer() = default;
+    static void server_task(void *param);
+};
\ No newline at end of file
@@ -0,0 +1,455 @@
+#include "history_stream.hpp"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <algorithm>
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+namespace
+{
+    constexpr char const *CSV_HEADERS = "HTTP/1.1 200 OK\r\n"
+                                        "Content-Type: text/csv\r\n"
+                                        "Transfer-Encoding: chunked\r\n"
+                                        "Connection: close\r\n\r\n";
+
+    const char *status_text(int status)
+    {
+        switch (status)
+        {
+        case 400:
+            return "Bad Request";
+        case 404:
+            return "Not Found";
+        case 405:
+            return "Method Not Allowed";
+        default:
+            return "Internal Server Error";
+        }
+    }
+
+    void set_timeout(int socket, int option, uint32_t timeout_ms)
+    {
+        struct timeval timeout;
+        timeout.tv_sec = timeout_ms / 1000;
+        timeout.tv_usec = (timeout_ms % 1000) * 1000;
+        setsockopt(socket, SOL_SOCKET, option, &timeout, sizeof(timeout));
+    }
+
+    /**
+     * @brief Parse an unsigned decimal query value.
+     * @param text The value, ending at '&', ' ' or the end of the string.
+     * @param value Set to the number.
+     * @return False if the value is empty, not a number or out of range.
+     */
+    bool parse_uint(const char *text, uint32_t &value)
+    {
+        uint64_t result = 0;
+        const char *start = text;
+        while (*text >= '0' && *text <= '9')
+        {
+            result = result * 10 + (*text++ - '0');
+            if (result > UINT32_MAX)
+            {
+                return false;
+            }
+        }
+        value = static_cast<uint32_t>(result);
+        return text != start && (*text == '&' || *text == ' ' || *text == '\0');
+    }
+
+    // Scales are 1 or a power of ten, printed with as many decimals
+    int format_fixed(char *out, size_t size, int32_t value, int32_t scale)
+    {
+        if (scale <= 1)
+        {
+            return snprintf(out, size, "%ld", static_cast<long>(value));
+        }
+
+        int decimals = 0;
+        for (int32_t s = scale; s > 1; s /= 10)
+        {
+            decimals++;
+        }
+        int64_t magnitude = value < 0 ? -int64_t(value) : value;
+        return snprintf(out, size, "%s%ld.%0*ld", value < 0 ? "-" : "", static_cast<long>(magnitude / scale),
+                        decimals, static_cast<long>(magnitude % scale));
+    }
+}
+
+/**
+ * @brief Read the request, stream the answer and return; the caller closes the socket.
+ * @param socket A connected client socket.
+ */
+void HistoryStream::handle_client(int socket)
+{
+    m_socket = socket;
+    m_failed = false;
+    m_stats.requests++;
+
+    set_timeout(socket, SO_RCVTIMEO, config::history::RECV_TIMEOUT_MS);
+    set_timeout(socket, SO_SNDTIMEO, config::history::SEND_TIMEOUT_MS);
+
+    Request request;
+    int status = read_head() ? parse_request(m_head, static_cast<uint32_t>(time(nullptr)), request) : 400;
+    if (status != 200)
+    {
+        send_error(status);
+        return;
+    }
+
+    stream(request);
+    if (m_failed)
+    {
+        m_stats.aborted++;
+    }
+}
+
+/**
+ * @brief Parse the request line of a history request.
+ * @param head The request head, NUL-terminated.
+ * @param now Current Unix time, the default end of the range.
+ * @param request Set to the requested range.
+ * @return 200 if the request is valid, otherwise the HTTP status to answer with.
+ */
+int HistoryStream::parse_request(const char *head, uint32_t now, Request &request)
+{
+    if (strncmp(head, "GET ", 4) != 0)
+    {
+        return 405;
+    }
+
+    const char *path = head + 4;
+    static constexpr char PATH[] = "/history";
+    if (strncmp(path, PATH, sizeof(PATH) - 1) != 0 ||
+        (path[sizeof(PATH) - 1] != '?' && path[sizeof(PATH) - 1] != ' '))
+    {
+        return 404;
+    }
+
+    bool has_from = false;
+    request.to = now + 1;
+    request.resolution_s = 0;
+
+    const char *param = path + sizeof(PATH) - 1;
+    while (*param == '?' || *param == '&')
+    {
+        param++;
+        const char *value = strchr(param, '=');
+        const char *end = param + strcspn(param, "& ");
+        if (!value || value > end)
+        {
+            param = end;
+            continue;
+        }
+        value++;
+
+        size_t key_length = value - 1 - param;
+        uint32_t *target = nullptr;
+        if (key_length == 4 && strncmp(param, "from", 4) == 0)
+        {
+            target = &request.from;
+            has_from = true;
+        }
+        else if (key_length == 2 && strncmp(param, "to", 2) == 0)
+        {
+            target = &request.to;
+        }
+        else if (key_length == 3 && strncmp(param, "res", 3) == 0)
+        {
+            target = &request.resolution_s;
+        }
+
+        // Unknown parameters are ignored
+        if (target && !parse_uint(value, *target))
+        {
+            return 400;
+        }
+        param = end;
+    }
+
+    if (!has_from)
+    {
+        request.from = request.to > config::history::DEFAULT_RANGE_S
+                           ? request.to - config::history::DEFAULT_RANGE_S
+                           : 0;
+    }
+    if (request.from >= request.to || request.to - request.from > config::history::MAX_RANGE_S ||
+        request.resolution_s > config::history::MAX_RESOLUTION_S)
+    {
+        return 400;
+    }
+    return 200;
+}
+
+/**
+ * @brief Read the request head, up to the blank line or the buffer size.
+ * @return True if at least a complete request line arrived.
+ */
+bool HistoryStream::read_head()
+{
+    size_t length = 0;
+    while (length < sizeof(m_head) - 1)
+    {
+        int received = recv(m_socket, m_head + length, sizeof(m_head) - 1 - length, 0);
+        if (received <= 0)
+        {
+            break;
+        }
+        length += received;
+        m_head[length] = '\0';
+        if (strstr(m_head, "\r\n\r\n"))
+        {
+            return true;
+        }
+    }
+    m_head[length] = '\0';
+
+    // Long headers are cut off, only the request line matters
+    return strstr(m_head, "\r\n") != nullptr;
+}
+
+/**
+ * @brief Send a buffer completely.
+ * @param data The bytes.
+ * @param length The number of bytes.
+ * @return False once the client is gone or stalled.
+ */
+bool HistoryStream::send_all(const char *data, size_t length)
+{
+    while (!m_failed && length > 0)
+    {
+        int sent = send(m_socket, data, length, MSG_NOSIGNAL);
+        if (sent <= 0)
+        {
+            m_failed = true;
+            break;
+        }
+        data += sent;
+        length -= sent;
+        m_stats.bytes_sent += sent;
+    }
+    return !m_failed;
+}
+
+/**
+ * @brief Answer with an error status and a one-line body.
+ * @param status The HTTP status.
+ */
+void HistoryStream::send_error(int status)
+{
+    m_stats.rejected++;
+
+    char response[160];
+    int length = snprintf(response, sizeof(response),
+                          "HTTP/1.1 %d %s\r\nContent-Type: text/plain\r\nContent-Length: %u\r\n"
+                          "Connection: close\r\n\r\n%s\n",
+                          status, status_text(status), static_cast<unsigned>(strlen(status_text(status)) + 1),
+                          status_text(status));
+    send_all(response, length);
+}
+
+/**
+ * @brief Stream the records of every day file in the range.
+ * @param request The validated request.
+ */
+void HistoryStream::stream(const Request &request)
+{
+    if (!send_all(CSV_HEADERS, strlen(CSV_HEADERS)))
+    {
+        return;
+    }
+
+    m_fill = 0;
+    m_bucket = Bucket();
+    m_resolution_s = request.resolution_s;
+
+    for (size_t f = 0; f < log_format::NUM_FIELDS; f++)
+    {
+        write(log_format::FIELDS[f].name, strlen(log_format::FIELDS[f].name));
+        write(f + 1 < log_format::NUM_FIELDS ? "," : "\r\n", f + 1 < log_format::NUM_FIELDS ? 1 : 2);
+    }
+
+    uint32_t day_start = request.from;
+    while (day_start < request.to && !m_failed)
+    {
+        uint32_t day_end;
+        if (open_day(day_start, day_end))
+        {
+            m_reader.query(day_start, std::min(request.to, day_end), on_record, this);
+            m_reader.close();
+        }
+        if (day_end <= day_start)
+        {
+            break;
+        }
+        day_start = day_end;
+    }
+
+    flush_bucket();
+    send_chunk();
+    send_all("0\r\n\r\n", 5);
+}
+
+/**
+ * @brief Open the log of the local day containing a time.
+ * @param timestamp A time within the day.
+ * @param day_end Set to the start of the next day.
+ * @return True if a log for that day exists.
+ */
+bool HistoryStream::open_day(uint32_t timestamp, uint32_t &day_end)
+{
+    time_t t = timestamp;
+    struct tm day;
+    localtime_r(&t, &day);
+
+    char date[8];
+    strftime(date, sizeof(date), "%y%m%d", &day);
+
+    day.tm_mday++;
+    day.tm_hour = 0;
+    day.tm_min = 0;
+    day.tm_sec = 0;
+    day.tm_isdst = -1;
+    day_end = static_cast<uint32_t>(mktime(&day));
+
+    // Same names as DataLogger, binary preferred
+    char path[48];
+    snprintf(path, sizeof(path), "%s/%s.bin", m_root, date);
+    if (m_reader.open(path))
+    {
+        return true;
+    }
+    snprintf(path, sizeof(path), "%s/%s.csv", m_root, date);
+    return m_reader.open(path);
+}
+
+/**
+ * @brief LogReader callback.
+ * @return False to stop reading once the client is gone.
+ */
+bool HistoryStream::on_record(void *context, const log_format::Record &record)
+{
+    HistoryStream *stream = static_cast<HistoryStream *>(context);
+    if (stream->m_resolution_s == 0)
+    {
+        stream->write_row(record);
+    }
+    else
+    {
+        stream->add_to_bucket(record);
+    }
+    return !stream->m_failed;
+}
+
+/**
+ * @brief Accumulate a record into its res-second bucket, emitting the previous one.
+ * @param record The record.
+ */
+void HistoryStream::add_to_bucket(const log_format::Record &record)
+{
+    uint32_t timestamp = static_cast<uint32_t>(record[log_format::TIMESTAMP]);
+    uint32_t start = timestamp - timestamp % m_resolution_s;
+    if (m_bucket.count > 0 && start != m_bucket.start)
+    {
+        flush_bucket();
+    }
+
+    if (m_bucket.count == 0)
+    {
+        m_bucket.start = start;
+        std::fill(std::begin(m_bucket.maxima), std::end(m_bucket.maxima), INT32_MIN);
+    }
+    for (size_t f = 0; f < log_format::NUM_FIELDS; f++)
+    {
+        m_bucket.sums[f] += record[f];
+        m_bucket.maxima[f] = std::max(m_bucket.maxima[f], record[f]);
+    }
+    m_bucket.count++;
+}
+
+/**
+ * @brief Write the pending bucket as one row.
+ */
+void HistoryStream::flush_bucket()
+{
+    if (m_bucket.count == 0)
+    {
+        return;
+    }
+
+    log_format::Record record;
+    for (size_t f = 0; f < log_format::NUM_FIELDS; f++)
+    {
+        int64_t sum = m_bucket.sums[f];
+        int64_t half = (sum < 0 ? -1 : 1) * int64_t(m_bucket.count / 2);
+        record[f] = static_cast<int32_t>((sum + half) / int64_t(m_bucket.count));
+    }
+    record[log_format::TIMESTAMP] = static_cast<int32_t>(m_bucket.start);
+    record[log_format::CATEGORY] = m_bucket.maxima[log_format::CATEGORY];
+    record[log_format::LCPEAK] = m_bucket.maxima[log_format::LCPEAK];
+    record[log_format::ONE_MIN_MAX] = m_bucket.maxima[log_format::ONE_MIN_MAX];
+    write_row(record);
+
+    m_bucket = Bucket();
+}
+
+/**
+ * @brief Format one record as a CSV row into the chunk buffer.
+ * @param record The record.
+ */
+void HistoryStream::write_row(const log_format::Record &record)
+{
+    char row[log_format::NUM_FIELDS * 14 + 2];
+    size_t length = 0;
+    for (size_t f = 0; f < log_format::NUM_FIELDS; f++)
+    {
+        length += format_fixed(row + length, sizeof(row) - length, record[f], log_format::FIELDS[f].scale);
+        row[length++] = f + 1 < log_format::NUM_FIELDS ? ',' : '\r';
+    }
+    row[length++] = '\n';
+
+    write(row, length);
+    m_stats.records_sent++;
+}
+
+/**
+ * @brief Append bytes to the chunk buffer, sending it when full.
+ * @param text The bytes.
+ * @param length The number of bytes, at most STREAM_BUFFER_SIZE.
+ */
+void HistoryStream::write(const char *text, size_t length)
+{
+    if (m_fill + length > config::history::STREAM_BUFFER_SIZE)
+    {
+        send_chunk();
+    }
+    memcpy(m_chunk + CHUNK_HEADER_SIZE + m_fill, text, length);
+    m_fill += length;
+}
+
+/**
+ * @brief Frame the buffered bytes as one chunk and send it.
+ */
+void HistoryStream::send_chunk()
+{
+    if (m_fill == 0)
+    {
+        return;
+    }
+
+    // The size line goes right in front of the payload, the CRLF right after it
+    char size_line[CHUNK_HEADER_SIZE + 1];
+    int header = snprintf(size_line, sizeof(size_line), "%X\r\n", static_cast<unsigned>(m_fill));
+    char *start = m_chunk + CHUNK_HEADER_SIZE - header;
+    memcpy(start, size_line, header);
+    memcpy(m_chunk + CHUNK_HEADER_SIZE + m_fill, "\r\n", 2);
+
+    send_all(start, header + m_fill + 2);
+    m_fill = 0;
+}
\ No newline at end of file
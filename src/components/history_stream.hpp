@@ -0,0 +1,80 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "log_reader.hpp"
+#include "config/config.h"
+
+/**
+ * @brief Answers one HTTP request for logged history on a connected socket.
+ *
+ * GET /history?from=&to=&res= (Unix times, end exclusive, res in seconds)
+ * streams the records of every day file in the range as CSV with chunked
+ * transfer encoding. Records flow from LogReader through one fixed chunk
+ * buffer to the socket, so memory use does not depend on the range. With
+ * res, records are averaged into res-second buckets on the fly (peaks and
+ * the category keep their maximum).
+ *
+ * Plain BSD sockets and stdio, so it runs on lwIP and on a host.
+ */
+class HistoryStream
+{
+public:
+    struct Request
+    {
+        uint32_t from{0};
+        uint32_t to{0};
+        uint32_t resolution_s{0}; // 0 for every record
+    };
+
+    struct Stats
+    {
+        uint32_t requests{0};
+        uint32_t rejected{0}; // Answered with an error status
+        uint32_t aborted{0};  // Client went away mid-stream
+        uint32_t records_sent{0};
+        uint32_t bytes_sent{0};
+    };
+
+    explicit HistoryStream(const char *root) : m_root(root) {}
+
+    void handle_client(int socket);
+    static int parse_request(const char *head, uint32_t now, Request &request);
+
+    const Stats &get_stats() const { return m_stats; }
+
+private:
+    static constexpr size_t CHUNK_HEADER_SIZE = 6; // Up to four hex digits and CRLF
+
+    struct Bucket
+    {
+        uint32_t start{0};
+        uint32_t count{0};
+        int64_t sums[log_format::NUM_FIELDS]{};
+        int32_t maxima[log_format::NUM_FIELDS]{};
+    };
+
+    const char *m_root;
+    LogReader m_reader;
+    int m_socket{-1};
+    bool m_failed{false};
+    uint32_t m_resolution_s{0};
+    size_t m_fill{0};
+    Bucket m_bucket;
+    Stats m_stats;
+    char m_head[config::history::REQUEST_BUFFER_SIZE];
+    char m_chunk[CHUNK_HEADER_SIZE + config::history::STREAM_BUFFER_SIZE + 2];
+
+    bool read_head();
+    bool send_all(const char *data, size_t length);
+    void send_error(int status);
+    void stream(const Request &request);
+    bool open_day(uint32_t timestamp, uint32_t &day_end);
+
+    static bool on_record(void *context, const log_format::Record &record);
+    void add_to_bucket(const log_format::Record &record);
+    void flush_bucket();
+    void write_row(const log_format::Record &record);
+    void write(const char *text, size_t length);
+    void send_chunk();
+};
\ No newline at end of file
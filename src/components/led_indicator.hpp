@@ -1,17 +1,21 @@
 #pragma once
 
-#include <Adafruit_NeoPixel.h>
+#include <Arduino.h>
 #include "config/config.h"
-#include "signal_processor.hpp"
+#include "led_meter.hpp"
+#include "rmt_led_output.hpp"
+#include "signal_frame.hpp"
 
 class LedIndicator
 {
 public:
-    LedIndicator();
+    LedIndicator() = default;
     void begin();
-    void update(const SignalProcessor &signal_processor);
+    void update(const SignalFrame &frame);
+
+    const LedMeter::Stats &get_stats() const { return m_meter.get_stats(); }
 
 private:
-    Adafruit_NeoPixel m_pixels;
-    void update_level_display(float noise_level);
+    RmtLedOutput m_output{config::hardware::pins::led::STRIP};
+    LedMeter m_meter{m_output, millis};
 };
\ No newline at end of file
@@ -0,0 +1,79 @@
+#include "led_meter.hpp"
+#include <algorithm>
+
+/**
+ * @brief Show a level, sending the frame only if it differs from the one on the strip.
+ * @param level The current noise level.
+ */
+void LedMeter::update(float level)
+{
+    m_stats.updates++;
+
+    // LED 0 is always lit, the others once the level reaches their threshold
+    const auto &thresholds = led_meter::THRESHOLDS;
+    size_t reached = std::upper_bound(thresholds.begin() + 1, thresholds.end(), level,
+                                      [](float value, uint16_t threshold) { return value < threshold; }) -
+                     thresholds.begin();
+    m_bar = static_cast<uint8_t>(reached);
+
+    update_peak(m_clock());
+    send();
+}
+
+/**
+ * @brief Turn every LED off and forget the peak.
+ */
+void LedMeter::clear()
+{
+    m_bar = 0;
+    m_peak = -1;
+    send();
+}
+
+/**
+ * @brief Raise the peak to the bar, or let it fall once its hold time is over.
+ * @param now The current time in milliseconds.
+ */
+void LedMeter::update_peak(unsigned long now)
+{
+    int8_t top = static_cast<int8_t>(m_bar) - 1;
+    if (top >= m_peak)
+    {
+        m_peak = top;
+        m_peak_time = now + config::led::PEAK_HOLD_MS;
+    }
+    else if (static_cast<long>(now - m_peak_time) >= 0)
+    {
+        m_peak--;
+        m_peak_time = now + config::led::PEAK_DECAY_MS;
+    }
+}
+
+/**
+ * @brief Transmit the frame if it changed and the output is free.
+ */
+void LedMeter::send()
+{
+    // The peak only shows above the bar
+    int8_t peak = m_peak >= static_cast<int8_t>(m_bar) ? m_peak : -1;
+    if (m_bar == m_sent_bar && peak == m_sent_peak)
+    {
+        m_stats.frames_unchanged++;
+        return;
+    }
+    if (m_output.is_busy())
+    {
+        m_stats.output_busy++;
+        return;
+    }
+
+    for (size_t i = 0; i < led_meter::NUM_PIXELS; i++)
+    {
+        bool lit = i < m_bar || static_cast<int8_t>(i) == peak;
+        m_frame[i] = lit ? led_meter::COLORS[i] : 0;
+    }
+    m_output.show(m_frame);
+    m_sent_bar = m_bar;
+    m_sent_peak = peak;
+    m_stats.frames_sent++;
+}
\ No newline at end of file
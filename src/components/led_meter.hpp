@@ -0,0 +1,159 @@
+#pragma once
+
+#include <array>
+#include <stddef.h>
+#include <stdint.h>
+#include "config/config.h"
+
+/**
+ * @brief Compile-time threshold and color tables for the LED level meter.
+ */
+namespace led_meter
+{
+    constexpr size_t NUM_PIXELS = config::led::NUM_PIXELS;
+
+    // LED i lights at QUIET + i/(N-1) of the way to MAX; LED 0 is always lit
+    constexpr std::array<uint16_t, NUM_PIXELS> make_thresholds()
+    {
+        namespace ranges = config::signal_processing::ranges;
+        std::array<uint16_t, NUM_PIXELS> table{};
+        for (size_t i = 0; i < NUM_PIXELS; i++)
+        {
+            table[i] = NUM_PIXELS > 1
+                           ? static_cast<uint16_t>(ranges::QUIET + uint32_t(ranges::MAX - ranges::QUIET) * i / (NUM_PIXELS - 1))
+                           : ranges::QUIET;
+        }
+        return table;
+    }
+
+    constexpr uint8_t channel(uint32_t color, int shift)
+    {
+        return static_cast<uint8_t>(color >> shift);
+    }
+
+    constexpr uint8_t blend(uint8_t from, uint8_t to, float weight)
+    {
+        return static_cast<uint8_t>(from + (to - from) * weight + 0.5f);
+    }
+
+    // Brightness scaling as done by Adafruit_NeoPixel::setBrightness()
+    constexpr uint8_t dim(uint8_t value)
+    {
+        return static_cast<uint8_t>((value * (config::led::BRIGHTNESS + 1)) >> 8);
+    }
+
+    constexpr uint32_t gradient_color(float position)
+    {
+        using config::led::colors::INDICATOR_GRADIENT;
+        constexpr size_t STOPS = sizeof(INDICATOR_GRADIENT) / sizeof(INDICATOR_GRADIENT[0]);
+        size_t upper = 1;
+        while (upper < STOPS - 1 && INDICATOR_GRADIENT[upper].position < position)
+        {
+            upper++;
+        }
+        const auto &a = INDICATOR_GRADIENT[upper - 1];
+        const auto &b = INDICATOR_GRADIENT[upper];
+        float weight = (position - a.position) / (b.position - a.position);
+        weight = weight < 0.0f ? 0.0f : (weight > 1.0f ? 1.0f : weight);
+        return config::led::make_color(dim(blend(channel(a.color, 16), channel(b.color, 16), weight)),
+                                       dim(blend(channel(a.color, 8), channel(b.color, 8), weight)),
+                                       dim(blend(channel(a.color, 0), channel(b.color, 0), weight)));
+    }
+
+    constexpr std::array<uint32_t, NUM_PIXELS> make_colors()
+    {
+        std::array<uint32_t, NUM_PIXELS> table{};
+        for (size_t i = 0; i < NUM_PIXELS; i++)
+        {
+            table[i] = gradient_color(NUM_PIXELS > 1 ? static_cast<float>(i) / (NUM_PIXELS - 1) : 0.0f);
+        }
+        return table;
+    }
+
+    constexpr std::array<uint16_t, NUM_PIXELS> THRESHOLDS = make_thresholds();
+    constexpr std::array<uint32_t, NUM_PIXELS> COLORS = make_colors(); // 0xRRGGBB, brightness applied
+
+    constexpr bool is_ascending(const std::array<uint16_t, NUM_PIXELS> &table)
+    {
+        for (size_t i = 1; i < NUM_PIXELS; i++)
+        {
+            if (table[i] < table[i - 1])
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    static_assert(NUM_PIXELS <= INT8_MAX, "Peak indexes are int8_t");
+    static_assert(is_ascending(THRESHOLDS), "LED thresholds must not decrease along the strip");
+    static_assert(sizeof(config::led::colors::INDICATOR_GRADIENT) / sizeof(config::led::colors::GradientStop) >= 2,
+                  "The LED gradient needs at least two stops");
+}
+
+/**
+ * @brief Hardware-abstraction seam for an addressable LED strip.
+ *
+ * The device implementation hands the bit stream to a peripheral and
+ * returns at once; is_busy() reports whether it is still being sent.
+ */
+class LedOutput
+{
+public:
+    virtual ~LedOutput() = default;
+
+    virtual bool begin() = 0;
+    virtual bool is_busy() = 0;
+
+    // NUM_PIXELS colors as 0xRRGGBB
+    virtual void show(const uint32_t *colors) = 0;
+};
+
+/**
+ * @brief Bar-graph level meter with a falling peak LED.
+ *
+ * update() costs the same whatever the strip length: the bar is a lookup in
+ * THRESHOLDS, the peak a single index that is held for PEAK_HOLD_MS and then
+ * falls one LED per PEAK_DECAY_MS. A frame is fully described by the bar
+ * length and the peak index, so unchanged frames are recognised without
+ * comparing pixels and are never sent. A frame that changes while the
+ * previous one is still being transmitted is sent by a later update().
+ */
+class LedMeter
+{
+public:
+    using ClockFn = unsigned long (*)(); // Milliseconds
+
+    struct Stats
+    {
+        uint32_t updates{0};
+        uint32_t frames_sent{0};
+        uint32_t frames_unchanged{0}; // Updates that left the strip as it was
+        uint32_t output_busy{0};      // Changed frames held back by a running transmission
+    };
+
+    LedMeter(LedOutput &output, ClockFn clock) : m_output(output), m_clock(clock) {}
+
+    void update(float level);
+    void clear();
+
+    uint8_t get_bar_length() const { return m_bar; }
+    int8_t get_peak() const { return m_peak; }
+    const Stats &get_stats() const { return m_stats; }
+
+private:
+    static constexpr uint8_t NOT_SENT = UINT8_MAX;
+
+    LedOutput &m_output;
+    ClockFn m_clock;
+    uint8_t m_bar{0};    // Lit LEDs from the start of the strip
+    int8_t m_peak{-1};   // Index of the peak LED, -1 for none
+    unsigned long m_peak_time{0};
+    uint8_t m_sent_bar{NOT_SENT};
+    int8_t m_sent_peak{-1};
+    uint32_t m_frame[led_meter::NUM_PIXELS]{};
+    Stats m_stats;
+
+    void update_peak(unsigned long now);
+    void send();
+};
\ No newline at end of file
@@ -0,0 +1,62 @@
+#include "ledc_tone_output.hpp"
+#include "esp_log.h"
+
+/**
+ * @brief Configure the LEDC timer and channel, starting silent.
+ * @return True if the peripheral is ready, false otherwise.
+ */
+bool LedcToneOutput::begin()
+{
+    ledc_timer_config_t timer_config = {};
+    timer_config.speed_mode = SPEED_MODE;
+    timer_config.duty_resolution = RESOLUTION;
+    timer_config.timer_num = TIMER;
+    timer_config.freq_hz = config::alert::ALARM_FREQUENCY;
+    timer_config.clk_cfg = LEDC_AUTO_CLK;
+    if (ledc_timer_config(&timer_config) != ESP_OK)
+    {
+        ESP_LOGE(TAG, "Failed to configure LEDC timer");
+        return false;
+    }
+
+    ledc_channel_config_t channel_config = {};
+    channel_config.gpio_num = m_pin;
+    channel_config.speed_mode = SPEED_MODE;
+    channel_config.channel = CHANNEL;
+    channel_config.intr_type = LEDC_INTR_DISABLE;
+    channel_config.timer_sel = TIMER;
+    channel_config.duty = 0;
+    channel_config.hpoint = 0;
+    if (ledc_channel_config(&channel_config) != ESP_OK)
+    {
+        ESP_LOGE(TAG, "Failed to configure LEDC channel");
+        return false;
+    }
+
+    m_initialized = true;
+    return true;
+}
+
+/**
+ * @brief Change the output frequency, or silence it.
+ * @param frequency_hz The tone frequency, 0 for silence.
+ */
+void LedcToneOutput::set_tone(uint16_t frequency_hz)
+{
+    if (!m_initialized || frequency_hz == m_frequency_hz)
+    {
+        return;
+    }
+
+    if (frequency_hz > 0)
+    {
+        ledc_set_freq(SPEED_MODE, TIMER, frequency_hz);
+        ledc_set_duty(SPEED_MODE, CHANNEL, HALF_DUTY);
+    }
+    else
+    {
+        ledc_set_duty(SPEED_MODE, CHANNEL, 0);
+    }
+    ledc_update_duty(SPEED_MODE, CHANNEL);
+    m_frequency_hz = frequency_hz;
+}
\ No newline at end of file
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <Arduino.h>
+#include <driver/ledc.h>
+#include "config/config.h"
+#include "tone_engine.hpp"
+
+/**
+ * @brief Square-wave tone output on the ESP32 LEDC PWM peripheral.
+ *
+ * LEDC generates the waveform in hardware at 50% duty; changing the tone is a
+ * register write, so nothing waits on the speaker.
+ */
+class LedcToneOutput : public ToneOutput
+{
+public:
+    explicit LedcToneOutput(uint8_t pin) : m_pin(pin) {}
+
+    bool begin() override;
+    void set_tone(uint16_t frequency_hz) override;
+
+private:
+    static constexpr ledc_mode_t SPEED_MODE = LEDC_LOW_SPEED_MODE;
+    static constexpr ledc_timer_t TIMER = LEDC_TIMER_1;
+    static constexpr ledc_channel_t CHANNEL = LEDC_CHANNEL_1;
+    static constexpr ledc_timer_bit_t RESOLUTION = LEDC_TIMER_10_BIT;
+    static constexpr uint32_t HALF_DUTY = 1 << (RESOLUTION - 1);
+    static constexpr char const *TAG = "LedcToneOutput";
+
+    uint8_t m_pin;
+    bool m_initialized{false};
+    uint16_t m_frequency_hz{0};
+};
\ No newline at end of file
@@ -0,0 +1,196 @@
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+#include "config/config.h"
+
+/**
+ * @brief Fixed-bin histogram for streaming exceedance levels (L10/L50/L90).
+ *
+ * Memory is fixed no matter how long the window runs: O(1) to add a value and
+ * O(bins) to query a percentile. Bins are one ADC unit wide at the bottom of
+ * the scale and a constant share of the level above it, like the mantissa of
+ * a small float, so quiet levels resolve to the unit and loud ones to a
+ * fraction of a dB. Values past the top bin are clamped into it, so the exact
+ * maximum should be tracked alongside.
+ */
+class LevelHistogram
+{
+public:
+    static constexpr uint16_t LINEAR_BINS = config::signal_processing::histogram::LINEAR_BINS;
+    static constexpr uint16_t SUB_BINS = config::signal_processing::histogram::SUB_BINS;
+    static constexpr uint16_t NUM_BINS = config::signal_processing::histogram::NUM_BINS;
+
+    // Lowest level that falls into a bin
+    static constexpr uint32_t bin_low(uint16_t bin)
+    {
+        return bin < LINEAR_BINS ? bin
+                                 : uint32_t(SUB_BINS + (bin - LINEAR_BINS) % SUB_BINS) << ((bin - LINEAR_BINS) / SUB_BINS + 1);
+    }
+
+    static constexpr uint32_t bin_width(uint16_t bin)
+    {
+        return bin < LINEAR_BINS ? 1 : uint32_t(2) << ((bin - LINEAR_BINS) / SUB_BINS);
+    }
+
+    static constexpr uint8_t LINEAR_SHIFT = __builtin_ctz(LINEAR_BINS);
+
+    static_assert(LINEAR_BINS == 2 * SUB_BINS && (SUB_BINS & (SUB_BINS - 1)) == 0,
+                  "Octave bins must continue the unit-wide bins without a gap");
+
+    static uint16_t bin_of(float value)
+    {
+        if (!(value > 0))
+        {
+            return 0;
+        }
+        if (value >= bin_low(NUM_BINS - 1))
+        {
+            return NUM_BINS - 1;
+        }
+
+        uint32_t level = static_cast<uint32_t>(value);
+        if (level < LINEAR_BINS)
+        {
+            return static_cast<uint16_t>(level);
+        }
+
+        // Octave above LINEAR_BINS, then the top log2(SUB_BINS) bits below the leading one
+        uint32_t octave = (31 - __builtin_clz(level)) - LINEAR_SHIFT;
+        return static_cast<uint16_t>(LINEAR_BINS + octave * SUB_BINS + (level >> (octave + 1)) - SUB_BINS);
+    }
+
+    void add(float value)
+    {
+        m_counts[bin_of(value)]++;
+        m_total++;
+    }
+
+    // Take back values that were added to this histogram and to `other`
+    void remove(const LevelHistogram &other)
+    {
+        for (uint16_t bin = 0; bin < NUM_BINS; bin++)
+        {
+            m_counts[bin] -= other.m_counts[bin];
+        }
+        m_total -= other.m_total;
+    }
+
+    void clear()
+    {
+        memset(m_counts, 0, sizeof(m_counts));
+        m_total = 0;
+    }
+
+    uint32_t total() const { return m_total; }
+
+    /**
+     * @brief Level exceeded for the given share of the window (L10 = exceeded(10)).
+     * @param percent Exceedance percentage, 0-100.
+     * @return The middle of the bin holding that level, 0 if the histogram is empty.
+     */
+    uint16_t exceeded(uint8_t percent) const
+    {
+        if (m_total == 0)
+        {
+            return 0;
+        }
+
+        // Rank of the sample at the (100 - percent)th percentile, 1-based
+        uint64_t rank = (uint64_t(m_total) * (100 - percent) + 99) / 100;
+        if (rank == 0)
+        {
+            rank = 1;
+        }
+
+        uint32_t cumulative = 0;
+        for (uint16_t bin = 0; bin < NUM_BINS; bin++)
+        {
+            cumulative += m_counts[bin];
+            if (cumulative >= rank)
+            {
+                return static_cast<uint16_t>(bin_low(bin) + bin_width(bin) / 2);
+            }
+        }
+        return static_cast<uint16_t>(bin_low(NUM_BINS - 1) + bin_width(NUM_BINS - 1) / 2);
+    }
+
+private:
+    uint32_t m_counts[NUM_BINS]{};
+    uint32_t m_total{0};
+};
+
+static_assert(LevelHistogram::bin_low(LevelHistogram::NUM_BINS - 1) + LevelHistogram::bin_width(LevelHistogram::NUM_BINS - 1) >
+                  config::adc::MAX_VALUE,
+              "Histogram must cover the ADC full scale");
+
+/**
+ * @brief Slides a window histogram over a ring of per-slot histograms.
+ *
+ * Values go into both the open slot and the window; when a slot expires its
+ * counts are taken back out of the window. The window therefore covers the
+ * open slot plus SLOTS - 1 closed ones, like a BucketTier, and slides in
+ * steps of one slot. Each slot costs one LevelHistogram of memory.
+ */
+template <size_t SLOTS>
+class LevelHistogramSlots
+{
+public:
+    static_assert(SLOTS >= 2, "A sliding window needs the open slot and at least one closed slot");
+
+    LevelHistogramSlots(LevelHistogram &window, uint32_t slot_ms) : m_window(window), m_slot_ms(slot_ms) {}
+
+    /**
+     * @brief Expire the slots that ended before `now`; call once per block before adding its values.
+     * @param now The current time, in milliseconds.
+     */
+    void advance(unsigned long now)
+    {
+        if (!m_started)
+        {
+            m_start = now - now % m_slot_ms;
+            m_started = true;
+            return;
+        }
+
+        unsigned long elapsed = (now - m_start) / m_slot_ms;
+        if (elapsed == 0)
+        {
+            return;
+        }
+
+        // A gap longer than the whole window leaves nothing behind
+        if (elapsed >= SLOTS)
+        {
+            for (auto &slot : m_slots)
+            {
+                slot.clear();
+            }
+            m_window.clear();
+        }
+        else
+        {
+            for (unsigned long i = 0; i < elapsed; i++)
+            {
+                m_head = (m_head + 1) % SLOTS;
+                m_window.remove(m_slots[m_head]);
+                m_slots[m_head].clear();
+            }
+        }
+        m_start += elapsed * m_slot_ms;
+    }
+
+    void add(float value)
+    {
+        m_slots[m_head].add(value);
+        m_window.add(value);
+    }
+
+private:
+    LevelHistogram &m_window;
+    uint32_t m_slot_ms;
+    unsigned long m_start{0};
+    bool m_started{false};
+    LevelHistogram m_slots[SLOTS];
+    size_t m_head{0};
+};
\ No newline at end of file
@@ -0,0 +1,334 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "crc32.hpp"
+
+/**
+ * @brief Compact binary log format, shared by the logger and the host tools.
+ *
+ * A file starts with a FileHeader followed by self-contained blocks:
+ *
+ *   BlockHeader | payload | crc32(BlockHeader + payload)
+ *
+ * Every record is NUM_FIELDS fixed-point integers. Within a block each field
+ * is stored as the zigzag varint of its difference to the previous record
+ * (the first record against zero), so slowly changing levels take one byte
+ * per field. A reader that meets a torn or corrupted block skips ahead to
+ * the next BLOCK_MAGIC whose CRC matches. All integers are little-endian.
+ *
+ * No Arduino dependencies, so host tools can include it directly.
+ */
+namespace log_format
+{
+    constexpr uint32_t FILE_MAGIC = 0x4C42544C; // "LTBL"
+    constexpr uint16_t VERSION = 1;
+    constexpr uint16_t BLOCK_MAGIC = 0xB10C;
+
+    enum Field : uint8_t
+    {
+        TIMESTAMP,
+        NOISE,
+        BASELINE,
+        CATEGORY,
+        ONE_MIN_AVG,
+        FIFTEEN_MIN_AVG,
+        LAEQ,
+        LCPEAK,
+        ONE_MIN_L10,
+        ONE_MIN_L50,
+        ONE_MIN_L90,
+        ONE_MIN_MAX,
+        NUM_FIELDS
+    };
+
+    struct FieldInfo
+    {
+        const char *name; // CSV column, as in the text log
+        int32_t scale;    // Stored value = round(value * scale)
+    };
+
+    constexpr FieldInfo FIELDS[NUM_FIELDS] = {
+        {"timestamp", 1},
+        {"noise", 100},
+        {"baseline", 100},
+        {"category", 1},
+        {"1min_avg", 100},
+        {"15min_avg", 100},
+        {"laeq", 100},
+        {"lcpeak", 100},
+        {"1min_l10", 1},
+        {"1min_l50", 1},
+        {"1min_l90", 1},
+        {"1min_max", 1},
+    };
+
+    using Record = int32_t[NUM_FIELDS];
+
+    struct FileHeader
+    {
+        uint32_t magic;
+        uint16_t version;
+        uint16_t header_size;
+        uint16_t num_fields;
+        uint16_t reserved;
+        uint32_t created_at; // Unix time, 0 if the clock was not set
+    };
+
+    struct BlockHeader
+    {
+        uint16_t magic;
+        uint16_t payload_length;
+        uint16_t record_count;
+        uint16_t reserved;
+        uint32_t first_timestamp; // Lets readers find a time without decoding
+    };
+
+    /**
+     * Sparse time index kept next to each log file (same name, .idx): an
+     * IndexHeader followed by entries in time order, each giving the offset
+     * of the first CSV row or binary block of an INDEX_INTERVAL_S bucket.
+     */
+    constexpr uint32_t INDEX_MAGIC = 0x58444E49; // "INDX"
+
+    struct IndexHeader
+    {
+        uint32_t magic;
+        uint16_t version;
+        uint16_t entry_size;
+        uint32_t interval_s;
+        uint32_t reserved;
+    };
+
+    struct IndexEntry
+    {
+        uint32_t timestamp;
+        uint32_t offset;
+    };
+
+    static_assert(sizeof(FileHeader) == 16 && sizeof(BlockHeader) == 12, "Unexpected padding");
+    static_assert(sizeof(IndexHeader) == 16 && sizeof(IndexEntry) == 8, "Unexpected padding");
+
+    constexpr size_t CRC_SIZE = sizeof(uint32_t);
+    constexpr size_t MAX_RECORD_SIZE = NUM_FIELDS * 5; // Worst-case varints
+    constexpr size_t MAX_PAYLOAD = 1024;
+    constexpr size_t MAX_BLOCK_SIZE = sizeof(BlockHeader) + MAX_PAYLOAD + CRC_SIZE;
+
+    inline FileHeader make_file_header(uint32_t created_at)
+    {
+        return {FILE_MAGIC, VERSION, sizeof(FileHeader), NUM_FIELDS, 0, created_at};
+    }
+
+    inline bool is_valid(const FileHeader &header)
+    {
+        return header.magic == FILE_MAGIC && header.version == VERSION &&
+               header.header_size >= sizeof(FileHeader) && header.num_fields == NUM_FIELDS;
+    }
+
+    inline IndexHeader make_index_header(uint32_t interval_s)
+    {
+        return {INDEX_MAGIC, VERSION, sizeof(IndexEntry), interval_s, 0};
+    }
+
+    inline bool is_valid(const IndexHeader &header)
+    {
+        return header.magic == INDEX_MAGIC && header.version == VERSION &&
+               header.entry_size == sizeof(IndexEntry);
+    }
+
+    /**
+     * @brief Derive the index file name from a log file name.
+     * @param log_path The log file, e.g. "/sd/240315.bin".
+     * @param out Receives the index path, e.g. "/sd/240315.idx".
+     * @param size Capacity of out.
+     * @return False if the path does not fit.
+     */
+    inline bool make_index_path(const char *log_path, char *out, size_t size)
+    {
+        const char *dot = strrchr(log_path, '.');
+        const char *slash = strrchr(log_path, '/');
+        size_t stem = dot && (!slash || dot > slash) ? dot - log_path : strlen(log_path);
+        if (stem + sizeof(".idx") > size)
+        {
+            return false;
+        }
+        memcpy(out, log_path, stem);
+        memcpy(out + stem, ".idx", sizeof(".idx"));
+        return true;
+    }
+
+    inline uint32_t zigzag(int32_t value)
+    {
+        return (static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31);
+    }
+
+    inline int32_t unzigzag(uint32_t value)
+    {
+        return static_cast<int32_t>((value >> 1) ^ (0 - (value & 1)));
+    }
+
+    /**
+     * @brief Accumulates records into one block.
+     */
+    class BlockEncoder
+    {
+    public:
+        explicit BlockEncoder(uint16_t max_records) : m_max_records(max_records) { reset(); }
+
+        /**
+         * @brief Append a record to the block.
+         * @param record The field values.
+         * @return False if the block is full; finish() it and add the record again.
+         */
+        bool add(const Record &record)
+        {
+            if (m_count >= m_max_records || MAX_PAYLOAD - m_length < MAX_RECORD_SIZE)
+            {
+                return false;
+            }
+            if (m_count == 0)
+            {
+                m_first_timestamp = static_cast<uint32_t>(record[TIMESTAMP]);
+            }
+
+            uint8_t *out = m_block + sizeof(BlockHeader) + m_length;
+            for (size_t f = 0; f < NUM_FIELDS; f++)
+            {
+                // Wrapping difference, undone exactly by the wrapping sum when decoding
+                uint32_t delta = zigzag(static_cast<int32_t>(
+                    static_cast<uint32_t>(record[f]) - static_cast<uint32_t>(m_previous[f])));
+                while (delta >= 0x80)
+                {
+                    *out++ = static_cast<uint8_t>(delta | 0x80);
+                    delta >>= 7;
+                }
+                *out++ = static_cast<uint8_t>(delta);
+                m_previous[f] = record[f];
+            }
+            m_length = out - (m_block + sizeof(BlockHeader));
+            m_count++;
+            return true;
+        }
+
+        /**
+         * @brief Seal the block with its header and CRC and start a new one.
+         * @param size Set to the sealed block's size in bytes.
+         * @return The sealed block, valid until the next add().
+         */
+        const uint8_t *finish(size_t &size)
+        {
+            BlockHeader header{BLOCK_MAGIC, static_cast<uint16_t>(m_length), m_count, 0,
+                               m_first_timestamp};
+            memcpy(m_block, &header, sizeof(header));
+            uint32_t crc = crc32(m_block, sizeof(header) + m_length);
+            memcpy(m_block + sizeof(header) + m_length, &crc, CRC_SIZE);
+            size = sizeof(header) + m_length + CRC_SIZE;
+            reset();
+            return m_block;
+        }
+
+        bool is_empty() const { return m_count == 0; }
+        uint16_t get_count() const { return m_count; }
+        uint32_t get_first_timestamp() const { return m_first_timestamp; }
+
+    private:
+        uint16_t m_max_records;
+        uint16_t m_count{0};
+        size_t m_length{0};
+        uint32_t m_first_timestamp{0};
+        Record m_previous{};
+        uint8_t m_block[MAX_BLOCK_SIZE];
+
+        void reset()
+        {
+            m_count = 0;
+            m_length = 0;
+            memset(m_previous, 0, sizeof(m_previous));
+        }
+    };
+
+    /**
+     * @brief Validate a block at the start of a buffer.
+     * @param data The bytes at the candidate block.
+     * @param available The number of bytes in the buffer.
+     * @param header Set to the block header if the block is valid.
+     * @return The block size in bytes, or 0 if no intact block starts here.
+     */
+    inline size_t check_block(const uint8_t *data, size_t available, BlockHeader &header)
+    {
+        if (available < sizeof(BlockHeader) + CRC_SIZE)
+        {
+            return 0;
+        }
+        memcpy(&header, data, sizeof(header));
+        if (header.magic != BLOCK_MAGIC || header.payload_length > MAX_PAYLOAD ||
+            header.record_count == 0)
+        {
+            return 0;
+        }
+
+        size_t size = sizeof(BlockHeader) + header.payload_length + CRC_SIZE;
+        if (size > available)
+        {
+            return 0;
+        }
+        uint32_t crc;
+        memcpy(&crc, data + size - CRC_SIZE, CRC_SIZE);
+        return crc == crc32(data, size - CRC_SIZE) ? size : 0;
+    }
+
+    /**
+     * @brief Iterates the records of a block accepted by check_block().
+     */
+    class BlockDecoder
+    {
+    public:
+        BlockDecoder(const uint8_t *block, const BlockHeader &header)
+            : m_in(block + sizeof(BlockHeader)),
+              m_end(m_in + header.payload_length),
+              m_remaining(header.record_count) {}
+
+        /**
+         * @brief Decode the next record.
+         * @param record Set to the field values.
+         * @return False once all records were read, or if the payload is malformed.
+         */
+        bool next(Record &record)
+        {
+            if (m_remaining == 0)
+            {
+                return false;
+            }
+            for (size_t f = 0; f < NUM_FIELDS; f++)
+            {
+                uint32_t value = 0;
+                for (int shift = 0;; shift += 7)
+                {
+                    if (m_in == m_end || shift > 28)
+                    {
+                        m_remaining = 0;
+                        return false;
+                    }
+                    uint8_t byte = *m_in++;
+                    value |= static_cast<uint32_t>(byte & 0x7F) << shift;
+                    if (!(byte & 0x80))
+                    {
+                        break;
+                    }
+                }
+                m_previous[f] = static_cast<int32_t>(static_cast<uint32_t>(m_previous[f]) +
+                                                     static_cast<uint32_t>(unzigzag(value)));
+                record[f] = m_previous[f];
+            }
+            m_remaining--;
+            return true;
+        }
+
+    private:
+        const uint8_t *m_in;
+        const uint8_t *m_end;
+        uint16_t m_remaining;
+        Record m_previous{};
+    };
+}
\ No newline at end of file
@@ -0,0 +1,343 @@
+#include "log_reader.hpp"
+#include "spi_arbiter.hpp"
+#include <string.h>
+
+namespace
+{
+    /**
+     * @brief Parse one CSV number into fixed point.
+     * @param text Advanced past the number and its separator.
+     * @param scale Fixed-point scale, 1 or a power of ten.
+     * @param value Set to round(number * scale).
+     * @return False if no number starts here.
+     */
+    bool parse_fixed(const char *&text, int32_t scale, int32_t &value)
+    {
+        bool negative = *text == '-';
+        text += negative;
+        if (*text < '0' || *text > '9')
+        {
+            return false;
+        }
+
+        int64_t whole = 0;
+        while (*text >= '0' && *text <= '9')
+        {
+            whole = whole * 10 + (*text++ - '0');
+        }
+
+        int64_t fraction = 0;
+        int32_t place = scale;
+        bool round_up = false;
+        if (*text == '.')
+        {
+            text++;
+            while (*text >= '0' && *text <= '9')
+            {
+                if (place > 1)
+                {
+                    place /= 10;
+                    fraction += (*text - '0') * place;
+                }
+                else if (place == 1)
+                {
+                    round_up = *text >= '5';
+                    place = 0;
+                }
+                text++;
+            }
+        }
+
+        int64_t result = whole * scale + fraction + round_up;
+        value = static_cast<int32_t>(negative ? -result : result);
+        if (*text == ',')
+        {
+            text++;
+        }
+        return true;
+    }
+}
+
+/**
+ * @brief Open a log and its index, if there is one.
+ * @param log_path The CSV or binary log file.
+ * @return True if the log is readable, false otherwise.
+ */
+bool LogReader::open(const char *log_path)
+{
+    close();
+
+    SpiArbiter::Lease lease(SpiArbiter::Device::SD);
+    m_log = fopen(log_path, "rb");
+    if (!m_log)
+    {
+        return false;
+    }
+    fseek(m_log, 0, SEEK_END);
+    m_log_size = ftell(m_log);
+    fseek(m_log, 0, SEEK_SET);
+
+    log_format::FileHeader header;
+    m_binary = fread(&header, sizeof(header), 1, m_log) == 1 && log_format::is_valid(header);
+    m_data_offset = m_binary ? header.header_size : 0;
+
+    char index_path[64];
+    log_format::IndexHeader index_header;
+    if (log_format::make_index_path(log_path, index_path, sizeof(index_path)) &&
+        (m_index = fopen(index_path, "rb")) != nullptr)
+    {
+        if (fread(&index_header, sizeof(index_header), 1, m_index) == 1 &&
+            log_format::is_valid(index_header) && fseek(m_index, 0, SEEK_END) == 0)
+        {
+            m_index_entries = (ftell(m_index) - sizeof(index_header)) / sizeof(log_format::IndexEntry);
+        }
+        else
+        {
+            fclose(m_index);
+            m_index = nullptr;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Close the log and its index.
+ */
+void LogReader::close()
+{
+    SpiArbiter::Lease lease(SpiArbiter::Device::SD);
+    if (m_log)
+    {
+        fclose(m_log);
+        m_log = nullptr;
+    }
+    if (m_index)
+    {
+        fclose(m_index);
+        m_index = nullptr;
+    }
+    m_index_entries = 0;
+}
+
+/**
+ * @brief Deliver every record with from <= timestamp < to, in file order.
+ * @param from Start of the range, Unix time.
+ * @param to End of the range, exclusive.
+ * @param callback Receives each record; returning false ends the query.
+ * @param context Passed to the callback.
+ * @return The number of records delivered.
+ */
+size_t LogReader::query(uint32_t from, uint32_t to, RecordFn callback, void *context)
+{
+    if (!m_log || from >= to)
+    {
+        return 0;
+    }
+
+    long offset = find_start(from);
+    return m_binary ? scan_binary(offset, from, to, callback, context)
+                    : scan_csv(offset, from, to, callback, context);
+}
+
+/**
+ * @brief Read one index entry.
+ * @param position The entry number.
+ * @param entry Set to the entry.
+ * @return True on success.
+ */
+bool LogReader::read_entry(uint32_t position, log_format::IndexEntry &entry)
+{
+    m_stats.index_probes++;
+    SpiArbiter::Lease lease(SpiArbiter::Device::SD);
+    long offset = sizeof(log_format::IndexHeader) + long(position) * sizeof(entry);
+    return fseek(m_index, offset, SEEK_SET) == 0 && fread(&entry, sizeof(entry), 1, m_index) == 1;
+}
+
+/**
+ * @brief Move the log's read position.
+ * @param offset The file offset.
+ * @return True on success.
+ */
+bool LogReader::seek_log(long offset)
+{
+    SpiArbiter::Lease lease(SpiArbiter::Device::SD);
+    return fseek(m_log, offset, SEEK_SET) == 0;
+}
+
+/**
+ * @brief Read one CSV row, holding the SD card's bus only for the read.
+ * @param line Receives the row; BUFFER_SIZE bytes.
+ * @return False at the end of the log.
+ */
+bool LogReader::read_line(char *line)
+{
+    SpiArbiter::Lease lease(SpiArbiter::Device::SD);
+    return fgets(line, BUFFER_SIZE, m_log) != nullptr;
+}
+
+/**
+ * @brief Binary search the index for where to start reading.
+ * @param from Start of the range.
+ * @return The offset of the last indexed row or block at or before from.
+ */
+long LogReader::find_start(uint32_t from)
+{
+    // Entries before the first bucket of the range
+    uint32_t low = 0;
+    uint32_t high = m_index_entries;
+    log_format::IndexEntry entry;
+    while (low < high)
+    {
+        uint32_t middle = low + (high - low) / 2;
+        if (!read_entry(middle, entry))
+        {
+            return m_data_offset;
+        }
+        if (entry.timestamp <= from)
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+
+    // After a crash the index can point past the end of the log
+    while (low > 0)
+    {
+        if (read_entry(--low, entry) && entry.offset >= m_data_offset && entry.offset < m_log_size)
+        {
+            return entry.offset;
+        }
+    }
+    return m_data_offset;
+}
+
+/**
+ * @brief Decode blocks from an offset until the range ends.
+ */
+size_t LogReader::scan_binary(long offset, uint32_t from, uint32_t to, RecordFn callback, void *context)
+{
+    if (!seek_log(offset))
+    {
+        return 0;
+    }
+
+    size_t matched = 0;
+    size_t fill = 0;
+    size_t pos = 0;
+    bool at_end = false;
+    bool skipping = false;
+
+    while (true)
+    {
+        // Keep at least one whole block in the buffer
+        if (!at_end && fill - pos < log_format::MAX_BLOCK_SIZE)
+        {
+            memmove(m_buffer, m_buffer + pos, fill - pos);
+            fill -= pos;
+            pos = 0;
+            size_t read;
+            {
+                SpiArbiter::Lease lease(SpiArbiter::Device::SD);
+                read = fread(m_buffer + fill, 1, BUFFER_SIZE - fill, m_log);
+            }
+            m_stats.bytes_read += read;
+            fill += read;
+            at_end = fill < BUFFER_SIZE;
+        }
+        if (pos >= fill)
+        {
+            return matched;
+        }
+
+        log_format::BlockHeader header;
+        size_t size = log_format::check_block(m_buffer + pos, fill - pos, header);
+        if (size == 0)
+        {
+            // Step byte by byte to the next intact block
+            m_stats.corrupt_skips += !skipping;
+            skipping = true;
+            pos++;
+            continue;
+        }
+        skipping = false;
+        if (header.first_timestamp >= to)
+        {
+            return matched;
+        }
+
+        log_format::BlockDecoder decoder(m_buffer + pos, header);
+        log_format::Record record;
+        while (decoder.next(record))
+        {
+            m_stats.records_scanned++;
+            uint32_t timestamp = static_cast<uint32_t>(record[log_format::TIMESTAMP]);
+            if (timestamp >= to)
+            {
+                return matched;
+            }
+            if (timestamp >= from)
+            {
+                matched++;
+                m_stats.records_matched++;
+                if (!callback(context, record))
+                {
+                    return matched;
+                }
+            }
+        }
+        pos += size;
+    }
+}
+
+/**
+ * @brief Parse CSV rows from an offset until the range ends.
+ */
+size_t LogReader::scan_csv(long offset, uint32_t from, uint32_t to, RecordFn callback, void *context)
+{
+    if (!seek_log(offset))
+    {
+        return 0;
+    }
+
+    size_t matched = 0;
+    char *line = reinterpret_cast<char *>(m_buffer);
+    while (read_line(line))
+    {
+        m_stats.bytes_read += strlen(line);
+
+        // Skips the header row as well as damaged ones
+        log_format::Record record;
+        const char *text = line;
+        size_t f = 0;
+        while (f < log_format::NUM_FIELDS &&
+               parse_fixed(text, log_format::FIELDS[f].scale, record[f]))
+        {
+            f++;
+        }
+        if (f < log_format::NUM_FIELDS)
+        {
+            m_stats.corrupt_skips += line[0] >= '0' && line[0] <= '9';
+            continue;
+        }
+
+        m_stats.records_scanned++;
+        uint32_t timestamp = static_cast<uint32_t>(record[log_format::TIMESTAMP]);
+        if (timestamp >= to)
+        {
+            break;
+        }
+        if (timestamp >= from)
+        {
+            matched++;
+            m_stats.records_matched++;
+            if (!callback(context, record))
+            {
+                break;
+            }
+        }
+    }
+    return matched;
+}
\ No newline at end of file
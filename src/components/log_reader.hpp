@@ -0,0 +1,68 @@
+#pragma once
+
+#include <stdio.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "log_format.hpp"
+
+/**
+ * @brief Time-range queries over one day's log, CSV or binary.
+ *
+ * The .idx sidecar is binary searched on disk for the last entry at or
+ * before the start of the range, and the log is read forward from that
+ * offset until the range ends, so a query touches O(log n) index entries
+ * and only the blocks it returns. Without an index, or past its last entry,
+ * the log is scanned. Records come back in the fixed-point form of
+ * log_format, whatever the file format.
+ *
+ * Plain stdio, so it works on the SD card's VFS mount and on a host copy.
+ * Every read holds the shared SPI bus through SpiArbiter on its own, never
+ * while a record is handed to the callback.
+ */
+class LogReader
+{
+public:
+    // Return false to stop the query early
+    using RecordFn = bool (*)(void *context, const log_format::Record &record);
+
+    struct Stats
+    {
+        uint32_t index_probes{0};
+        uint32_t bytes_read{0};
+        uint32_t records_scanned{0};
+        uint32_t records_matched{0};
+        uint32_t corrupt_skips{0}; // Damaged blocks or rows stepped over
+    };
+
+    LogReader() = default;
+    ~LogReader() { close(); }
+
+    bool open(const char *log_path);
+    void close();
+    bool is_open() const { return m_log != nullptr; }
+    bool is_binary() const { return m_binary; }
+    bool has_index() const { return m_index != nullptr; }
+
+    size_t query(uint32_t from, uint32_t to, RecordFn callback, void *context);
+
+    const Stats &get_stats() const { return m_stats; }
+
+private:
+    static constexpr size_t BUFFER_SIZE = 2 * log_format::MAX_BLOCK_SIZE;
+
+    FILE *m_log{nullptr};
+    FILE *m_index{nullptr};
+    bool m_binary{false};
+    long m_log_size{0};
+    long m_data_offset{0}; // First byte after the file header
+    uint32_t m_index_entries{0};
+    Stats m_stats;
+    uint8_t m_buffer[BUFFER_SIZE];
+
+    bool read_entry(uint32_t position, log_format::IndexEntry &entry);
+    bool seek_log(long offset);
+    bool read_line(char *line);
+    long find_start(uint32_t from);
+    size_t scan_binary(long offset, uint32_t from, uint32_t to, RecordFn callback, void *context);
+    size_t scan_csv(long offset, uint32_t from, uint32_t to, RecordFn callback, void *context);
+};
\ No newline at end of file
@@ -0,0 +1,251 @@
+#include "log_writer.hpp"
+#include "spi_arbiter.hpp"
+#include <Arduino.h>
+#include <string.h>
+#include <unistd.h>
+#include <algorithm>
+
+/**
+ * @brief Open a file for appending, keeping its contents.
+ *
+ * The bytes past the last sector boundary are read back into the buffer so
+ * that later writes can rewrite that sector whole.
+ * @param path File path, e.g. on the SD card's VFS mount.
+ * @return True if the file is open, false otherwise.
+ */
+bool LogWriter::open(const char *path)
+{
+    close();
+
+    SpiArbiter::Lease lease(SpiArbiter::Device::SD);
+    m_file = fopen(path, "r+b");
+    if (!m_file)
+    {
+        m_file = fopen(path, "w+b");
+    }
+    if (!m_file)
+    {
+        m_stats.io_errors++;
+        return false;
+    }
+
+    // Writes go straight to the driver in the sizes chosen here
+    setvbuf(m_file, nullptr, _IONBF, 0);
+
+    long length = fseek(m_file, 0, SEEK_END) == 0 ? ftell(m_file) : -1;
+    if (length < 0)
+    {
+        m_stats.io_errors++;
+        fclose(m_file);
+        m_file = nullptr;
+        return false;
+    }
+
+    m_base = static_cast<uint32_t>(length) & ~(SECTOR_SIZE - 1);
+    m_fill = static_cast<size_t>(length) - m_base;
+    if (fseek(m_file, m_base, SEEK_SET) != 0 ||
+        (m_fill > 0 && fread(m_buffer, 1, m_fill, m_file) != m_fill) ||
+        fseek(m_file, m_base, SEEK_SET) != 0)
+    {
+        m_stats.io_errors++;
+        fclose(m_file);
+        m_file = nullptr;
+        m_base = 0;
+        m_fill = 0;
+        return false;
+    }
+
+    m_dirty = false;
+    m_last_flush = m_clock();
+    m_last_sync = m_last_flush;
+    return true;
+}
+
+/**
+ * @brief Write out and sync everything buffered, then close the file.
+ */
+void LogWriter::close()
+{
+    if (!m_file)
+    {
+        return;
+    }
+
+    sync();
+    SpiArbiter::Lease lease(SpiArbiter::Device::SD);
+    fclose(m_file);
+    m_file = nullptr;
+    m_base = 0;
+    m_fill = 0;
+}
+
+/**
+ * @brief Buffer bytes for the file, writing whole sectors out first if they do not fit.
+ *
+ * All or nothing: if the bytes cannot all be buffered, none are, and the
+ * buffer is left as it was.
+ * @param data The bytes to append, at most MAX_APPEND.
+ * @param length The number of bytes.
+ * @return True if the bytes were accepted, false if they were dropped.
+ */
+bool LogWriter::append(const void *data, size_t length)
+{
+    if (!m_file)
+    {
+        return false;
+    }
+
+    if (length > BUFFER_SIZE - m_fill && (!flush_sectors() || length > BUFFER_SIZE - m_fill))
+    {
+        m_stats.dropped_bytes += length;
+        return false;
+    }
+
+    memcpy(m_buffer + m_fill, data, length);
+    m_fill += length;
+    m_stats.bytes_appended += length;
+    return true;
+}
+
+/**
+ * @brief Write out data that is due by fill level or age, and sync if due.
+ * @return False on an I/O error, true otherwise.
+ */
+bool LogWriter::poll()
+{
+    if (!m_file)
+    {
+        return false;
+    }
+
+    unsigned long now = m_clock();
+    if (now - m_last_sync >= config::logging::SYNC_INTERVAL_MS)
+    {
+        return sync();
+    }
+    if (now - m_last_flush >= config::logging::FLUSH_INTERVAL_MS)
+    {
+        return flush();
+    }
+    if (m_fill >= config::logging::FLUSH_THRESHOLD)
+    {
+        return flush_sectors();
+    }
+    return true;
+}
+
+/**
+ * @brief Write everything buffered, including the partial last sector.
+ * @return True on success, false on an I/O error.
+ */
+bool LogWriter::flush()
+{
+    if (!m_file)
+    {
+        return false;
+    }
+
+    m_last_flush = m_clock();
+    if (!flush_sectors())
+    {
+        return false;
+    }
+    if (m_fill == 0)
+    {
+        return true;
+    }
+
+    // The tail stays buffered and is rewritten once its sector fills up
+    uint32_t start_us = micros();
+    bool ok = write_at(0, m_fill);
+    m_stats.last_flush_us = micros() - start_us;
+    m_stats.max_flush_us = std::max(m_stats.max_flush_us, m_stats.last_flush_us);
+    return ok;
+}
+
+/**
+ * @brief Write everything buffered and commit it, with the file size, to the card.
+ * @return True on success, false on an I/O error.
+ */
+bool LogWriter::sync()
+{
+    if (!m_file)
+    {
+        return false;
+    }
+
+    m_last_sync = m_clock();
+    if (!flush())
+    {
+        return false;
+    }
+    if (!m_dirty)
+    {
+        return true;
+    }
+
+    {
+        SpiArbiter::Lease lease(SpiArbiter::Device::SD);
+        if (fflush(m_file) != 0 || fsync(fileno(m_file)) != 0)
+        {
+            m_stats.io_errors++;
+            return false;
+        }
+    }
+    m_dirty = false;
+    m_stats.syncs++;
+    return true;
+}
+
+/**
+ * @brief Write part of the buffer at its file offset, holding the SPI bus for just this write.
+ * @param offset The sector-aligned offset into the buffer.
+ * @param length The number of bytes to write.
+ * @return True on success, false on an I/O error.
+ */
+bool LogWriter::write_at(size_t offset, size_t length)
+{
+    SpiArbiter::Lease lease(SpiArbiter::Device::SD);
+    if (fseek(m_file, m_base + offset, SEEK_SET) != 0 ||
+        fwrite(m_buffer + offset, 1, length, m_file) != length)
+    {
+        m_stats.io_errors++;
+        return false;
+    }
+    m_dirty = true;
+    m_stats.flushes++;
+    return true;
+}
+
+/**
+ * @brief Write the whole sectors in the buffer and keep only the partial tail.
+ *
+ * Sectors go out in writes of at most WRITE_CHUNK bytes, so a large flush
+ * gives the display the bus in between.
+ * @return True on success, false on an I/O error.
+ */
+bool LogWriter::flush_sectors()
+{
+    size_t whole = m_fill & ~(SECTOR_SIZE - 1);
+    if (whole == 0)
+    {
+        return true;
+    }
+
+    uint32_t start_us = micros();
+    for (size_t offset = 0; offset < whole; offset += WRITE_CHUNK)
+    {
+        if (!write_at(offset, std::min(WRITE_CHUNK, whole - offset)))
+        {
+            return false;
+        }
+    }
+    m_stats.last_flush_us = micros() - start_us;
+    m_stats.max_flush_us = std::max(m_stats.max_flush_us, m_stats.last_flush_us);
+    m_stats.sectors_written += whole / SECTOR_SIZE;
+
+    m_base += whole;
+    m_fill -= whole;
+    memmove(m_buffer, m_buffer + whole, m_fill);
+    return true;
+}
\ No newline at end of file
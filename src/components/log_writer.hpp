@@ -0,0 +1,79 @@
+#pragma once
+
+#include <stdio.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "config/config.h"
+
+/**
+ * @brief Append-only file writer that hands the card whole, aligned sectors.
+ *
+ * Records are copied into a RAM buffer that mirrors the file from the last
+ * sector boundary onwards. An append is taken whole or not at all, so a
+ * failing card never leaves half a record in the file. Whole sectors are
+ * written once FLUSH_THRESHOLD
+ * bytes are buffered; at FLUSH_INTERVAL_MS the partial tail is written as
+ * well but stays buffered and is rewritten in place with the next sector, so
+ * every write starts on a sector boundary. The file stays open, so FAT
+ * metadata is only touched by sync(), which runs at SYNC_INTERVAL_MS, at
+ * rollover and at close. Each write and sync holds the shared SPI bus
+ * through SpiArbiter, and whole sectors go out in chunks of
+ * config::spi::SD_WRITE_CHUNK_SECTORS.
+ *
+ * Plain stdio, so it works on the SD card's VFS mount and on a host file.
+ */
+class LogWriter
+{
+public:
+    using ClockFn = unsigned long (*)(); // Milliseconds
+
+    struct Stats
+    {
+        uint32_t bytes_appended{0};
+        uint32_t sectors_written{0};
+        uint32_t flushes{0};
+        uint32_t syncs{0};
+        uint32_t dropped_bytes{0}; // Appends refused because the card stopped taking data
+        uint32_t io_errors{0};
+        uint32_t last_flush_us{0};
+        uint32_t max_flush_us{0};
+    };
+
+    static constexpr size_t SECTOR_SIZE = config::logging::SECTOR_SIZE;
+    static constexpr size_t BUFFER_SIZE = config::logging::BUFFER_SIZE;
+    static constexpr size_t MAX_APPEND = BUFFER_SIZE - SECTOR_SIZE; // Always fits once whole sectors are out
+
+    explicit LogWriter(ClockFn clock) : m_clock(clock) {}
+    ~LogWriter() { close(); }
+
+    bool open(const char *path);
+    void close();
+    bool is_open() const { return m_file != nullptr; }
+
+    bool append(const void *data, size_t length);
+    bool poll();
+    bool flush();
+    bool sync();
+
+    uint32_t size() const { return m_base + m_fill; }
+    const Stats &get_stats() const { return m_stats; }
+
+private:
+    static_assert(BUFFER_SIZE % SECTOR_SIZE == 0, "Buffer must hold whole sectors");
+    static_assert(config::logging::FLUSH_THRESHOLD <= BUFFER_SIZE, "Threshold must fit the buffer");
+    static constexpr size_t WRITE_CHUNK = config::spi::SD_WRITE_CHUNK_SECTORS * SECTOR_SIZE;
+    static_assert(WRITE_CHUNK > 0, "Writes need at least one sector");
+
+    ClockFn m_clock;
+    FILE *m_file{nullptr};
+    uint32_t m_base{0}; // Sector-aligned file offset of m_buffer[0]
+    size_t m_fill{0};
+    bool m_dirty{false}; // Data written since the last sync
+    unsigned long m_last_flush{0};
+    unsigned long m_last_sync{0};
+    alignas(4) uint8_t m_buffer[BUFFER_SIZE];
+    Stats m_stats;
+
+    bool write_at(size_t offset, size_t length);
+    bool flush_sectors();
+};
\ No newline at end of file
@@ -1,8 +1,10 @@
 #include "noise_monitor.hpp"
 #include <time.h>
+#include "wifi_manager.hpp"
 
 NoiseMonitor::NoiseMonitor()
-    : m_display(m_alert_manager)
+    : m_display(m_alert_manager),
+      m_scheduler(millis)
 {
     // Empty constructor - initialization moved to begin()
 }
@@ -14,9 +16,6 @@ NoiseMonitor::NoiseMonitor()
 bool NoiseMonitor::begin()
 {
     // Initialize components one at a time with delays
-    m_sound_sensor.begin();
-    delay(100); // Give ADC time to stabilize
-
     m_display.begin();
     delay(100); // Give display time to initialize
 
@@ -29,65 +28,231 @@ bool NoiseMonitor::begin()
     bool logger_ok = m_logger.begin();
     delay(50); // Give SD card time to initialize
 
+    // Uploads that cannot be delivered are stored on the card, and logs are served from it
+    if (logger_ok)
+    {
+        ApiHandler::instance().enable_backlog();
+        HistoryServer::instance().begin();
+    }
+
+    // Sampling starts last: the DMA ring holds 80 ms, less than the set-up above takes
+    if (!config::adc::acquisition::CONTINUOUS_MODE ||
+        !m_sound_sensor.begin(*m_audio_source))
+    {
+        // Fall back to polled analogRead() sampling
+        m_sound_sensor.begin();
+    }
+
+    schedule_tasks();
+
+    if (config::tasks::DUAL_CORE && !start_acquisition_task())
+    {
+        ESP_LOGW("NoiseMonitor", "Acquisition task not started, sampling from loop()");
+    }
+
     return logger_ok; // Return logger status
 }
 
+/**
+ * @brief Start the pinned acquisition and DSP task.
+ * @return True if the task is running, false otherwise.
+ */
+bool NoiseMonitor::start_acquisition_task()
+{
+    BaseType_t result = xTaskCreatePinnedToCore(acquisition_task,
+                                                "acquisition",
+                                                config::tasks::ACQUISITION_STACK_SIZE,
+                                                this,
+                                                config::tasks::ACQUISITION_PRIORITY,
+                                                &m_acquisition_task,
+                                                config::tasks::ACQUISITION_CORE);
+    if (result != pdPASS)
+    {
+        m_acquisition_task = nullptr;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Acquisition task body: sample, process and publish frames forever.
+ * @param param The NoiseMonitor instance.
+ */
+void NoiseMonitor::acquisition_task(void *param)
+{
+    NoiseMonitor *monitor = static_cast<NoiseMonitor *>(param);
+
+    for (;;)
+    {
+        // Yield for a tick when idle so lower priority tasks on this core can run
+        if (!monitor->handle_sampling())
+        {
+            vTaskDelay(1);
+        }
+    }
+}
+
+/**
+ * @brief Register the periodic consumer tasks with the scheduler.
+ */
+void NoiseMonitor::schedule_tasks()
+{
+    using Policy = TaskScheduler::Policy;
+
+    // Late runs are skipped rather than replayed: every task works on the latest frame
+    m_scheduler.add_task({"alerts", config::timing::ALERT_INTERVAL, 3,
+                          config::scheduler::ALERT_BUDGET_MS, Policy::SKIP},
+                         [](void *self) { static_cast<NoiseMonitor *>(self)->handle_alerts(); }, this);
+    m_scheduler.add_task({"leds", config::timing::LED_UPDATE_INTERVAL, 2,
+                          config::scheduler::LED_BUDGET_MS, Policy::SKIP},
+                         [](void *self) { static_cast<NoiseMonitor *>(self)->handle_leds(); }, this);
+    m_scheduler.add_task({"display", config::timing::DISPLAY_INTERVAL, 1,
+                          config::scheduler::DISPLAY_BUDGET_MS, Policy::SKIP},
+                         [](void *self) { static_cast<NoiseMonitor *>(self)->handle_display(); }, this);
+    m_scheduler.add_task({"logging", config::logging::RECORD_INTERVAL_MS, 0,
+                          config::scheduler::LOG_BUDGET_MS, Policy::SKIP},
+                         [](void *self) { static_cast<NoiseMonitor *>(self)->handle_logging(); }, this);
+    m_scheduler.add_task({"api", config::thingspeak::upload::SAMPLE_INTERVAL_MS, 0,
+                          config::scheduler::API_BUDGET_MS, Policy::SKIP},
+                         [](void *self) { static_cast<NoiseMonitor *>(self)->handle_api_update(); }, this);
+    m_scheduler.add_task({"wifi", config::timing::WIFI_INTERVAL, 1,
+                          config::scheduler::WIFI_BUDGET_MS, Policy::SKIP},
+                         [](void *) { wifi::WiFiManager::instance().update(); }, nullptr);
+    m_scheduler.add_task({"spectrum", config::timing::SPECTRUM_LOG_INTERVAL, 0,
+                          config::scheduler::SPECTRUM_BUDGET_MS, Policy::SKIP},
+                         [](void *self) { static_cast<NoiseMonitor *>(self)->handle_spectrum_log(); }, this);
+}
+
 /**
  * @brief Update the noise monitor.
  */
 void NoiseMonitor::update()
 {
-    unsigned long current_time = millis();
+    // Without the acquisition task, loop() is both producer and consumer
+    if (m_acquisition_task == nullptr)
+    {
+        handle_sampling();
+    }
 
-    // Handle periodic tasks
-    handle_sampling();
-    handle_display();
-    handle_logging();
-    handle_api_update();
+    drain_frames();
 
-    // Update alert manager
-    m_alert_manager.update(m_signal_processor);
+    // Handle periodic tasks
+    m_scheduler.run_pending();
 }
 
 /**
  * @brief Handle the sampling task.
+ * @return True if any samples were processed, false otherwise.
  */
-void NoiseMonitor::handle_sampling()
+bool NoiseMonitor::handle_sampling()
 {
+    if (m_sound_sensor.is_continuous())
+    {
+        return handle_block_sampling();
+    }
+
     unsigned long current_time = millis();
 
     if (current_time - m_last_sample_time >= config::timing::SAMPLE_INTERVAL)
     {
         uint16_t raw_value = m_sound_sensor.read_averaged_sample();
         m_signal_processor.process_sample(raw_value);
-
-        // Update plot buffer
-        m_display.add_plot_point(m_signal_processor.get_current_value());
+        publish_frame(current_time);
 
         m_last_sample_time = current_time;
+        return true;
     }
+    return false;
 }
 
 /**
- * @brief Handle the display task.
+ * @brief Drain the blocks the DMA ring collected since the last pass.
+ * @return True if any block was processed or a spectrum computed, false otherwise.
  */
-void NoiseMonitor::handle_display()
+bool NoiseMonitor::handle_block_sampling()
 {
-    unsigned long current_time = millis();
+    bool processed = false;
 
-    // Update display at slower rate
-    if (current_time - m_last_display_time >= config::timing::DISPLAY_INTERVAL)
+    // Bound the work per pass so a long stall cannot starve the other tasks
+    for (uint8_t i = 0; i < config::adc::acquisition::NUM_BLOCKS; i++)
     {
-        m_display.update(m_signal_processor);
-        m_last_display_time = current_time;
+        if (!m_sound_sensor.read_block(m_sample_block))
+        {
+            break;
+        }
+
+        m_signal_processor.process_audio(m_sample_block.samples, m_sample_block.count);
+        m_spectrum.push(m_sample_block.samples, m_sample_block.count);
+
+        // Keep the peak of each block, matching the polled peak detection
+        uint16_t peak = 0;
+        for (size_t j = 0; j < m_sample_block.count; j++)
+        {
+            peak = max(peak, m_sample_block.samples[j]);
+        }
+        m_signal_processor.process_block(&peak, 1, m_sample_block.timestamp_ms);
+        publish_frame(m_sample_block.timestamp_ms);
+        processed = true;
     }
 
-    // Update LED indicator at faster rate
-    if (current_time - m_last_led_time >= config::timing::LED_UPDATE_INTERVAL)
+    // At most one FFT per pass
+    return m_spectrum.analyze() || processed;
+}
+
+/**
+ * @brief Snapshot the signal processor into the frame ring.
+ * @param timestamp Time of the samples the frame was produced from.
+ */
+void NoiseMonitor::publish_frame(unsigned long timestamp)
+{
+    // A full ring drops the frame; the statistics live on in the processor
+    m_frames.push(SignalFrame::capture(m_signal_processor, m_spectrum, m_frame_sequence++, timestamp));
+}
+
+/**
+ * @brief Consume the frames published since the last pass.
+ */
+void NoiseMonitor::drain_frames()
+{
+    SignalFrame frame;
+    while (m_frames.pop(frame))
     {
-        m_led_indicator.update(m_signal_processor);
-        m_last_led_time = current_time;
+        // Every frame goes into the plot, which decimates to its time span
+        m_display.add_plot_point(static_cast<uint16_t>(frame.value), frame.timestamp_ms);
+        m_latest_frame = frame;
     }
+
+    uint32_t overflows = m_frames.get_stats().overflows;
+    if (overflows != m_reported_overflows)
+    {
+        ESP_LOGW("NoiseMonitor", "Frame ring full, %u frames dropped",
+                 overflows - m_reported_overflows);
+        m_reported_overflows = overflows;
+    }
+}
+
+/**
+ * @brief Handle the display task.
+ */
+void NoiseMonitor::handle_display()
+{
+    m_display.update(m_latest_frame);
+}
+
+/**
+ * @brief Handle the LED indicator task.
+ */
+void NoiseMonitor::handle_leds()
+{
+    m_led_indicator.update(m_latest_frame);
+}
+
+/**
+ * @brief Handle the alert task.
+ */
+void NoiseMonitor::handle_alerts()
+{
+    m_alert_manager.update(m_latest_frame);
 }
 
 /**
@@ -95,44 +260,50 @@ void NoiseMonitor::handle_display()
  */
 void NoiseMonitor::handle_logging()
 {
-    unsigned long current_time = millis();
+    m_logger.log_data(m_latest_frame);
+}
+
+/**
+ * @brief Log the octave band levels of the latest frame.
+ */
+void NoiseMonitor::handle_spectrum_log()
+{
+    if (!m_latest_frame.has_spectrum)
+    {
+        return;
+    }
 
-    if (current_time - m_last_log_time >= config::timing::LOG_INTERVAL)
+    // e.g. "31Hz:42.1 63Hz:45.0 ... 4000Hz:38.2"
+    char line[spectrum::OCTAVE_BANDS * 16];
+    size_t length = 0;
+    for (size_t b = 0; b < spectrum::OCTAVE_BANDS && length < sizeof(line); b++)
     {
-        m_logger.log_data(m_signal_processor);
-        m_last_log_time = current_time;
+        length += snprintf(line + length, sizeof(line) - length, "%s%.0fHz:%.1f", b > 0 ? " " : "",
+                           SpectrumAnalyzer::octave_center_hz(b), m_latest_frame.octave_db[b]);
     }
+    ESP_LOGI("NoiseMonitor", "Octave bands (dB): %s", line);
 }
 
+/**
+ * @brief Handle the API update task.
+ */
 void NoiseMonitor::handle_api_update()
 {
-    unsigned long current_time = millis();
-
-    // Only attempt API updates if enough time has passed
-    if (current_time - m_last_api_time >= config::thingspeak::UPDATE_INTERVAL_MS)
+    // Only queue points with a valid wall-clock time; never wait for NTP here
+    struct tm timeinfo;
+    if (!getLocalTime(&timeinfo, 0))
     {
-        // Create a temporary JsonDocument
-        JsonDocument doc;
-
-        // Get current timestamp
-        struct tm timeinfo;
-        if (getLocalTime(&timeinfo))
-        {
-            char timestamp[30];
-            strftime(timestamp, sizeof(timestamp), "%Y-%m-%d %H:%M:%S", &timeinfo);
-
-            // Add data to JSON document
-            doc["created_at"] = timestamp;
-            doc["field1"] = m_signal_processor.get_current_value();
-            doc["field2"] = m_signal_processor.get_baseline();
-            doc["field3"] = static_cast<int>(m_signal_processor.get_noise_category());
-
-            // Send data to ThingSpeak
-            if (ApiHandler::instance().send_noise_data(doc))
-            {
-                ESP_LOGI("NoiseMonitor", "Data sent to ThingSpeak at %s", timestamp);
-            }
-        }
-        m_last_api_time = current_time;
+        return;
     }
+
+    UploadRecord record;
+    record.created_at = static_cast<uint32_t>(time(nullptr));
+    record.num_fields = 3;
+    record.fields[0] = m_latest_frame.value;
+    record.fields[1] = m_latest_frame.baseline;
+    record.fields[2] = static_cast<float>(m_latest_frame.category);
+    record.integer_fields = 1 << 2;
+
+    // The upload task batches it with the following points and sends them in the background
+    ApiHandler::instance().enqueue(record);
 }
\ No newline at end of file
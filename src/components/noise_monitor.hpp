@@ -1,39 +1,78 @@
 #pragma once
 
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
 #include "sound_sensor.hpp"
+#include "adc_dma_source.hpp"
 #include "signal_processor.hpp"
+#include "signal_frame.hpp"
+#include "spsc_ring.hpp"
+#include "task_scheduler.hpp"
+#include "spectrum_analyzer.hpp"
 #include "display_manager.hpp"
 #include "led_indicator.hpp"
 #include "alert_manager.hpp"
 #include "data_logger.hpp"
 #include "api_handler.hpp"
+#include "history_server.hpp"
 
 /**
  * @brief Class representing the noise monitor.
+ *
+ * Acquisition and DSP run in a task pinned to ACQUISITION_CORE and publish
+ * SignalFrames through a lock-free ring; update() runs on the loop() core and
+ * only ever sees frames, so a blocking consumer cannot stall sampling.
  */
 class NoiseMonitor
 {
 public:
+    using FrameRing = SpscRing<SignalFrame, config::tasks::FRAME_RING_SIZE>;
+
     NoiseMonitor();
     bool begin();
     void update();
 
+    // Replace the DMA source before begin(), e.g. with a ReplaySource on the host
+    void set_audio_source(AudioSource &source) { m_audio_source = &source; }
+
+    FrameRing::Stats get_frame_stats() const { return m_frames.get_stats(); }
+    const TaskScheduler &get_scheduler() const { return m_scheduler; }
+
 private:
+    // Producer side, owned by the acquisition task once it is running
     SoundSensor m_sound_sensor;
+    AdcDmaSource m_adc_source;
+    AudioSource *m_audio_source{&m_adc_source};
+    SampleBlock m_sample_block;
     SignalProcessor m_signal_processor;
+    SpectrumAnalyzer m_spectrum;
+    uint32_t m_frame_sequence{0};
+    unsigned long m_last_sample_time{0};
+    TaskHandle_t m_acquisition_task{nullptr};
+
+    FrameRing m_frames;
+
+    // Consumer side, loop() only
+    SignalFrame m_latest_frame;
+    uint32_t m_reported_overflows{0};
+    AlertManager m_alert_manager; // Before m_display, which keeps a reference to it
     DisplayManager m_display;
     LedIndicator m_led_indicator;
-    AlertManager m_alert_manager;
     DataLogger m_logger;
+    TaskScheduler m_scheduler;
 
-    unsigned long m_last_sample_time{0};
-    unsigned long m_last_display_time{0};
-    unsigned long m_last_led_time{0};
-    unsigned long m_last_log_time{0};
-    unsigned long m_last_api_time{0};
+    static void acquisition_task(void *param);
+    bool start_acquisition_task();
+    bool handle_sampling();
+    bool handle_block_sampling();
+    void publish_frame(unsigned long timestamp);
 
-    void handle_sampling();
+    void drain_frames();
+    void schedule_tasks();
     void handle_display();
+    void handle_leds();
+    void handle_alerts();
     void handle_logging();
+    void handle_spectrum_log();
     void handle_api_update();
 };
\ No newline at end of file
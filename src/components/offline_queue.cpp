@@ -0,0 +1,279 @@
+#include "offline_queue.hpp"
+#include "crc32.hpp"
+#include "spi_arbiter.hpp"
+#include <string.h>
+#include <unistd.h>
+#include <algorithm>
+
+/**
+ * @brief Constructor for the OfflineQueue class.
+ * @param path File path, e.g. on the SD card's VFS mount.
+ * @param capacity Maximum number of records kept.
+ */
+OfflineQueue::OfflineQueue(const char *path, uint32_t capacity)
+    : m_path(path), m_capacity(capacity)
+{
+}
+
+/**
+ * @brief Open the queue file, recovering its cursors, or create an empty one.
+ * @return True if the queue is usable, false otherwise.
+ */
+bool OfflineQueue::begin()
+{
+    end();
+
+    SpiArbiter::Lease lease(SpiArbiter::Device::SD);
+    m_file = fopen(m_path, "r+b");
+    if (m_file && load_header())
+    {
+        return true;
+    }
+
+    // Missing, unreadable or created with another layout: start over
+    if (m_file)
+    {
+        fclose(m_file);
+    }
+    m_file = fopen(m_path, "w+b");
+    if (!m_file)
+    {
+        return false;
+    }
+
+    m_sequence = 0;
+    m_head = 0;
+    m_tail = 0;
+    // Both header copies, so the file never has an invalid pair
+    if (!commit_header() || !commit_header())
+    {
+        fclose(m_file);
+        m_file = nullptr;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Close the queue file.
+ */
+void OfflineQueue::end()
+{
+    if (m_file)
+    {
+        SpiArbiter::Lease lease(SpiArbiter::Device::SD);
+        fclose(m_file);
+        m_file = nullptr;
+    }
+}
+
+/**
+ * @brief Append records, evicting the oldest ones if the queue is full.
+ * @param records The records, oldest first.
+ * @param count The number of records.
+ * @return True if the records were stored, false on an I/O error.
+ */
+bool OfflineQueue::append(const UploadRecord *records, size_t count)
+{
+    if (!m_file)
+    {
+        return false;
+    }
+
+    SpiArbiter::Lease lease(SpiArbiter::Device::SD);
+
+    // Only the newest capacity records can be kept
+    size_t skipped = 0;
+    if (count > m_capacity)
+    {
+        skipped = count - m_capacity;
+        records += skipped;
+        count = m_capacity;
+    }
+
+    uint32_t overflow = size() + count > m_capacity ? size() + count - m_capacity : 0;
+    if (overflow > 0)
+    {
+        // Release the oldest slots before they are overwritten
+        m_head += overflow;
+        m_stats.evicted += overflow;
+        if (!commit_header())
+        {
+            m_head -= overflow;
+            m_stats.evicted -= overflow;
+            return false;
+        }
+    }
+
+    if (!write_records(records, count))
+    {
+        return false;
+    }
+
+    m_tail += count;
+    if (!commit_header())
+    {
+        m_tail -= count;
+        return false;
+    }
+    m_stats.appended += count;
+    m_stats.evicted += skipped;
+    return true;
+}
+
+/**
+ * @brief Read the oldest records without removing them.
+ * @param records Output array.
+ * @param max_count Capacity of the output array.
+ * @return The number of records read.
+ */
+size_t OfflineQueue::peek(UploadRecord *records, size_t max_count)
+{
+    if (!m_file)
+    {
+        return 0;
+    }
+
+    SpiArbiter::Lease lease(SpiArbiter::Device::SD);
+    size_t count = std::min<size_t>(max_count, size());
+    for (size_t i = 0; i < count; i++)
+    {
+        StoredRecord stored;
+        if (fseek(m_file, slot_offset(m_head + i), SEEK_SET) != 0 ||
+            fread(&stored, sizeof(stored), 1, m_file) != 1)
+        {
+            m_stats.io_errors++;
+            return i;
+        }
+
+        UploadRecord &record = records[i];
+        record = UploadRecord();
+        record.created_at = stored.created_at;
+        record.num_fields = std::min<uint8_t>(stored.num_fields, config::thingspeak::MAX_FIELDS);
+        record.integer_fields = stored.integer_fields;
+        memcpy(record.fields, stored.fields, sizeof(record.fields));
+    }
+    return count;
+}
+
+/**
+ * @brief Remove the oldest records, typically after they were uploaded.
+ * @param count The number of records to remove.
+ * @return True if the removal was committed, false on an I/O error.
+ */
+bool OfflineQueue::pop(size_t count)
+{
+    if (!m_file)
+    {
+        return false;
+    }
+
+    SpiArbiter::Lease lease(SpiArbiter::Device::SD);
+    count = std::min<size_t>(count, size());
+    m_head += count;
+    if (!commit_header())
+    {
+        m_head -= count;
+        return false;
+    }
+    m_stats.removed += count;
+    return true;
+}
+
+/**
+ * @brief Load the newest valid header copy.
+ * @return True if a header matching this layout was found, false otherwise.
+ */
+bool OfflineQueue::load_header()
+{
+    bool found = false;
+    for (long slot = 0; slot < 2; slot++)
+    {
+        Header header;
+        if (fseek(m_file, slot * HEADER_SLOT_SIZE, SEEK_SET) != 0 ||
+            fread(&header, sizeof(header), 1, m_file) != 1)
+        {
+            continue;
+        }
+
+        if (header.magic != MAGIC || header.version != VERSION ||
+            header.record_size != sizeof(StoredRecord) || header.capacity != m_capacity ||
+            header.crc != crc32(&header, offsetof(Header, crc)) ||
+            header.tail - header.head > m_capacity)
+        {
+            continue;
+        }
+
+        if (!found || static_cast<int32_t>(header.sequence - m_sequence) > 0)
+        {
+            m_sequence = header.sequence;
+            m_head = header.head;
+            m_tail = header.tail;
+            found = true;
+        }
+    }
+    return found;
+}
+
+/**
+ * @brief Write the cursors to the older header copy and sync.
+ * @return True if committed, false on an I/O error.
+ */
+bool OfflineQueue::commit_header()
+{
+    Header header = {};
+    header.magic = MAGIC;
+    header.version = VERSION;
+    header.record_size = sizeof(StoredRecord);
+    header.capacity = m_capacity;
+    header.sequence = m_sequence + 1;
+    header.head = m_head;
+    header.tail = m_tail;
+    header.crc = crc32(&header, offsetof(Header, crc));
+
+    // Alternate copies, so the other one stays valid while this one is written
+    long offset = (header.sequence % 2) * HEADER_SLOT_SIZE;
+    if (fseek(m_file, offset, SEEK_SET) != 0 ||
+        fwrite(&header, sizeof(header), 1, m_file) != 1 ||
+        !sync())
+    {
+        m_stats.io_errors++;
+        return false;
+    }
+    m_sequence = header.sequence;
+    return true;
+}
+
+/**
+ * @brief Write records into the slots following the tail and sync.
+ * @return True if written, false on an I/O error.
+ */
+bool OfflineQueue::write_records(const UploadRecord *records, size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        StoredRecord stored = {};
+        stored.created_at = records[i].created_at;
+        stored.num_fields = records[i].num_fields;
+        stored.integer_fields = records[i].integer_fields;
+        memcpy(stored.fields, records[i].fields, sizeof(stored.fields));
+
+        if (fseek(m_file, slot_offset(m_tail + i), SEEK_SET) != 0 ||
+            fwrite(&stored, sizeof(stored), 1, m_file) != 1)
+        {
+            m_stats.io_errors++;
+            return false;
+        }
+    }
+    return sync();
+}
+
+bool OfflineQueue::sync()
+{
+    return fflush(m_file) == 0 && fsync(fileno(m_file)) == 0;
+}
+
+long OfflineQueue::slot_offset(uint32_t index) const
+{
+    return DATA_OFFSET + static_cast<long>(index % m_capacity) * static_cast<long>(sizeof(StoredRecord));
+}
\ No newline at end of file
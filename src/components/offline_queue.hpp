@@ -0,0 +1,91 @@
+#pragma once
+
+#include <stdio.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "upload_worker.hpp"
+
+/**
+ * @brief Persistent FIFO of upload records for store-and-forward.
+ *
+ * The file is a fixed ring of record slots behind two header copies. The
+ * header holds free-running read and write counters; each update goes to the
+ * older copy with a higher sequence number and a CRC, so a torn write leaves
+ * the previous header valid. Records are written before the header that
+ * publishes them, and eviction commits the advanced read counter before its
+ * slots are overwritten, so a crash at any point loses at most the records
+ * being appended. When full, the oldest records are evicted.
+ *
+ * Plain stdio, so it works on the SD card's VFS mount and on a host file.
+ */
+class OfflineQueue
+{
+public:
+    struct Stats
+    {
+        uint32_t appended{0};
+        uint32_t removed{0};
+        uint32_t evicted{0};
+        uint32_t io_errors{0};
+    };
+
+    OfflineQueue(const char *path, uint32_t capacity);
+    ~OfflineQueue() { end(); }
+
+    bool begin();
+    void end();
+    bool is_open() const { return m_file != nullptr; }
+
+    bool append(const UploadRecord *records, size_t count);
+    size_t peek(UploadRecord *records, size_t max_count);
+    bool pop(size_t count);
+
+    size_t size() const { return m_tail - m_head; }
+    bool is_empty() const { return m_tail == m_head; }
+    uint32_t get_capacity() const { return m_capacity; }
+    const Stats &get_stats() const { return m_stats; }
+
+private:
+    static constexpr uint32_t MAGIC = 0x51464C4E; // "NLFQ"
+    static constexpr uint16_t VERSION = 1;
+
+    struct Header
+    {
+        uint32_t magic;
+        uint16_t version;
+        uint16_t record_size;
+        uint32_t capacity;
+        uint32_t sequence;
+        uint32_t head; // Records ever removed
+        uint32_t tail; // Records ever appended
+        uint32_t crc;
+    };
+
+    // On-disk record, independent of UploadRecord's in-memory extras
+    struct StoredRecord
+    {
+        uint32_t created_at;
+        uint8_t num_fields;
+        uint8_t integer_fields; // Was reserved and written as 0, so older files still read back
+        uint8_t reserved[2];
+        float fields[config::thingspeak::MAX_FIELDS];
+    };
+
+    static constexpr long HEADER_SLOT_SIZE = 32;
+    static constexpr long DATA_OFFSET = 2 * HEADER_SLOT_SIZE;
+    static_assert(sizeof(Header) <= HEADER_SLOT_SIZE, "Header must fit its slot");
+
+    const char *m_path;
+    uint32_t m_capacity;
+    FILE *m_file{nullptr};
+    uint32_t m_sequence{0};
+    uint32_t m_head{0};
+    uint32_t m_tail{0};
+    Stats m_stats;
+
+    bool load_header();
+    bool commit_header();
+    bool write_records(const UploadRecord *records, size_t count);
+    bool sync();
+    long slot_offset(uint32_t index) const;
+};
\ No newline at end of file
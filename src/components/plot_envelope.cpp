@@ -0,0 +1,81 @@
+#include "plot_envelope.hpp"
+#include <algorithm>
+
+/**
+ * @brief Select the time span shown across the plot, discarding the history.
+ * @param span The new span.
+ */
+void PlotEnvelope::set_span(Span span)
+{
+    m_span = span;
+    m_column_ms = std::max<uint32_t>(1, span_ms(span) / COLUMNS);
+    std::fill(std::begin(m_columns), std::end(m_columns), Column());
+    m_newest = COLUMNS - 1;
+    m_started = false;
+}
+
+/**
+ * @brief Fold a sample into the column covering its time.
+ * @param value The sample.
+ * @param timestamp_ms When it was taken, in non-decreasing order.
+ */
+void PlotEnvelope::add(uint16_t value, unsigned long timestamp_ms)
+{
+    if (!m_started)
+    {
+        m_column_start = timestamp_ms;
+        m_started = true;
+    }
+
+    unsigned long elapsed = timestamp_ms - m_column_start;
+    if (elapsed >= m_column_ms)
+    {
+        // Columns without samples stay empty, so gaps show as gaps
+        uint32_t steps = elapsed / m_column_ms;
+        advance(steps);
+        m_column_start += static_cast<unsigned long>(steps) * m_column_ms;
+    }
+
+    Column &column = m_columns[m_newest];
+    column.min = std::min(column.min, value);
+    column.max = std::max(column.max, value);
+    column.sum += value;
+    column.count++;
+}
+
+/**
+ * @brief Read a column in display order.
+ * @param index 0 for the oldest column, COLUMNS - 1 for the one being filled.
+ * @return The column.
+ */
+const PlotEnvelope::Column &PlotEnvelope::column(uint8_t index) const
+{
+    return m_columns[(m_newest + 1 + index) % COLUMNS];
+}
+
+uint32_t PlotEnvelope::span_ms(Span span)
+{
+    switch (span)
+    {
+    case Span::MINUTE_1:
+        return 60000;
+    case Span::MINUTES_10:
+        return 600000;
+    case Span::SECONDS_10:
+    default:
+        return 10000;
+    }
+}
+
+/**
+ * @brief Start new, empty columns, dropping the oldest ones.
+ * @param columns The number of columns to advance.
+ */
+void PlotEnvelope::advance(uint32_t columns)
+{
+    for (uint32_t i = 0; i < std::min<uint32_t>(columns, COLUMNS); i++)
+    {
+        m_newest = (m_newest + 1) % COLUMNS;
+        m_columns[m_newest] = Column();
+    }
+}
\ No newline at end of file
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "config/config.h"
+
+/**
+ * @brief Decimated history for the scrolling plot.
+ *
+ * Samples are folded into fixed time columns of span / COLUMNS each, keeping
+ * the min, max and mean of every sample that fell into the column, so the
+ * plot covers the whole span at any input rate. Columns live in a ring that
+ * column(0) reads from the oldest end; adding a sample and reading a column
+ * are O(1), a full redraw O(COLUMNS).
+ */
+class PlotEnvelope
+{
+public:
+    static constexpr uint8_t COLUMNS = config::display::plot::COLUMNS;
+
+    enum class Span : uint8_t
+    {
+        SECONDS_10,
+        MINUTE_1,
+        MINUTES_10
+    };
+
+    static constexpr Span DEFAULT_SPAN = config::display::plot::SPAN_S == 600  ? Span::MINUTES_10
+                                         : config::display::plot::SPAN_S == 60 ? Span::MINUTE_1
+                                                                               : Span::SECONDS_10;
+
+    struct Column
+    {
+        uint16_t min{UINT16_MAX};
+        uint16_t max{0};
+        uint32_t sum{0};
+        uint32_t count{0}; // 0 for columns without samples
+
+        bool is_empty() const { return count == 0; }
+        uint16_t mean() const { return count ? static_cast<uint16_t>(sum / count) : 0; }
+    };
+
+    explicit PlotEnvelope(Span span = DEFAULT_SPAN) { set_span(span); }
+
+    void set_span(Span span);
+    Span get_span() const { return m_span; }
+    uint32_t get_column_ms() const { return m_column_ms; }
+
+    void add(uint16_t value, unsigned long timestamp_ms);
+    const Column &column(uint8_t index) const;
+
+private:
+    Span m_span{DEFAULT_SPAN};
+    uint32_t m_column_ms{1};
+    Column m_columns[COLUMNS];
+    uint8_t m_newest{COLUMNS - 1}; // Ring position of the column being filled
+    unsigned long m_column_start{0};
+    bool m_started{false};
+
+    static uint32_t span_ms(Span span);
+    void advance(uint32_t columns);
+};
\ No newline at end of file
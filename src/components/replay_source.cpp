@@ -0,0 +1,283 @@
+#include "replay_source.hpp"
+#include <stdlib.h>
+#include <string.h>
+
+namespace
+{
+    uint32_t read_le32(const uint8_t *bytes)
+    {
+        return bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | (static_cast<uint32_t>(bytes[3]) << 24);
+    }
+
+    uint16_t read_le16(const uint8_t *bytes)
+    {
+        return bytes[0] | (bytes[1] << 8);
+    }
+
+    bool has_extension(const char *path, const char *extension)
+    {
+        size_t path_len = strlen(path);
+        size_t ext_len = strlen(extension);
+        return path_len >= ext_len && strcasecmp(path + path_len - ext_len, extension) == 0;
+    }
+}
+
+ReplaySource::ReplaySource(const char *path, bool loop)
+    : m_path(path), m_loop(loop)
+{
+}
+
+/**
+ * @brief Open the recording and prepare it for block replay.
+ * @param sample_rate_hz Rate used for CSV files; WAV files carry their own.
+ * @return True if the recording could be opened, false otherwise.
+ */
+bool ReplaySource::begin(uint32_t sample_rate_hz)
+{
+    end();
+
+    m_file = fopen(m_path, "rb");
+    if (!m_file)
+    {
+        return false;
+    }
+
+    if (has_extension(m_path, ".wav"))
+    {
+        if (!parse_wav_header(sample_rate_hz))
+        {
+            end();
+            return false;
+        }
+    }
+    else
+    {
+        m_format = Format::CSV;
+        m_data_offset = 0;
+    }
+
+    m_sample_rate_hz = sample_rate_hz;
+    m_samples_emitted = 0;
+    m_finished = false;
+    m_start_us = m_clock ? m_clock() : 0;
+    return true;
+}
+
+/**
+ * @brief Close the recording.
+ */
+void ReplaySource::end()
+{
+    if (m_file)
+    {
+        fclose(m_file);
+        m_file = nullptr;
+    }
+}
+
+/**
+ * @brief Produce the next block of the recording.
+ * @param block The block to fill.
+ * @return True if a block was produced, false if none is due yet or the recording ended.
+ */
+bool ReplaySource::read_block(SampleBlock &block)
+{
+    if (!m_file || m_finished)
+    {
+        return false;
+    }
+
+    if (m_clock)
+    {
+        uint32_t due = blocks_due();
+        if (due == 0)
+        {
+            return false;
+        }
+
+        // The I2S driver only queues QUEUED_BLOCKS; anything older was overwritten
+        if (due > config::adc::acquisition::QUEUED_BLOCKS)
+        {
+            uint32_t overwritten = due - config::adc::acquisition::QUEUED_BLOCKS;
+            uint16_t discarded;
+            for (uint64_t i = 0; i < uint64_t(overwritten) * config::adc::acquisition::BLOCK_SIZE; i++)
+            {
+                if (!next_sample(discarded))
+                {
+                    return false;
+                }
+                m_samples_emitted++;
+            }
+            note_dropped(overwritten);
+        }
+    }
+
+    unsigned long timestamp_ms = static_cast<unsigned long>(m_samples_emitted * 1000 / m_sample_rate_hz);
+
+    block.count = 0;
+    while (block.count < config::adc::acquisition::BLOCK_SIZE &&
+           next_sample(block.samples[block.count]))
+    {
+        block.count++;
+    }
+
+    if (block.count == 0)
+    {
+        return false;
+    }
+
+    m_samples_emitted += block.count;
+    complete_block(block, timestamp_ms);
+    return true;
+}
+
+/**
+ * @brief Parse the RIFF header and position the file at the PCM data.
+ * @param sample_rate_hz Receives the sample rate stored in the file.
+ * @return True if the file is a supported PCM WAV, false otherwise.
+ */
+bool ReplaySource::parse_wav_header(uint32_t &sample_rate_hz)
+{
+    uint8_t riff[12];
+    if (fread(riff, 1, sizeof(riff), m_file) != sizeof(riff) ||
+        memcmp(riff, "RIFF", 4) != 0 || memcmp(riff + 8, "WAVE", 4) != 0)
+    {
+        return false;
+    }
+
+    bool have_format = false;
+    uint8_t chunk_header[8];
+    while (fread(chunk_header, 1, sizeof(chunk_header), m_file) == sizeof(chunk_header))
+    {
+        uint32_t chunk_size = read_le32(chunk_header + 4);
+
+        if (memcmp(chunk_header, "fmt ", 4) == 0)
+        {
+            uint8_t fmt[16];
+            if (chunk_size < sizeof(fmt) || fread(fmt, 1, sizeof(fmt), m_file) != sizeof(fmt))
+            {
+                return false;
+            }
+
+            uint16_t audio_format = read_le16(fmt);
+            uint16_t bits_per_sample = read_le16(fmt + 14);
+            if (audio_format != 1 || (bits_per_sample != 8 && bits_per_sample != 16))
+            {
+                return false; // Only uncompressed PCM
+            }
+
+            m_wav_channels = read_le16(fmt + 2);
+            sample_rate_hz = read_le32(fmt + 4);
+            m_format = bits_per_sample == 8 ? Format::WAV_U8 : Format::WAV_S16;
+            have_format = m_wav_channels > 0;
+            fseek(m_file, chunk_size - sizeof(fmt) + (chunk_size & 1), SEEK_CUR);
+            continue;
+        }
+
+        if (memcmp(chunk_header, "data", 4) == 0)
+        {
+            m_data_offset = ftell(m_file);
+            return have_format;
+        }
+
+        // Skip chunks we do not need (LIST, fact, ...), honouring RIFF padding
+        fseek(m_file, chunk_size + (chunk_size & 1), SEEK_CUR);
+    }
+
+    return false;
+}
+
+/**
+ * @brief Read one sample from the file and convert it to 12-bit ADC units.
+ * @param sample Receives the converted sample.
+ * @return True if a sample was read, false at end of file.
+ */
+bool ReplaySource::read_sample(uint16_t &sample)
+{
+    switch (m_format)
+    {
+    case Format::WAV_U8:
+    {
+        uint8_t frame[8];
+        size_t frame_bytes = m_wav_channels;
+        if (frame_bytes > sizeof(frame) || fread(frame, 1, frame_bytes, m_file) != frame_bytes)
+        {
+            return false;
+        }
+        sample = static_cast<uint16_t>(frame[0]) << 4;
+        return true;
+    }
+    case Format::WAV_S16:
+    {
+        uint8_t frame[16];
+        size_t frame_bytes = m_wav_channels * 2;
+        if (frame_bytes > sizeof(frame) || fread(frame, 1, frame_bytes, m_file) != frame_bytes)
+        {
+            return false;
+        }
+        int16_t value = static_cast<int16_t>(read_le16(frame));
+        sample = static_cast<uint16_t>((value + 32768) >> 4);
+        return true;
+    }
+    case Format::CSV:
+    default:
+    {
+        char line[32];
+        while (fgets(line, sizeof(line), m_file))
+        {
+            char *end_ptr;
+            long value = strtol(line, &end_ptr, 10);
+            if (end_ptr == line)
+            {
+                continue; // Header or blank line
+            }
+            if (value < 0)
+                value = 0;
+            if (value > config::adc::MAX_VALUE)
+                value = config::adc::MAX_VALUE;
+            sample = static_cast<uint16_t>(value);
+            return true;
+        }
+        return false;
+    }
+    }
+}
+
+/**
+ * @brief Read the next sample, rewinding when looping is enabled.
+ * @param sample Receives the converted sample.
+ * @return True if a sample was produced, false once the recording has ended.
+ */
+bool ReplaySource::next_sample(uint16_t &sample)
+{
+    if (read_sample(sample))
+    {
+        return true;
+    }
+
+    // An empty recording fails the read after the rewind too
+    if (m_loop)
+    {
+        fseek(m_file, m_data_offset, SEEK_SET);
+        if (read_sample(sample))
+        {
+            return true;
+        }
+    }
+
+    m_finished = true;
+    return false;
+}
+
+/**
+ * @brief Number of blocks the paced clock says should be waiting for the consumer.
+ * @return Blocks due since the last one handed out.
+ */
+uint32_t ReplaySource::blocks_due() const
+{
+    uint64_t elapsed_us = m_clock() - m_start_us;
+    uint64_t produced_samples = elapsed_us * m_sample_rate_hz / 1000000;
+    uint64_t produced_blocks = produced_samples / config::adc::acquisition::BLOCK_SIZE;
+    uint64_t emitted_blocks = m_samples_emitted / config::adc::acquisition::BLOCK_SIZE;
+    return produced_blocks > emitted_blocks ? static_cast<uint32_t>(produced_blocks - emitted_blocks) : 0;
+}
\ No newline at end of file
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <stdio.h>
+#include "audio_source.hpp"
+
+/**
+ * @brief AudioSource that replays a recorded WAV or CSV session.
+ *
+ * WAV files (8/16-bit PCM, first channel used) are rescaled to 12-bit ADC units;
+ * CSV files hold one raw ADC value per line. Without a clock the source runs
+ * as fast as it is drained, which measures pipeline throughput. With a clock
+ * it paces blocks like the DMA ring would and counts blocks the consumer was
+ * too slow to collect.
+ */
+class ReplaySource : public AudioSource
+{
+public:
+    using ClockFn = uint64_t (*)(); // Microseconds
+
+    explicit ReplaySource(const char *path, bool loop = false);
+    ~ReplaySource() override { end(); }
+
+    bool begin(uint32_t sample_rate_hz) override;
+    void end() override;
+    bool read_block(SampleBlock &block) override;
+
+    void set_clock(ClockFn clock) { m_clock = clock; }
+    bool is_finished() const { return m_finished; }
+
+private:
+    enum class Format
+    {
+        CSV,
+        WAV_U8,
+        WAV_S16
+    };
+
+    const char *m_path;
+    bool m_loop;
+    FILE *m_file{nullptr};
+    Format m_format{Format::CSV};
+    uint16_t m_wav_channels{1};
+    long m_data_offset{0};
+    uint64_t m_samples_emitted{0};
+    uint64_t m_start_us{0};
+    ClockFn m_clock{nullptr};
+    bool m_finished{false};
+
+    bool parse_wav_header(uint32_t &sample_rate_hz);
+    bool read_sample(uint16_t &sample);
+    bool next_sample(uint16_t &sample);
+    uint32_t blocks_due() const;
+};
\ No newline at end of file
@@ -0,0 +1,75 @@
+#include "rmt_led_output.hpp"
+#include "esp_log.h"
+
+namespace
+{
+    // WS2812 bit timings in ticks: 0 = 0.4us high + 0.85us low, 1 = 0.8us + 0.45us
+    constexpr uint32_t make_item(uint16_t high_ticks, uint16_t low_ticks)
+    {
+        return high_ticks | (1u << 15) | (uint32_t(low_ticks) << 16);
+    }
+
+    constexpr uint32_t BIT_0 = make_item(16, 34);
+    constexpr uint32_t BIT_1 = make_item(32, 18);
+}
+
+/**
+ * @brief Install the RMT driver on the strip's pin.
+ * @return True if the output is ready, false otherwise.
+ */
+bool RmtLedOutput::begin()
+{
+    if (m_initialized)
+    {
+        return true;
+    }
+
+    rmt_config_t tx_config = RMT_DEFAULT_CONFIG_TX(static_cast<gpio_num_t>(m_pin), CHANNEL);
+    tx_config.clk_div = CLOCK_DIVIDER;
+    if (rmt_config(&tx_config) != ESP_OK || rmt_driver_install(CHANNEL, 0, 0) != ESP_OK)
+    {
+        ESP_LOGE(TAG, "Failed to install RMT driver");
+        return false;
+    }
+
+    m_initialized = true;
+    return true;
+}
+
+/**
+ * @brief Check whether the last frame is still being transmitted.
+ * @return True while the RMT channel is sending.
+ */
+bool RmtLedOutput::is_busy()
+{
+    return m_initialized && rmt_wait_tx_done(CHANNEL, 0) != ESP_OK;
+}
+
+/**
+ * @brief Start sending a frame; returns before the transmission ends.
+ * @param colors NUM_PIXELS colors as 0xRRGGBB.
+ */
+void RmtLedOutput::show(const uint32_t *colors)
+{
+    if (!m_initialized || is_busy())
+    {
+        return;
+    }
+
+    rmt_item32_t *item = m_items;
+    for (size_t i = 0; i < led_meter::NUM_PIXELS; i++)
+    {
+        // The strip expects green, red, blue, most significant bit first
+        uint32_t color = colors[i];
+        uint32_t grb = ((color & 0x00FF00) << 8) | ((color & 0xFF0000) >> 8) | (color & 0x0000FF);
+        for (uint32_t mask = 1u << (BITS_PER_PIXEL - 1); mask; mask >>= 1)
+        {
+            (item++)->val = grb & mask ? BIT_1 : BIT_0;
+        }
+    }
+
+    if (rmt_write_items(CHANNEL, m_items, led_meter::NUM_PIXELS * BITS_PER_PIXEL, false) != ESP_OK)
+    {
+        ESP_LOGW(TAG, "Failed to start LED transmission");
+    }
+}
\ No newline at end of file
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <Arduino.h>
+#include <driver/rmt.h>
+#include "led_meter.hpp"
+
+/**
+ * @brief WS2812 (GRB, 800kHz) strip output on the ESP32 RMT peripheral.
+ *
+ * show() encodes the frame into RMT items and starts the transmission
+ * without waiting; the driver feeds the RMT memory from its interrupt, so
+ * the CPU is free and other interrupts keep running while the strip
+ * updates. The items must stay untouched until is_busy() is false.
+ */
+class RmtLedOutput : public LedOutput
+{
+public:
+    explicit RmtLedOutput(uint8_t pin) : m_pin(pin) {}
+
+    bool begin() override;
+    bool is_busy() override;
+    void show(const uint32_t *colors) override;
+
+private:
+    static constexpr rmt_channel_t CHANNEL = RMT_CHANNEL_0;
+    static constexpr uint8_t CLOCK_DIVIDER = 2; // 40MHz, 25ns ticks
+    static constexpr size_t BITS_PER_PIXEL = 24;
+
+    static constexpr char const *TAG = "RmtLedOutput";
+
+    static_assert(sizeof(rmt_item32_t) == sizeof(uint32_t), "RMT items are one word");
+
+    uint8_t m_pin;
+    bool m_initialized{false};
+    rmt_item32_t m_items[led_meter::NUM_PIXELS * BITS_PER_PIXEL];
+};
\ No newline at end of file
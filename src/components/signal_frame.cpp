@@ -0,0 +1,45 @@
+#include "signal_frame.hpp"
+
+namespace
+{
+    WindowSummary summarize(const SignalProcessor::Statistics &stats)
+    {
+        WindowSummary summary;
+        summary.min = stats.min;
+        summary.max = stats.max;
+        summary.avg = stats.avg;
+        summary.samples = stats.samples;
+        summary.l10 = stats.l10();
+        summary.l50 = stats.l50();
+        summary.l90 = stats.l90();
+        return summary;
+    }
+}
+
+/**
+ * @brief Take a snapshot of the processor state.
+ * @param signal_processor The signal processor instance.
+ * @param spectrum The spectrum analyzer fed from the same samples.
+ * @param sequence Monotonic frame number, gaps mean dropped frames.
+ * @param timestamp_ms Time of the block the frame was produced from.
+ * @return The frame.
+ */
+SignalFrame SignalFrame::capture(const SignalProcessor &signal_processor, const SpectrumAnalyzer &spectrum,
+                                 uint32_t sequence, unsigned long timestamp_ms)
+{
+    SignalFrame frame;
+    frame.sequence = sequence;
+    frame.timestamp_ms = timestamp_ms;
+    frame.value = signal_processor.get_current_value();
+    frame.baseline = signal_processor.get_baseline();
+    frame.category = signal_processor.get_noise_category();
+    frame.has_levels = signal_processor.has_levels();
+    frame.laeq = signal_processor.get_laeq();
+    frame.lcpeak = signal_processor.get_lcpeak();
+    frame.has_spectrum = spectrum.has_spectrum();
+    frame.octave_db = spectrum.get_octave_levels();
+    frame.one_min = summarize(signal_processor.get_one_min_stats());
+    frame.fifteen_min = summarize(signal_processor.get_fifteen_min_stats());
+    frame.daily = summarize(signal_processor.get_daily_stats());
+    return frame;
+}
\ No newline at end of file
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <array>
+#include <stdint.h>
+#include "signal_processor.hpp"
+#include "spectrum_analyzer.hpp"
+
+/**
+ * @brief Summary of one statistics window, copied out of the processor.
+ */
+struct WindowSummary
+{
+    uint16_t min{UINT16_MAX};
+    uint16_t max{0};
+    float avg{0};
+    uint32_t samples{0};
+    uint16_t l10{0};
+    uint16_t l50{0};
+    uint16_t l90{0};
+};
+
+/**
+ * @brief Snapshot of the processed signal handed from the DSP task to consumers.
+ *
+ * Plain data, so it can cross cores through the SPSC ring while the DSP task
+ * keeps mutating the SignalProcessor it was taken from.
+ */
+struct SignalFrame
+{
+    uint32_t sequence{0};
+    unsigned long timestamp_ms{0};
+
+    float value{0};
+    float baseline{0};
+    SignalProcessor::NoiseLevel category{SignalProcessor::NoiseLevel::OK};
+
+    bool has_levels{false};
+    float laeq{0};
+    float lcpeak{0};
+
+    bool has_spectrum{false};
+    std::array<float, spectrum::OCTAVE_BANDS> octave_db{}; // Band levels, see SpectrumAnalyzer
+
+    WindowSummary one_min;
+    WindowSummary fifteen_min;
+    WindowSummary daily;
+
+    static SignalFrame capture(const SignalProcessor &signal_processor, const SpectrumAnalyzer &spectrum,
+                               uint32_t sequence, unsigned long timestamp_ms);
+};
\ No newline at end of file
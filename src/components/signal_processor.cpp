@@ -8,70 +8,75 @@ SignalProcessor::SignalProcessor() = default;
  */
 void SignalProcessor::process_sample(uint16_t raw_value)
 {
-    // Update current value immediately
-    m_ema_value = (config::signal_processing::EMA_ALPHA * raw_value) +
-                  ((1.0f - config::signal_processing::EMA_ALPHA) * m_ema_value);
+    process_block(&raw_value, 1, millis());
+}
 
-    // Update baseline more slowly
-    if (m_baseline_ema == 0)
+/**
+ * @brief Process a block of samples that share one timestamp.
+ *
+ * Produces exactly the same state as calling the per-sample path for every
+ * sample with the same timestamp, but reads the clock once, keeps the filter
+ * state in registers and publishes the window statistics once per block.
+ * @param samples The raw ADC values to process.
+ * @param count The number of samples in the block.
+ * @param timestamp The time the block was acquired, in milliseconds.
+ */
+void SignalProcessor::process_block(const uint16_t *samples, size_t count, unsigned long timestamp)
+{
+    if (count == 0)
     {
-        m_baseline_ema = m_ema_value;
+        return;
     }
-    m_baseline_ema = (config::signal_processing::BASELINE_ALPHA * m_ema_value) +
-                     ((1.0f - config::signal_processing::BASELINE_ALPHA) * m_baseline_ema);
 
-    // Update each statistic window independently
-    unsigned long current_time = millis();
+    // Windows and histogram slots can only roll over between blocks
+    m_windows.advance(timestamp);
+    m_one_min_levels.advance(timestamp);
+    m_fifteen_min_levels.advance(timestamp);
+    m_daily_levels.advance(timestamp);
+
+    EnvelopeFilter envelope = m_envelope;
+    for (size_t i = 0; i < count; i++)
+    {
+        envelope.update(samples[i]);
+        float value = envelope.value();
+        m_windows.add(value);
+        m_one_min_levels.add(value);
+        m_fifteen_min_levels.add(value);
+        m_daily_levels.add(value);
+    }
+    m_envelope = envelope;
 
-    // Update statistics for each time window
-    update_statistics(m_one_min_stats, m_ema_value);
-    update_statistics(m_fifteen_min_stats, m_ema_value);
-    update_statistics(m_daily_stats, m_ema_value);
+    publish_statistics(m_one_min_stats, m_windows.one_minute(), timestamp);
+    publish_statistics(m_fifteen_min_stats, m_windows.fifteen_minutes(), timestamp);
+    publish_statistics(m_daily_stats, m_windows.daily(), timestamp);
 }
 
 /**
- * @brief Update the EMA (Exponential Moving Average) value.
- * @param raw_value The raw ADC value to process.
+ * @brief Feed full-rate acquisition samples to the A/C-weighted level meter.
+ * @param samples The raw ADC values, at the acquisition rate.
+ * @param count The number of samples.
  */
-void SignalProcessor::update_ema(uint16_t raw_value)
+void SignalProcessor::process_audio(const uint16_t *samples, size_t count)
 {
-    // Calculate fast EMA for current noise
-    m_ema_value = (config::signal_processing::EMA_ALPHA * raw_value) +
-                  ((1.0f - config::signal_processing::EMA_ALPHA) * m_ema_value);
-
-    // Update baseline (very slow EMA)
-    if (m_baseline_ema == 0)
-    {
-        m_baseline_ema = m_ema_value; // Initialize baseline
-    }
-    m_baseline_ema = (config::signal_processing::BASELINE_ALPHA * m_ema_value) +
-                     ((1.0f - config::signal_processing::BASELINE_ALPHA) * m_baseline_ema);
+    m_level_meter.process(samples, count);
 }
 
 /**
- * @brief Update the statistics for a given value.
+ * @brief Copy a sliding window summary into the public statistics.
  * @param stats The statistics structure to update.
- * @param value The value to update the statistics with.
+ * @param window The window summary.
+ * @param current_time The time of the block, in milliseconds.
  */
-void SignalProcessor::update_statistics(Statistics &stats, float value)
+void SignalProcessor::publish_statistics(Statistics &stats, const WindowAggregate &window,
+                                         unsigned long current_time)
 {
-    unsigned long current_time = millis();
-
-    // Reset if window has expired
-    if (current_time - stats.last_update > stats.window_size)
-    {
-        stats.min = stats.max = static_cast<uint16_t>(value);
-        stats.avg = value;
-        stats.samples = 1;
-    }
-    else
+    if (window.count > 0)
     {
-        stats.min = std::min(stats.min, static_cast<uint16_t>(value));
-        stats.max = std::max(stats.max, static_cast<uint16_t>(value));
-        // Weighted average to prevent overflow
-        stats.avg = (stats.avg * 0.95f) + (value * 0.05f);
-        stats.samples++;
+        stats.min = static_cast<uint16_t>(window.min);
+        stats.max = static_cast<uint16_t>(window.max);
     }
+    stats.avg = window.mean();
+    stats.samples = window.count;
     stats.last_update = current_time;
 }
 
@@ -82,7 +87,7 @@ void SignalProcessor::update_statistics(Statistics &stats, float value)
 SignalProcessor::NoiseLevel SignalProcessor::get_noise_category() const
 {
     // Use absolute values instead of ratios
-    float current = m_ema_value;
+    float current = m_envelope.value();
 
     if (current < config::signal_processing::ranges::QUIET)
         return NoiseLevel::OK;
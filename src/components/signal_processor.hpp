@@ -1,7 +1,12 @@
 #pragma once
 
 #include <Arduino.h>
+#include <type_traits>
 #include "config/config.h"
+#include "envelope_filter.hpp"
+#include "sound_level_meter.hpp"
+#include "level_histogram.hpp"
+#include "sliding_window.hpp"
 
 /**
  * @brief Class representing the signal processor.
@@ -17,6 +22,10 @@ public:
         CRITICAL
     };
 
+    /**
+     * min/max/avg/samples slide over the last window_size ms. The exceedance
+     * levels slide over the same window in steps of one histogram slot.
+     */
     struct Statistics
     {
         uint16_t min{UINT16_MAX};
@@ -25,29 +34,64 @@ public:
         uint32_t samples{0};
         unsigned long last_update{0};
         uint32_t window_size;
+        LevelHistogram histogram;
 
         Statistics(uint32_t window_ms) : window_size(window_ms) {}
+
+        // Exceedance levels over the window; Lmax is max
+        uint16_t l10() const { return histogram.exceeded(10); }
+        uint16_t l50() const { return histogram.exceeded(50); }
+        uint16_t l90() const { return histogram.exceeded(90); }
     };
 
     SignalProcessor();
 
     void process_sample(uint16_t raw_value);
-    float get_current_value() const { return m_ema_value; }
-    float get_baseline() const { return m_baseline_ema; }
+    void process_block(const uint16_t *samples, size_t count, unsigned long timestamp);
+    void process_audio(const uint16_t *samples, size_t count);
+    float get_current_value() const { return m_envelope.value(); }
+    float get_baseline() const { return m_envelope.baseline(); }
     NoiseLevel get_noise_category() const;
 
+    // Calibrated levels in dB SPL, only available with continuous acquisition
+    bool has_levels() const { return m_level_meter.has_levels(); }
+    float get_laeq() const { return m_level_meter.get_laeq(); }
+    float get_lcpeak() const { return m_level_meter.get_lcpeak(); }
+
     const Statistics &get_one_min_stats() const { return m_one_min_stats; }
     const Statistics &get_fifteen_min_stats() const { return m_fifteen_min_stats; }
     const Statistics &get_daily_stats() const { return m_daily_stats; }
 
 private:
-    float m_ema_value{0.0f};
-    float m_baseline_ema{0.0f};
+    using EnvelopeFilter = std::conditional_t<config::signal_processing::FIXED_POINT,
+                                              FixedEnvelopeFilter,
+                                              FloatEnvelopeFilter>;
+
+    EnvelopeFilter m_envelope;
+    SoundLevelMeter m_level_meter;
+
+    SlidingWindowAggregator m_windows;
+    Statistics m_one_min_stats{config::signal_processing::windows::ONE_MIN_MS};
+    Statistics m_fifteen_min_stats{config::signal_processing::windows::FIFTEEN_MIN_MS};
+    Statistics m_daily_stats{config::signal_processing::windows::DAILY_MS};
+
+    static constexpr size_t ONE_MIN_SLOTS = config::signal_processing::histogram::ONE_MIN_SLOTS;
+    static constexpr size_t FIFTEEN_MIN_SLOTS = config::signal_processing::histogram::FIFTEEN_MIN_SLOTS;
+    static constexpr size_t DAILY_SLOTS = config::signal_processing::histogram::DAILY_SLOTS;
+
+    static_assert(config::signal_processing::windows::ONE_MIN_MS % ONE_MIN_SLOTS == 0 &&
+                      config::signal_processing::windows::FIFTEEN_MIN_MS % FIFTEEN_MIN_SLOTS == 0 &&
+                      config::signal_processing::windows::DAILY_MS % DAILY_SLOTS == 0,
+                  "Each window must be a whole number of histogram slots");
 
-    Statistics m_one_min_stats{60000};
-    Statistics m_fifteen_min_stats{900000};
-    Statistics m_daily_stats{86400000};
+    // Feed the histograms of the statistics above, so declared after them
+    LevelHistogramSlots<ONE_MIN_SLOTS> m_one_min_levels{
+        m_one_min_stats.histogram, config::signal_processing::windows::ONE_MIN_MS / ONE_MIN_SLOTS};
+    LevelHistogramSlots<FIFTEEN_MIN_SLOTS> m_fifteen_min_levels{
+        m_fifteen_min_stats.histogram, config::signal_processing::windows::FIFTEEN_MIN_MS / FIFTEEN_MIN_SLOTS};
+    LevelHistogramSlots<DAILY_SLOTS> m_daily_levels{
+        m_daily_stats.histogram, config::signal_processing::windows::DAILY_MS / DAILY_SLOTS};
 
-    void update_ema(uint16_t raw_value);
-    void update_statistics(Statistics &stats, float value);
+    static void publish_statistics(Statistics &stats, const WindowAggregate &window,
+                                   unsigned long current_time);
 };
\ No newline at end of file
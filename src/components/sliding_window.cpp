@@ -0,0 +1,93 @@
+#include "sliding_window.hpp"
+
+SlidingWindowAggregator::SlidingWindowAggregator() = default;
+
+/**
+ * @brief Close every bucket that ended before `now`, rolling each into the tier above.
+ * @param now The current time, in milliseconds.
+ */
+void SlidingWindowAggregator::advance(unsigned long now)
+{
+    if (!m_started)
+    {
+        m_seconds.start(now);
+        m_minutes.start(now);
+        m_quarters.start(now);
+        m_started = true;
+        return;
+    }
+
+    while (m_seconds.due(now))
+    {
+        // Bring the minute tier up to the closing second before handing it over
+        unsigned long start = m_seconds.bucket_start();
+        WindowAggregate closed = m_seconds.close(now);
+        advance_minutes(start);
+        m_minutes.merge(closed);
+    }
+    advance_minutes(now);
+}
+
+/**
+ * @brief Roll the minute tier forward to `now`.
+ * @param now The time to advance to, in milliseconds.
+ */
+void SlidingWindowAggregator::advance_minutes(unsigned long now)
+{
+    while (m_minutes.due(now))
+    {
+        unsigned long start = m_minutes.bucket_start();
+        WindowAggregate closed = m_minutes.close(now);
+        advance_quarters(start);
+        m_quarters.merge(closed);
+    }
+    advance_quarters(now);
+}
+
+/**
+ * @brief Roll the 15 minute tier forward to `now`.
+ * @param now The time to advance to, in milliseconds.
+ */
+void SlidingWindowAggregator::advance_quarters(unsigned long now)
+{
+    while (m_quarters.due(now))
+    {
+        m_quarters.close(now);
+    }
+}
+
+/**
+ * @brief Summary of the last minute: closed seconds plus the open second.
+ * @return The window aggregate.
+ */
+WindowAggregate SlidingWindowAggregator::one_minute() const
+{
+    WindowAggregate window = m_seconds.closed_total();
+    window.merge(m_seconds.current());
+    return window;
+}
+
+/**
+ * @brief Summary of the last 15 minutes: closed minutes plus the open minute and second.
+ * @return The window aggregate.
+ */
+WindowAggregate SlidingWindowAggregator::fifteen_minutes() const
+{
+    WindowAggregate window = m_minutes.closed_total();
+    window.merge(m_minutes.current());
+    window.merge(m_seconds.current());
+    return window;
+}
+
+/**
+ * @brief Summary of the last 24 hours: closed quarters plus every open bucket below.
+ * @return The window aggregate.
+ */
+WindowAggregate SlidingWindowAggregator::daily() const
+{
+    WindowAggregate window = m_quarters.closed_total();
+    window.merge(m_quarters.current());
+    window.merge(m_minutes.current());
+    window.merge(m_seconds.current());
+    return window;
+}
\ No newline at end of file
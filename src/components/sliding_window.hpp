@@ -0,0 +1,147 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <float.h>
+#include "config/config.h"
+
+/**
+ * @brief Mergeable min/max/sum/count summary of a span of values.
+ */
+struct WindowAggregate
+{
+    float min{FLT_MAX};
+    float max{-FLT_MAX};
+    float sum{0.0f};
+    uint32_t count{0};
+
+    void add(float value)
+    {
+        min = value < min ? value : min;
+        max = value > max ? value : max;
+        sum += value;
+        count++;
+    }
+
+    void merge(const WindowAggregate &other)
+    {
+        min = other.min < min ? other.min : min;
+        max = other.max > max ? other.max : max;
+        sum += other.sum;
+        count += other.count;
+    }
+
+    float mean() const { return count ? sum / count : 0.0f; }
+};
+
+/**
+ * @brief One level of the bucket hierarchy: an open bucket plus a ring of closed ones.
+ *
+ * The summary of the closed buckets is rebuilt once per bucket close, so the
+ * per-value cost stays O(1) and the rescan is amortised over a whole bucket.
+ */
+template <size_t SLOTS>
+class BucketTier
+{
+public:
+    static_assert(SLOTS >= 2, "A tier needs the open bucket and at least one closed bucket");
+
+    explicit BucketTier(uint32_t bucket_ms) : m_bucket_ms(bucket_ms) {}
+
+    void start(unsigned long now)
+    {
+        m_start = now - now % m_bucket_ms;
+        m_started = true;
+    }
+
+    bool due(unsigned long now) const { return m_started && now - m_start >= m_bucket_ms; }
+    unsigned long bucket_start() const { return m_start; }
+
+    void add(float value) { m_current.add(value); }
+    void merge(const WindowAggregate &aggregate) { m_current.merge(aggregate); }
+
+    /**
+     * @brief Close the open bucket and start the next one.
+     * @param now The current time, used to skip over long idle gaps.
+     * @return The bucket that was closed.
+     */
+    WindowAggregate close(unsigned long now)
+    {
+        WindowAggregate closed = m_current;
+        m_ring[m_head] = closed;
+        m_head = (m_head + 1) % RING_SIZE;
+        m_current = WindowAggregate();
+        m_start += m_bucket_ms;
+
+        // A gap longer than the whole tier leaves nothing but empty buckets behind
+        if (now - m_start >= uint64_t(m_bucket_ms) * SLOTS)
+        {
+            for (auto &bucket : m_ring)
+            {
+                bucket = WindowAggregate();
+            }
+            m_start = now - (now - m_start) % m_bucket_ms;
+        }
+
+        m_closed_total = WindowAggregate();
+        for (const auto &bucket : m_ring)
+        {
+            m_closed_total.merge(bucket);
+        }
+        return closed;
+    }
+
+    const WindowAggregate &current() const { return m_current; }
+    const WindowAggregate &closed_total() const { return m_closed_total; }
+
+private:
+    static constexpr size_t RING_SIZE = SLOTS - 1;
+
+    uint32_t m_bucket_ms;
+    unsigned long m_start{0};
+    bool m_started{false};
+    WindowAggregate m_current;
+    WindowAggregate m_ring[RING_SIZE];
+    size_t m_head{0};
+    WindowAggregate m_closed_total;
+};
+
+/**
+ * @brief True sliding 1 min / 15 min / 24 h windows over hierarchical buckets.
+ *
+ * Values land in a 1 s bucket; closed seconds roll into a 1 min bucket, closed
+ * minutes into a 15 min bucket. Each window is its tier's ring of closed
+ * buckets plus the open buckets below it, so memory is fixed and adding a
+ * value is O(1).
+ */
+class SlidingWindowAggregator
+{
+public:
+    SlidingWindowAggregator();
+
+    // Roll buckets forward to `now`; call once per block before adding its values
+    void advance(unsigned long now);
+    void add(float value) { m_seconds.add(value); }
+
+    WindowAggregate one_minute() const;
+    WindowAggregate fifteen_minutes() const;
+    WindowAggregate daily() const;
+
+private:
+    static constexpr uint32_t SECOND_MS = config::signal_processing::windows::SECOND_BUCKET_MS;
+    static constexpr uint32_t MINUTE_MS = config::signal_processing::windows::ONE_MIN_MS;
+    static constexpr uint32_t QUARTER_MS = config::signal_processing::windows::FIFTEEN_MIN_MS;
+    static constexpr uint32_t DAY_MS = config::signal_processing::windows::DAILY_MS;
+
+    static_assert(MINUTE_MS % SECOND_MS == 0 && QUARTER_MS % MINUTE_MS == 0 &&
+                      DAY_MS % QUARTER_MS == 0,
+                  "Each window must be a whole number of the buckets below it");
+
+    BucketTier<MINUTE_MS / SECOND_MS> m_seconds{SECOND_MS};
+    BucketTier<QUARTER_MS / MINUTE_MS> m_minutes{MINUTE_MS};
+    BucketTier<DAY_MS / QUARTER_MS> m_quarters{QUARTER_MS};
+    bool m_started{false};
+
+    void advance_minutes(unsigned long now);
+    void advance_quarters(unsigned long now);
+};
\ No newline at end of file
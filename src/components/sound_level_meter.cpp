@@ -0,0 +1,103 @@
+#include "sound_level_meter.hpp"
+#include <math.h>
+#include <algorithm>
+
+SoundLevelMeter::SoundLevelMeter()
+    : m_calibration_db(calibration_db())
+{
+}
+
+/**
+ * @brief Derive the ADC-count to dB SPL calibration from the sensor constants.
+ * @return The offset to add to 20*log10(amplitude in ADC counts).
+ */
+float SoundLevelMeter::calibration_db()
+{
+    using namespace config::adc;
+
+    // counts -> volts at the ADC -> volts at the capsule -> pascal -> dB re 20uPa
+    float volts_per_count = sound_sensor::FULL_SCALE_VOLTAGE / MAX_VALUE;
+    float sensitivity_dbv = (sound_sensor::MIN_DB + sound_sensor::MAX_DB) / 2.0f;
+    return 20.0f * log10f(volts_per_count) - sound_sensor::VOLTAGE_GAIN - sensitivity_dbv -
+           20.0f * log10f(config::signal_processing::levels::REFERENCE_PRESSURE_PA);
+}
+
+/**
+ * @brief Run a block of raw samples through the weighting filters.
+ * @param samples The raw ADC values, at the acquisition rate.
+ * @param count The number of samples.
+ */
+void SoundLevelMeter::process(const uint16_t *samples, size_t count)
+{
+    if (count == 0)
+    {
+        return;
+    }
+
+    // Remove the bias before the first sample so the high-pass starts settled
+    if (!m_primed)
+    {
+        m_dc_offset = samples[0];
+        m_primed = true;
+    }
+
+    for (size_t i = 0; i < count; i++)
+    {
+        float c = m_lowpass.process(m_highpass.process(samples[i] - m_dc_offset));
+        float a = m_midband.process(c) * weighting::A_GAIN;
+        c *= weighting::C_GAIN;
+
+        m_a_energy += a * a;
+        m_c_peak = std::max(m_c_peak, fabsf(c));
+
+        if (++m_period_samples >= PERIOD_SAMPLES)
+        {
+            finish_period();
+        }
+    }
+}
+
+/**
+ * @brief Clear filter state and the current integration period.
+ */
+void SoundLevelMeter::reset()
+{
+    m_highpass.reset();
+    m_lowpass.reset();
+    m_midband.reset();
+    m_primed = false;
+    m_a_energy = 0.0f;
+    m_c_peak = 0.0f;
+    m_period_samples = 0;
+    m_has_levels = false;
+}
+
+/**
+ * @brief Publish the levels of the completed integration period and start a new one.
+ */
+void SoundLevelMeter::finish_period()
+{
+    m_laeq_db = to_db(sqrtf(m_a_energy / m_period_samples));
+    m_lcpeak_db = to_db(m_c_peak);
+    m_has_levels = true;
+
+    m_a_energy = 0.0f;
+    m_c_peak = 0.0f;
+    m_period_samples = 0;
+}
+
+/**
+ * @brief Convert an amplitude in ADC counts to dB SPL.
+ * @param amplitude_counts RMS or peak amplitude in ADC counts.
+ * @return The calibrated level, never below FLOOR_DB.
+ */
+float SoundLevelMeter::to_db(float amplitude_counts) const
+{
+    if (amplitude_counts <= 0.0f)
+    {
+        return config::signal_processing::levels::FLOOR_DB;
+    }
+
+    return std::max(config::signal_processing::levels::FLOOR_DB,
+                    20.0f * log10f(amplitude_counts) + m_calibration_db);
+}
\ No newline at end of file
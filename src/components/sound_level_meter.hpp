@@ -0,0 +1,51 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "weighting_filter.hpp"
+
+/**
+ * @brief Calibrated A/C-weighted level meter running at the acquisition rate.
+ *
+ * Produces LAeq (A-weighted energy average) and LCpeak (C-weighted absolute
+ * peak) in dB SPL over each LEQ_PERIOD_MS integration period.
+ */
+class SoundLevelMeter
+{
+public:
+    SoundLevelMeter();
+
+    void process(const uint16_t *samples, size_t count);
+    void reset();
+
+    bool has_levels() const { return m_has_levels; }
+    float get_laeq() const { return m_laeq_db; }
+    float get_lcpeak() const { return m_lcpeak_db; }
+
+    // Offset from 20*log10(amplitude in ADC counts) to dB SPL
+    static float calibration_db();
+
+private:
+    static constexpr uint32_t PERIOD_SAMPLES =
+        config::adc::acquisition::SAMPLE_RATE_HZ *
+        config::signal_processing::levels::LEQ_PERIOD_MS / 1000;
+
+    weighting::Biquad m_highpass{weighting::HIGHPASS};
+    weighting::Biquad m_lowpass{weighting::LOWPASS};
+    weighting::Biquad m_midband{weighting::MIDBAND};
+
+    float m_calibration_db;
+    float m_dc_offset{0.0f};
+    bool m_primed{false};
+
+    float m_a_energy{0.0f};
+    float m_c_peak{0.0f};
+    uint32_t m_period_samples{0};
+
+    bool m_has_levels{false};
+    float m_laeq_db{config::signal_processing::levels::FLOOR_DB};
+    float m_lcpeak_db{config::signal_processing::levels::FLOOR_DB};
+
+    void finish_period();
+    float to_db(float amplitude_counts) const;
+};
\ No newline at end of file
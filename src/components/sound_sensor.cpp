@@ -8,6 +8,48 @@ void SoundSensor::begin()
     configure_adc();
 }
 
+/**
+ * @brief Initialize the sound sensor in continuous acquisition mode.
+ * @param source The block source feeding the sensor (DMA on device, replay on host).
+ * @param sample_rate_hz The acquisition rate.
+ * @return True if the source started, false otherwise.
+ */
+bool SoundSensor::begin(AudioSource &source, uint32_t sample_rate_hz)
+{
+    if (!source.begin(sample_rate_hz))
+    {
+        m_source_ptr = nullptr;
+        return false;
+    }
+
+    m_source_ptr = &source;
+    return true;
+}
+
+/**
+ * @brief Fetch the next complete block of samples without blocking.
+ * @param block The block to fill.
+ * @return True if a complete block is available, false otherwise.
+ */
+bool SoundSensor::read_block(SampleBlock &block)
+{
+    if (!m_source_ptr)
+    {
+        return false;
+    }
+
+    return m_source_ptr->read_block(block);
+}
+
+/**
+ * @brief Get throughput and dropped-block counters of the acquisition source.
+ * @return The statistics, or nullptr when running in polled mode.
+ */
+const AudioSource::Stats *SoundSensor::get_acquisition_stats() const
+{
+    return m_source_ptr ? &m_source_ptr->get_stats() : nullptr;
+}
+
 /**
  * @brief Configure the ADC for the sound sensor.
  */
@@ -16,15 +58,16 @@ void SoundSensor::configure_adc()
     // Configure ADC for 12-bit resolution
     analogReadResolution(config::adc::RESOLUTION_BITS);
 
-    // Set attenuation to 0db for maximum sensitivity
-    analogSetAttenuation(ADC_0db);
+    // Same attenuation as the DMA path, which the level calibration assumes
+    analogSetAttenuation(static_cast<adc_attenuation_t>(config::adc::sound_sensor::ATTENUATION));
 
     // Optimize ADC for fast sampling
     analogSetClockDiv(1); // Fastest ADC clock
     analogSetWidth(12);   // Ensure 12-bit resolution
 
     // Set pin-specific attenuation
-    analogSetPinAttenuation(config::hardware::pins::analog::SOUND_SENSOR, ADC_0db);
+    analogSetPinAttenuation(config::hardware::pins::analog::SOUND_SENSOR,
+                            static_cast<adc_attenuation_t>(config::adc::sound_sensor::ATTENUATION));
 }
 
 /**
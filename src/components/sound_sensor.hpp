@@ -2,6 +2,7 @@
 
 #include <Arduino.h>
 #include "config/config.h"
+#include "audio_source.hpp"
 
 /**
  * @brief Class representing the sound sensor.
@@ -12,9 +13,18 @@ public:
     SoundSensor() = default;
     void begin();
 
+    // Continuous mode: samples arrive in blocks from the given source
+    bool begin(AudioSource &source,
+               uint32_t sample_rate_hz = config::adc::acquisition::SAMPLE_RATE_HZ);
+    bool is_continuous() const { return m_source_ptr != nullptr; }
+    bool read_block(SampleBlock &block);
+    const AudioSource::Stats *get_acquisition_stats() const;
+
     // Takes multiple samples and returns their average
     uint16_t read_averaged_sample(uint8_t num_samples = config::adc::AVERAGING_SAMPLES);
 
 private:
+    AudioSource *m_source_ptr{nullptr};
+
     void configure_adc();
 };
\ No newline at end of file
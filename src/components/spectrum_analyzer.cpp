@@ -0,0 +1,276 @@
+#include "spectrum_analyzer.hpp"
+#include <Arduino.h>
+#include <math.h>
+#include "sound_level_meter.hpp"
+#include "esp_log.h"
+
+namespace
+{
+    // Input is normalised below this, and a stage is halved once its input reaches it
+    constexpr int32_t HEADROOM_LIMIT = 1 << 14;
+
+    int32_t abs32(int32_t value)
+    {
+        return value < 0 ? -value : value;
+    }
+
+    int bit_length(uint32_t value)
+    {
+        int bits = 0;
+        while (value)
+        {
+            bits++;
+            value >>= 1;
+        }
+        return bits;
+    }
+}
+
+/**
+ * @brief Append acquisition samples to the frame ring.
+ * @param samples The raw ADC values, at the acquisition rate.
+ * @param count The number of samples.
+ */
+void SpectrumAnalyzer::push(const uint16_t *samples, size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        m_ring[m_write_pos] = samples[i];
+        m_write_pos = (m_write_pos + 1) % spectrum::FFT_SIZE;
+    }
+
+    m_samples_seen += count;
+    m_since_hop += count;
+
+    // Wait for one full frame before the first analysis
+    while (m_samples_seen >= spectrum::FFT_SIZE &&
+           m_since_hop >= config::signal_processing::spectrum::HOP_SIZE)
+    {
+        m_since_hop -= config::signal_processing::spectrum::HOP_SIZE;
+
+        // Hops passing before the first analysis are the boot backlog draining, not a missed deadline
+        if (m_frame_pending && m_stats.frames_analyzed > 0)
+        {
+            m_stats.frames_skipped++;
+        }
+        m_frame_pending = true;
+    }
+}
+
+/**
+ * @brief Analyze the most recent frame if a hop has elapsed.
+ * @return True if new band levels were produced, false otherwise.
+ */
+bool SpectrumAnalyzer::analyze()
+{
+    if (!m_frame_pending)
+    {
+        return false;
+    }
+    m_frame_pending = false;
+
+    uint32_t start_us = micros();
+
+    int input_shift = load_frame();
+    int exponent = transform() - input_shift;
+    accumulate_bands(exponent);
+
+    m_stats.last_fft_us = micros() - start_us;
+    m_stats.max_fft_us = std::max(m_stats.max_fft_us, m_stats.last_fft_us);
+    m_stats.frames_analyzed++;
+
+    if (!m_budget_warned && get_load_percent() > config::signal_processing::spectrum::MAX_LOAD_PERCENT)
+    {
+        ESP_LOGW(TAG, "Spectrum over budget: %u us per %u us hop, %u frames skipped",
+                 m_stats.max_fft_us, HOP_PERIOD_US, m_stats.frames_skipped);
+        m_budget_warned = true;
+    }
+    return true;
+}
+
+/**
+ * @brief Centre frequency of an octave band.
+ * @param band The band index.
+ * @return The exact base-2 centre frequency in Hz.
+ */
+float SpectrumAnalyzer::octave_center_hz(size_t band)
+{
+    return spectrum::band_center_hz(spectrum::OCTAVE_FIRST_INDEX + static_cast<int>(band), 1);
+}
+
+/**
+ * @brief Centre frequency of a third-octave band.
+ * @param band The band index.
+ * @return The exact base-2 centre frequency in Hz.
+ */
+float SpectrumAnalyzer::third_octave_center_hz(size_t band)
+{
+    return spectrum::band_center_hz(spectrum::THIRD_OCTAVE_FIRST_INDEX + static_cast<int>(band), 3);
+}
+
+/**
+ * @brief Worst-case FFT time as a share of the hop period.
+ * @return The load in percent.
+ */
+uint8_t SpectrumAnalyzer::get_load_percent() const
+{
+    return static_cast<uint8_t>(std::min<uint32_t>(100, m_stats.max_fft_us * 100 / HOP_PERIOD_US));
+}
+
+/**
+ * @brief Check the analyzer keeps up with acquisition without crowding out other tasks.
+ * @return True if no hop was skipped and the load is within MAX_LOAD_PERCENT.
+ */
+bool SpectrumAnalyzer::is_within_budget() const
+{
+    return m_stats.frames_skipped == 0 &&
+           get_load_percent() <= config::signal_processing::spectrum::MAX_LOAD_PERCENT;
+}
+
+/**
+ * @brief Copy the newest frame out of the ring, remove DC, normalise and window it.
+ *
+ * Even samples go to the real part and odd samples to the imaginary part, in
+ * bit-reversed order, ready for the in-place half-length complex FFT.
+ * @return The left shift applied to use the available headroom.
+ */
+int SpectrumAnalyzer::load_frame()
+{
+    int32_t sum = 0;
+    for (size_t n = 0; n < spectrum::FFT_SIZE; n++)
+    {
+        sum += m_ring[n];
+    }
+    int32_t mean = sum / static_cast<int32_t>(spectrum::FFT_SIZE);
+
+    int32_t peak = 0;
+    for (size_t n = 0; n < spectrum::FFT_SIZE; n++)
+    {
+        peak = std::max(peak, abs32(m_ring[n] - mean));
+    }
+    int shift = std::max(0, bit_length(HEADROOM_LIMIT - 1) - bit_length(peak));
+
+    size_t bits = bit_length(spectrum::HALF_SIZE) - 1;
+    for (size_t i = 0; i < spectrum::HALF_SIZE; i++)
+    {
+        size_t reversed = 0;
+        for (size_t b = 0; b < bits; b++)
+        {
+            reversed |= ((i >> b) & 1) << (bits - 1 - b);
+        }
+
+        // The oldest sample sits at the write position
+        size_t n = 2 * reversed;
+        size_t even = (m_write_pos + n) % spectrum::FFT_SIZE;
+        size_t odd = (m_write_pos + n + 1) % spectrum::FFT_SIZE;
+        m_re[i] = (((m_ring[even] - mean) << shift) * spectrum::WINDOW[n]) >> 15;
+        m_im[i] = (((m_ring[odd] - mean) << shift) * spectrum::WINDOW[n + 1]) >> 15;
+    }
+    return shift;
+}
+
+/**
+ * @brief In-place radix-2 decimation-in-time FFT over the packed frame.
+ * @return The number of stages that were scaled by 1/2.
+ */
+int SpectrumAnalyzer::transform()
+{
+    int scaled_stages = 0;
+
+    for (size_t span = 1; span < spectrum::HALF_SIZE; span <<= 1)
+    {
+        int32_t peak = 0;
+        for (size_t i = 0; i < spectrum::HALF_SIZE; i++)
+        {
+            peak = std::max(peak, std::max(abs32(m_re[i]), abs32(m_im[i])));
+        }
+        int scale = peak >= HEADROOM_LIMIT ? 1 : 0;
+        scaled_stages += scale;
+
+        // Twiddle W = exp(-2*pi*i*k / (2*span)) is entry k * stride of the N-point table
+        size_t stride = spectrum::FFT_SIZE / (2 * span);
+        for (size_t k = 0; k < span; k++)
+        {
+            int32_t c = spectrum::COS_TABLE[k * stride];
+            int32_t s = spectrum::SIN_TABLE[k * stride];
+
+            for (size_t i = k; i < spectrum::HALF_SIZE; i += 2 * span)
+            {
+                size_t j = i + span;
+                int32_t tr = static_cast<int32_t>((int64_t(c) * m_re[j] + int64_t(s) * m_im[j]) >> 15);
+                int32_t ti = static_cast<int32_t>((int64_t(c) * m_im[j] - int64_t(s) * m_re[j]) >> 15);
+                m_re[j] = (m_re[i] - tr) >> scale;
+                m_im[j] = (m_im[i] - ti) >> scale;
+                m_re[i] = (m_re[i] + tr) >> scale;
+                m_im[i] = (m_im[i] + ti) >> scale;
+            }
+        }
+    }
+
+    return scaled_stages;
+}
+
+/**
+ * @brief Split the packed transform into the real spectrum and sum bin powers per band.
+ * @param exponent Power-of-two scale between the computed and the true spectrum.
+ */
+void SpectrumAnalyzer::accumulate_bands(int exponent)
+{
+    uint64_t octave_power[spectrum::OCTAVE_BANDS] = {};
+    uint64_t third_octave_power[spectrum::THIRD_OCTAVE_BANDS] = {};
+
+    for (size_t k = 0; k < spectrum::NUM_BINS; k++)
+    {
+        int32_t xr;
+        int32_t xi;
+        if (k == 0 || k == spectrum::HALF_SIZE)
+        {
+            // DC and Nyquist are the sum and difference of the packed bin 0
+            xr = k == 0 ? m_re[0] + m_im[0] : m_re[0] - m_im[0];
+            xi = 0;
+        }
+        else
+        {
+            // X[k] = (Z[k] + Z*[M-k]) / 2 + W^k (Z[k] - Z*[M-k]) / 2i
+            size_t m = spectrum::HALF_SIZE - k;
+            int32_t even_r = (m_re[k] + m_re[m]) >> 1;
+            int32_t even_i = (m_im[k] - m_im[m]) >> 1;
+            int32_t odd_r = (m_im[k] + m_im[m]) >> 1;
+            int32_t odd_i = (m_re[m] - m_re[k]) >> 1;
+            int32_t c = spectrum::COS_TABLE[k];
+            int32_t s = spectrum::SIN_TABLE[k];
+            xr = even_r + static_cast<int32_t>((int64_t(c) * odd_r + int64_t(s) * odd_i) >> 15);
+            xi = even_i + static_cast<int32_t>((int64_t(c) * odd_i - int64_t(s) * odd_r) >> 15);
+        }
+
+        uint64_t power = uint64_t(int64_t(xr) * xr) + uint64_t(int64_t(xi) * xi);
+        if (spectrum::OCTAVE_BIN_MAP[k] >= 0)
+        {
+            octave_power[spectrum::OCTAVE_BIN_MAP[k]] += power;
+        }
+        if (spectrum::THIRD_OCTAVE_BIN_MAP[k] >= 0)
+        {
+            third_octave_power[spectrum::THIRD_OCTAVE_BIN_MAP[k]] += power;
+        }
+    }
+
+    // One-sided Parseval: mean square = 2 * sum|X|^2 / (N * sum w^2), in ADC counts^2
+    const float to_mean_square = ldexpf(2.0f / (spectrum::FFT_SIZE * spectrum::WINDOW_POWER),
+                                        2 * exponent);
+    const float calibration_db = SoundLevelMeter::calibration_db();
+    auto to_db = [&](uint64_t power)
+    {
+        float mean_square = static_cast<float>(power) * to_mean_square;
+        return mean_square > 0.0f ? 10.0f * log10f(mean_square) + calibration_db
+                                  : config::signal_processing::levels::FLOOR_DB;
+    };
+
+    for (size_t b = 0; b < spectrum::OCTAVE_BANDS; b++)
+    {
+        m_octave_db[b] = to_db(octave_power[b]);
+    }
+    for (size_t b = 0; b < spectrum::THIRD_OCTAVE_BANDS; b++)
+    {
+        m_third_octave_db[b] = to_db(third_octave_power[b]);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,195 @@
+#pragma once
+
+#include <array>
+#include <stddef.h>
+#include <stdint.h>
+#include "config/config.h"
+#include "dsp_math.hpp"
+
+/**
+ * @brief Compile-time tables for the fixed-point spectrum analyzer.
+ */
+namespace spectrum
+{
+    constexpr size_t FFT_SIZE = config::signal_processing::spectrum::FFT_SIZE;
+    constexpr size_t HALF_SIZE = FFT_SIZE / 2; // Complex FFT length of the packed real input
+    constexpr size_t NUM_BINS = HALF_SIZE + 1;
+    constexpr double SAMPLE_RATE_HZ = config::adc::acquisition::SAMPLE_RATE_HZ;
+
+    constexpr int16_t to_q15(double value)
+    {
+        return value >= 1.0 ? INT16_MAX : static_cast<int16_t>(value * 32768.0 + (value < 0 ? -0.5 : 0.5));
+    }
+
+    // Periodic Hann window, the usual choice for overlapped spectral analysis
+    constexpr std::array<int16_t, FFT_SIZE> make_window()
+    {
+        std::array<int16_t, FFT_SIZE> table{};
+        for (size_t n = 0; n < FFT_SIZE; n++)
+        {
+            table[n] = to_q15(0.5 - 0.5 * dsp_math::cos(2.0 * dsp_math::PI * n / FFT_SIZE));
+        }
+        return table;
+    }
+
+    constexpr double window_power(const std::array<int16_t, FFT_SIZE> &window)
+    {
+        double sum = 0.0;
+        for (size_t n = 0; n < FFT_SIZE; n++)
+        {
+            sum += (window[n] / 32768.0) * (window[n] / 32768.0);
+        }
+        return sum;
+    }
+
+    // cos/sin(2*pi*k/FFT_SIZE), shared by the complex FFT (stride 2) and the real split
+    constexpr std::array<int16_t, HALF_SIZE> make_cos_table()
+    {
+        std::array<int16_t, HALF_SIZE> table{};
+        for (size_t k = 0; k < HALF_SIZE; k++)
+        {
+            table[k] = to_q15(dsp_math::cos(2.0 * dsp_math::PI * k / FFT_SIZE));
+        }
+        return table;
+    }
+
+    constexpr std::array<int16_t, HALF_SIZE> make_sin_table()
+    {
+        std::array<int16_t, HALF_SIZE> table{};
+        for (size_t k = 0; k < HALF_SIZE; k++)
+        {
+            table[k] = to_q15(dsp_math::sin(2.0 * dsp_math::PI * k / FFT_SIZE));
+        }
+        return table;
+    }
+
+    constexpr std::array<int16_t, FFT_SIZE> WINDOW = make_window();
+    constexpr double WINDOW_POWER = window_power(WINDOW);
+    constexpr std::array<int16_t, HALF_SIZE> COS_TABLE = make_cos_table();
+    constexpr std::array<int16_t, HALF_SIZE> SIN_TABLE = make_sin_table();
+
+    /**
+     * Base-2 fractional-octave bands around 1kHz (IEC 61260): band i has centre
+     * 1000 * 2^((FIRST_INDEX + i) / BANDS_PER_OCTAVE). Only bands whose upper
+     * edge fits below Nyquist are produced.
+     */
+    constexpr double band_center_hz(int index, int bands_per_octave)
+    {
+        return 1000.0 * dsp_math::exp2(static_cast<double>(index) / bands_per_octave);
+    }
+
+    constexpr double band_edge_hz(int index, int bands_per_octave, double side)
+    {
+        return band_center_hz(index, bands_per_octave) *
+               dsp_math::exp2(side / (2.0 * bands_per_octave));
+    }
+
+    constexpr size_t count_bands(int first_index, int bands_per_octave)
+    {
+        size_t count = 0;
+        while (band_edge_hz(first_index + static_cast<int>(count), bands_per_octave, 1.0) <=
+               SAMPLE_RATE_HZ / 2.0)
+        {
+            count++;
+        }
+        return count;
+    }
+
+    // Band index of every FFT bin, -1 for bins outside all bands
+    constexpr std::array<int8_t, NUM_BINS> make_bin_map(int first_index, int bands_per_octave,
+                                                        size_t num_bands)
+    {
+        std::array<int8_t, NUM_BINS> map{};
+        for (size_t k = 0; k < NUM_BINS; k++)
+        {
+            double f = k * SAMPLE_RATE_HZ / FFT_SIZE;
+            map[k] = -1;
+            for (size_t b = 0; b < num_bands; b++)
+            {
+                int index = first_index + static_cast<int>(b);
+                if (f >= band_edge_hz(index, bands_per_octave, -1.0) &&
+                    f < band_edge_hz(index, bands_per_octave, 1.0))
+                {
+                    map[k] = static_cast<int8_t>(b);
+                    break;
+                }
+            }
+        }
+        return map;
+    }
+
+    constexpr int OCTAVE_FIRST_INDEX = -5;        // 31.5Hz
+    constexpr int THIRD_OCTAVE_FIRST_INDEX = -16; // 25Hz
+    constexpr size_t OCTAVE_BANDS = count_bands(OCTAVE_FIRST_INDEX, 1);
+    constexpr size_t THIRD_OCTAVE_BANDS = count_bands(THIRD_OCTAVE_FIRST_INDEX, 3);
+    constexpr std::array<int8_t, NUM_BINS> OCTAVE_BIN_MAP =
+        make_bin_map(OCTAVE_FIRST_INDEX, 1, OCTAVE_BANDS);
+    constexpr std::array<int8_t, NUM_BINS> THIRD_OCTAVE_BIN_MAP =
+        make_bin_map(THIRD_OCTAVE_FIRST_INDEX, 3, THIRD_OCTAVE_BANDS);
+
+    static_assert(OCTAVE_BANDS > 0 && THIRD_OCTAVE_BANDS > 0, "No bands fit below Nyquist");
+    static_assert(THIRD_OCTAVE_BANDS < INT8_MAX, "Band map entries are int8_t");
+}
+
+/**
+ * @brief Fixed-point radix-2 real FFT producing octave and third-octave band levels.
+ *
+ * Samples are collected in a frame ring; every HOP_SIZE samples a frame becomes
+ * pending and analyze() turns it into band levels. The FFT packs the real
+ * frame into a half-length complex transform on int32 data with Q15 twiddles,
+ * scaling a stage by 1/2 only when its input nears the headroom limit (block
+ * floating point), so quiet bands keep their resolution. All memory is static.
+ */
+class SpectrumAnalyzer
+{
+public:
+    struct Stats
+    {
+        uint32_t frames_analyzed{0};
+        uint32_t frames_skipped{0}; // Hops that elapsed while a frame was still pending, after the first analysis
+        uint32_t last_fft_us{0};
+        uint32_t max_fft_us{0};
+    };
+
+    SpectrumAnalyzer() = default;
+
+    void push(const uint16_t *samples, size_t count);
+    bool analyze();
+
+    bool has_spectrum() const { return m_stats.frames_analyzed > 0; }
+    const std::array<float, spectrum::OCTAVE_BANDS> &get_octave_levels() const { return m_octave_db; }
+    const std::array<float, spectrum::THIRD_OCTAVE_BANDS> &get_third_octave_levels() const
+    {
+        return m_third_octave_db;
+    }
+    static float octave_center_hz(size_t band);
+    static float third_octave_center_hz(size_t band);
+
+    const Stats &get_stats() const { return m_stats; }
+    uint8_t get_load_percent() const;
+    bool is_within_budget() const;
+
+private:
+    static constexpr uint32_t HOP_PERIOD_US = static_cast<uint32_t>(
+        uint64_t(config::signal_processing::spectrum::HOP_SIZE) * 1000000 /
+        config::adc::acquisition::SAMPLE_RATE_HZ);
+    static constexpr char const *TAG = "SpectrumAnalyzer";
+
+    uint16_t m_ring[spectrum::FFT_SIZE]{};
+    size_t m_write_pos{0};
+    size_t m_samples_seen{0};
+    size_t m_since_hop{0};
+    bool m_frame_pending{false};
+
+    int32_t m_re[spectrum::HALF_SIZE];
+    int32_t m_im[spectrum::HALF_SIZE];
+
+    std::array<float, spectrum::OCTAVE_BANDS> m_octave_db{};
+    std::array<float, spectrum::THIRD_OCTAVE_BANDS> m_third_octave_db{};
+    Stats m_stats;
+    bool m_budget_warned{false};
+
+    int load_frame();
+    int transform();
+    void accumulate_bands(int exponent);
+};
\ No newline at end of file
@@ -0,0 +1,129 @@
+#include "spi_arbiter.hpp"
+#include <algorithm>
+
+namespace
+{
+    uint64_t elapsed_us(std::chrono::steady_clock::time_point since, std::chrono::steady_clock::time_point now)
+    {
+        return std::chrono::duration_cast<std::chrono::microseconds>(now - since).count();
+    }
+}
+
+/**
+ * @brief Wait for the bus, behind any higher-priority device that is waiting.
+ * @param device The device about to use the bus.
+ * @param timeout_ms Longest wait, or WAIT_FOREVER.
+ * @return True if the bus is held and must be released, false on timeout.
+ */
+bool SpiArbiter::acquire(Device device, uint32_t timeout_ms)
+{
+    uint8_t index = static_cast<uint8_t>(device);
+    std::unique_lock<std::mutex> lock(m_mutex);
+    DeviceStats &stats = m_stats[index];
+
+    Clock::time_point start = Clock::now();
+    if (m_busy || !is_next(index))
+    {
+        stats.contended++;
+        m_waiting[index]++;
+
+        auto ready = [&] { return !m_busy && is_next(index); };
+        bool granted = true;
+        if (timeout_ms == WAIT_FOREVER)
+        {
+            m_released.wait(lock, ready);
+        }
+        else
+        {
+            granted = m_released.wait_for(lock, std::chrono::milliseconds(timeout_ms), ready);
+        }
+        m_waiting[index]--;
+
+        uint32_t waited = static_cast<uint32_t>(elapsed_us(start, Clock::now()));
+        stats.wait_us += waited;
+        stats.max_wait_us = std::max(stats.max_wait_us, waited);
+        if (!granted)
+        {
+            stats.timeouts++;
+            // A lower-priority device may have been held back by this waiter
+            m_released.notify_all();
+            return false;
+        }
+    }
+
+    m_busy = true;
+    m_hold_start = Clock::now();
+    stats.acquisitions++;
+    return true;
+}
+
+/**
+ * @brief Free the bus and wake the waiting devices.
+ * @param device The device that held the bus.
+ */
+void SpiArbiter::release(Device device)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        DeviceStats &stats = m_stats[static_cast<uint8_t>(device)];
+        uint32_t held = static_cast<uint32_t>(elapsed_us(m_hold_start, Clock::now()));
+        stats.busy_us += held;
+        stats.max_hold_us = std::max(stats.max_hold_us, held);
+        m_busy = false;
+    }
+    m_released.notify_all();
+}
+
+/**
+ * @brief Bus statistics of one device.
+ * @param device The device.
+ * @return A copy of its statistics.
+ */
+SpiArbiter::DeviceStats SpiArbiter::get_stats(Device device) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats[static_cast<uint8_t>(device)];
+}
+
+/**
+ * @brief Share of time a device held the bus since the statistics were reset.
+ * @param device The device.
+ * @return The utilisation in percent.
+ */
+uint8_t SpiArbiter::get_utilisation_percent(Device device) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    uint64_t total = elapsed_us(m_stats_start, Clock::now());
+    uint64_t busy = m_stats[static_cast<uint8_t>(device)].busy_us;
+    return total ? static_cast<uint8_t>(std::min<uint64_t>(100, busy * 100 / total)) : 0;
+}
+
+/**
+ * @brief Start a new statistics period.
+ */
+void SpiArbiter::reset_stats()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    for (DeviceStats &stats : m_stats)
+    {
+        stats = DeviceStats();
+    }
+    m_stats_start = Clock::now();
+}
+
+/**
+ * @brief Check that no device with a higher priority is waiting.
+ * @param index The device index.
+ * @return True if the device may take the bus once it is free.
+ */
+bool SpiArbiter::is_next(uint8_t index) const
+{
+    for (uint8_t i = 0; i < index; i++)
+    {
+        if (m_waiting[i] > 0)
+        {
+            return false;
+        }
+    }
+    return true;
+}
\ No newline at end of file
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <stdint.h>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+
+/**
+ * @brief Priority arbiter for the SPI bus shared by the display and the SD card.
+ *
+ * Every device operation on the bus (a display tile push, one bounded chunk
+ * of SD sectors, a read) runs under a Lease. When the bus frees up, the
+ * waiting device with the highest priority goes next, so a queue of SD
+ * writes delays a display push by at most one chunk. Sampling never waits
+ * here; it runs on its own core and uses no SPI.
+ *
+ * std::mutex and std::condition_variable, so it works on FreeRTOS and on a host.
+ */
+class SpiArbiter
+{
+public:
+    // In priority order, highest first
+    enum class Device : uint8_t
+    {
+        DISPLAY,
+        SD,
+        COUNT
+    };
+
+    struct DeviceStats
+    {
+        uint32_t acquisitions{0};
+        uint32_t contended{0}; // Acquisitions that had to wait
+        uint32_t timeouts{0};
+        uint64_t busy_us{0};   // Time holding the bus
+        uint32_t max_hold_us{0};
+        uint64_t wait_us{0};   // Time queued for the bus
+        uint32_t max_wait_us{0};
+    };
+
+    static constexpr uint32_t WAIT_FOREVER = UINT32_MAX;
+
+    /**
+     * @brief Holds the bus for one device operation.
+     */
+    class Lease
+    {
+    public:
+        explicit Lease(Device device, uint32_t timeout_ms = WAIT_FOREVER)
+            : m_device(device), m_held(SpiArbiter::instance().acquire(device, timeout_ms)) {}
+        ~Lease()
+        {
+            if (m_held)
+            {
+                SpiArbiter::instance().release(m_device);
+            }
+        }
+        Lease(const Lease &) = delete;
+        Lease &operator=(const Lease &) = delete;
+
+        bool is_held() const { return m_held; }
+
+    private:
+        Device m_device;
+        bool m_held;
+    };
+
+    static SpiArbiter &instance()
+    {
+        static SpiArbiter instance;
+        return instance;
+    }
+
+    bool acquire(Device device, uint32_t timeout_ms = WAIT_FOREVER);
+    void release(Device device);
+
+    DeviceStats get_stats(Device device) const;
+    uint8_t get_utilisation_percent(Device device) const;
+    void reset_stats();
+
+private:
+    using Clock = std::chrono::steady_clock;
+    static constexpr uint8_t NUM_DEVICES = static_cast<uint8_t>(Device::COUNT);
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_released;
+    bool m_busy{false};
+    uint8_t m_waiting[NUM_DEVICES]{};
+    Clock::time_point m_hold_start;
+    Clock::time_point m_stats_start{Clock::now()};
+    DeviceStats m_stats[NUM_DEVICES];
+
+    SpiArbiter() = default;
+    bool is_next(uint8_t index) const;
+};
\ No newline at end of file
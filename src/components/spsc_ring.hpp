@@ -0,0 +1,96 @@
+#pragma once
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Lock-free single-producer/single-consumer ring buffer.
+ *
+ * Portable C++ (std::atomic only), so the same queue runs between FreeRTOS
+ * tasks on the device and std::threads on the host. The producer never
+ * blocks: when the ring is full the new item is dropped and counted, which
+ * keeps acquisition running even if a consumer stalls.
+ */
+template <typename T, size_t CAPACITY>
+class SpscRing
+{
+public:
+    static_assert(CAPACITY >= 2 && (CAPACITY & (CAPACITY - 1)) == 0,
+                  "Capacity must be a power of two");
+
+    struct Stats
+    {
+        uint32_t pushed;
+        uint32_t popped;
+        uint32_t overflows;
+        uint32_t high_water; // Deepest fill level seen by the producer
+    };
+
+    // Producer side
+    bool push(const T &item)
+    {
+        uint32_t head = m_head.load(std::memory_order_relaxed);
+        uint32_t tail = m_tail.load(std::memory_order_acquire);
+        uint32_t depth = head - tail;
+        if (depth >= CAPACITY)
+        {
+            m_overflows.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        m_items[head & MASK] = item;
+        m_head.store(head + 1, std::memory_order_release);
+        m_pushed.fetch_add(1, std::memory_order_relaxed);
+
+        if (depth + 1 > m_high_water.load(std::memory_order_relaxed))
+        {
+            m_high_water.store(depth + 1, std::memory_order_relaxed);
+        }
+        return true;
+    }
+
+    // Consumer side
+    bool pop(T &item)
+    {
+        uint32_t tail = m_tail.load(std::memory_order_relaxed);
+        uint32_t head = m_head.load(std::memory_order_acquire);
+        if (head == tail)
+        {
+            return false;
+        }
+
+        item = m_items[tail & MASK];
+        m_tail.store(tail + 1, std::memory_order_release);
+        m_popped.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // Either side; only a snapshot while the other side is running
+    size_t size() const
+    {
+        return m_head.load(std::memory_order_acquire) - m_tail.load(std::memory_order_acquire);
+    }
+
+    Stats get_stats() const
+    {
+        return {m_pushed.load(std::memory_order_relaxed),
+                m_popped.load(std::memory_order_relaxed),
+                m_overflows.load(std::memory_order_relaxed),
+                m_high_water.load(std::memory_order_relaxed)};
+    }
+
+private:
+    static constexpr uint32_t MASK = CAPACITY - 1;
+
+    T m_items[CAPACITY];
+
+    // Free-running indices; unsigned wrap keeps head - tail correct
+    std::atomic<uint32_t> m_head{0};
+    std::atomic<uint32_t> m_tail{0};
+
+    std::atomic<uint32_t> m_pushed{0};
+    std::atomic<uint32_t> m_popped{0};
+    std::atomic<uint32_t> m_overflows{0};
+    std::atomic<uint32_t> m_high_water{0};
+};
\ No newline at end of file
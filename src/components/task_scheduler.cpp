@@ -0,0 +1,152 @@
+#include "task_scheduler.hpp"
+#include <algorithm>
+
+/**
+ * @brief Register a periodic task; its first run is due one period from now.
+ * @param task_config Name, period, priority, budget and late policy.
+ * @param fn The function to run.
+ * @param context Passed to fn on every run.
+ * @return The task id, or INVALID_TASK if the scheduler is full.
+ */
+TaskScheduler::TaskId TaskScheduler::add_task(const TaskConfig &task_config, TaskFn fn, void *context)
+{
+    if (m_task_count >= config::scheduler::MAX_TASKS || task_config.period_ms == 0 || !fn)
+    {
+        return INVALID_TASK;
+    }
+
+    TaskId id = static_cast<TaskId>(m_task_count++);
+    m_tasks[id] = {task_config, fn, context, m_clock() + task_config.period_ms, {}};
+    m_queue[id] = id;
+    reschedule(id);
+    return id;
+}
+
+/**
+ * @brief Run every task whose deadline has passed, highest priority first.
+ *
+ * Each task runs at most once per call, so a task catching up cannot starve
+ * the others.
+ */
+void TaskScheduler::run_pending()
+{
+    unsigned long now = m_clock();
+
+    // The queue is deadline ordered, so the due tasks form its prefix
+    size_t due = 0;
+    while (due < m_task_count && is_due(m_tasks[m_queue[due]].deadline, now))
+    {
+        due++;
+    }
+
+    TaskId batch[config::scheduler::MAX_TASKS];
+    for (size_t i = 0; i < due; i++)
+    {
+        batch[i] = m_queue[i];
+    }
+
+    while (due > 0)
+    {
+        size_t best = 0;
+        for (size_t i = 1; i < due; i++)
+        {
+            if (m_tasks[batch[i]].config.priority > m_tasks[batch[best]].config.priority)
+            {
+                best = i;
+            }
+        }
+
+        TaskId id = batch[best];
+        batch[best] = batch[--due];
+        run_task(id, m_clock());
+    }
+}
+
+/**
+ * @brief Time until the earliest deadline, for callers that want to sleep.
+ * @return Milliseconds until the next task is due, 0 if one is already due.
+ */
+uint32_t TaskScheduler::time_until_next() const
+{
+    if (m_task_count == 0)
+    {
+        return UINT32_MAX;
+    }
+
+    unsigned long now = m_clock();
+    unsigned long deadline = m_tasks[m_queue[0]].deadline;
+    return is_due(deadline, now) ? 0 : static_cast<uint32_t>(deadline - now);
+}
+
+/**
+ * @brief Wrap-safe deadline comparison.
+ */
+bool TaskScheduler::is_due(unsigned long deadline, unsigned long now)
+{
+    return static_cast<long>(now - deadline) >= 0;
+}
+
+/**
+ * @brief Run one task, record its timing and advance its deadline.
+ * @param id The task to run.
+ * @param now Start time of the run.
+ */
+void TaskScheduler::run_task(TaskId id, unsigned long now)
+{
+    Task &task = m_tasks[id];
+    uint32_t period = task.config.period_ms;
+    uint32_t late = static_cast<uint32_t>(now - task.deadline);
+
+    task.fn(task.context);
+
+    uint32_t runtime = static_cast<uint32_t>(m_clock() - now);
+    TaskStats &stats = task.stats;
+    stats.runs++;
+    stats.last_jitter_ms = late;
+    stats.max_jitter_ms = std::max(stats.max_jitter_ms, late);
+    stats.last_runtime_ms = runtime;
+    stats.max_runtime_ms = std::max(stats.max_runtime_ms, runtime);
+    if (task.config.budget_ms > 0 && runtime > task.config.budget_ms)
+    {
+        stats.overruns++;
+    }
+
+    if (task.config.policy == Policy::SKIP)
+    {
+        uint32_t missed = late / period;
+        stats.missed_periods += missed;
+        task.deadline += (missed + 1) * period;
+    }
+    else
+    {
+        task.deadline += period;
+    }
+    reschedule(id);
+}
+
+/**
+ * @brief Move a task to its place in the deadline queue after its deadline changed.
+ * @param id The task whose deadline changed.
+ */
+void TaskScheduler::reschedule(TaskId id)
+{
+    size_t pos = 0;
+    while (m_queue[pos] != id)
+    {
+        pos++;
+    }
+    for (; pos + 1 < m_task_count; pos++)
+    {
+        m_queue[pos] = m_queue[pos + 1];
+    }
+
+    // Insert after every task due no later, so equal deadlines keep their order
+    unsigned long deadline = m_tasks[id].deadline;
+    pos = m_task_count - 1;
+    while (pos > 0 && !is_due(m_tasks[m_queue[pos - 1]].deadline, deadline))
+    {
+        m_queue[pos] = m_queue[pos - 1];
+        pos--;
+    }
+    m_queue[pos] = id;
+}
\ No newline at end of file
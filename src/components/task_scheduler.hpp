@@ -0,0 +1,82 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "config/config.h"
+
+/**
+ * @brief Cooperative scheduler for periodic tasks with deadlines.
+ *
+ * Tasks are kept in a queue ordered by their next deadline. Each call to
+ * run_pending() runs every task that is due, highest priority first, and
+ * records how late it started (jitter), how long it ran against its budget
+ * and how many periods it missed. Time comes from an injected millisecond
+ * clock, so a host build can drive it faster than real time.
+ */
+class TaskScheduler
+{
+public:
+    using ClockFn = unsigned long (*)(); // Milliseconds
+    using TaskFn = void (*)(void *context);
+    using TaskId = uint8_t;
+
+    static constexpr TaskId INVALID_TASK = UINT8_MAX;
+
+    // What to do with periods that passed while a task was late
+    enum class Policy
+    {
+        CATCH_UP, // Run once per missed period, one run per pass
+        SKIP      // Drop the missed periods and keep the original phase
+    };
+
+    struct TaskConfig
+    {
+        const char *name;
+        uint32_t period_ms;
+        uint8_t priority;   // Higher runs first when several tasks are due
+        uint32_t budget_ms; // 0 disables overrun checking
+        Policy policy;
+    };
+
+    struct TaskStats
+    {
+        uint32_t runs{0};
+        uint32_t overruns{0};       // Runs that took longer than the budget
+        uint32_t missed_periods{0}; // Periods dropped by the SKIP policy
+        uint32_t last_jitter_ms{0};
+        uint32_t max_jitter_ms{0};
+        uint32_t last_runtime_ms{0};
+        uint32_t max_runtime_ms{0};
+    };
+
+    explicit TaskScheduler(ClockFn clock) : m_clock(clock) {}
+
+    TaskId add_task(const TaskConfig &task_config, TaskFn fn, void *context);
+    void run_pending();
+    uint32_t time_until_next() const;
+
+    size_t get_task_count() const { return m_task_count; }
+    const TaskConfig &get_config(TaskId id) const { return m_tasks[id].config; }
+    const TaskStats &get_stats(TaskId id) const { return m_tasks[id].stats; }
+
+private:
+    struct Task
+    {
+        TaskConfig config;
+        TaskFn fn;
+        void *context;
+        unsigned long deadline;
+        TaskStats stats;
+    };
+
+    ClockFn m_clock;
+    Task m_tasks[config::scheduler::MAX_TASKS];
+    size_t m_task_count{0};
+
+    // Task ids sorted by deadline, earliest first
+    TaskId m_queue[config::scheduler::MAX_TASKS];
+
+    static bool is_due(unsigned long deadline, unsigned long now);
+    void run_task(TaskId id, unsigned long now);
+    void reschedule(TaskId id);
+};
\ No newline at end of file
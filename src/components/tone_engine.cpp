@@ -0,0 +1,63 @@
+#include "tone_engine.hpp"
+
+/**
+ * @brief Start a pattern, replacing any pattern that is still playing.
+ * @param pattern The pattern to play; it must outlive playback.
+ */
+void ToneEngine::play(const TonePattern &pattern)
+{
+    if (pattern.num_steps == 0 || pattern.repeats == 0)
+    {
+        stop();
+        return;
+    }
+
+    m_pattern = &pattern;
+    m_step = 0;
+    m_repeat = 0;
+    m_step_end = m_clock() + pattern.steps[0].duration_ms;
+    m_output.set_tone(pattern.steps[0].frequency_hz);
+}
+
+/**
+ * @brief Silence the output and drop the current pattern.
+ */
+void ToneEngine::stop()
+{
+    m_pattern = nullptr;
+    m_output.set_tone(0);
+}
+
+/**
+ * @brief Advance the pattern to the step that should be sounding now.
+ */
+void ToneEngine::update()
+{
+    if (!m_pattern)
+    {
+        return;
+    }
+
+    unsigned long now = m_clock();
+    if (static_cast<long>(now - m_step_end) < 0)
+    {
+        return;
+    }
+
+    // Skip over every step that ended while update() was not called
+    do
+    {
+        if (++m_step >= m_pattern->num_steps)
+        {
+            m_step = 0;
+            if (++m_repeat >= m_pattern->repeats)
+            {
+                stop();
+                return;
+            }
+        }
+        m_step_end += m_pattern->steps[m_step].duration_ms;
+    } while (static_cast<long>(now - m_step_end) >= 0);
+
+    m_output.set_tone(m_pattern->steps[m_step].frequency_hz);
+}
\ No newline at end of file
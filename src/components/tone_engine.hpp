@@ -0,0 +1,76 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief One step of a tone pattern; a frequency of 0 is silence.
+ */
+struct ToneStep
+{
+    uint16_t frequency_hz;
+    uint16_t duration_ms;
+};
+
+/**
+ * @brief Declarative tone sequence: the steps are played in order, repeats times.
+ */
+struct TonePattern
+{
+    const ToneStep *steps;
+    uint8_t num_steps;
+    uint8_t repeats;
+};
+
+template <size_t N>
+constexpr TonePattern make_tone_pattern(const ToneStep (&steps)[N], uint8_t repeats)
+{
+    static_assert(N > 0 && N <= UINT8_MAX, "A pattern needs 1-255 steps");
+    return {steps, static_cast<uint8_t>(N), repeats};
+}
+
+/**
+ * @brief Hardware-abstraction seam for a square-wave tone generator.
+ *
+ * The device implementation lets a PWM peripheral produce the waveform, so
+ * the CPU only touches the output when the frequency changes.
+ */
+class ToneOutput
+{
+public:
+    virtual ~ToneOutput() = default;
+
+    virtual bool begin() = 0;
+
+    // 0 silences the output
+    virtual void set_tone(uint16_t frequency_hz) = 0;
+};
+
+/**
+ * @brief Non-blocking sequencer playing TonePatterns on a ToneOutput.
+ *
+ * play() only starts the first step; update() switches steps as their
+ * durations expire and returns immediately otherwise. Step boundaries are
+ * computed from the previous boundary, not from when update() ran, so a late
+ * update does not stretch the rest of the pattern.
+ */
+class ToneEngine
+{
+public:
+    using ClockFn = unsigned long (*)(); // Milliseconds
+
+    ToneEngine(ToneOutput &output, ClockFn clock) : m_output(output), m_clock(clock) {}
+
+    void play(const TonePattern &pattern);
+    void stop();
+    void update();
+    bool is_playing() const { return m_pattern != nullptr; }
+
+private:
+    ToneOutput &m_output;
+    ClockFn m_clock;
+    const TonePattern *m_pattern{nullptr};
+    uint8_t m_step{0};
+    uint8_t m_repeat{0};
+    unsigned long m_step_end{0};
+};
\ No newline at end of file
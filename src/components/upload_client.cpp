@@ -0,0 +1,136 @@
+#include "upload_client.hpp"
+#include "upload_payload.hpp"
+#include "esp_log.h"
+#include <algorithm>
+
+/**
+ * @brief Set up the client for one channel. Does not connect.
+ * @param channel_id The ThingSpeak channel.
+ * @param write_api_key The channel's write key; must outlive the client.
+ * @return True if the request path fits, false otherwise.
+ */
+bool UploadClient::begin(const char *channel_id, const char *write_api_key)
+{
+    m_secure_client.setInsecure(); // For ThingSpeak we can use insecure mode
+    m_http_client.setReuse(true);  // Keep-alive, end() leaves the connection open
+    m_write_api_key = write_api_key;
+
+    // The request path never changes, build it once
+    return upload_payload::build_bulk_update_path(channel_id, m_path, sizeof(m_path)) > 0;
+}
+
+/**
+ * @brief POST a batch of records as one bulk update.
+ * @param records The data points, oldest first.
+ * @param count The number of records.
+ * @return The HTTP status code, or a negative HTTPClient error.
+ */
+int UploadClient::post_batch(const UploadRecord *records, size_t count)
+{
+    size_t length = upload_payload::build_bulk_update(records, count, m_write_api_key, m_payload, sizeof(m_payload));
+    if (length == 0)
+    {
+        // Retrying cannot make it fit; report it as a client error so the batch is dropped
+        ESP_LOGE(TAG, "Payload for %zu records exceeds %zu bytes", count, sizeof(m_payload));
+        return HTTP_CODE_PAYLOAD_TOO_LARGE;
+    }
+    ESP_LOGD(TAG, "Sending %zu records: %s", count, m_payload);
+
+    ESP_LOGD(TAG, "Sending to https://%s%s", config::thingspeak::HOST, m_path);
+
+    int http_code = HTTPC_ERROR_CONNECTION_REFUSED;
+    for (uint8_t attempt = 0; attempt < 2; attempt++)
+    {
+        bool reused = false;
+        if (!open_connection(reused))
+        {
+            ESP_LOGE(TAG, "Failed to connect to %s", config::thingspeak::HOST);
+            return HTTPC_ERROR_CONNECTION_REFUSED;
+        }
+
+        if (!m_http_client.begin(m_secure_client, config::thingspeak::HOST, config::thingspeak::PORT, m_path, true))
+        {
+            ESP_LOGE(TAG, "Failed to begin HTTP client");
+            return HTTPC_ERROR_CONNECTION_REFUSED;
+        }
+
+        m_http_client.addHeader("Content-Type", "application/json");
+        http_code = m_http_client.POST(reinterpret_cast<uint8_t *>(m_payload), length);
+        m_stats.requests++;
+
+        // The server may have closed an idle kept-alive connection; retry once on a fresh one
+        if (http_code < 0 && reused)
+        {
+            ESP_LOGD(TAG, "Kept-alive connection was stale (%d), reconnecting", http_code);
+            m_stats.stale_retries++;
+            close();
+            continue;
+        }
+        break;
+    }
+
+    if (http_code == HTTP_CODE_OK || http_code == HTTP_CODE_ACCEPTED)
+    {
+        // The body is discarded by end(); nothing in it is needed
+        ESP_LOGD(TAG, "ThingSpeak accepted %zu records", count);
+    }
+    else
+    {
+        // Retries and backoff are up to the worker
+        ESP_LOGW(TAG, "HTTP POST failed, code: %d", http_code);
+    }
+
+    // Keeps the connection open unless the server asked to close it
+    m_http_client.end();
+    if (http_code < 0)
+    {
+        m_secure_client.stop();
+    }
+    return http_code;
+}
+
+/**
+ * @brief Drop the connection; the next request makes a fresh one.
+ */
+void UploadClient::close()
+{
+    m_http_client.end();
+    m_secure_client.stop();
+}
+
+/**
+ * @brief Make sure a TLS connection to ThingSpeak is open, reusing a kept-alive one.
+ * @param reused Set to true if an existing connection is reused.
+ * @return True if connected, false otherwise.
+ */
+bool UploadClient::open_connection(bool &reused)
+{
+    if (m_secure_client.connected())
+    {
+        reused = true;
+        m_stats.reused++;
+        return true;
+    }
+
+    reused = false;
+    m_secure_client.stop();
+
+    uint32_t heap_before = ESP.getFreeHeap();
+    unsigned long start = millis();
+    if (!m_secure_client.connect(config::thingspeak::HOST, config::thingspeak::PORT))
+    {
+        return false;
+    }
+
+    ConnectionStats &stats = m_stats;
+    stats.handshakes++;
+    stats.last_connect_ms = millis() - start;
+    stats.max_connect_ms = std::max(stats.max_connect_ms, stats.last_connect_ms);
+    uint32_t heap_after = ESP.getFreeHeap();
+    stats.tls_heap_bytes = heap_before > heap_after ? heap_before - heap_after : 0;
+    stats.min_free_heap = ESP.getMinFreeHeap();
+
+    ESP_LOGD(TAG, "TLS handshake %u ms, %u bytes held", static_cast<unsigned>(stats.last_connect_ms),
+             static_cast<unsigned>(stats.tls_heap_bytes));
+    return true;
+}
\ No newline at end of file
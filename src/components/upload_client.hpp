@@ -0,0 +1,52 @@
+#pragma once
+
+#include <Arduino.h>
+#include <HTTPClient.h>
+#include <WiFiClientSecure.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "config/config.h"
+#include "upload_worker.hpp"
+
+/**
+ * @brief HTTPS transport for ThingSpeak bulk_update requests.
+ *
+ * Owns the TLS connection and keeps it alive between requests, so a batch
+ * normally costs one request rather than a handshake. A kept-alive
+ * connection the server has closed while idle is retried once on a fresh
+ * one. The request body is built in a fixed buffer; nothing is allocated
+ * per request. Only the upload task uses it.
+ */
+class UploadClient
+{
+public:
+    struct ConnectionStats
+    {
+        uint32_t requests{0};
+        uint32_t handshakes{0};      // Fresh TLS connections
+        uint32_t reused{0};          // Requests sent on a kept-alive connection
+        uint32_t stale_retries{0};   // Kept-alive connections the server had dropped
+        uint32_t last_connect_ms{0}; // TCP connect plus TLS handshake
+        uint32_t max_connect_ms{0};
+        uint32_t tls_heap_bytes{0};  // Heap held by the open connection
+        uint32_t min_free_heap{0};   // Lowest free heap seen since boot
+    };
+
+    bool begin(const char *channel_id, const char *write_api_key);
+    int post_batch(const UploadRecord *records, size_t count);
+    void close();
+
+    const ConnectionStats &get_stats() const { return m_stats; }
+
+private:
+    HTTPClient m_http_client;
+    WiFiClientSecure m_secure_client;
+    const char *m_write_api_key{nullptr};
+    char m_payload[config::thingspeak::upload::PAYLOAD_BUFFER_SIZE];
+    char m_path[64]; // Request path, built once in begin()
+    ConnectionStats m_stats;
+
+    static constexpr char const *TAG = "UploadClient";
+
+    bool open_connection(bool &reused);
+};
\ No newline at end of file
@@ -0,0 +1,204 @@
+#include "upload_payload.hpp"
+#include <math.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <time.h>
+
+namespace
+{
+    /**
+     * @brief Appends text to a fixed buffer, remembering if anything was cut off.
+     */
+    class PayloadWriter
+    {
+    public:
+        PayloadWriter(char *buffer, size_t size) : m_buffer(buffer), m_size(size) {}
+
+        void raw(const char *text)
+        {
+            while (*text)
+            {
+                put(*text++);
+            }
+        }
+
+        // JSON string with the characters that need it escaped
+        void string(const char *text)
+        {
+            put('"');
+            for (; *text; text++)
+            {
+                if (*text == '"' || *text == '\\')
+                {
+                    put('\\');
+                }
+                if (static_cast<unsigned char>(*text) >= 0x20)
+                {
+                    put(*text);
+                }
+            }
+            put('"');
+        }
+
+        void number(float value)
+        {
+            // JSON has no NaN or infinity
+            if (!isfinite(value))
+            {
+                raw("null");
+                return;
+            }
+            format("%.2f", value);
+        }
+
+        void integer(float value)
+        {
+            if (!isfinite(value))
+            {
+                raw("null");
+                return;
+            }
+            format("%ld", lroundf(value));
+        }
+
+        // Local time, the format ThingSpeak expects in created_at
+        void timestamp(uint32_t unix_time)
+        {
+            time_t created_at = unix_time;
+            struct tm timeinfo;
+            localtime_r(&created_at, &timeinfo);
+
+            put('"');
+            if (!m_overflow)
+            {
+                size_t written = strftime(m_buffer + m_length, m_size - m_length, "%Y-%m-%d %H:%M:%S", &timeinfo);
+                m_overflow = written == 0;
+                m_length += written;
+            }
+            put('"');
+        }
+
+        void format(const char *fmt, ...)
+        {
+            if (m_overflow)
+            {
+                return;
+            }
+
+            va_list args;
+            va_start(args, fmt);
+            int written = vsnprintf(m_buffer + m_length, m_size - m_length, fmt, args);
+            va_end(args);
+
+            if (written < 0 || static_cast<size_t>(written) >= m_size - m_length)
+            {
+                m_overflow = true;
+                return;
+            }
+            m_length += written;
+        }
+
+        // Length of the NUL terminated text, 0 if it did not fit
+        size_t finish()
+        {
+            if (m_overflow || m_length >= m_size)
+            {
+                return 0;
+            }
+            m_buffer[m_length] = '\0';
+            return m_length;
+        }
+
+    private:
+        char *m_buffer;
+        size_t m_size;
+        size_t m_length{0};
+        bool m_overflow{false};
+
+        void put(char c)
+        {
+            // Keep one byte for the terminator
+            if (m_overflow || m_length + 1 >= m_size)
+            {
+                m_overflow = true;
+                return;
+            }
+            m_buffer[m_length++] = c;
+        }
+    };
+}
+
+namespace upload_payload
+{
+    /**
+     * @brief Serialize records as one bulk_update JSON body, without heap allocation.
+     * @param records The data points, oldest first.
+     * @param count The number of records.
+     * @param write_api_key The channel write key.
+     * @param buffer Output buffer, NUL terminated on success.
+     * @param size Size of the buffer.
+     * @return The body length, or 0 if it does not fit.
+     */
+    size_t build_bulk_update(const UploadRecord *records, size_t count, const char *write_api_key,
+                             char *buffer, size_t size)
+    {
+        if (!buffer || size == 0)
+        {
+            return 0;
+        }
+
+        PayloadWriter writer(buffer, size);
+        writer.raw("{\"write_api_key\":");
+        writer.string(write_api_key);
+        writer.raw(",\"updates\":[");
+
+        for (size_t i = 0; i < count; i++)
+        {
+            const UploadRecord &record = records[i];
+            if (i > 0)
+            {
+                writer.raw(",");
+            }
+
+            // Timestamp of the measurement, not of the upload
+            writer.raw("{\"created_at\":");
+            writer.timestamp(record.created_at);
+
+            for (uint8_t f = 0; f < record.num_fields; f++)
+            {
+                writer.format(",\"field%u\":", f + 1);
+                if (record.integer_fields & (1u << f))
+                {
+                    writer.integer(record.fields[f]);
+                }
+                else
+                {
+                    writer.number(record.fields[f]);
+                }
+            }
+            writer.raw("}");
+        }
+
+        writer.raw("]}");
+        return writer.finish();
+    }
+
+    /**
+     * @brief Build the bulk_update request path for a channel.
+     * @param channel_id The ThingSpeak channel id.
+     * @param buffer Output buffer, NUL terminated on success.
+     * @param size Size of the buffer.
+     * @return The path length, or 0 if it does not fit.
+     */
+    size_t build_bulk_update_path(const char *channel_id, char *buffer, size_t size)
+    {
+        if (!buffer || size == 0)
+        {
+            return 0;
+        }
+
+        PayloadWriter writer(buffer, size);
+        writer.format("/channels/%s/bulk_update.json", channel_id);
+        return writer.finish();
+    }
+}
\ No newline at end of file
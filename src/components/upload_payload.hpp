@@ -0,0 +1,18 @@
+#pragma once
+
+#include <stddef.h>
+#include "upload_worker.hpp"
+
+/**
+ * @brief ThingSpeak bulk_update request bodies.
+ *
+ * Kept apart from the HTTP client so the exact bytes sent can be checked
+ * in a host build. Everything is written straight into caller-provided
+ * buffers, so building a request never touches the heap.
+ */
+namespace upload_payload
+{
+    size_t build_bulk_update(const UploadRecord *records, size_t count, const char *write_api_key,
+                             char *buffer, size_t size);
+    size_t build_bulk_update_path(const char *channel_id, char *buffer, size_t size);
+}
\ No newline at end of file
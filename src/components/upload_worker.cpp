@@ -0,0 +1,282 @@
+#include "upload_worker.hpp"
+#include "offline_queue.hpp"
+#include <algorithm>
+
+/**
+ * @brief Constructor for the UploadWorker class.
+ * @param send Sends a batch of records, returning the HTTP status or a negative transport error.
+ * @param context Passed to send.
+ * @param clock Millisecond clock.
+ * @param seed Seed for the backoff jitter.
+ */
+UploadWorker::UploadWorker(SendFn send, void *context, ClockFn clock, uint32_t seed)
+    : m_send(send), m_context(context), m_clock(clock), m_random(seed ? seed : 1)
+{
+}
+
+/**
+ * @brief Queue a record for upload without blocking.
+ * @param record The record; enqueued_ms is stamped here.
+ * @return True if queued, false if the queue is full.
+ */
+bool UploadWorker::enqueue(const UploadRecord &record)
+{
+    UploadRecord stamped = record;
+    stamped.enqueued_ms = m_clock();
+
+    // The ring counts accepted and dropped records, so the producer never writes m_stats
+    return m_queue.push(stamped);
+}
+
+/**
+ * @brief Snapshot of the upload counters.
+ * @return The worker's counters with the producer-side counts of the queue.
+ */
+UploadWorker::Stats UploadWorker::get_stats() const
+{
+    Stats stats = m_stats;
+    auto queue = m_queue.get_stats();
+    stats.enqueued = queue.pushed;
+    stats.dropped_full = queue.overflows;
+    return stats;
+}
+
+/**
+ * @brief Run one step of the state machine, sending at most one batch.
+ *
+ * Queued records are collected into the batch until it is full or its
+ * oldest record has waited FLUSH_INTERVAL_MS; then the whole batch goes out
+ * as one request. A due live batch always goes first; backlog batches use
+ * the request slots in between.
+ * @return Milliseconds until poll() has work again, WAIT_FOREVER if idle.
+ */
+uint32_t UploadWorker::poll()
+{
+    unsigned long now = m_clock();
+
+    while (m_batch_count < config::thingspeak::upload::MAX_BATCH &&
+           m_queue.pop(m_batch[m_batch_count]))
+    {
+        m_batch_count++;
+    }
+
+    if (m_state == State::BACKOFF && static_cast<long>(now - m_next_attempt) < 0)
+    {
+        // Park full batches on storage so the ring keeps draining while offline
+        if (m_batch_count == config::thingspeak::upload::MAX_BATCH && spill_batch())
+        {
+            return 0;
+        }
+        return static_cast<uint32_t>(m_next_attempt - now);
+    }
+
+    uint32_t waited = m_batch_count > 0 ? static_cast<uint32_t>(now - m_batch[0].enqueued_ms) : 0;
+    bool live_due = m_batch_count == config::thingspeak::upload::MAX_BATCH ||
+                    (m_batch_count > 0 && waited >= config::thingspeak::upload::FLUSH_INTERVAL_MS);
+    bool backlog_ready = m_backlog && !m_backlog->is_empty();
+
+    if (!live_due && !backlog_ready)
+    {
+        if (m_batch_count == 0)
+        {
+            m_state = State::IDLE;
+            return WAIT_FOREVER;
+        }
+        m_state = State::COLLECTING;
+        return config::thingspeak::upload::FLUSH_INTERVAL_MS - waited;
+    }
+    m_state = State::READY;
+
+    // ThingSpeak rejects updates closer together than its minimum interval
+    if (m_has_sent && now - m_last_success < config::thingspeak::upload::MIN_REQUEST_INTERVAL_MS)
+    {
+        uint32_t spacing = config::thingspeak::upload::MIN_REQUEST_INTERVAL_MS - (now - m_last_success);
+        return live_due ? spacing : std::min(spacing, config::thingspeak::upload::FLUSH_INTERVAL_MS - waited);
+    }
+
+    return live_due ? send_live() : send_backlog();
+}
+
+/**
+ * @brief Send the live batch and handle the result.
+ * @return Milliseconds until poll() should run again.
+ */
+uint32_t UploadWorker::send_live()
+{
+    int status = m_send(m_context, m_batch, m_batch_count);
+    m_attempts++;
+
+    switch (classify(status))
+    {
+    case Outcome::SUCCESS:
+        m_last_success = m_clock();
+        m_has_sent = true;
+        m_stats.batches_sent++;
+        m_stats.records_sent += m_batch_count;
+        m_stats.last_latency_ms = static_cast<uint32_t>(m_last_success - m_batch[0].enqueued_ms);
+        m_stats.max_latency_ms = std::max(m_stats.max_latency_ms, m_stats.last_latency_ms);
+        finish_batch();
+        return 0;
+
+    case Outcome::RATE_LIMITED:
+        m_stats.rate_limited++;
+        m_attempts--; // The server asked us to wait; this is not a failure of the batch
+        start_backoff(std::max(config::thingspeak::upload::RATE_LIMIT_BACKOFF_MS, backoff_delay()));
+        break;
+
+    case Outcome::TRANSIENT:
+        m_stats.failed_attempts++;
+        start_backoff(backoff_delay());
+        // Keep the data on storage rather than retrying from RAM
+        if (spill_batch())
+        {
+            break;
+        }
+        if (m_attempts < config::thingspeak::upload::MAX_ATTEMPTS)
+        {
+            break;
+        }
+        m_stats.dropped_failed += m_batch_count;
+        finish_batch();
+        return 0;
+
+    case Outcome::PERMANENT:
+        m_stats.failed_attempts++;
+        m_stats.dropped_failed += m_batch_count;
+        finish_batch();
+        return 0;
+    }
+
+    return static_cast<uint32_t>(m_next_attempt - m_clock());
+}
+
+/**
+ * @brief Send the oldest backlog records and handle the result.
+ * @return Milliseconds until poll() should run again.
+ */
+uint32_t UploadWorker::send_backlog()
+{
+    size_t count = m_backlog->peek(m_replay, config::thingspeak::upload::BACKLOG_BATCH);
+    if (count == 0)
+    {
+        return 0;
+    }
+
+    int status = m_send(m_context, m_replay, count);
+    m_attempts++;
+
+    switch (classify(status))
+    {
+    case Outcome::SUCCESS:
+        m_last_success = m_clock();
+        m_has_sent = true;
+        m_attempts = 0;
+        m_stats.batches_sent++;
+        m_stats.records_sent += count;
+        m_stats.replayed += count;
+        m_backlog->pop(count);
+        return 0;
+
+    case Outcome::RATE_LIMITED:
+        m_stats.rate_limited++;
+        m_attempts--;
+        start_backoff(std::max(config::thingspeak::upload::RATE_LIMIT_BACKOFF_MS, backoff_delay()));
+        break;
+
+    case Outcome::TRANSIENT:
+        // Stored records are never dropped for being undeliverable, only evicted when full
+        m_stats.failed_attempts++;
+        start_backoff(backoff_delay());
+        break;
+
+    case Outcome::PERMANENT:
+        m_stats.failed_attempts++;
+        m_stats.dropped_failed += count;
+        m_backlog->pop(count);
+        m_attempts = 0;
+        return 0;
+    }
+
+    return static_cast<uint32_t>(m_next_attempt - m_clock());
+}
+
+/**
+ * @brief Move the live batch to the backlog.
+ * @return True if the batch was stored, false if there is no usable backlog.
+ */
+bool UploadWorker::spill_batch()
+{
+    if (!m_backlog || !m_backlog->append(m_batch, m_batch_count))
+    {
+        return false;
+    }
+    m_stats.spilled += m_batch_count;
+    m_batch_count = 0;
+    return true;
+}
+
+/**
+ * @brief Map a send result to a retry decision.
+ * @param status HTTP status code, or negative for transport errors.
+ * @return The outcome.
+ */
+UploadWorker::Outcome UploadWorker::classify(int status)
+{
+    if (status == 200 || status == 202)
+    {
+        return Outcome::SUCCESS;
+    }
+    if (status == 429)
+    {
+        return Outcome::RATE_LIMITED;
+    }
+    // Connection errors, timeouts and server errors may succeed later
+    if (status < 0 || status == 408 || status >= 500)
+    {
+        return Outcome::TRANSIENT;
+    }
+    return Outcome::PERMANENT;
+}
+
+/**
+ * @brief Exponential backoff for the current attempt with "equal jitter".
+ *
+ * Half the delay is fixed and half random, so retries from many devices
+ * spread out while each still waits at least half the nominal delay.
+ * @return The delay in ms.
+ */
+uint32_t UploadWorker::backoff_delay()
+{
+    uint8_t exponent = std::min<uint8_t>(m_attempts > 0 ? m_attempts - 1 : 0, 16);
+    uint32_t delay = std::min<uint64_t>(uint64_t(config::thingspeak::upload::RETRY_BASE_MS) << exponent,
+                                        config::thingspeak::upload::RETRY_MAX_MS);
+    uint32_t half = delay / 2;
+    return half + (half > 0 ? next_random() % (half + 1) : 0);
+}
+
+/**
+ * @brief xorshift32, plenty for jitter.
+ */
+uint32_t UploadWorker::next_random()
+{
+    m_random ^= m_random << 13;
+    m_random ^= m_random >> 17;
+    m_random ^= m_random << 5;
+    return m_random;
+}
+
+void UploadWorker::finish_batch()
+{
+    m_batch_count = 0;
+    m_attempts = 0;
+    if (m_state != State::BACKOFF)
+    {
+        m_state = State::IDLE;
+    }
+}
+
+void UploadWorker::start_backoff(uint32_t delay_ms)
+{
+    m_state = State::BACKOFF;
+    m_next_attempt = m_clock() + delay_ms;
+}
\ No newline at end of file
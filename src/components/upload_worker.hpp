@@ -0,0 +1,121 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "config/config.h"
+#include "spsc_ring.hpp"
+
+class OfflineQueue;
+
+/**
+ * @brief One timestamped data point waiting to be uploaded.
+ */
+struct UploadRecord
+{
+    uint32_t created_at{0};       // Unix time of the measurement
+    unsigned long enqueued_ms{0}; // Local clock when queued, for latency
+    uint8_t num_fields{0};
+    uint8_t integer_fields{0}; // Bit f set: fields[f] is a count or category, sent without decimals
+    float fields[config::thingspeak::MAX_FIELDS]{};
+};
+
+/**
+ * @brief Upload queue with an explicit retry/backoff state machine.
+ *
+ * enqueue() never blocks: records go into a bounded single-producer ring and
+ * are dropped (and counted) when it is full. poll() is called by the worker
+ * task; it gathers records into a batch, sends it as one bulk request
+ * through the injected send function once it is full or due, and reports how
+ * long the worker may sleep. Failed sends back off exponentially with
+ * jitter, and the batch is retried until MAX_ATTEMPTS.
+ *
+ * With a backlog attached, a batch that fails or fills up during a backoff is
+ * moved to persistent storage instead of being retried from RAM or dropped.
+ * The backlog is replayed in larger batches in the request slots the live
+ * batches leave free, so catching up never delays live data.
+ * Clock, transport and jitter seed are injected so a host build can drive it.
+ */
+class UploadWorker
+{
+public:
+    using ClockFn = unsigned long (*)(); // Milliseconds
+    // Returns the HTTP status, or <0 on transport errors
+    using SendFn = int (*)(void *context, const UploadRecord *records, size_t count);
+
+    static constexpr uint32_t WAIT_FOREVER = UINT32_MAX;
+
+    enum class State
+    {
+        IDLE,       // Nothing pending
+        COLLECTING, // Batch waiting to fill up or reach the flush interval
+        READY,      // Batch is due and may be sent now
+        BACKOFF     // Waiting before the next attempt
+    };
+
+    // enqueued and dropped_full come from the ring's producer-side counters, the rest
+    // is only written by the worker task
+    struct Stats
+    {
+        uint32_t enqueued{0};
+        uint32_t records_sent{0};
+        uint32_t batches_sent{0};
+        uint32_t failed_attempts{0};
+        uint32_t rate_limited{0};
+        uint32_t dropped_full{0};    // Rejected by enqueue()
+        uint32_t dropped_failed{0};  // Records given up after MAX_ATTEMPTS or a permanent error
+        uint32_t spilled{0};         // Records moved to the backlog
+        uint32_t replayed{0};        // Backlog records uploaded
+        uint32_t last_latency_ms{0}; // Oldest record of a batch, enqueue to successful send
+        uint32_t max_latency_ms{0};
+    };
+
+    UploadWorker(SendFn send, void *context, ClockFn clock, uint32_t seed);
+
+    // Producer side
+    bool enqueue(const UploadRecord &record);
+
+    // Worker side
+    void set_backlog(OfflineQueue *backlog) { m_backlog = backlog; }
+    uint32_t poll();
+
+    State get_state() const { return m_state; }
+    size_t get_queue_depth() const { return m_queue.size() + m_batch_count; }
+    Stats get_stats() const;
+
+private:
+    enum class Outcome
+    {
+        SUCCESS,
+        RATE_LIMITED,
+        TRANSIENT,
+        PERMANENT
+    };
+
+    SendFn m_send;
+    void *m_context;
+    ClockFn m_clock;
+    uint32_t m_random;
+
+    SpscRing<UploadRecord, config::thingspeak::upload::QUEUE_SIZE> m_queue;
+    UploadRecord m_batch[config::thingspeak::upload::MAX_BATCH];
+    size_t m_batch_count{0};
+    uint8_t m_attempts{0};
+
+    OfflineQueue *m_backlog{nullptr};
+    UploadRecord m_replay[config::thingspeak::upload::BACKLOG_BATCH];
+
+    State m_state{State::IDLE};
+    unsigned long m_next_attempt{0};
+    unsigned long m_last_success{0};
+    bool m_has_sent{false};
+    Stats m_stats;
+
+    uint32_t send_live();
+    uint32_t send_backlog();
+    bool spill_batch();
+    static Outcome classify(int status);
+    uint32_t backoff_delay();
+    uint32_t next_random();
+    void finish_batch();
+    void start_backoff(uint32_t delay_ms);
+};
\ No newline at end of file
@@ -0,0 +1,162 @@
+#pragma once
+
+#include <stdint.h>
+#include "config/config.h"
+#include "dsp_math.hpp"
+
+/**
+ * @brief IEC 61672 A- and C-weighting as cascaded biquads.
+ *
+ * The analog weighting networks factor into real first-order high/low-pass
+ * terms, whose digital equivalents need no trigonometry, so every coefficient
+ * is derived at compile time for the configured sample rate. A and C share the
+ * 20.6Hz and 12.2kHz pole pairs, so both weightings cost three biquads:
+ *
+ *   C = HIGHPASS * LOWPASS
+ *   A = HIGHPASS * LOWPASS * MIDBAND
+ */
+namespace weighting
+{
+    struct BiquadCoefficients
+    {
+        float b0;
+        float b1;
+        float b2;
+        float a1;
+        float a2;
+    };
+
+    /**
+     * @brief Second-order IIR section in transposed direct form II.
+     */
+    class Biquad
+    {
+    public:
+        constexpr explicit Biquad(const BiquadCoefficients &coefficients)
+            : m_c(coefficients) {}
+
+        float process(float x)
+        {
+            float y = m_c.b0 * x + m_z1;
+            m_z1 = m_c.b1 * x - m_c.a1 * y + m_z2;
+            m_z2 = m_c.b2 * x - m_c.a2 * y;
+            return y;
+        }
+
+        void reset() { m_z1 = m_z2 = 0.0f; }
+
+    private:
+        BiquadCoefficients m_c;
+        float m_z1{0.0f};
+        float m_z2{0.0f};
+    };
+
+    namespace design
+    {
+        // IEC 61672-1 pole frequencies
+        constexpr double F1_HZ = 20.598997;
+        constexpr double F2_HZ = 107.65265;
+        constexpr double F3_HZ = 737.86223;
+        constexpr double F4_HZ = 12194.217;
+        constexpr double REFERENCE_HZ = 1000.0;
+        constexpr double PI = dsp_math::PI;
+
+        struct FirstOrder
+        {
+            double b0;
+            double b1;
+            double a1;
+        };
+
+        // s / (s + w) through the bilinear transform
+        constexpr FirstOrder highpass(double f_hz, double fs_hz)
+        {
+            double k = 2.0 * fs_hz;
+            double w = 2.0 * PI * f_hz;
+            return {k / (k + w), -k / (k + w), -(k - w) / (k + w)};
+        }
+
+        /**
+         * w / (s + w) as a matched-pole section whose zero is placed so the
+         * magnitude at Nyquist equals the analog one. The 12.2kHz pole sits at
+         * or above Nyquist for the usual rates, where the bilinear transform
+         * would pull the response down by several dB in the top octave.
+         */
+        constexpr FirstOrder lowpass(double f_hz, double fs_hz)
+        {
+            double w = 2.0 * PI * f_hz;
+            double p = dsp_math::exp(-w / fs_hz);
+            double ratio = fs_hz / (2.0 * f_hz);
+            double t = (1.0 + p) / ((1.0 - p) * dsp_math::sqrt(1.0 + ratio * ratio));
+            double q = (1.0 - t) / (1.0 + t);
+            double dc_gain = (1.0 - p) / (1.0 + q);
+            return {dc_gain, dc_gain * q, -p};
+        }
+
+        struct Section
+        {
+            double b0, b1, b2, a1, a2;
+        };
+
+        constexpr Section cascade(const FirstOrder &p, const FirstOrder &q)
+        {
+            return {p.b0 * q.b0, p.b0 * q.b1 + p.b1 * q.b0, p.b1 * q.b1,
+                    p.a1 + q.a1, p.a1 * q.a1};
+        }
+
+        // |H(e^jw)|^2 of one section
+        constexpr double magnitude_squared(const Section &s, double f_hz, double fs_hz)
+        {
+            double w = 2.0 * PI * f_hz / fs_hz;
+            double c1 = dsp_math::cos(w);
+            double c2 = dsp_math::cos(2.0 * w);
+            double num = s.b0 * s.b0 + s.b1 * s.b1 + s.b2 * s.b2 +
+                         2.0 * (s.b0 * s.b1 + s.b1 * s.b2) * c1 + 2.0 * s.b0 * s.b2 * c2;
+            double den = 1.0 + s.a1 * s.a1 + s.a2 * s.a2 +
+                         2.0 * (s.a1 + s.a1 * s.a2) * c1 + 2.0 * s.a2 * c2;
+            return num / den;
+        }
+
+        constexpr BiquadCoefficients to_float(const Section &s)
+        {
+            return {static_cast<float>(s.b0), static_cast<float>(s.b1), static_cast<float>(s.b2),
+                    static_cast<float>(s.a1), static_cast<float>(s.a2)};
+        }
+
+        constexpr Section highpass_section(double fs_hz)
+        {
+            return cascade(highpass(F1_HZ, fs_hz), highpass(F1_HZ, fs_hz));
+        }
+
+        constexpr Section midband_section(double fs_hz)
+        {
+            return cascade(highpass(F2_HZ, fs_hz), highpass(F3_HZ, fs_hz));
+        }
+
+        constexpr Section lowpass_section(double fs_hz)
+        {
+            return cascade(lowpass(F4_HZ, fs_hz), lowpass(F4_HZ, fs_hz));
+        }
+
+        // Gains normalising each weighting to 0dB at 1kHz
+        constexpr double c_gain(double fs_hz)
+        {
+            return 1.0 / dsp_math::sqrt(magnitude_squared(highpass_section(fs_hz), REFERENCE_HZ, fs_hz) *
+                                     magnitude_squared(lowpass_section(fs_hz), REFERENCE_HZ, fs_hz));
+        }
+
+        constexpr double a_gain(double fs_hz)
+        {
+            return c_gain(fs_hz) /
+                   dsp_math::sqrt(magnitude_squared(midband_section(fs_hz), REFERENCE_HZ, fs_hz));
+        }
+    }
+
+    // Coefficients for the configured acquisition rate
+    constexpr double SAMPLE_RATE_HZ = config::adc::acquisition::SAMPLE_RATE_HZ;
+    constexpr BiquadCoefficients HIGHPASS = design::to_float(design::highpass_section(SAMPLE_RATE_HZ));
+    constexpr BiquadCoefficients MIDBAND = design::to_float(design::midband_section(SAMPLE_RATE_HZ));
+    constexpr BiquadCoefficients LOWPASS = design::to_float(design::lowpass_section(SAMPLE_RATE_HZ));
+    constexpr float A_GAIN = static_cast<float>(design::a_gain(SAMPLE_RATE_HZ));
+    constexpr float C_GAIN = static_cast<float>(design::c_gain(SAMPLE_RATE_HZ));
+}
\ No newline at end of file
@@ -1,7 +1,7 @@
 #include "wifi_manager.hpp"
 #include "config/config.h"
+#include <algorithm>
 #include <time.h>
-#include "esp_sntp.h"
 
 namespace wifi
 {
@@ -11,80 +11,195 @@ namespace wifi
         return instance;
     }
 
+    /**
+     * @brief Start the station and the first connection attempt. Does not wait.
+     * @return True once the attempt has been started.
+     */
     bool WiFiManager::init()
     {
         ESP_LOGI(TAG, "Initializing WiFi connection...");
         WiFi.mode(WIFI_STA);
-        return ensure_connected() && sync_time();
+        WiFi.setAutoReconnect(false); // Reconnects are paced by update()
+        WiFi.onEvent(on_event);
+        start_attempt();
+        return true;
     }
 
-    bool WiFiManager::ensure_connected()
+    /**
+     * @brief Apply the events since the last call, time out attempts and start due retries.
+     *
+     * Called periodically from the main loop; never blocks. The only place the
+     * state and the stats change.
+     */
+    void WiFiManager::update()
     {
-        if (WiFi.status() == WL_CONNECTED)
+        unsigned long now = millis();
+        bool got_ip = m_got_ip.exchange(false);
+        bool disconnected = m_disconnected.exchange(false);
+
+        switch (m_state.load())
         {
-            m_is_connected = true;
-            return true;
-        }
+        case State::IDLE:
+            start_attempt();
+            break;
 
-        ESP_LOGI(TAG, "Connecting to WiFi network: %s", config::wifi::SSID);
-        ESP_LOGI(TAG, "MAC: %s", WiFi.macAddress().c_str());
-        WiFi.begin(config::wifi::SSID, config::wifi::PASSWORD);
+        case State::CONNECTING:
+            // A drop after the address came in fails the attempt too
+            if (disconnected)
+            {
+                fail_attempt("Connection attempt rejected");
+            }
+            else if (got_ip)
+            {
+                complete_attempt();
+            }
+            else if (now - m_attempt_start >= config::wifi::CONNECT_TIMEOUT_MS)
+            {
+                fail_attempt("Connection attempt timed out");
+            }
+            break;
 
-        int retries = 0;
-        while (WiFi.status() != WL_CONNECTED && retries < MAX_RETRIES)
-        {
-            delay(RETRY_DELAY_MS);
-            ESP_LOGD(TAG, "Waiting for WiFi connection... (%d/%d)", retries + 1, MAX_RETRIES);
-            ESP_LOGD(TAG, "MAC: %s", WiFi.macAddress().c_str());
-            retries++;
-        }
+        case State::BACKOFF:
+        case State::FAILED:
+            if (static_cast<long>(now - m_next_attempt) >= 0)
+            {
+                start_attempt();
+            }
+            break;
 
-        if (WiFi.status() == WL_CONNECTED)
-        {
-            m_is_connected = true;
-            ESP_LOGI(TAG, "Connected to WiFi. IP: %s", WiFi.localIP().toString().c_str());
-            return true;
+        case State::CONNECTED:
+            if (disconnected)
+            {
+                // Lost an established link: reconnect on the next update
+                m_stats.disconnects++;
+                m_is_connected = false;
+                m_state = State::IDLE;
+                ESP_LOGW(TAG, "WiFi connection lost");
+                break;
+            }
+            if (!m_time_sync_started)
+            {
+                sync_time();
+            }
+            break;
         }
+    }
 
-        m_is_connected = false;
-        m_last_error = "Failed to connect to WiFi";
-        ESP_LOGE(TAG, "%s", m_last_error.c_str());
-        return false;
+    /**
+     * @brief Report whether the station is connected. Never blocks.
+     * @return True if connected; otherwise update() is already working on it.
+     */
+    bool WiFiManager::ensure_connected()
+    {
+        return m_is_connected;
     }
 
+    /**
+     * @brief Start background NTP synchronization. Does not wait for it.
+     * @return True if the clock is already valid, false otherwise.
+     */
     bool WiFiManager::sync_time()
     {
         ESP_LOGI(TAG, "Synchronizing time with NTP server...");
 
-        // Configure NTP
+        // SNTP keeps running in the background and re-syncs on its own
         configTzTime(config::ntp::TIMEZONE, config::ntp::SERVER);
+        m_time_sync_started = true;
+        return is_time_synced();
+    }
 
-        // Wait for time to be set
-        int retry = 0;
-        const int max_retry = 10;
-        while (time(nullptr) < 1000000000 && retry < max_retry)
-        {
-            ESP_LOGD(TAG, "Waiting for NTP time sync... (%d/%d)", retry + 1, max_retry);
-            delay(500);
-            retry++;
-        }
+    /**
+     * @brief Check whether the wall clock has been set.
+     * @return True if the clock holds a plausible date.
+     */
+    bool WiFiManager::is_time_synced() const
+    {
+        return time(nullptr) > 1000000000;
+    }
+
+    /**
+     * @brief Handle WiFi events; runs on the WiFi event task.
+     *
+     * Only raises flags for update(). The link is marked down at once so the
+     * upload task stops using it without waiting for the next update.
+     * @param event The event.
+     */
+    void WiFiManager::on_event(arduino_event_id_t event)
+    {
+        WiFiManager &manager = instance();
 
-        if (time(nullptr) < 1000000000)
+        switch (event)
         {
-            m_last_error = "Failed to sync time with NTP server";
-            ESP_LOGE(TAG, "%s", m_last_error.c_str());
-            return false;
+        case ARDUINO_EVENT_WIFI_STA_GOT_IP:
+            manager.m_got_ip_ms = millis();
+            manager.m_got_ip = true;
+            break;
+
+        case ARDUINO_EVENT_WIFI_STA_DISCONNECTED:
+            manager.m_is_connected = false;
+            manager.m_disconnected = true;
+            break;
+
+        default:
+            break;
         }
+    }
+
+    /**
+     * @brief Begin one connection attempt.
+     */
+    void WiFiManager::start_attempt()
+    {
+        ESP_LOGI(TAG, "Connecting to WiFi network: %s", config::wifi::SSID);
+
+        // Tear down what is left of the last attempt first, and forget its events
+        WiFi.disconnect();
+        m_got_ip = false;
+        m_disconnected = false;
+
+        m_attempt_start = millis();
+        m_stats.attempts++;
+        m_state = State::CONNECTING;
+        WiFi.begin(config::wifi::SSID, config::wifi::PASSWORD);
+    }
+
+    /**
+     * @brief Finish a successful attempt once the station has an address.
+     */
+    void WiFiManager::complete_attempt()
+    {
+        uint32_t elapsed = m_got_ip_ms.load() - m_attempt_start;
+        m_stats.connects++;
+        m_stats.reconnects = m_stats.connects - 1;
+        m_stats.last_connect_ms = elapsed;
+        m_stats.max_connect_ms = std::max(m_stats.max_connect_ms, elapsed);
+        m_failures = 0;
+        m_is_connected = true;
+        m_state = State::CONNECTED;
+        ESP_LOGI(TAG, "Connected to WiFi in %u ms. IP: %s", static_cast<unsigned>(elapsed),
+                 WiFi.localIP().toString().c_str());
+    }
 
-        // Log current time
-        struct tm timeinfo;
-        if (getLocalTime(&timeinfo))
+    /**
+     * @brief End a failed attempt and schedule the next one with exponential backoff.
+     * @param reason Why the attempt failed.
+     */
+    void WiFiManager::fail_attempt(const char *reason)
+    {
+        m_last_error = reason;
+        WiFi.disconnect();
+
+        if (m_failures < UINT8_MAX)
         {
-            char time_str[64];
-            strftime(time_str, sizeof(time_str), "%Y-%m-%d %H:%M:%S %Z", &timeinfo);
-            ESP_LOGI(TAG, "Time synchronized: %s", time_str);
+            m_failures++;
         }
 
-        return true;
+        uint8_t doublings = std::min<uint8_t>(m_failures - 1, 20);
+        uint32_t delay = std::min<uint32_t>(config::wifi::RETRY_BASE_MS << doublings,
+                                            config::wifi::RETRY_MAX_MS);
+        m_next_attempt = millis() + delay;
+        m_state = m_failures < config::wifi::MAX_FAST_ATTEMPTS ? State::BACKOFF : State::FAILED;
+
+        ESP_LOGW(TAG, "%s (%u failures), retrying in %u ms", reason, m_failures, delay);
     }
 }
\ No newline at end of file
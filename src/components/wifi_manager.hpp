@@ -1,30 +1,79 @@
 #pragma once
 #include <WiFi.h>
+#include <atomic>
 #include <string>
 #include "esp_log.h"
 
 namespace wifi
 {
+    /**
+     * @brief Non-blocking WiFi connection state machine.
+     *
+     * WiFi events arrive on the WiFi event task and only raise flags;
+     * update() consumes them, owns the state and the stats, starts attempts,
+     * times them out and backs off exponentially between failures.
+     * ensure_connected() only reports the current state, so callers on the
+     * upload path never wait for the radio.
+     */
     class WiFiManager
     {
+    public:
+        enum class State
+        {
+            IDLE,       // Not started, or dropped and about to reconnect
+            CONNECTING, // Attempt in progress
+            CONNECTED,  // Associated with an IP address
+            BACKOFF,    // Waiting before the next attempt
+            FAILED      // Repeated failures, still retrying with backoff
+        };
+
+        struct Stats
+        {
+            uint32_t attempts{0};
+            uint32_t connects{0};
+            uint32_t reconnects{0}; // Connects after the first
+            uint32_t disconnects{0};
+            uint32_t last_connect_ms{0}; // Attempt start to IP address
+            uint32_t max_connect_ms{0};
+        };
+
     private:
         static constexpr char const *TAG = "WiFiManager";
-        static constexpr int MAX_RETRIES = 20;
-        static constexpr int RETRY_DELAY_MS = 500;
 
-        bool m_is_connected = false;
+        std::atomic<State> m_state{State::IDLE};
+        std::atomic<bool> m_is_connected{false};
+
+        // Raised by on_event(), consumed by update()
+        std::atomic<bool> m_got_ip{false};
+        std::atomic<bool> m_disconnected{false};
+        std::atomic<unsigned long> m_got_ip_ms{0};
+
+        uint8_t m_failures{0};
+        unsigned long m_attempt_start{0};
+        unsigned long m_next_attempt{0};
+        bool m_time_sync_started{false};
+        Stats m_stats;
         std::string m_last_error;
 
         WiFiManager() = default;
 
+        static void on_event(arduino_event_id_t event);
+        void start_attempt();
+        void complete_attempt();
+        void fail_attempt(const char *reason);
+
     public:
         static WiFiManager &instance();
 
         bool init();
+        void update();
         bool ensure_connected();
         bool is_connected() const { return m_is_connected; }
+        State get_state() const { return m_state; }
+        const Stats &get_stats() const { return m_stats; }
         const std::string &get_last_error() const { return m_last_error; }
 
         bool sync_time();
+        bool is_time_synced() const;
     };
 }
\ No newline at end of file
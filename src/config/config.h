@@ -22,6 +22,11 @@ namespace config
 #else
         constexpr char const *PASSWORD = WIFI_PASS;
 #endif
+
+        constexpr uint32_t CONNECT_TIMEOUT_MS = 15000; // One association and DHCP attempt
+        constexpr uint32_t RETRY_BASE_MS = 1000;       // First backoff, doubled per failed attempt
+        constexpr uint32_t RETRY_MAX_MS = 300000;
+        constexpr uint8_t MAX_FAST_ATTEMPTS = 6;       // Failures before the state reports FAILED
     }
 
     namespace hardware
@@ -112,6 +117,13 @@ namespace config
         constexpr float EMA_ALPHA = 0.7f;         // Balanced response
         constexpr float BASELINE_ALPHA = 0.0005f; // Very slow baseline adjustment
 
+        // Integer (Q15 coefficient) envelope and baseline filters instead of float
+#ifndef SIGNAL_PROCESSING_FIXED_POINT
+        constexpr bool FIXED_POINT = false;
+#else
+        constexpr bool FIXED_POINT = true;
+#endif
+
         namespace ranges
         {
             // Adjusted for peak-to-peak values
@@ -121,6 +133,49 @@ namespace config
             constexpr uint16_t MAX = 500;      // Was 800
         }
 
+        namespace levels
+        {
+            constexpr uint32_t LEQ_PERIOD_MS = 1000;      // Integration time of LAeq/LCpeak
+            constexpr float REFERENCE_PRESSURE_PA = 20e-6f; // 0dB SPL
+            constexpr float FLOOR_DB = 0.0f;                // Reported for digital silence
+        }
+
+        namespace windows
+        {
+            // Sliding statistics windows, built from buckets of the next shorter span
+            constexpr uint32_t SECOND_BUCKET_MS = 1000;
+            constexpr uint32_t ONE_MIN_MS = 60000;
+            constexpr uint32_t FIFTEEN_MIN_MS = 900000;
+            constexpr uint32_t DAILY_MS = 86400000;
+        }
+
+        namespace histogram
+        {
+            // Exceedance levels per statistics window, in ADC units. Bins are one unit wide
+            // below LINEAR_BINS, then SUB_BINS per octave, so no bin is wider than 1/SUB_BINS
+            // of its level (0.27 dB) and NUM_BINS cover the full 12-bit scale
+            constexpr uint16_t LINEAR_BINS = 64;
+            constexpr uint16_t SUB_BINS = 32;
+            constexpr uint16_t NUM_BINS = 256;
+
+            // Slots per statistics window: the exceedance levels slide in steps of one slot,
+            // and every slot holds a histogram of its own (1 KB)
+            constexpr size_t ONE_MIN_SLOTS = 6;     // 10 s steps
+            constexpr size_t FIFTEEN_MIN_SLOTS = 5; // 3 min steps
+            constexpr size_t DAILY_SLOTS = 8;       // 3 h steps
+        }
+
+        namespace spectrum
+        {
+            constexpr size_t FFT_SIZE = 512;         // 31.25Hz bins at 16kHz
+            constexpr size_t HOP_SIZE = 512;         // One spectrum every 32ms at 16kHz
+            constexpr uint8_t MAX_LOAD_PERCENT = 20; // FFT time allowed per hop period
+
+            static_assert(FFT_SIZE >= 64 && FFT_SIZE <= 4096 && (FFT_SIZE & (FFT_SIZE - 1)) == 0,
+                          "FFT size must be a power of two between 64 and 4096");
+            static_assert(HOP_SIZE > 0, "Hop size must be positive");
+        }
+
         namespace thresholds
         {
             constexpr float NOISE_REGULAR = 1.2f;
@@ -135,15 +190,112 @@ namespace config
         constexpr uint32_t DISPLAY_INTERVAL = 500;   // Change from 250ms to 500ms
         constexpr uint32_t LED_UPDATE_INTERVAL = 50; // 50ms for LED updates
         constexpr uint32_t LOG_INTERVAL = 60000;     // Keep this the same
+        constexpr uint32_t ALERT_INTERVAL = 10;      // Alert state machine and tone steps
+        constexpr uint32_t WIFI_INTERVAL = 250;      // WiFi connection state machine
+        constexpr uint32_t SPECTRUM_LOG_INTERVAL = LOG_INTERVAL; // Octave band levels to the console
+    }
+
+    namespace scheduler
+    {
+        constexpr uint8_t MAX_TASKS = 8;
+
+        // Per-task run time budgets, exceeding one counts an overrun
+        constexpr uint32_t DISPLAY_BUDGET_MS = 40;
+        constexpr uint32_t LED_BUDGET_MS = 5;
+        constexpr uint32_t ALERT_BUDGET_MS = 5;
+        constexpr uint32_t LOG_BUDGET_MS = 200;
+        constexpr uint32_t API_BUDGET_MS = 3000;
+        constexpr uint32_t WIFI_BUDGET_MS = 5;
+        constexpr uint32_t SPECTRUM_BUDGET_MS = 5;
+    }
+
+    namespace logging
+    {
+        constexpr char const *MOUNT_POINT = "/sd";        // VFS mount used by SD.begin()
+        constexpr size_t SECTOR_SIZE = 512;
+        constexpr size_t BUFFER_SIZE = 4096;              // RAM buffer, whole sectors
+        constexpr size_t FLUSH_THRESHOLD = 2048;          // Write whole sectors once this much is buffered
+        constexpr uint32_t FLUSH_INTERVAL_MS = 60000;     // Longest time data stays in RAM only
+        constexpr uint32_t SYNC_INTERVAL_MS = 300000;     // Commit the file size to the FAT
+
+        static_assert((SECTOR_SIZE & (SECTOR_SIZE - 1)) == 0, "Sector size must be a power of two");
+
+        // Delta-encoded binary blocks (see log_format.hpp) instead of CSV rows
+#ifndef LOG_BINARY
+        constexpr bool BINARY_FORMAT = false;
+#else
+        constexpr bool BINARY_FORMAT = LOG_BINARY;
+#endif
+        constexpr uint32_t RECORD_INTERVAL_MS = BINARY_FORMAT ? 1000 : timing::LOG_INTERVAL;
+        constexpr uint16_t BLOCK_RECORDS = 60;            // Records per binary block, one minute at 1Hz
+        constexpr uint32_t INDEX_INTERVAL_S = 60;         // One .idx entry per minute of log
+        constexpr size_t INDEX_PENDING = 16;              // Entries held in RAM before they are appended
+    }
+
+    namespace spi
+    {
+        // The display and the SD card share one SPI bus, see SpiArbiter
+        constexpr uint32_t DISPLAY_TIMEOUT_MS = 50;       // Skip a frame rather than wait longer for the bus
+        constexpr size_t SD_WRITE_CHUNK_SECTORS = 4;      // Longest SD write between display pushes
+    }
+
+    namespace history
+    {
+        // GET /history?from=&to=&res= streams logged records as chunked CSV
+        constexpr uint16_t PORT = 80;
+        constexpr size_t REQUEST_BUFFER_SIZE = 512;       // Request line and headers
+        constexpr size_t STREAM_BUFFER_SIZE = 1436;       // Chunk payload, one TCP segment with framing
+        constexpr uint32_t MAX_RANGE_S = 7 * 86400;       // Longest range one request may ask for
+        constexpr uint32_t DEFAULT_RANGE_S = 3600;        // Range ending now when from is omitted
+        constexpr uint32_t MAX_RESOLUTION_S = 86400;
+        constexpr uint32_t RECV_TIMEOUT_MS = 2000;
+        constexpr uint32_t SEND_TIMEOUT_MS = 5000;        // A stalled client is dropped after this
+        constexpr uint8_t SERVER_CORE = 1;
+        constexpr uint8_t SERVER_PRIORITY = 1;
+        constexpr uint32_t SERVER_STACK_SIZE = 6144;
+    }
+
+    namespace tasks
+    {
+        // Run acquisition and DSP in a pinned FreeRTOS task instead of loop()
+#ifndef DUAL_CORE_PIPELINE
+        constexpr bool DUAL_CORE = true;
+#else
+        constexpr bool DUAL_CORE = DUAL_CORE_PIPELINE;
+#endif
+        constexpr uint8_t ACQUISITION_CORE = 0;           // loop() and its consumers run on core 1
+        constexpr uint8_t ACQUISITION_PRIORITY = 10;      // Above loop(), below the WiFi and lwIP tasks
+        constexpr uint32_t ACQUISITION_STACK_SIZE = 8192; // Bytes
+        constexpr size_t FRAME_RING_SIZE = 32;            // 320ms of frames at one frame per 10ms block
+
+        static_assert((FRAME_RING_SIZE & (FRAME_RING_SIZE - 1)) == 0,
+                      "Frame ring size must be a power of two");
     }
 
     namespace display
     {
+        // 128x64 panel in 8x8 tiles, the unit of partial updates
+        constexpr uint8_t TILE_COLUMNS = 16;
+        constexpr uint8_t TILE_ROWS = 8;
+
+        // Text row bands: status line, 1 minute, 15 minute statistics
+        constexpr uint8_t ROW_TOP[] = {0, 12, 22};
+        constexpr uint8_t ROW_HEIGHT[] = {12, 10, 10};
+
         namespace plot
         {
-            constexpr uint8_t PLOT_POINTS = 60;
+            constexpr uint8_t COLUMNS = 128; // One envelope column per pixel
             constexpr uint8_t PLOT_HEIGHT = 30;
             constexpr uint8_t PLOT_BASELINE_Y_POSITION = 63;
+
+            // Time shown across the plot at start-up: 10, 60 or 600 seconds
+#ifndef PLOT_SPAN_SECONDS
+            constexpr uint32_t SPAN_S = 10;
+#else
+            constexpr uint32_t SPAN_S = PLOT_SPAN_SECONDS;
+#endif
+            static_assert(SPAN_S == 10 || SPAN_S == 60 || SPAN_S == 600,
+                          "Plot span must be 10, 60 or 600 seconds");
         }
     }
 
@@ -153,11 +305,53 @@ namespace config
         constexpr uint16_t MAX_VALUE = (1 << RESOLUTION_BITS) - 1;
         constexpr uint8_t AVERAGING_SAMPLES = 1; // Back to 1 for fastest response
 
+        namespace acquisition
+        {
+            // Continuous (DMA) acquisition instead of one analogRead() per loop pass
+            constexpr bool CONTINUOUS_MODE = true;
+            constexpr uint32_t SAMPLE_RATE_HZ = 16000;
+            constexpr uint32_t MIN_SAMPLE_RATE_HZ = 8000;
+            constexpr uint32_t MAX_SAMPLE_RATE_HZ = 48000;
+            constexpr size_t BLOCK_SIZE = 160; // 10ms per block at 16kHz
+            constexpr uint8_t NUM_BLOCKS = 8;  // DMA ring depth, 80ms of slack at 16kHz
+            constexpr uint8_t QUEUED_BLOCKS = NUM_BLOCKS - 1; // Filled buffers the I2S driver queues before it drops the oldest
+
+            static_assert(SAMPLE_RATE_HZ >= MIN_SAMPLE_RATE_HZ &&
+                              SAMPLE_RATE_HZ <= MAX_SAMPLE_RATE_HZ,
+                          "Acquisition sample rate must be within 8-48kHz");
+            static_assert(BLOCK_SIZE > 0 && BLOCK_SIZE <= 1024,
+                          "I2S DMA buffers hold at most 1024 samples");
+            static_assert(NUM_BLOCKS >= 2 && NUM_BLOCKS <= 128,
+                          "I2S DMA ring needs between 2 and 128 buffers");
+        }
+
         namespace sound_sensor
         {
-            constexpr float VOLTAGE_REFERENCE = 3.3f;
-            constexpr float VOLTAGE_GAIN = 52.0f;
-            constexpr float MIN_DB = -60.0f;
+            // ADC input attenuation of both sampling paths, in the order of adc_atten_t
+            enum class Attenuation : uint8_t
+            {
+                DB_0,
+                DB_2_5,
+                DB_6,
+                DB_11
+            };
+
+            constexpr Attenuation ATTENUATION = Attenuation::DB_0; // Maximum sensitivity
+
+            // Nominal input voltage that reads MAX_VALUE (ESP32 datasheet); the ADC is not
+            // characterised per chip, so levels can be off by the part's gain error
+            constexpr float full_scale_voltage(Attenuation attenuation)
+            {
+                return attenuation == Attenuation::DB_0     ? 1.1f
+                       : attenuation == Attenuation::DB_2_5 ? 1.5f
+                       : attenuation == Attenuation::DB_6   ? 2.2f
+                                                            : 3.9f;
+            }
+
+            constexpr float FULL_SCALE_VOLTAGE = full_scale_voltage(ATTENUATION);
+
+            constexpr float VOLTAGE_GAIN = 52.0f; // Preamp gain in dB
+            constexpr float MIN_DB = -60.0f;      // Microphone sensitivity range in dBV/Pa
             constexpr float MAX_DB = -56.0f;
         }
     }
@@ -176,30 +370,43 @@ namespace config
         constexpr uint8_t NUM_PIXELS = LED_NUM_PIXELS;
 #endif
 
+        constexpr uint8_t BRIGHTNESS = 32;      // Of 255, applied to the color table at compile time
+        constexpr uint32_t PEAK_HOLD_MS = 1000; // The peak LED stays lit this long
+        constexpr uint32_t PEAK_DECAY_MS = 100; // Then falls back one LED per interval
+
+        static_assert(NUM_PIXELS > 0, "The strip needs at least one LED");
+
         namespace colors
         {
-            constexpr uint32_t INDICATOR_COLORS[NUM_PIXELS] = {
-                make_color(0, 255, 0),   // Pure Green
-                make_color(85, 255, 0),  // Light Green
-                make_color(170, 255, 0), // Yellow-Green
-                make_color(255, 255, 0), // Yellow
-                make_color(255, 170, 0), // Orange-Yellow
-                make_color(255, 85, 0),  // Orange
-                make_color(255, 0, 0),   // Bright Red
-                make_color(128, 0, 0)    // Dark Red
+            struct GradientStop
+            {
+                float position; // 0 is the first LED, 1 the last
+                uint32_t color;
+            };
+
+            // Interpolated across the strip; at 8 LEDs every LED gets a pure step
+            constexpr GradientStop INDICATOR_GRADIENT[] = {
+                {0.0f, make_color(0, 255, 0)},          // Pure Green
+                {3.0f / 7.0f, make_color(255, 255, 0)}, // Yellow
+                {6.0f / 7.0f, make_color(255, 0, 0)},   // Bright Red
+                {1.0f, make_color(128, 0, 0)}           // Dark Red
             };
         }
     }
 
     namespace alert
     {
-#ifndef SPEAKER_PIN
+#ifndef PIN_SPEAKER
         constexpr uint8_t SPEAKER_PIN = 26;
 #else
         constexpr uint8_t SPEAKER_PIN = PIN_SPEAKER;
 #endif
         constexpr uint32_t ELEVATED_THRESHOLD_MS = 5000;
         constexpr uint32_t BEEP_DURATION_MS = 200;
+        constexpr uint16_t BEEP_TONE_MS = 100; // One beep of an alert pattern
+        constexpr uint16_t BEEP_GAP_MS = 50;   // Silence between beeps
+        constexpr uint8_t ALERT_BEEPS = 4;
+        constexpr uint8_t RAPID_ALERT_BEEPS = 8; // Alternates both alarm frequencies
         constexpr uint32_t BEEP_INTERVAL_MS = 1000;
         constexpr uint8_t MAX_ALERTS = 3;
         constexpr uint32_t BASE_COOLDOWN_MS = 10000;
@@ -221,6 +428,8 @@ namespace config
     namespace thingspeak
     {
         constexpr char const *ENDPOINT = "https://api.thingspeak.com";
+        constexpr char const *HOST = "api.thingspeak.com"; // Must match ENDPOINT
+        constexpr uint16_t PORT = 443;
 
 #ifndef THINGSPEAK_USER_API_KEY
         constexpr char const *USER_API_KEY = "your_user_api_key";
@@ -238,6 +447,34 @@ namespace config
         constexpr int MAX_FIELDS = 8;
         constexpr bool PUBLIC_FLAG = false;
 
+        namespace upload
+        {
+            constexpr uint32_t SAMPLE_INTERVAL_MS = 5000;                // One data point per interval
+            constexpr uint32_t FLUSH_INTERVAL_MS = UPDATE_INTERVAL_MS;   // One bulk request per interval
+            constexpr size_t MAX_BATCH = 32;                             // Points per bulk request
+            constexpr size_t BULK_LIMIT = 960;                           // ThingSpeak free tier points per request
+            constexpr size_t QUEUE_SIZE = 64;                            // RAM cap: records waiting for the worker
+            constexpr size_t PAYLOAD_BUFFER_SIZE = 8192;                 // Serialized bulk request, BACKLOG_BATCH points
+            constexpr char const *BACKLOG_PATH = "/sd/upload_queue.bin"; // Store-and-forward file on the SD mount
+            constexpr uint32_t BACKLOG_CAPACITY = 17280;                 // Records, one day at SAMPLE_INTERVAL_MS
+            constexpr size_t BACKLOG_BATCH = 64;                         // Points per replayed bulk request
+            constexpr uint32_t MIN_REQUEST_INTERVAL_MS = 15000;          // ThingSpeak free tier limit
+            constexpr uint32_t RATE_LIMIT_BACKOFF_MS = 15000;            // Minimum wait after HTTP 429
+            constexpr uint32_t RETRY_BASE_MS = 2000;                     // First retry delay, doubled per attempt
+            constexpr uint32_t RETRY_MAX_MS = 120000;
+            constexpr uint8_t MAX_ATTEMPTS = 5;
+            constexpr uint8_t WORKER_CORE = 1;
+            constexpr uint8_t WORKER_PRIORITY = 1;                       // Same as loop(), blocking I/O yields
+            constexpr uint32_t WORKER_STACK_SIZE = 8192;                 // Bytes, TLS needs most of it
+
+            static_assert(MAX_BATCH > 0 && MAX_BATCH <= BULK_LIMIT,
+                          "Batch must fit in one bulk_update request");
+            static_assert(BACKLOG_BATCH >= MAX_BATCH && BACKLOG_BATCH <= BULK_LIMIT,
+                          "Backlog batch must fit in one bulk_update request");
+            static_assert(FLUSH_INTERVAL_MS >= MIN_REQUEST_INTERVAL_MS,
+                          "Flushing faster than ThingSpeak accepts requests");
+        }
+
 #ifndef THINGSPEAK_NOISE_CHANNEL_ID
         constexpr char const *NOISE_CHANNEL_ID = "your_noise_channel_id";
 #else
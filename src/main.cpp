@@ -12,10 +12,9 @@ void setup()
 {
   Serial.begin(115200);
   
-  // Try to initialize WiFi and API, but continue if they fail
-  if (wifi::WiFiManager::instance().init()) {
-    ApiHandler::instance().begin();
-  }
+  // Start connecting to WiFi in the background; uploads queue up until it connects
+  wifi::WiFiManager::instance().init();
+  ApiHandler::instance().begin();
   
   // Initialize core noise monitoring functionality
   if (!noise_monitor.begin())
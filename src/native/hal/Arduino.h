@@ -0,0 +1,76 @@
+#pragma once
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <algorithm>
+#include "esp_log.h"
+#include "esp_system.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+
+// Arduino core subset used by the firmware, on the virtual clock of native_hal.hpp
+
+using std::max;
+using std::min;
+
+#define INPUT 0x01
+#define OUTPUT 0x03
+#define LOW 0x0
+#define HIGH 0x1
+#define A0 36
+
+typedef enum
+{
+    ADC_0db,
+    ADC_2_5db,
+    ADC_6db,
+    ADC_11db
+} adc_attenuation_t;
+
+unsigned long millis();
+unsigned long micros();
+void delay(uint32_t ms);
+
+inline long map(long x, long in_min, long in_max, long out_min, long out_max)
+{
+    return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
+}
+
+inline void pinMode(uint8_t, uint8_t) {}
+inline void digitalWrite(uint8_t, uint8_t) {}
+
+uint16_t analogRead(uint8_t pin);
+inline void analogReadResolution(uint8_t) {}
+inline void analogSetAttenuation(adc_attenuation_t) {}
+inline void analogSetClockDiv(uint8_t) {}
+inline void analogSetWidth(uint8_t) {}
+inline void analogSetPinAttenuation(uint8_t, adc_attenuation_t) {}
+inline int8_t digitalPinToAnalogChannel(uint8_t pin) { return pin >= 32 && pin <= 39 ? (pin - 32 + 4) % 8 : -1; }
+
+bool getLocalTime(struct tm *info, uint32_t ms = 5000);
+void configTzTime(const char *tz, const char *server1, const char *server2 = nullptr, const char *server3 = nullptr);
+
+class HardwareSerial
+{
+public:
+    void begin(unsigned long) {}
+    size_t print(const char *text) { return fputs(text, stdout) >= 0 ? strlen(text) : 0; }
+    size_t println(const char *text = "") { return print(text) + print("\n"); }
+    size_t printf(const char *format, ...) __attribute__((format(printf, 2, 3)));
+};
+
+extern HardwareSerial Serial;
+
+class EspClass
+{
+public:
+    uint32_t getFreeHeap() { return 200000; }
+    uint32_t getMinFreeHeap() { return 200000; }
+};
+
+extern EspClass ESP;
\ No newline at end of file
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "WiFiClientSecure.h"
+
+#define HTTPC_ERROR_CONNECTION_REFUSED (-1)
+#define HTTPC_ERROR_SEND_HEADER_FAILED (-2)
+#define HTTPC_ERROR_NOT_CONNECTED (-4)
+
+enum t_http_codes
+{
+    HTTP_CODE_OK = 200,
+    HTTP_CODE_ACCEPTED = 202,
+    HTTP_CODE_PAYLOAD_TOO_LARGE = 413
+};
+
+// Requests go over the given client to the simulated server in native_hal
+class HTTPClient
+{
+public:
+    void setReuse(bool) {}
+    bool begin(WiFiClientSecure &client, const char *, uint16_t, const char *, bool = false)
+    {
+        m_client = &client;
+        return true;
+    }
+    void addHeader(const char *, const char *) {}
+    int POST(uint8_t *, size_t)
+    {
+        if (!m_client || !m_client->is_alive())
+        {
+            return HTTPC_ERROR_SEND_HEADER_FAILED;
+        }
+        return native_hal::server_http_status();
+    }
+    void end() { m_client = nullptr; }
+
+private:
+    WiFiClientSecure *m_client{nullptr};
+};
\ No newline at end of file
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * SD card: begin() mounts the host directory given to native_hal::set_sd_root()
+ * at config::logging::MOUNT_POINT. The firmware then uses stdio on that path
+ * as it does on the device; the native build remaps it in fopen().
+ */
+class SDFS
+{
+public:
+    bool begin(uint8_t cs_pin);
+    void end();
+};
+
+extern SDFS SD;
\ No newline at end of file
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <stdint.h>
+#include <string.h>
+
+/**
+ * 128x64 monochrome panel with U8g2's full frame buffer: 8 rows of tiles,
+ * each byte a vertical run of 8 pixels, least significant bit on top.
+ * Lines, boxes and pixels are drawn into the buffer; text is captured as
+ * strings instead of being rasterised. sendBuffer() and updateDisplayArea()
+ * copy the buffer to the emulated panel, which is captured on every update.
+ */
+struct NativeFont
+{
+    uint8_t width;
+    uint8_t height;
+};
+
+constexpr NativeFont u8g2_font_6x10_tf{6, 10};
+constexpr NativeFont u8g2_font_ncenB14_tr{11, 14};
+
+constexpr int U8G2_R0 = 0;
+
+class U8G2_ST7565_ERC12864_ALT_F_4W_HW_SPI
+{
+public:
+    static constexpr uint8_t WIDTH = 128;
+    static constexpr uint8_t HEIGHT = 64;
+    static constexpr size_t BUFFER_SIZE = WIDTH * HEIGHT / 8;
+
+    U8G2_ST7565_ERC12864_ALT_F_4W_HW_SPI(int, uint8_t, uint8_t, uint8_t) {}
+
+    bool begin() { return true; }
+    void setContrast(uint8_t) {}
+    void setFont(const NativeFont &font) { m_font = &font; }
+    void setDrawColor(uint8_t color) { m_color = color; }
+
+    uint8_t getWidth() const { return WIDTH; }
+    uint8_t getHeight() const { return HEIGHT; }
+    uint8_t *getBufferPtr() { return m_buffer; }
+    uint16_t getStrWidth(const char *text) const { return strlen(text) * m_font->width; }
+
+    void clearBuffer() { memset(m_buffer, 0, sizeof(m_buffer)); }
+    void drawPixel(int x, int y);
+    void drawHLine(int x, int y, int w);
+    void drawVLine(int x, int y, int h);
+    void drawBox(int x, int y, int w, int h);
+    void drawFrame(int x, int y, int w, int h);
+    uint16_t drawStr(int x, int y, const char *text);
+
+    void sendBuffer();
+    void updateDisplayArea(uint8_t tile_x, uint8_t tile_y, uint8_t tile_width, uint8_t tile_height);
+
+private:
+    const NativeFont *m_font{&u8g2_font_6x10_tf};
+    uint8_t m_color{1};
+    uint8_t m_buffer[BUFFER_SIZE]{};
+    uint8_t m_panel[BUFFER_SIZE]{};
+};
\ No newline at end of file
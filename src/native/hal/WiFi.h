@@ -0,0 +1,55 @@
+#pragma once
+
+#include <stdint.h>
+#include <string>
+#include "Arduino.h"
+
+// No network on the host: begin() never connects on its own; tests deliver events with raise_event()
+typedef enum
+{
+    ARDUINO_EVENT_WIFI_STA_GOT_IP,
+    ARDUINO_EVENT_WIFI_STA_DISCONNECTED
+} arduino_event_id_t;
+
+typedef enum
+{
+    WIFI_OFF,
+    WIFI_STA
+} wifi_mode_t;
+
+typedef void (*WiFiEventCb)(arduino_event_id_t event);
+
+class IPAddress
+{
+public:
+    std::string toString() const { return "0.0.0.0"; }
+};
+
+class WiFiClass
+{
+public:
+    bool mode(wifi_mode_t) { return true; }
+    bool setAutoReconnect(bool) { return true; }
+    int onEvent(WiFiEventCb callback)
+    {
+        m_callback = callback;
+        return 0;
+    }
+    int begin(const char *, const char *) { return 0; }
+    bool disconnect(bool = false) { return true; }
+    IPAddress localIP() const { return IPAddress(); }
+
+    // As the WiFi event task would, on whatever thread calls it
+    void raise_event(arduino_event_id_t event)
+    {
+        if (m_callback)
+        {
+            m_callback(event);
+        }
+    }
+
+private:
+    WiFiEventCb m_callback{nullptr};
+};
+
+extern WiFiClass WiFi;
\ No newline at end of file
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <stdint.h>
+#include "../native_hal.hpp"
+
+// Connects to the simulated server in native_hal. Like the real client, it
+// still reports connected after the server has closed the connection; only
+// the next request finds out.
+class WiFiClientSecure
+{
+public:
+    void setInsecure() {}
+    int connect(const char *, uint16_t)
+    {
+        m_open = native_hal::server_connect(m_connection);
+        return m_open;
+    }
+    uint8_t connected() { return m_open; }
+    void stop() { m_open = false; }
+
+    bool is_alive() const { return m_open && native_hal::server_connection_alive(m_connection); }
+
+private:
+    bool m_open{false};
+    uint32_t m_connection{0};
+};
\ No newline at end of file
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "esp_system.h"
+
+typedef enum
+{
+    ADC1_CHANNEL_0,
+    ADC1_CHANNEL_MAX = 8
+} adc1_channel_t;
+
+typedef enum
+{
+    ADC_UNIT_1 = 1
+} adc_unit_t;
+
+typedef enum
+{
+    ADC_WIDTH_BIT_12 = 3
+} adc_bits_width_t;
+
+typedef enum
+{
+    ADC_ATTEN_DB_0,
+    ADC_ATTEN_DB_2_5,
+    ADC_ATTEN_DB_6,
+    ADC_ATTEN_DB_11
+} adc_atten_t;
+
+inline esp_err_t adc1_config_width(adc_bits_width_t) { return ESP_OK; }
+inline esp_err_t adc1_config_channel_atten(adc1_channel_t, adc_atten_t) { return ESP_OK; }
\ No newline at end of file
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <stddef.h>
+#include "esp_system.h"
+#include "freertos/FreeRTOS.h"
+#include "driver/adc.h"
+#include "../../native_hal.hpp"
+
+// The ADC is simulated once a test gives it a signal (native_hal::set_adc_signal);
+// otherwise installing the driver fails and recorded sessions come in through
+// ReplaySource instead.
+typedef enum
+{
+    I2S_NUM_0
+} i2s_port_t;
+
+typedef enum
+{
+    I2S_MODE_MASTER = 1,
+    I2S_MODE_RX = 4,
+    I2S_MODE_ADC_BUILT_IN = 32
+} i2s_mode_t;
+
+typedef enum
+{
+    I2S_BITS_PER_SAMPLE_16BIT = 16
+} i2s_bits_per_sample_t;
+
+typedef enum
+{
+    I2S_CHANNEL_FMT_ONLY_LEFT = 4
+} i2s_channel_fmt_t;
+
+typedef enum
+{
+    I2S_COMM_FORMAT_STAND_MSB = 3
+} i2s_comm_format_t;
+
+typedef enum
+{
+    I2S_EVENT_RX_DONE,
+    I2S_EVENT_RX_Q_OVF
+} i2s_event_type_t;
+
+typedef struct
+{
+    i2s_event_type_t type;
+    size_t size;
+} i2s_event_t;
+
+typedef struct
+{
+    i2s_mode_t mode;
+    uint32_t sample_rate;
+    i2s_bits_per_sample_t bits_per_sample;
+    i2s_channel_fmt_t channel_format;
+    i2s_comm_format_t communication_format;
+    int intr_alloc_flags;
+    int dma_buf_count;
+    int dma_buf_len;
+    bool use_apll;
+} i2s_config_t;
+
+#define ESP_INTR_FLAG_LEVEL1 (1 << 1)
+
+inline esp_err_t i2s_driver_install(i2s_port_t, const i2s_config_t *config, int, QueueHandle_t *)
+{
+    return native_hal::i2s_install(config->sample_rate, config->dma_buf_count, config->dma_buf_len) ? ESP_OK : ESP_FAIL;
+}
+
+inline esp_err_t i2s_driver_uninstall(i2s_port_t)
+{
+    native_hal::i2s_uninstall();
+    return ESP_OK;
+}
+
+inline esp_err_t i2s_set_adc_mode(adc_unit_t, adc1_channel_t) { return ESP_OK; }
+
+inline esp_err_t i2s_adc_enable(i2s_port_t)
+{
+    native_hal::i2s_start();
+    return ESP_OK;
+}
+
+inline esp_err_t i2s_adc_disable(i2s_port_t) { return ESP_OK; }
+
+inline esp_err_t i2s_read(i2s_port_t, void *dest, size_t size, size_t *bytes_read, TickType_t)
+{
+    *bytes_read = native_hal::i2s_read(static_cast<uint16_t *>(dest), size / sizeof(uint16_t)) * sizeof(uint16_t);
+    return ESP_OK;
+}
\ No newline at end of file
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_system.h"
+#include "freertos/FreeRTOS.h"
+#include "driver/gpio.h"
+
+// Transmissions complete at once and are decoded into captured LED frames, see native_hal.hpp
+typedef enum
+{
+    RMT_CHANNEL_0
+} rmt_channel_t;
+
+typedef enum
+{
+    RMT_MODE_TX
+} rmt_mode_t;
+
+typedef struct
+{
+    union
+    {
+        struct
+        {
+            uint32_t duration0 : 15;
+            uint32_t level0 : 1;
+            uint32_t duration1 : 15;
+            uint32_t level1 : 1;
+        };
+        uint32_t val;
+    };
+} rmt_item32_t;
+
+typedef struct
+{
+    rmt_mode_t rmt_mode;
+    rmt_channel_t channel;
+    gpio_num_t gpio_num;
+    uint8_t clk_div;
+    uint8_t mem_block_num;
+} rmt_config_t;
+
+#define RMT_DEFAULT_CONFIG_TX(gpio, channel_id) {RMT_MODE_TX, channel_id, gpio, 80, 1}
+
+inline esp_err_t rmt_config(const rmt_config_t *) { return ESP_OK; }
+inline esp_err_t rmt_driver_install(rmt_channel_t, size_t, int) { return ESP_OK; }
+inline esp_err_t rmt_wait_tx_done(rmt_channel_t, TickType_t) { return ESP_OK; }
+esp_err_t rmt_write_items(rmt_channel_t channel, const rmt_item32_t *items, int count, bool wait_tx_done);
\ No newline at end of file
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <stdio.h>
+#include "../native_hal.hpp"
+
+#define NATIVE_HAL_LOG(level, letter, tag, format, ...)                                   \
+    do                                                                                   \
+    {                                                                                    \
+        if (native_hal::log_enabled(level))                                              \
+        {                                                                                \
+            fprintf(stderr, letter " (%llu) %s: " format "\n",                           \
+                    static_cast<unsigned long long>(native_hal::now_us() / 1000), tag,   \
+                    ##__VA_ARGS__);                                                      \
+        }                                                                                \
+    } while (0)
+
+#define ESP_LOGE(tag, format, ...) NATIVE_HAL_LOG(native_hal::LOG_ERROR, "E", tag, format, ##__VA_ARGS__)
+#define ESP_LOGW(tag, format, ...) NATIVE_HAL_LOG(native_hal::LOG_WARN, "W", tag, format, ##__VA_ARGS__)
+#define ESP_LOGI(tag, format, ...) NATIVE_HAL_LOG(native_hal::LOG_INFO, "I", tag, format, ##__VA_ARGS__)
+#define ESP_LOGD(tag, format, ...) NATIVE_HAL_LOG(native_hal::LOG_DEBUG, "D", tag, format, ##__VA_ARGS__)
+#define ESP_LOGV(tag, format, ...) NATIVE_HAL_LOG(native_hal::LOG_DEBUG, "V", tag, format, ##__VA_ARGS__)
\ No newline at end of file
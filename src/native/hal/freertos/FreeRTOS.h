@@ -0,0 +1,19 @@
+#pragma once
+
+#include <stdint.h>
+
+// No second core or scheduler on the host: task creation fails, so the
+// firmware's single-core fallbacks run everything from the simulation loop.
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef uint32_t TickType_t;
+typedef void *TaskHandle_t;
+typedef void *QueueHandle_t;
+typedef void (*TaskFunction_t)(void *);
+
+#define pdFALSE 0
+#define pdTRUE 1
+#define pdFAIL 0
+#define pdPASS 1
+#define portMAX_DELAY UINT32_MAX
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms))
\ No newline at end of file
@@ -0,0 +1,5 @@
+#pragma once
+
+#include "FreeRTOS.h"
+
+inline BaseType_t xQueueReceive(QueueHandle_t, void *, TickType_t) { return pdFALSE; }
\ No newline at end of file
@@ -0,0 +1,17 @@
+#pragma once
+
+#include "FreeRTOS.h"
+
+inline BaseType_t xTaskCreatePinnedToCore(TaskFunction_t, const char *, uint32_t, void *, UBaseType_t,
+                                          TaskHandle_t *handle, BaseType_t)
+{
+    if (handle)
+    {
+        *handle = nullptr;
+    }
+    return pdFAIL;
+}
+
+inline void vTaskDelay(TickType_t) {}
+inline void xTaskNotifyGive(TaskHandle_t) {}
+inline uint32_t ulTaskNotifyTake(BaseType_t, TickType_t) { return 0; }
\ No newline at end of file
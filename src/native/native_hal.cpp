@@ -0,0 +1,445 @@
+#include "native_hal.hpp"
+#include <Arduino.h>
+#include <SD.h>
+#include <U8g2lib.h>
+#include <WiFi.h>
+#include <errno.h>
+#include <limits.h>
+#include <stdarg.h>
+#include <sys/stat.h>
+#include <string>
+#include <vector>
+#include "config/config.h"
+
+// Link with -Wl,--wrap=fopen,--wrap=time: the firmware's SD paths and wall clock go through here
+extern "C" FILE *__real_fopen(const char *path, const char *mode);
+extern "C" time_t __real_time(time_t *out);
+
+HardwareSerial Serial;
+EspClass ESP;
+SDFS SD;
+WiFiClass WiFi;
+
+namespace
+{
+    uint64_t s_now_us = 0;
+    time_t s_epoch = 0;
+    uint16_t s_analog_value = config::adc::MAX_VALUE / 2;
+    native_hal::LogLevel s_log_level = native_hal::LOG_ERROR;
+    uint32_t s_random = 0x2545F491;
+    std::vector<shutdown_handler_t> s_shutdown_handlers;
+
+    bool s_server_reachable = false;
+    uint32_t s_handshake_ms = 0;
+    int s_http_status = 200;
+    uint32_t s_server_connections = 0; // Bumped when the server drops them all
+
+    native_hal::AdcSignal s_adc_signal = nullptr;
+    bool s_i2s_installed = false;
+    uint32_t s_i2s_rate = 0;
+    uint32_t s_i2s_buffer_count = 0;
+    uint32_t s_i2s_buffer_length = 0;
+    uint64_t s_i2s_start_us = 0;
+    uint64_t s_i2s_read_index = 0; // Next sample the reader gets
+    constexpr uint16_t I2S_CHANNEL_BITS = 0x6000; // The hardware tags each sample with its channel
+
+    std::string s_sd_root;
+    bool s_sd_mounted = false;
+
+    std::string s_capture_dir;
+    FILE *s_display_file = nullptr;
+    FILE *s_text_file = nullptr;
+    FILE *s_led_file = nullptr;
+    FILE *s_tone_file = nullptr;
+    using Panel = U8G2_ST7565_ERC12864_ALT_F_4W_HW_SPI;
+
+    uint8_t s_panel[Panel::BUFFER_SIZE];
+    bool s_panel_pending = false;
+    uint32_t s_panel_time = 0;
+    native_hal::CaptureCounts s_counts;
+
+    constexpr const char *MOUNT_POINT = config::logging::MOUNT_POINT;
+
+    /**
+     * @brief Map a path on the SD mount to the host directory behind it.
+     * @param path The path the firmware opens.
+     * @param mapped Receives the host path.
+     * @return The path to open, or nullptr if it is on the mount and no card is mounted.
+     */
+    const char *map_path(const char *path, std::string &mapped)
+    {
+        size_t length = strlen(MOUNT_POINT);
+        if (strncmp(path, MOUNT_POINT, length) != 0 || (path[length] != '/' && path[length] != '\0'))
+        {
+            return path;
+        }
+        if (!s_sd_mounted)
+        {
+            return nullptr;
+        }
+        mapped = s_sd_root + (path + length);
+        return mapped.c_str();
+    }
+
+    FILE *open_capture_file(const char *name, const char *header)
+    {
+        std::string path = s_capture_dir + "/" + name;
+        FILE *file = __real_fopen(path.c_str(), "wb");
+        if (file && header)
+        {
+            fputs(header, file);
+        }
+        return file;
+    }
+
+    void write_panel()
+    {
+        if (!s_panel_pending)
+        {
+            return;
+        }
+        if (s_display_file)
+        {
+            fwrite(&s_panel_time, sizeof(s_panel_time), 1, s_display_file);
+            fwrite(s_panel, 1, sizeof(s_panel), s_display_file);
+        }
+        s_panel_pending = false;
+    }
+
+    // Netpbm bitmap of the panel, viewable with most image tools
+    void write_pbm()
+    {
+        FILE *file = open_capture_file("display.pbm", nullptr);
+        if (!file)
+        {
+            return;
+        }
+        fprintf(file, "P1\n%u %u\n", Panel::WIDTH, Panel::HEIGHT);
+        for (unsigned y = 0; y < Panel::HEIGHT; y++)
+        {
+            for (unsigned x = 0; x < Panel::WIDTH; x++)
+            {
+                bool on = s_panel[(y / 8) * Panel::WIDTH + x] & (1 << (y % 8));
+                fputc(on ? '1' : '0', file);
+            }
+            fputc('\n', file);
+        }
+        fclose(file);
+    }
+
+    void close_file(FILE *&file)
+    {
+        if (file)
+        {
+            fclose(file);
+            file = nullptr;
+        }
+    }
+}
+
+extern "C" FILE *__wrap_fopen(const char *path, const char *mode)
+{
+    std::string mapped;
+    const char *host_path = map_path(path, mapped);
+    if (!host_path)
+    {
+        errno = ENOENT;
+        return nullptr;
+    }
+    return __real_fopen(host_path, mode);
+}
+
+// Like an ESP32 whose clock was never set, wall time starts at 0 without an epoch
+extern "C" time_t __wrap_time(time_t *out)
+{
+    time_t now = s_epoch + static_cast<time_t>(s_now_us / 1000000);
+    if (out)
+    {
+        *out = now;
+    }
+    return now;
+}
+
+namespace native_hal
+{
+    uint64_t now_us() { return s_now_us; }
+    void advance_us(uint64_t us) { s_now_us += us; }
+    void set_epoch(time_t epoch) { s_epoch = epoch; }
+    void set_log_level(LogLevel level) { s_log_level = level; }
+    bool log_enabled(LogLevel level) { return level <= s_log_level; }
+    void set_analog_value(uint16_t value) { s_analog_value = value; }
+    const CaptureCounts &get_capture_counts() { return s_counts; }
+
+    void set_sd_root(const char *directory)
+    {
+        s_sd_root = directory;
+        while (s_sd_root.size() > 1 && s_sd_root.back() == '/')
+        {
+            s_sd_root.pop_back();
+        }
+    }
+
+    void set_server_reachable(bool reachable) { s_server_reachable = reachable; }
+    void set_handshake_ms(uint32_t ms) { s_handshake_ms = ms; }
+    void set_http_status(int status) { s_http_status = status; }
+    void drop_server_connections() { s_server_connections++; }
+    int server_http_status() { return s_http_status; }
+
+    /**
+     * @brief Open a connection to the simulated server, taking the handshake time.
+     * @param connection Receives the connection, for server_connection_alive().
+     * @return True if the server is reachable.
+     */
+    bool server_connect(uint32_t &connection)
+    {
+        if (!s_server_reachable)
+        {
+            return false;
+        }
+        s_now_us += s_handshake_ms * 1000ULL;
+        connection = s_server_connections;
+        return true;
+    }
+
+    bool server_connection_alive(uint32_t connection)
+    {
+        return s_server_reachable && connection == s_server_connections;
+    }
+
+    void set_adc_signal(AdcSignal signal) { s_adc_signal = signal; }
+
+    bool i2s_install(uint32_t sample_rate_hz, int buffer_count, int buffer_length)
+    {
+        if (!s_adc_signal || s_i2s_installed || buffer_count < 2 || buffer_length < 1)
+        {
+            return false;
+        }
+        s_i2s_installed = true;
+        s_i2s_rate = sample_rate_hz;
+        s_i2s_buffer_count = buffer_count;
+        s_i2s_buffer_length = buffer_length;
+        i2s_start();
+        return true;
+    }
+
+    void i2s_start()
+    {
+        s_i2s_start_us = s_now_us;
+        s_i2s_read_index = 0;
+    }
+
+    void i2s_uninstall() { s_i2s_installed = false; }
+
+    /**
+     * @brief Read samples the DMA buffers hold, as the legacy I2S driver hands them out.
+     *
+     * Filled buffers wait in a queue of buffer_count - 1; when another one
+     * fills, the oldest is dropped. A buffer the reader has started stays
+     * with the reader.
+     * @param samples Receives the samples, with the channel in the upper bits.
+     * @param count The most samples to read.
+     * @return The number of samples read.
+     */
+    size_t i2s_read(uint16_t *samples, size_t count)
+    {
+        if (!s_i2s_installed)
+        {
+            return 0;
+        }
+
+        const uint64_t length = s_i2s_buffer_length;
+        uint64_t sampled = (s_now_us - s_i2s_start_us) * s_i2s_rate / 1000000;
+        uint64_t filled = sampled / length * length;
+        uint64_t queued = uint64_t(s_i2s_buffer_count - 1) * length;
+        uint64_t oldest = filled > queued ? filled - queued : 0;
+
+        size_t read = 0;
+        while (read < count && s_i2s_read_index < filled)
+        {
+            if (s_i2s_read_index % length == 0 && s_i2s_read_index < oldest)
+            {
+                s_i2s_read_index = oldest;
+            }
+            samples[read++] = I2S_CHANNEL_BITS | (s_adc_signal(s_i2s_read_index++) & 0x0FFF);
+        }
+        return read;
+    }
+
+    void run_shutdown_handlers()
+    {
+        for (shutdown_handler_t handler : s_shutdown_handlers)
+        {
+            handler();
+        }
+    }
+
+    /**
+     * @brief Start capturing the outputs into a directory.
+     * @param directory An existing directory.
+     * @return True if every capture file was created.
+     */
+    bool open_capture(const char *directory)
+    {
+        close_capture();
+        s_capture_dir = directory;
+        s_display_file = open_capture_file("display.bin", nullptr);
+        s_text_file = open_capture_file("display.csv", "millis,x,y,text\n");
+        s_led_file = open_capture_file("leds.csv", "millis,colors\n");
+        s_tone_file = open_capture_file("tones.csv", "millis,frequency_hz\n");
+        s_counts = CaptureCounts();
+        return s_display_file && s_text_file && s_led_file && s_tone_file;
+    }
+
+    /**
+     * @brief Write out what is pending and close the capture files.
+     */
+    void close_capture()
+    {
+        write_panel();
+        if (s_display_file)
+        {
+            write_pbm();
+        }
+        close_file(s_display_file);
+        close_file(s_text_file);
+        close_file(s_led_file);
+        close_file(s_tone_file);
+    }
+
+    // Several tile updates at the same millisecond make one captured panel update
+    void capture_display(const uint8_t *panel, size_t size)
+    {
+        uint32_t now = static_cast<uint32_t>(millis());
+        if (s_panel_pending && now != s_panel_time)
+        {
+            write_panel();
+        }
+        if (!s_panel_pending)
+        {
+            s_counts.display_updates++;
+        }
+        memcpy(s_panel, panel, std::min(size, sizeof(s_panel)));
+        s_panel_time = now;
+        s_panel_pending = true;
+    }
+
+    void capture_text(int x, int y, const char *text)
+    {
+        s_counts.display_text++;
+        if (!s_text_file)
+        {
+            return;
+        }
+        fprintf(s_text_file, "%lu,%d,%d,\"", millis(), x, y);
+        for (const char *c = text; *c; c++)
+        {
+            if (*c == '"')
+            {
+                fputc('"', s_text_file);
+            }
+            fputc(*c, s_text_file);
+        }
+        fputs("\"\n", s_text_file);
+    }
+
+    void capture_leds(const uint32_t *colors, size_t count)
+    {
+        s_counts.led_frames++;
+        if (!s_led_file)
+        {
+            return;
+        }
+        fprintf(s_led_file, "%lu", millis());
+        for (size_t i = 0; i < count; i++)
+        {
+            fprintf(s_led_file, ",%06X", colors[i]);
+        }
+        fputc('\n', s_led_file);
+    }
+
+    void capture_tone(uint32_t frequency_hz)
+    {
+        s_counts.tone_changes++;
+        if (s_tone_file)
+        {
+            fprintf(s_tone_file, "%lu,%u\n", millis(), frequency_hz);
+        }
+    }
+}
+
+unsigned long millis()
+{
+    return static_cast<unsigned long>(s_now_us / 1000);
+}
+
+unsigned long micros()
+{
+    return static_cast<unsigned long>(s_now_us);
+}
+
+// Waiting is instant on the virtual clock
+void delay(uint32_t ms)
+{
+    s_now_us += uint64_t(ms) * 1000;
+}
+
+uint16_t analogRead(uint8_t)
+{
+    return s_analog_value;
+}
+
+bool getLocalTime(struct tm *info, uint32_t)
+{
+    time_t now = time(nullptr);
+    if (now < 1000000000)
+    {
+        return false;
+    }
+    localtime_r(&now, info);
+    return true;
+}
+
+void configTzTime(const char *tz, const char *, const char *, const char *)
+{
+    setenv("TZ", tz, 1);
+    tzset();
+}
+
+size_t HardwareSerial::printf(const char *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    int written = vprintf(format, args);
+    va_end(args);
+    return written > 0 ? written : 0;
+}
+
+esp_err_t esp_register_shutdown_handler(shutdown_handler_t handler)
+{
+    s_shutdown_handlers.push_back(handler);
+    return ESP_OK;
+}
+
+// Deterministic, so upload backoff jitter is the same on every run
+uint32_t esp_random(void)
+{
+    s_random ^= s_random << 13;
+    s_random ^= s_random >> 17;
+    s_random ^= s_random << 5;
+    return s_random;
+}
+
+bool SDFS::begin(uint8_t)
+{
+    if (s_sd_root.empty() || (mkdir(s_sd_root.c_str(), 0755) != 0 && errno != EEXIST))
+    {
+        return false;
+    }
+    s_sd_mounted = true;
+    return true;
+}
+
+void SDFS::end()
+{
+    s_sd_mounted = false;
+}
\ No newline at end of file
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <time.h>
+
+/**
+ * @brief Host-side state behind the HAL shims in native/hal.
+ *
+ * The native build links the device sources against thin stand-ins for the
+ * Arduino core, ESP-IDF drivers, SD, U8g2 and the HTTP client. Time is
+ * virtual: millis(), micros(), delay() and time() follow a clock that only
+ * the simulation advances, so a session replays as fast as the host can
+ * process it and every run of the same input gives the same output.
+ *
+ * Outputs that would leave the device are captured:
+ *   sd/          The SD card mount; log files, indexes and the upload backlog
+ *   display.bin  Every panel update: uint32 millis + the 1024-byte U8g2 tile buffer
+ *   display.pbm  The panel after the last update
+ *   display.csv  Text drawn on the panel: millis,x,y,text (glyphs are not rasterised)
+ *   leds.csv     Every frame sent to the strip: millis,RRGGBB per LED
+ *   tones.csv    Speaker changes: millis,frequency_hz (0 is silence)
+ *
+ * The ThingSpeak server behind WiFiClientSecure and HTTPClient is simulated
+ * too. It is unreachable unless a test says otherwise, so a replay keeps its
+ * uploads queued or in the backlog.
+ *
+ * So is the I2S ADC, once a test gives it a signal: its DMA buffers fill
+ * from the virtual clock and the driver queue drops the oldest when readers
+ * fall behind. Without a signal the driver fails to install, and sessions
+ * come in through ReplaySource instead.
+ */
+namespace native_hal
+{
+    enum LogLevel : uint8_t
+    {
+        LOG_NONE,
+        LOG_ERROR,
+        LOG_WARN,
+        LOG_INFO,
+        LOG_DEBUG
+    };
+
+    struct CaptureCounts
+    {
+        uint32_t display_updates{0};
+        uint32_t display_text{0};
+        uint32_t led_frames{0};
+        uint32_t tone_changes{0};
+    };
+
+    // Virtual clock
+    uint64_t now_us();
+    void advance_us(uint64_t us);
+    void set_epoch(time_t epoch); // Wall time at virtual time 0; 0 leaves the clock unset
+
+    // Host directory that SD.begin() mounts at config::logging::MOUNT_POINT
+    void set_sd_root(const char *directory);
+
+    bool open_capture(const char *directory);
+    void close_capture();
+    const CaptureCounts &get_capture_counts();
+
+    void set_log_level(LogLevel level);
+    void set_analog_value(uint16_t value); // What analogRead() returns
+    void run_shutdown_handlers();          // As esp_restart() would
+
+    // Simulated ThingSpeak server
+    void set_server_reachable(bool reachable);
+    void set_handshake_ms(uint32_t ms); // Virtual time a TLS connect takes
+    void set_http_status(int status);   // Answer to a request on a live connection
+    void drop_server_connections();     // The server closes every open connection, as after an idle timeout
+
+    // Simulated I2S ADC
+    using AdcSignal = uint16_t (*)(uint64_t index); // 12-bit sample number `index` since sampling started
+    void set_adc_signal(AdcSignal signal);          // nullptr makes i2s_driver_install() fail
+
+    // Used by the shims
+    bool log_enabled(LogLevel level);
+    void capture_display(const uint8_t *panel, size_t size);
+    void capture_text(int x, int y, const char *text);
+    void capture_leds(const uint32_t *colors, size_t count);
+    void capture_tone(uint32_t frequency_hz);
+    bool server_connect(uint32_t &connection);
+    bool server_connection_alive(uint32_t connection);
+    int server_http_status();
+    bool i2s_install(uint32_t sample_rate_hz, int buffer_count, int buffer_length);
+    void i2s_start();
+    void i2s_uninstall();
+    size_t i2s_read(uint16_t *samples, size_t count);
+}
\ No newline at end of file
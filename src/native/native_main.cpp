@@ -0,0 +1,206 @@
+/**
+ * @brief Host simulation: replay a recorded session through NoiseMonitor.
+ *
+ * Build and run with PlatformIO:
+ *   pio run -e native && .pio/build/native/program session.wav --out run1
+ * Usage:  program [--out DIR] [--epoch T] [--loop --duration S] [-v] FILE
+ *
+ * FILE is a WAV or CSV recording (see ReplaySource). The firmware runs as in
+ * setup()/loop() but on the virtual clock of native_hal.hpp, which jumps
+ * straight to the next sample block or scheduler deadline, so a session
+ * replays as fast as the host can process it. Everything the device would
+ * output is captured in DIR (default "native_out") for golden comparisons:
+ * compare two runs with diff -r.
+ *
+ * --epoch  Wall time at the start of the replay (default 2024-01-01 UTC),
+ *          0 to run with the clock unset
+ * --loop   Repeat the recording, for soak runs bounded by --duration seconds
+ * -v       Log at INFO, -vv at DEBUG (default WARN)
+ *
+ * Left out of unit test builds (pio test -e native), whose suites have their
+ * own main().
+ */
+#ifndef PIO_UNIT_TESTING
+
+#include <Arduino.h>
+#include <errno.h>
+#include <sys/stat.h>
+#include <chrono>
+#include <string>
+#include "components/noise_monitor.hpp"
+#include "components/replay_source.hpp"
+#include "components/wifi_manager.hpp"
+#include "components/api_handler.hpp"
+#include "native_hal.hpp"
+
+namespace
+{
+    constexpr time_t DEFAULT_EPOCH = 1704067200;
+    constexpr uint64_t BLOCK_SIZE = config::adc::acquisition::BLOCK_SIZE;
+
+    // Static like the device's global, the components are too large for the stack
+    NoiseMonitor noise_monitor;
+
+    /**
+     * @brief Time the next sample block completes, as ReplaySource counts them.
+     * @param elapsed_us Replay time so far.
+     * @param sample_rate_hz The recording's rate.
+     * @return Replay time of the next block boundary.
+     */
+    uint64_t next_block_us(uint64_t elapsed_us, uint32_t sample_rate_hz)
+    {
+        uint64_t blocks = elapsed_us * sample_rate_hz / 1000000 / BLOCK_SIZE;
+        return ((blocks + 1) * BLOCK_SIZE * 1000000 + sample_rate_hz - 1) / sample_rate_hz;
+    }
+
+    bool make_directory(const std::string &path)
+    {
+        return mkdir(path.c_str(), 0755) == 0 || errno == EEXIST;
+    }
+
+    void print_summary(const ReplaySource &replay, uint64_t replay_us, double wall_s)
+    {
+        const AudioSource::Stats &stats = replay.get_stats();
+        double audio_s = replay_us / 1e6;
+        printf("Replayed %.1f s of audio in %.2f s (%.0fx real time)\n", audio_s, wall_s,
+               wall_s > 0 ? audio_s / wall_s : 0.0);
+        printf("Blocks: %u read, %u dropped\n", stats.blocks_read, stats.blocks_dropped);
+
+        NoiseMonitor::FrameRing::Stats frames = noise_monitor.get_frame_stats();
+        printf("Frames: %u pushed, %u overflows\n", frames.pushed, frames.overflows);
+
+        const TaskScheduler &scheduler = noise_monitor.get_scheduler();
+        printf("%-10s %8s %8s %8s %10s\n", "task", "runs", "overruns", "missed", "max jitter");
+        for (TaskScheduler::TaskId id = 0; id < scheduler.get_task_count(); id++)
+        {
+            const TaskScheduler::TaskStats &task = scheduler.get_stats(id);
+            printf("%-10s %8u %8u %8u %8u ms\n", scheduler.get_config(id).name, task.runs, task.overruns,
+                   task.missed_periods, task.max_jitter_ms);
+        }
+
+        const native_hal::CaptureCounts &counts = native_hal::get_capture_counts();
+        printf("Captured: %u display updates, %u text draws, %u LED frames, %u tone changes\n",
+               counts.display_updates, counts.display_text, counts.led_frames, counts.tone_changes);
+    }
+
+    void usage()
+    {
+        fprintf(stderr, "usage: program [--out DIR] [--epoch T] [--loop --duration S] [-v] FILE\n");
+    }
+}
+
+int main(int argc, char **argv)
+{
+    std::string output = "native_out";
+    const char *input = nullptr;
+    time_t epoch = DEFAULT_EPOCH;
+    bool loop = false;
+    double duration_s = 0;
+    native_hal::LogLevel log_level = native_hal::LOG_WARN;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (!strcmp(argv[i], "--out") && i + 1 < argc)
+        {
+            output = argv[++i];
+        }
+        else if (!strcmp(argv[i], "--epoch") && i + 1 < argc)
+        {
+            epoch = static_cast<time_t>(strtoll(argv[++i], nullptr, 10));
+        }
+        else if (!strcmp(argv[i], "--duration") && i + 1 < argc)
+        {
+            duration_s = strtod(argv[++i], nullptr);
+        }
+        else if (!strcmp(argv[i], "--loop"))
+        {
+            loop = true;
+        }
+        else if (!strcmp(argv[i], "-v") || !strcmp(argv[i], "-vv"))
+        {
+            log_level = argv[i][2] ? native_hal::LOG_DEBUG : native_hal::LOG_INFO;
+        }
+        else if (argv[i][0] == '-' || input)
+        {
+            usage();
+            return 2;
+        }
+        else
+        {
+            input = argv[i];
+        }
+    }
+    if (!input || (loop && duration_s <= 0))
+    {
+        usage();
+        return 2;
+    }
+
+    if (!make_directory(output) || !native_hal::open_capture(output.c_str()))
+    {
+        fprintf(stderr, "Cannot create %s\n", output.c_str());
+        return 1;
+    }
+    setenv("TZ", "UTC0", 1);
+    tzset();
+    native_hal::set_epoch(epoch);
+    native_hal::set_log_level(log_level);
+    native_hal::set_sd_root((output + "/sd").c_str());
+
+    ReplaySource replay(input, loop);
+    replay.set_clock(native_hal::now_us);
+
+    // As setup() in main.cpp
+    wifi::WiFiManager::instance().init();
+    ApiHandler::instance().begin();
+    uint64_t replay_start_us = native_hal::now_us();
+    noise_monitor.set_audio_source(replay);
+    if (!noise_monitor.begin())
+    {
+        fprintf(stderr, "Noise monitor started without its logger\n");
+    }
+
+    uint32_t sample_rate_hz = replay.get_sample_rate();
+    if (sample_rate_hz == 0)
+    {
+        fprintf(stderr, "%s: cannot replay\n", input);
+        return 1;
+    }
+    if (sample_rate_hz != config::adc::acquisition::SAMPLE_RATE_HZ)
+    {
+        fprintf(stderr, "%s: recorded at %u Hz, the weighting filters and spectrum assume %u Hz\n", input,
+                sample_rate_hz, config::adc::acquisition::SAMPLE_RATE_HZ);
+    }
+    uint64_t duration_us = static_cast<uint64_t>(duration_s * 1e6);
+
+    // As loop(), jumping the clock to whatever is due next
+    auto wall_start = std::chrono::steady_clock::now();
+    for (;;)
+    {
+        noise_monitor.update();
+
+        uint64_t elapsed_us = native_hal::now_us() - replay_start_us;
+        if (replay.is_finished() || (duration_us && elapsed_us >= duration_us))
+        {
+            break;
+        }
+
+        uint64_t next_us = replay_start_us + next_block_us(elapsed_us, sample_rate_hz);
+        uint32_t until_task_ms = noise_monitor.get_scheduler().time_until_next();
+        if (until_task_ms != UINT32_MAX)
+        {
+            next_us = min(next_us, (native_hal::now_us() / 1000 + until_task_ms) * 1000);
+        }
+        native_hal::advance_us(max(next_us, native_hal::now_us() + 1) - native_hal::now_us());
+    }
+    double wall_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - wall_start).count();
+
+    // As a restart would: flush the log and close the files
+    native_hal::run_shutdown_handlers();
+    native_hal::close_capture();
+
+    print_summary(replay, native_hal::now_us() - replay_start_us, wall_s);
+    return 0;
+}
+
+#endif // PIO_UNIT_TESTING
\ No newline at end of file
@@ -0,0 +1,161 @@
+#include <U8g2lib.h>
+#include <driver/ledc.h>
+#include <driver/rmt.h>
+#include <vector>
+#include "native_hal.hpp"
+
+namespace
+{
+    uint32_t s_tone_frequency_hz = 0;
+    uint32_t s_tone_duty = 0;
+    uint32_t s_tone_output_hz = 0;
+    bool s_tone_started = false;
+    std::vector<uint32_t> s_led_colors;
+
+    constexpr int BITS_PER_PIXEL = 24;
+    constexpr uint32_t BIT_THRESHOLD_TICKS = 24; // High time separating a 1 from a 0 at clk_div 2
+}
+
+esp_err_t ledc_timer_config(const ledc_timer_config_t *timer_config)
+{
+    s_tone_frequency_hz = timer_config->freq_hz;
+    return ESP_OK;
+}
+
+esp_err_t ledc_channel_config(const ledc_channel_config_t *channel_config)
+{
+    s_tone_duty = channel_config->duty;
+    return ESP_OK;
+}
+
+esp_err_t ledc_set_freq(ledc_mode_t, ledc_timer_t, uint32_t frequency_hz)
+{
+    s_tone_frequency_hz = frequency_hz;
+    return ESP_OK;
+}
+
+esp_err_t ledc_set_duty(ledc_mode_t, ledc_channel_t, uint32_t duty)
+{
+    s_tone_duty = duty;
+    return ESP_OK;
+}
+
+// The speaker sounds when the latched duty is non-zero
+esp_err_t ledc_update_duty(ledc_mode_t, ledc_channel_t)
+{
+    uint32_t output_hz = s_tone_duty ? s_tone_frequency_hz : 0;
+    if (!s_tone_started || output_hz != s_tone_output_hz)
+    {
+        s_tone_output_hz = output_hz;
+        s_tone_started = true;
+        native_hal::capture_tone(output_hz);
+    }
+    return ESP_OK;
+}
+
+// Decodes the WS2812 bit stream, GRB with the most significant bit first
+esp_err_t rmt_write_items(rmt_channel_t, const rmt_item32_t *items, int count, bool)
+{
+    if (count % BITS_PER_PIXEL != 0)
+    {
+        return ESP_FAIL;
+    }
+    s_led_colors.assign(count / BITS_PER_PIXEL, 0);
+    for (size_t pixel = 0; pixel < s_led_colors.size(); pixel++)
+    {
+        uint32_t grb = 0;
+        for (int bit = 0; bit < BITS_PER_PIXEL; bit++)
+        {
+            grb = (grb << 1) | (items->duration0 > BIT_THRESHOLD_TICKS ? 1 : 0);
+            items++;
+        }
+        s_led_colors[pixel] = ((grb & 0x00FF00) << 8) | ((grb & 0xFF0000) >> 8) | (grb & 0xFF);
+    }
+    native_hal::capture_leds(s_led_colors.data(), s_led_colors.size());
+    return ESP_OK;
+}
+
+// Draw colour 0 clears, 1 sets and 2 inverts, as in U8g2
+void U8G2_ST7565_ERC12864_ALT_F_4W_HW_SPI::drawPixel(int x, int y)
+{
+    if (x < 0 || x >= WIDTH || y < 0 || y >= HEIGHT)
+    {
+        return;
+    }
+    uint8_t &tile_byte = m_buffer[(y / 8) * WIDTH + x];
+    uint8_t mask = 1 << (y % 8);
+    if (m_color == 0)
+    {
+        tile_byte &= ~mask;
+    }
+    else if (m_color == 1)
+    {
+        tile_byte |= mask;
+    }
+    else
+    {
+        tile_byte ^= mask;
+    }
+}
+
+void U8G2_ST7565_ERC12864_ALT_F_4W_HW_SPI::drawHLine(int x, int y, int w)
+{
+    for (int i = 0; i < w; i++)
+    {
+        drawPixel(x + i, y);
+    }
+}
+
+void U8G2_ST7565_ERC12864_ALT_F_4W_HW_SPI::drawVLine(int x, int y, int h)
+{
+    for (int i = 0; i < h; i++)
+    {
+        drawPixel(x, y + i);
+    }
+}
+
+void U8G2_ST7565_ERC12864_ALT_F_4W_HW_SPI::drawBox(int x, int y, int w, int h)
+{
+    for (int i = 0; i < h; i++)
+    {
+        drawHLine(x, y + i, w);
+    }
+}
+
+void U8G2_ST7565_ERC12864_ALT_F_4W_HW_SPI::drawFrame(int x, int y, int w, int h)
+{
+    if (w <= 0 || h <= 0)
+    {
+        return;
+    }
+    drawHLine(x, y, w);
+    drawHLine(x, y + h - 1, w);
+    drawVLine(x, y + 1, h - 2);
+    drawVLine(x + w - 1, y + 1, h - 2);
+}
+
+uint16_t U8G2_ST7565_ERC12864_ALT_F_4W_HW_SPI::drawStr(int x, int y, const char *text)
+{
+    native_hal::capture_text(x, y, text);
+    return getStrWidth(text);
+}
+
+void U8G2_ST7565_ERC12864_ALT_F_4W_HW_SPI::sendBuffer()
+{
+    memcpy(m_panel, m_buffer, sizeof(m_panel));
+    native_hal::capture_display(m_panel, sizeof(m_panel));
+}
+
+void U8G2_ST7565_ERC12864_ALT_F_4W_HW_SPI::updateDisplayArea(uint8_t tile_x, uint8_t tile_y,
+                                                             uint8_t tile_width, uint8_t tile_height)
+{
+    for (uint8_t row = tile_y; row < tile_y + tile_height && row < HEIGHT / 8; row++)
+    {
+        for (uint8_t tile = tile_x; tile < tile_x + tile_width && tile < WIDTH / 8; tile++)
+        {
+            size_t offset = row * WIDTH + tile * 8;
+            memcpy(m_panel + offset, m_buffer + offset, 8);
+        }
+    }
+    native_hal::capture_display(m_panel, sizeof(m_panel));
+}
\ No newline at end of file
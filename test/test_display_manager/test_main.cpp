@@ -0,0 +1,146 @@
+/**
+ * @brief DisplayManager on the native panel: what a frame costs on the bus
+ * for a full redraw, an unchanged frame, a highlighted category and a new
+ * plot column, and the average over a simulated minute of updates.
+ */
+#include <unity.h>
+#include "components/display_manager.hpp"
+
+namespace
+{
+    constexpr uint32_t FRAME_BYTES = 128 * 64 / 8;
+    constexpr uint32_t TILE_BYTES = 8;
+
+    SignalFrame make_frame(float laeq, SignalProcessor::NoiseLevel category)
+    {
+        SignalFrame frame;
+        frame.has_levels = true;
+        frame.laeq = laeq;
+        frame.category = category;
+        return frame;
+    }
+
+    // Plot samples every SAMPLE_INTERVAL, as from the noise monitor, wandering over the plot range
+    void add_plot_points(DisplayManager &display, unsigned long &now_ms, uint32_t duration_ms, uint32_t &seed)
+    {
+        for (uint32_t elapsed = 0; elapsed < duration_ms; elapsed += config::timing::SAMPLE_INTERVAL)
+        {
+            seed = seed * 1664525u + 1013904223u;
+            display.add_plot_point(static_cast<uint16_t>(100 + (seed >> 16) % 200), now_ms);
+            now_ms += config::timing::SAMPLE_INTERVAL;
+        }
+    }
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_first_frame_sends_whole_panel()
+{
+    AlertManager alerts;
+    DisplayManager display(alerts);
+    display.begin();
+    display.update(make_frame(55.0f, SignalProcessor::NoiseLevel::OK));
+
+    const DisplayManager::Stats &stats = display.get_stats();
+    TEST_ASSERT_EQUAL_UINT32(1, stats.frames);
+    TEST_ASSERT_EQUAL_UINT32(FRAME_BYTES, stats.last_frame_bytes);
+    TEST_ASSERT_EQUAL_UINT32(3, stats.rows_rendered);
+}
+
+void test_unchanged_frame_sends_nothing()
+{
+    AlertManager alerts;
+    DisplayManager display(alerts);
+    display.begin();
+    SignalFrame frame = make_frame(55.0f, SignalProcessor::NoiseLevel::OK);
+    display.update(frame);
+
+    for (int i = 0; i < 10; i++)
+    {
+        display.update(frame);
+        TEST_ASSERT_EQUAL_UINT32(0, display.get_stats().last_frame_bytes);
+    }
+    TEST_ASSERT_EQUAL_UINT32(FRAME_BYTES, display.get_stats().bytes_sent);
+    TEST_ASSERT_EQUAL_UINT32(3, display.get_stats().rows_rendered);
+}
+
+void test_highlight_sends_only_its_tiles()
+{
+    AlertManager alerts;
+    DisplayManager display(alerts);
+    display.begin();
+    display.update(make_frame(55.0f, SignalProcessor::NoiseLevel::OK));
+
+    // The box behind "HIGH" is 24x10 pixels from x 64, y 2: three tile columns on two pages
+    display.update(make_frame(72.0f, SignalProcessor::NoiseLevel::ELEVATED));
+    TEST_ASSERT_EQUAL_UINT32(6 * TILE_BYTES, display.get_stats().last_frame_bytes);
+
+    // Clearing it again costs the same
+    display.update(make_frame(55.0f, SignalProcessor::NoiseLevel::OK));
+    TEST_ASSERT_EQUAL_UINT32(6 * TILE_BYTES, display.get_stats().last_frame_bytes);
+}
+
+void test_new_plot_column_sends_one_tile_column()
+{
+    AlertManager alerts;
+    DisplayManager display(alerts);
+    display.begin();
+    SignalFrame frame = make_frame(55.0f, SignalProcessor::NoiseLevel::OK);
+    display.update(frame);
+
+    // A column from zero to full scale runs through all four plot pages
+    unsigned long now_ms = 1000;
+    display.add_plot_point(0, now_ms);
+    display.add_plot_point(config::signal_processing::ranges::MAX, now_ms);
+    display.update(frame);
+    TEST_ASSERT_EQUAL_UINT32(4 * TILE_BYTES, display.get_stats().last_frame_bytes);
+
+    // Changing the span empties the plot; a quiet sample then only touches the baseline page
+    display.set_plot_span(PlotEnvelope::Span::SECONDS_10);
+    display.update(frame);
+    TEST_ASSERT_EQUAL_UINT32(4 * TILE_BYTES, display.get_stats().last_frame_bytes);
+    display.add_plot_point(0, now_ms);
+    display.update(frame);
+    TEST_ASSERT_EQUAL_UINT32(TILE_BYTES, display.get_stats().last_frame_bytes);
+}
+
+void test_benchmark_simulated_minute()
+{
+    AlertManager alerts;
+    DisplayManager display(alerts);
+    display.begin();
+    display.update(make_frame(55.0f, SignalProcessor::NoiseLevel::OK));
+    const uint32_t bytes_before = display.get_stats().bytes_sent;
+
+    // A minute of display updates over a plot that scrolls a column every 78 ms
+    unsigned long now_ms = 1000;
+    uint32_t seed = 1;
+    const uint32_t frames = 60000 / config::timing::DISPLAY_INTERVAL;
+    for (uint32_t i = 0; i < frames; i++)
+    {
+        add_plot_points(display, now_ms, config::timing::DISPLAY_INTERVAL, seed);
+        display.update(make_frame(55.0f + (i % 20) * 0.1f, SignalProcessor::NoiseLevel::OK));
+    }
+
+    const DisplayManager::Stats &stats = display.get_stats();
+    uint32_t average = (stats.bytes_sent - bytes_before) / frames;
+    // Text is not rasterised on the host, so this is the plot's share: at most its four pages
+    TEST_ASSERT_TRUE(average <= FRAME_BYTES / 2);
+
+    char message[128];
+    snprintf(message, sizeof(message), "%u frames, %u bytes per frame on average against %u for a full redraw",
+             frames, average, FRAME_BYTES);
+    TEST_MESSAGE(message);
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_first_frame_sends_whole_panel);
+    RUN_TEST(test_unchanged_frame_sends_nothing);
+    RUN_TEST(test_highlight_sends_only_its_tiles);
+    RUN_TEST(test_new_plot_column_sends_one_tile_column);
+    RUN_TEST(test_benchmark_simulated_minute);
+    return UNITY_END();
+}
\ No newline at end of file
@@ -0,0 +1,181 @@
+/**
+ * @brief Fixed-point against float envelope filters over a long synthetic
+ * recording, checked against double-precision references, and a per-sample
+ * cost benchmark of both.
+ */
+#include <unity.h>
+#include <chrono>
+#include <math.h>
+#include <vector>
+#include "components/envelope_filter.hpp"
+
+namespace
+{
+    constexpr uint32_t SAMPLE_RATE_HZ = config::adc::acquisition::SAMPLE_RATE_HZ;
+    constexpr size_t RECORDING_SAMPLES = size_t(SAMPLE_RATE_HZ) * 600; // Ten minutes
+
+    /**
+     * Quiet and loud stretches with noise on top, around a mid-scale bias like
+     * the microphone module's. The slow baseline needs minutes to settle on it.
+     */
+    std::vector<uint16_t> make_recording()
+    {
+        std::vector<uint16_t> samples(RECORDING_SAMPLES);
+        uint32_t state = 2024;
+        for (size_t i = 0; i < samples.size(); i++)
+        {
+            state = state * 1664525u + 1013904223u;
+            int32_t noise = static_cast<int32_t>(state >> 22) - 512;
+            int32_t amplitude = (i / (SAMPLE_RATE_HZ * 20)) % 3 == 2 ? 4 : 1;
+            int32_t value = 1800 + noise * amplitude / 2;
+            samples[i] = static_cast<uint16_t>(value < 0 ? 0 : (value > 4095 ? 4095 : value));
+        }
+        return samples;
+    }
+
+    const std::vector<uint16_t> &recording()
+    {
+        static const std::vector<uint16_t> samples = make_recording();
+        return samples;
+    }
+
+    // The same recurrences in double precision
+    class ReferenceFilter
+    {
+    public:
+        ReferenceFilter(double ema_alpha, double baseline_alpha)
+            : m_ema_alpha(ema_alpha), m_baseline_alpha(baseline_alpha) {}
+
+        void update(uint16_t raw_value)
+        {
+            m_ema += m_ema_alpha * (raw_value - m_ema);
+            if (m_baseline == 0)
+            {
+                m_baseline = m_ema;
+            }
+            m_baseline += m_baseline_alpha * (m_ema - m_baseline);
+        }
+
+        double value() const { return m_ema; }
+        double baseline() const { return m_baseline; }
+
+    private:
+        double m_ema_alpha;
+        double m_baseline_alpha;
+        double m_ema{0};
+        double m_baseline{0};
+    };
+
+    constexpr double Q15 = 1 << fixed_point::Q15_FRAC_BITS;
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_fixed_point_tracks_reference()
+{
+    FixedEnvelopeFilter fixed;
+    ReferenceFilter reference(FixedEnvelopeFilter::EMA_ALPHA_Q15 / Q15,
+                              FixedEnvelopeFilter::BASELINE_ALPHA_Q15 / Q15);
+    double max_value_error = 0;
+    double max_baseline_error = 0;
+    for (uint16_t sample : recording())
+    {
+        fixed.update(sample);
+        reference.update(sample);
+        max_value_error = fmax(max_value_error, fabs(fixed.value() - reference.value()));
+        max_baseline_error = fmax(max_baseline_error, fabs(fixed.baseline() - reference.baseline()));
+    }
+
+    // Rounding stays within a few LSBs of the state, far below one ADC count
+    TEST_ASSERT_TRUE(max_value_error < 1e-3);
+    TEST_ASSERT_TRUE(max_baseline_error < 1e-3);
+}
+
+void test_float_baseline_drifts_where_fixed_does_not()
+{
+    FloatEnvelopeFilter floating;
+    FixedEnvelopeFilter fixed;
+    ReferenceFilter float_reference(config::signal_processing::EMA_ALPHA, config::signal_processing::BASELINE_ALPHA);
+    ReferenceFilter fixed_reference(FixedEnvelopeFilter::EMA_ALPHA_Q15 / Q15,
+                                    FixedEnvelopeFilter::BASELINE_ALPHA_Q15 / Q15);
+    for (uint16_t sample : recording())
+    {
+        floating.update(sample);
+        fixed.update(sample);
+        float_reference.update(sample);
+        fixed_reference.update(sample);
+    }
+
+    double float_error = fabs(floating.baseline() - float_reference.baseline());
+    double fixed_error = fabs(fixed.baseline() - fixed_reference.baseline());
+    char message[96];
+    snprintf(message, sizeof(message), "Baseline error after ten minutes: float %.4f, fixed %.6f ADC counts",
+             float_error, fixed_error);
+    TEST_MESSAGE(message);
+    TEST_ASSERT_TRUE(fixed_error < float_error);
+
+    // Both envelopes follow the signal; they differ only by the Q15 rounding of alpha
+    TEST_ASSERT_FLOAT_WITHIN(2.0f, floating.value(), fixed.value());
+}
+
+// Integer-only, so every build reaches the same state for the configured alphas
+void test_fixed_point_is_deterministic()
+{
+    FixedEnvelopeFilter fixed;
+    for (uint16_t sample : recording())
+    {
+        fixed.update(sample);
+    }
+    // Recorded on the host; integer arithmetic gives the same state on the device
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, 1107.48047f, fixed.value());
+    TEST_ASSERT_FLOAT_WITHIN(1e-3f, 1794.41858f, fixed.baseline());
+}
+
+void test_constant_input_settles_on_input()
+{
+    FixedEnvelopeFilter fixed;
+    for (size_t i = 0; i < size_t(SAMPLE_RATE_HZ) * 120; i++)
+    {
+        fixed.update(1234);
+    }
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 1234.0f, fixed.value());
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 1234.0f, fixed.baseline());
+}
+
+template <typename Filter>
+double nanoseconds_per_sample()
+{
+    Filter filter;
+    auto start = std::chrono::steady_clock::now();
+    for (uint16_t sample : recording())
+    {
+        filter.update(sample);
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    // Keep the result alive so the loop is not optimised away
+    volatile float sink = filter.value() + filter.baseline();
+    (void)sink;
+    return seconds * 1e9 / recording().size();
+}
+
+void test_benchmark_cost_per_sample()
+{
+    double float_ns = nanoseconds_per_sample<FloatEnvelopeFilter>();
+    double fixed_ns = nanoseconds_per_sample<FixedEnvelopeFilter>();
+    char message[96];
+    snprintf(message, sizeof(message), "float: %.2f ns/sample, fixed: %.2f ns/sample", float_ns, fixed_ns);
+    TEST_MESSAGE(message);
+    TEST_ASSERT_TRUE(float_ns > 0 && fixed_ns > 0);
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_fixed_point_tracks_reference);
+    RUN_TEST(test_float_baseline_drifts_where_fixed_does_not);
+    RUN_TEST(test_fixed_point_is_deterministic);
+    RUN_TEST(test_constant_input_settles_on_input);
+    RUN_TEST(test_benchmark_cost_per_sample);
+    return UNITY_END();
+}
\ No newline at end of file
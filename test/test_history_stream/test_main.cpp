@@ -0,0 +1,406 @@
+/**
+ * @brief HistoryStream: request parsing, and whole responses over a local
+ * socket pair from a directory of sample day logs, binary and CSV, raw and
+ * averaged, including a client that hangs up mid-stream.
+ */
+#include <unity.h>
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <string>
+#include <thread>
+#include <vector>
+#include "components/history_stream.hpp"
+
+namespace
+{
+    using namespace log_format;
+
+    constexpr uint32_t DAY1 = 1704067200; // 2024-01-01 00:00 UTC
+    constexpr uint32_t DAY2 = DAY1 + 86400;
+    constexpr uint32_t STEP_S = 10;
+
+    char g_directory[] = "/tmp/history_stream_XXXXXX";
+    std::vector<std::string> g_files;
+
+    struct Row
+    {
+        int32_t values[NUM_FIELDS];
+    };
+
+    // Day one as a binary log, day two as CSV, nothing for day three
+    std::vector<Row> g_rows;
+
+    std::vector<Row> make_rows(uint32_t start, uint32_t end, uint32_t seed)
+    {
+        std::vector<Row> rows;
+        Row row{};
+        for (size_t f = 1; f < NUM_FIELDS; f++)
+        {
+            row.values[f] = 150000;
+        }
+        for (uint32_t t = start; t < end; t += STEP_S)
+        {
+            row.values[TIMESTAMP] = static_cast<int32_t>(t);
+            for (size_t f = 1; f < NUM_FIELDS; f++)
+            {
+                seed = seed * 1664525u + 1013904223u;
+                row.values[f] += static_cast<int32_t>(seed >> 26) - 32;
+            }
+            row.values[CATEGORY] = (seed >> 8) % 3;
+            rows.push_back(row);
+        }
+        return rows;
+    }
+
+    FILE *create(const char *name)
+    {
+        g_files.push_back(std::string(g_directory) + "/" + name);
+        FILE *file = fopen(g_files.back().c_str(), "wb");
+        TEST_ASSERT_NOT_NULL(file);
+        return file;
+    }
+
+    void write_binary(const char *name, const std::vector<Row> &rows)
+    {
+        FILE *file = create(name);
+        FileHeader header = make_file_header(rows.front().values[TIMESTAMP]);
+        fwrite(&header, sizeof(header), 1, file);
+
+        static BlockEncoder encoder(60);
+        size_t size;
+        for (const Row &row : rows)
+        {
+            if (!encoder.add(row.values))
+            {
+                const uint8_t *block = encoder.finish(size);
+                fwrite(block, 1, size, file);
+                encoder.add(row.values);
+            }
+        }
+        const uint8_t *block = encoder.finish(size);
+        fwrite(block, 1, size, file);
+        fclose(file);
+    }
+
+    void write_csv(const char *name, const std::vector<Row> &rows)
+    {
+        FILE *file = create(name);
+        fputs("timestamp,noise,baseline,category,1min_avg,15min_avg,laeq,lcpeak,1min_l10,1min_l50,1min_l90,1min_max\r\n",
+              file);
+        for (const Row &row : rows)
+        {
+            const int32_t *v = row.values;
+            fprintf(file, "%ld,%.2f,%.2f,%d,%.2f,%.2f,%.2f,%.2f,%d,%d,%d,%d\r\n", static_cast<long>(v[TIMESTAMP]),
+                    v[NOISE] / 100.0, v[BASELINE] / 100.0, static_cast<int>(v[CATEGORY]), v[ONE_MIN_AVG] / 100.0,
+                    v[FIFTEEN_MIN_AVG] / 100.0, v[LAEQ] / 100.0, v[LCPEAK] / 100.0, static_cast<int>(v[ONE_MIN_L10]),
+                    static_cast<int>(v[ONE_MIN_L50]), static_cast<int>(v[ONE_MIN_L90]),
+                    static_cast<int>(v[ONE_MIN_MAX]));
+        }
+        fclose(file);
+    }
+
+    // The row the stream should send for a record
+    std::string format_row(const int32_t *values)
+    {
+        std::string row;
+        char field[24];
+        for (size_t f = 0; f < NUM_FIELDS; f++)
+        {
+            if (FIELDS[f].scale == 1)
+            {
+                snprintf(field, sizeof(field), "%ld", static_cast<long>(values[f]));
+            }
+            else
+            {
+                snprintf(field, sizeof(field), "%.2f", values[f] / 100.0);
+            }
+            row += field;
+            row += f + 1 < NUM_FIELDS ? "," : "\r\n";
+        }
+        return row;
+    }
+
+    std::string header_row()
+    {
+        std::string row;
+        for (size_t f = 0; f < NUM_FIELDS; f++)
+        {
+            row += FIELDS[f].name;
+            row += f + 1 < NUM_FIELDS ? "," : "\r\n";
+        }
+        return row;
+    }
+
+    struct Response
+    {
+        std::string head;
+        std::string body; // De-chunked
+        size_t chunks{0};
+        size_t max_chunk{0};
+        bool complete{false}; // Ended with the zero-size chunk
+    };
+
+    Response parse_response(const std::string &raw)
+    {
+        Response response;
+        size_t end = raw.find("\r\n\r\n");
+        if (end == std::string::npos)
+        {
+            return response;
+        }
+        response.head = raw.substr(0, end + 4);
+        if (response.head.find("chunked") == std::string::npos)
+        {
+            response.body = raw.substr(end + 4);
+            response.complete = true;
+            return response;
+        }
+
+        size_t pos = end + 4;
+        while (pos < raw.size())
+        {
+            size_t line_end = raw.find("\r\n", pos);
+            if (line_end == std::string::npos)
+            {
+                break;
+            }
+            size_t size = strtoul(raw.c_str() + pos, nullptr, 16);
+            if (size == 0)
+            {
+                response.complete = raw.compare(line_end, 4, "\r\n\r\n") == 0;
+                break;
+            }
+            response.body += raw.substr(line_end + 2, size);
+            response.chunks++;
+            response.max_chunk = std::max(response.max_chunk, size);
+            pos = line_end + 2 + size + 2;
+        }
+        return response;
+    }
+
+    // Serve one request on a socket pair, reading everything the stream sends until it closes
+    std::string exchange(HistoryStream &stream, const char *request, size_t read_limit = SIZE_MAX)
+    {
+        int sockets[2];
+        TEST_ASSERT_EQUAL_INT(0, socketpair(AF_UNIX, SOCK_STREAM, 0, sockets));
+        std::thread server([&]()
+                           {
+            stream.handle_client(sockets[1]);
+            close(sockets[1]); });
+
+        send(sockets[0], request, strlen(request), 0);
+        shutdown(sockets[0], SHUT_WR);
+        std::string raw;
+        char buffer[4096];
+        ssize_t received;
+        while (raw.size() < read_limit && (received = recv(sockets[0], buffer, sizeof(buffer), 0)) > 0)
+        {
+            raw.append(buffer, received);
+        }
+        close(sockets[0]);
+        server.join();
+        return raw;
+    }
+
+    std::string get(uint32_t from, uint32_t to, uint32_t res = 0)
+    {
+        char request[128];
+        snprintf(request, sizeof(request), "GET /history?from=%u&to=%u&res=%u HTTP/1.1\r\nHost: x\r\n\r\n", from, to,
+                 res);
+        return request;
+    }
+
+    std::string expected_rows(uint32_t from, uint32_t to)
+    {
+        std::string body = header_row();
+        for (const Row &row : g_rows)
+        {
+            uint32_t timestamp = static_cast<uint32_t>(row.values[TIMESTAMP]);
+            if (timestamp >= from && timestamp < to)
+            {
+                body += format_row(row.values);
+            }
+        }
+        return body;
+    }
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_parses_requests()
+{
+    HistoryStream::Request request;
+    TEST_ASSERT_EQUAL_INT(200, HistoryStream::parse_request("GET /history?from=100&to=200&res=60 HTTP/1.1\r\n", 0,
+                                                            request));
+    TEST_ASSERT_EQUAL_UINT32(100, request.from);
+    TEST_ASSERT_EQUAL_UINT32(200, request.to);
+    TEST_ASSERT_EQUAL_UINT32(60, request.resolution_s);
+
+    // Defaults: up to now, the last DEFAULT_RANGE_S, every record; unknown keys ignored
+    TEST_ASSERT_EQUAL_INT(200, HistoryStream::parse_request("GET /history?x=1&flag HTTP/1.1\r\n", DAY1, request));
+    TEST_ASSERT_EQUAL_UINT32(DAY1 + 1, request.to);
+    TEST_ASSERT_EQUAL_UINT32(DAY1 + 1 - config::history::DEFAULT_RANGE_S, request.from);
+    TEST_ASSERT_EQUAL_UINT32(0, request.resolution_s);
+    TEST_ASSERT_EQUAL_INT(200, HistoryStream::parse_request("GET /history HTTP/1.1\r\n", 100, request));
+    TEST_ASSERT_EQUAL_UINT32(0, request.from);
+
+    const struct
+    {
+        const char *head;
+        int status;
+    } rejected[] = {
+        {"POST /history HTTP/1.1\r\n", 405},
+        {"GET /histories HTTP/1.1\r\n", 404},
+        {"GET / HTTP/1.1\r\n", 404},
+        {"GET /history?from=abc HTTP/1.1\r\n", 400},
+        {"GET /history?from=&to=5 HTTP/1.1\r\n", 400},
+        {"GET /history?from=4294967296 HTTP/1.1\r\n", 400},
+        {"GET /history?from=10x&to=20 HTTP/1.1\r\n", 400},
+        {"GET /history?from=200&to=200 HTTP/1.1\r\n", 400},
+        {"GET /history?from=0&to=604801 HTTP/1.1\r\n", 400},
+        {"GET /history?from=0&to=10&res=86401 HTTP/1.1\r\n", 400},
+    };
+    for (const auto &test : rejected)
+    {
+        TEST_ASSERT_EQUAL_INT_MESSAGE(test.status, HistoryStream::parse_request(test.head, DAY1, request), test.head);
+    }
+}
+
+void test_streams_every_record_across_days()
+{
+    HistoryStream stream(g_directory);
+
+    // From mid day one, across the binary and CSV files, into the day with no log
+    uint32_t from = DAY1 + 43205;
+    uint32_t to = DAY2 + 86400 + 3600;
+    Response response = parse_response(exchange(stream, get(from, to).c_str()));
+    TEST_ASSERT_TRUE(response.head.rfind("HTTP/1.1 200 OK\r\n", 0) == 0);
+    TEST_ASSERT_TRUE(response.complete);
+    TEST_ASSERT_TRUE(expected_rows(from, to) == response.body);
+    TEST_ASSERT_TRUE(response.max_chunk <= config::history::STREAM_BUFFER_SIZE);
+    TEST_ASSERT_EQUAL_UINT32((86400 + 43195) / STEP_S, stream.get_stats().records_sent);
+}
+
+void test_averages_into_buckets()
+{
+    HistoryStream stream(g_directory);
+    const uint32_t res = 60;
+    uint32_t from = DAY2 - 1800;
+    uint32_t to = DAY2 + 1800;
+    Response response = parse_response(exchange(stream, get(from, to, res).c_str()));
+    TEST_ASSERT_TRUE(response.complete);
+
+    // Means rounded half away from zero; the category and peaks keep their maximum
+    std::string expected = header_row();
+    for (uint32_t start = from; start < to; start += res)
+    {
+        int64_t sums[NUM_FIELDS] = {};
+        int32_t maxima[NUM_FIELDS];
+        std::fill(std::begin(maxima), std::end(maxima), INT32_MIN);
+        int64_t count = 0;
+        for (const Row &row : g_rows)
+        {
+            uint32_t timestamp = static_cast<uint32_t>(row.values[TIMESTAMP]);
+            if (timestamp >= start && timestamp < start + res)
+            {
+                for (size_t f = 0; f < NUM_FIELDS; f++)
+                {
+                    sums[f] += row.values[f];
+                    maxima[f] = std::max(maxima[f], row.values[f]);
+                }
+                count++;
+            }
+        }
+        int32_t values[NUM_FIELDS];
+        for (size_t f = 0; f < NUM_FIELDS; f++)
+        {
+            values[f] = static_cast<int32_t>((sums[f] + count / 2) / count);
+        }
+        values[TIMESTAMP] = static_cast<int32_t>(start);
+        values[CATEGORY] = maxima[CATEGORY];
+        values[LCPEAK] = maxima[LCPEAK];
+        values[ONE_MIN_MAX] = maxima[ONE_MIN_MAX];
+        expected += format_row(values);
+    }
+    TEST_ASSERT_TRUE(expected == response.body);
+    TEST_ASSERT_EQUAL_UINT32(60, stream.get_stats().records_sent);
+}
+
+void test_rejects_bad_requests_with_a_status()
+{
+    HistoryStream stream(g_directory);
+    Response response = parse_response(exchange(stream, "GET /nope HTTP/1.1\r\n\r\n"));
+    TEST_ASSERT_TRUE(response.head.rfind("HTTP/1.1 404 Not Found\r\n", 0) == 0);
+    TEST_ASSERT_TRUE(response.head.find("Content-Length: 10\r\n") != std::string::npos);
+    TEST_ASSERT_TRUE(response.body == "Not Found\n");
+
+    // No request line at all
+    response = parse_response(exchange(stream, "GET /history"));
+    TEST_ASSERT_TRUE(response.head.rfind("HTTP/1.1 400 Bad Request\r\n", 0) == 0);
+    TEST_ASSERT_EQUAL_UINT32(2, stream.get_stats().rejected);
+}
+
+void test_client_hanging_up_aborts_the_stream()
+{
+    HistoryStream stream(g_directory);
+    std::string raw = exchange(stream, get(DAY1, DAY2 + 86400).c_str(), 8192);
+
+    TEST_ASSERT_TRUE(raw.size() >= 8192);
+    TEST_ASSERT_EQUAL_UINT32(1, stream.get_stats().aborted);
+    TEST_ASSERT_TRUE(stream.get_stats().records_sent < 2 * 86400 / STEP_S);
+}
+
+void test_benchmark_one_day_raw()
+{
+    HistoryStream stream(g_directory);
+    auto start = std::chrono::steady_clock::now();
+    Response response = parse_response(exchange(stream, get(DAY1, DAY2).c_str()));
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    TEST_ASSERT_TRUE(response.complete);
+    TEST_ASSERT_EQUAL_UINT32(86400 / STEP_S, stream.get_stats().records_sent);
+
+    char message[160];
+    snprintf(message, sizeof(message), "One day, %u records: %u bytes in %zu chunks, %.1f ms (%.0f records/s)",
+             stream.get_stats().records_sent, stream.get_stats().bytes_sent, response.chunks, seconds * 1e3,
+             stream.get_stats().records_sent / seconds);
+    TEST_MESSAGE(message);
+}
+
+int main()
+{
+    // Day files are named by local date
+    setenv("TZ", "UTC0", 1);
+    tzset();
+    if (!mkdtemp(g_directory))
+    {
+        return 1;
+    }
+
+    g_rows = make_rows(DAY1, DAY2, 1);
+    std::vector<Row> day2 = make_rows(DAY2, DAY2 + 86400, 2);
+    write_binary("240101.bin", g_rows);
+    write_csv("240102.csv", day2);
+    g_rows.insert(g_rows.end(), day2.begin(), day2.end());
+
+    UNITY_BEGIN();
+    RUN_TEST(test_parses_requests);
+    RUN_TEST(test_streams_every_record_across_days);
+    RUN_TEST(test_averages_into_buckets);
+    RUN_TEST(test_rejects_bad_requests_with_a_status);
+    RUN_TEST(test_client_hanging_up_aborts_the_stream);
+    RUN_TEST(test_benchmark_one_day_raw);
+    int failures = UNITY_END();
+
+    for (const std::string &file : g_files)
+    {
+        unlink(file.c_str());
+    }
+    rmdir(g_directory);
+    return failures;
+}
\ No newline at end of file
@@ -0,0 +1,222 @@
+/**
+ * @brief LedMeter against a mock strip on a fake clock: the compile-time
+ * tables, bar lengths, peak hold and decay, frames skipped when nothing
+ * changed or the strip is still busy, and the cost of an update.
+ */
+#include <unity.h>
+#include <chrono>
+#include <vector>
+#include "components/led_meter.hpp"
+
+namespace
+{
+    constexpr size_t NUM_PIXELS = led_meter::NUM_PIXELS;
+
+    unsigned long g_now = 0;
+
+    unsigned long fake_clock()
+    {
+        return g_now;
+    }
+
+    class MockLedOutput : public LedOutput
+    {
+    public:
+        bool begin() override { return true; }
+        bool is_busy() override { return busy; }
+        void show(const uint32_t *colors) override { frames.emplace_back(colors, colors + NUM_PIXELS); }
+
+        bool busy{false};
+        std::vector<std::vector<uint32_t>> frames;
+    };
+
+    // Index of the last lit LED of a frame, -1 if all are off
+    int last_lit(const std::vector<uint32_t> &frame)
+    {
+        int last = -1;
+        for (size_t i = 0; i < frame.size(); i++)
+        {
+            last = frame[i] ? static_cast<int>(i) : last;
+        }
+        return last;
+    }
+}
+
+void setUp()
+{
+    g_now = 1000;
+}
+
+void tearDown() {}
+
+void test_tables_span_quiet_to_max()
+{
+    namespace ranges = config::signal_processing::ranges;
+    TEST_ASSERT_EQUAL_UINT16(ranges::QUIET, led_meter::THRESHOLDS[0]);
+    TEST_ASSERT_EQUAL_UINT16(ranges::MAX, led_meter::THRESHOLDS[NUM_PIXELS - 1]);
+    for (size_t i = 0; i < NUM_PIXELS; i++)
+    {
+        TEST_ASSERT_NOT_EQUAL(0, led_meter::COLORS[i]);
+    }
+
+    // Gradient ends, with the brightness applied
+    TEST_ASSERT_EQUAL_HEX32(led_meter::gradient_color(0.0f), led_meter::COLORS[0]);
+    TEST_ASSERT_EQUAL_HEX32(led_meter::gradient_color(1.0f), led_meter::COLORS[NUM_PIXELS - 1]);
+}
+
+void test_bar_follows_thresholds()
+{
+    MockLedOutput output;
+    LedMeter meter(output, fake_clock);
+
+    // LED 0 is always lit; LED i joins exactly at its threshold
+    meter.update(0.0f);
+    TEST_ASSERT_EQUAL_UINT8(1, meter.get_bar_length());
+    for (size_t i = 1; i < NUM_PIXELS; i++)
+    {
+        meter.update(led_meter::THRESHOLDS[i] - 0.01f);
+        TEST_ASSERT_EQUAL_UINT8(i, meter.get_bar_length());
+        meter.update(led_meter::THRESHOLDS[i]);
+        TEST_ASSERT_EQUAL_UINT8(i + 1, meter.get_bar_length());
+    }
+    meter.update(10000.0f);
+    TEST_ASSERT_EQUAL_UINT8(NUM_PIXELS, meter.get_bar_length());
+
+    // Lit LEDs carry their own color from the table
+    const std::vector<uint32_t> &frame = output.frames.back();
+    for (size_t i = 0; i < NUM_PIXELS; i++)
+    {
+        TEST_ASSERT_EQUAL_HEX32(led_meter::COLORS[i], frame[i]);
+    }
+}
+
+void test_unchanged_frames_are_not_sent()
+{
+    MockLedOutput output;
+    LedMeter meter(output, fake_clock);
+    const float level = led_meter::THRESHOLDS[2];
+    meter.update(level);
+
+    // Levels inside the same bar step leave the strip alone
+    for (int i = 0; i < 50; i++)
+    {
+        g_now += 50;
+        meter.update(level + (i % 5));
+    }
+    TEST_ASSERT_EQUAL_size_t(1, output.frames.size());
+    TEST_ASSERT_EQUAL_UINT32(1, meter.get_stats().frames_sent);
+    TEST_ASSERT_EQUAL_UINT32(50, meter.get_stats().frames_unchanged);
+}
+
+void test_peak_holds_then_falls()
+{
+    MockLedOutput output;
+    LedMeter meter(output, fake_clock);
+    meter.update(10000.0f);
+    const int8_t top = NUM_PIXELS - 1;
+    TEST_ASSERT_EQUAL_INT8(top, meter.get_peak());
+
+    // The bar drops at once, the peak stays for PEAK_HOLD_MS
+    meter.update(0.0f);
+    TEST_ASSERT_EQUAL_INT(top, last_lit(output.frames.back()));
+    g_now += config::led::PEAK_HOLD_MS - 1;
+    meter.update(0.0f);
+    TEST_ASSERT_EQUAL_INT8(top, meter.get_peak());
+
+    // Then it falls one LED per PEAK_DECAY_MS and disappears into the bar
+    g_now += 1;
+    meter.update(0.0f);
+    TEST_ASSERT_EQUAL_INT8(top - 1, meter.get_peak());
+    for (int8_t expected = top - 2; expected >= 1; expected--)
+    {
+        g_now += config::led::PEAK_DECAY_MS;
+        meter.update(0.0f);
+        TEST_ASSERT_EQUAL_INT8(expected, meter.get_peak());
+        TEST_ASSERT_EQUAL_INT(expected, last_lit(output.frames.back()));
+    }
+    g_now += config::led::PEAK_DECAY_MS;
+    meter.update(0.0f);
+    TEST_ASSERT_EQUAL_INT(0, last_lit(output.frames.back()));
+}
+
+void test_busy_strip_defers_the_frame()
+{
+    MockLedOutput output;
+    LedMeter meter(output, fake_clock);
+    meter.update(0.0f);
+
+    output.busy = true;
+    meter.update(10000.0f);
+    meter.update(10000.0f);
+    TEST_ASSERT_EQUAL_size_t(1, output.frames.size());
+    TEST_ASSERT_EQUAL_UINT32(2, meter.get_stats().output_busy);
+
+    // The held-back frame goes out with the next update once the strip is free
+    output.busy = false;
+    meter.update(10000.0f);
+    TEST_ASSERT_EQUAL_size_t(2, output.frames.size());
+    TEST_ASSERT_EQUAL_INT(NUM_PIXELS - 1, last_lit(output.frames.back()));
+}
+
+void test_clear_turns_everything_off()
+{
+    MockLedOutput output;
+    LedMeter meter(output, fake_clock);
+    meter.update(10000.0f);
+    meter.clear();
+    TEST_ASSERT_EQUAL_INT(-1, last_lit(output.frames.back()));
+    TEST_ASSERT_EQUAL_INT8(-1, meter.get_peak());
+    meter.clear();
+    TEST_ASSERT_EQUAL_size_t(2, output.frames.size());
+}
+
+void test_benchmark_minute_of_updates()
+{
+    MockLedOutput output;
+    LedMeter meter(output, fake_clock);
+
+    // A minute of updates at the LED task period over a level that wanders and spikes
+    const uint32_t updates = 60000 / config::timing::LED_UPDATE_INTERVAL;
+    uint32_t seed = 1;
+    std::vector<float> levels(updates);
+    for (float &level : levels)
+    {
+        seed = seed * 1664525u + 1013904223u;
+        level = (seed >> 16) % 64 == 0 ? 480.0f : 80.0f + (seed >> 16) % 40;
+    }
+
+    const int runs = 200;
+    auto start = std::chrono::steady_clock::now();
+    for (int run = 0; run < runs; run++)
+    {
+        for (float level : levels)
+        {
+            g_now += config::timing::LED_UPDATE_INTERVAL;
+            meter.update(level);
+        }
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    const LedMeter::Stats &stats = meter.get_stats();
+    TEST_ASSERT_EQUAL_UINT32(runs * updates, stats.updates);
+    TEST_ASSERT_EQUAL_UINT32(stats.updates, stats.frames_sent + stats.frames_unchanged);
+    TEST_ASSERT_GREATER_THAN(0, stats.frames_unchanged);
+
+    char message[128];
+    snprintf(message, sizeof(message), "%u of %u updates sent a frame, %.1f ns per update",
+             stats.frames_sent / runs, updates, seconds / (runs * updates) * 1e9);
+    TEST_MESSAGE(message);
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_tables_span_quiet_to_max);
+    RUN_TEST(test_bar_follows_thresholds);
+    RUN_TEST(test_unchanged_frames_are_not_sent);
+    RUN_TEST(test_peak_holds_then_falls);
+    RUN_TEST(test_busy_strip_defers_the_frame);
+    RUN_TEST(test_clear_turns_everything_off);
+    RUN_TEST(test_benchmark_minute_of_updates);
+    return UNITY_END();
+}
\ No newline at end of file
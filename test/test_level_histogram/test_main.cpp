@@ -0,0 +1,206 @@
+/**
+ * @brief LevelHistogram: exceedance levels against a sorted brute-force
+ * reference over the full ADC scale.
+ */
+#include <unity.h>
+#include <algorithm>
+#include <vector>
+#include "components/level_histogram.hpp"
+
+namespace
+{
+    // Value exceeded by the given share of the samples, from the sorted samples
+    uint16_t reference_exceeded(std::vector<uint16_t> values, uint8_t percent)
+    {
+        std::sort(values.begin(), values.end());
+        size_t rank = (values.size() * (100 - percent) + 99) / 100;
+        return values[std::max<size_t>(rank, 1) - 1];
+    }
+
+    // Half the width of the bin a level falls into: how far the reported level can be off
+    int tolerance(uint16_t level)
+    {
+        return LevelHistogram::bin_width(LevelHistogram::bin_of(level)) / 2;
+    }
+
+    std::vector<uint16_t> make_values(size_t count, uint16_t low, uint16_t high, uint32_t seed)
+    {
+        std::vector<uint16_t> values(count);
+        uint32_t state = seed;
+        for (uint16_t &value : values)
+        {
+            state = state * 1664525u + 1013904223u;
+            value = static_cast<uint16_t>(low + (state >> 8) % (high - low + 1));
+        }
+        return values;
+    }
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_empty_histogram_reads_zero()
+{
+    LevelHistogram histogram;
+    TEST_ASSERT_EQUAL_UINT16(0, histogram.exceeded(10));
+    TEST_ASSERT_EQUAL_UINT16(0, histogram.exceeded(90));
+}
+
+void test_matches_reference_within_half_a_bin()
+{
+    for (uint32_t seed : {1u, 2u, 3u})
+    {
+        std::vector<uint16_t> values = make_values(5000, 0, config::adc::MAX_VALUE, seed);
+        LevelHistogram histogram;
+        for (uint16_t value : values)
+        {
+            histogram.add(value);
+        }
+        TEST_ASSERT_EQUAL_UINT32(values.size(), histogram.total());
+
+        for (uint8_t percent : {1, 10, 50, 90, 99})
+        {
+            int expected = reference_exceeded(values, percent);
+            TEST_ASSERT_INT_WITHIN(tolerance(expected), expected, histogram.exceeded(percent));
+        }
+    }
+}
+
+// Peaks well above 1023 used to pin every level at the top bin
+void test_loud_levels_are_not_clamped()
+{
+    std::vector<uint16_t> values = make_values(1000, 2500, 2900, 7);
+    LevelHistogram histogram;
+    for (uint16_t value : values)
+    {
+        histogram.add(value);
+    }
+
+    uint16_t l10 = reference_exceeded(values, 10);
+    uint16_t l90 = reference_exceeded(values, 90);
+    TEST_ASSERT_INT_WITHIN(tolerance(l10), l10, histogram.exceeded(10));
+    TEST_ASSERT_INT_WITHIN(tolerance(l90), l90, histogram.exceeded(90));
+    TEST_ASSERT_TRUE(histogram.exceeded(90) < histogram.exceeded(10));
+}
+
+void test_full_scale_lands_in_top_bin()
+{
+    LevelHistogram histogram;
+    histogram.add(config::adc::MAX_VALUE);
+    histogram.add(-5.0f);
+    histogram.add(1e12f);
+    const uint16_t top = LevelHistogram::NUM_BINS - 1;
+    TEST_ASSERT_EQUAL_UINT16(top, LevelHistogram::bin_of(config::adc::MAX_VALUE));
+    TEST_ASSERT_EQUAL_UINT16(LevelHistogram::bin_low(top) + LevelHistogram::bin_width(top) / 2, histogram.exceeded(10));
+    TEST_ASSERT_EQUAL_UINT16(0, histogram.exceeded(90));
+}
+
+void test_bins_tile_the_scale()
+{
+    // Every level lands in the bin that starts at or below it, with no gaps or overlaps
+    uint16_t previous = 0;
+    for (uint32_t level = 0; level <= config::adc::MAX_VALUE; level++)
+    {
+        uint16_t bin = LevelHistogram::bin_of(static_cast<float>(level));
+        TEST_ASSERT_TRUE(bin == previous || bin == previous + 1);
+        TEST_ASSERT_TRUE(LevelHistogram::bin_low(bin) <= level);
+        TEST_ASSERT_TRUE(level < LevelHistogram::bin_low(bin) + LevelHistogram::bin_width(bin));
+        previous = bin;
+    }
+    TEST_ASSERT_EQUAL_UINT16(LevelHistogram::NUM_BINS - 1, previous);
+}
+
+void test_quiet_levels_resolve_to_the_unit()
+{
+    namespace ranges = config::signal_processing::ranges;
+
+    // Unit-wide bins up to past the QUIET threshold, then never wider than 1/32 of the level
+    for (uint16_t bin = 0; bin < LevelHistogram::NUM_BINS; bin++)
+    {
+        uint32_t low = LevelHistogram::bin_low(bin);
+        uint32_t width = LevelHistogram::bin_width(bin);
+        TEST_ASSERT_TRUE(low > ranges::QUIET || width == 1);
+        TEST_ASSERT_TRUE(width == 1 || width * LevelHistogram::SUB_BINS <= low);
+    }
+
+    // A level between two thresholds comes back exactly
+    LevelHistogram histogram;
+    for (int i = 0; i < 100; i++)
+    {
+        histogram.add(ranges::QUIET + 0.5f);
+    }
+    TEST_ASSERT_EQUAL_UINT16(ranges::QUIET, histogram.exceeded(50));
+}
+
+void test_clear_forgets_values()
+{
+    LevelHistogram histogram;
+    histogram.add(2000);
+    histogram.clear();
+    TEST_ASSERT_EQUAL_UINT32(0, histogram.total());
+    TEST_ASSERT_EQUAL_UINT16(0, histogram.exceeded(50));
+
+    histogram.add(100);
+    TEST_ASSERT_INT_WITHIN(tolerance(100), 100, histogram.exceeded(50));
+}
+
+void test_slots_slide_the_window()
+{
+    LevelHistogram window;
+    LevelHistogramSlots<4> slots(window, 1000);
+
+    // One value per 100 ms: 100 in the first second, 200 for the next three
+    for (unsigned long now = 0; now < 4000; now += 100)
+    {
+        slots.advance(now);
+        slots.add(now < 1000 ? 100 : 200);
+    }
+    TEST_ASSERT_EQUAL_UINT32(40, window.total());
+    TEST_ASSERT_INT_WITHIN(tolerance(100), 100, window.exceeded(90));
+
+    // The first second expires as soon as the fifth opens; the rest stays
+    slots.advance(4000);
+    TEST_ASSERT_EQUAL_UINT32(30, window.total());
+    TEST_ASSERT_INT_WITHIN(tolerance(200), 200, window.exceeded(90));
+
+    slots.advance(6500);
+    TEST_ASSERT_EQUAL_UINT32(10, window.total());
+}
+
+void test_slots_forget_everything_after_a_long_gap()
+{
+    LevelHistogram window;
+    LevelHistogramSlots<4> slots(window, 1000);
+    for (unsigned long now = 500; now < 3500; now += 100)
+    {
+        slots.advance(now);
+        slots.add(300);
+    }
+
+    slots.advance(3500 + 4000);
+    TEST_ASSERT_EQUAL_UINT32(0, window.total());
+
+    // Slots stay aligned to the slot length after the gap
+    slots.add(50);
+    slots.advance(7999);
+    TEST_ASSERT_EQUAL_UINT32(1, window.total());
+    slots.advance(10999);
+    TEST_ASSERT_EQUAL_UINT32(1, window.total());
+    slots.advance(11000);
+    TEST_ASSERT_EQUAL_UINT32(0, window.total());
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_empty_histogram_reads_zero);
+    RUN_TEST(test_matches_reference_within_half_a_bin);
+    RUN_TEST(test_loud_levels_are_not_clamped);
+    RUN_TEST(test_full_scale_lands_in_top_bin);
+    RUN_TEST(test_bins_tile_the_scale);
+    RUN_TEST(test_quiet_levels_resolve_to_the_unit);
+    RUN_TEST(test_clear_forgets_values);
+    RUN_TEST(test_slots_slide_the_window);
+    RUN_TEST(test_slots_forget_everything_after_a_long_gap);
+    return UNITY_END();
+}
\ No newline at end of file
@@ -0,0 +1,239 @@
+/**
+ * @brief log_format: records survive an encode/decode round trip exactly,
+ * including wrapping deltas; damaged blocks are rejected and a reader can
+ * resynchronise on the next intact one; index paths; bytes per record.
+ */
+#include <unity.h>
+#include <limits.h>
+#include <vector>
+#include "components/log_format.hpp"
+
+namespace
+{
+    using namespace log_format;
+
+    // Slowly varying levels like the logger writes once per second
+    std::vector<std::vector<int32_t>> make_records(size_t count, uint32_t seed)
+    {
+        std::vector<std::vector<int32_t>> records;
+        std::vector<int32_t> record(NUM_FIELDS);
+        record[TIMESTAMP] = 1704067200;
+        for (size_t f = 1; f < NUM_FIELDS; f++)
+        {
+            record[f] = 200000;
+        }
+        for (size_t i = 0; i < count; i++)
+        {
+            record[TIMESTAMP]++;
+            for (size_t f = 1; f < NUM_FIELDS; f++)
+            {
+                seed = seed * 1664525u + 1013904223u;
+                record[f] += static_cast<int32_t>(seed >> 27) - 16;
+            }
+            record[CATEGORY] = (seed >> 8) % 3;
+            records.push_back(record);
+        }
+        return records;
+    }
+
+    // Encode into consecutive blocks the way the logger does
+    std::vector<uint8_t> encode(const std::vector<std::vector<int32_t>> &records, uint16_t block_records)
+    {
+        static BlockEncoder encoder(block_records);
+        encoder = BlockEncoder(block_records);
+        std::vector<uint8_t> out;
+        auto seal = [&]()
+        {
+            size_t size;
+            const uint8_t *block = encoder.finish(size);
+            out.insert(out.end(), block, block + size);
+        };
+
+        for (const std::vector<int32_t> &values : records)
+        {
+            Record record;
+            memcpy(record, values.data(), sizeof(record));
+            if (!encoder.add(record))
+            {
+                seal();
+                TEST_ASSERT_TRUE(encoder.add(record));
+            }
+        }
+        if (!encoder.is_empty())
+        {
+            seal();
+        }
+        return out;
+    }
+
+    // Decode every intact block, skipping damage byte by byte as the readers do
+    std::vector<std::vector<int32_t>> decode(const std::vector<uint8_t> &bytes, size_t *blocks = nullptr)
+    {
+        std::vector<std::vector<int32_t>> records;
+        size_t offset = 0;
+        size_t found = 0;
+        while (offset < bytes.size())
+        {
+            BlockHeader header;
+            size_t size = check_block(bytes.data() + offset, bytes.size() - offset, header);
+            if (size == 0)
+            {
+                offset++;
+                continue;
+            }
+            BlockDecoder decoder(bytes.data() + offset, header);
+            Record record;
+            while (decoder.next(record))
+            {
+                records.emplace_back(record, record + NUM_FIELDS);
+            }
+            offset += size;
+            found++;
+        }
+        if (blocks)
+        {
+            *blocks = found;
+        }
+        return records;
+    }
+
+    void assert_same(const std::vector<std::vector<int32_t>> &expected,
+                     const std::vector<std::vector<int32_t>> &actual)
+    {
+        TEST_ASSERT_EQUAL_size_t(expected.size(), actual.size());
+        for (size_t i = 0; i < expected.size(); i++)
+        {
+            TEST_ASSERT_EQUAL_INT32_ARRAY(expected[i].data(), actual[i].data(), NUM_FIELDS);
+        }
+    }
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_zigzag_round_trips_edge_values()
+{
+    const int32_t values[] = {0, 1, -1, 63, -64, 64, INT32_MAX, INT32_MIN, INT32_MIN + 1};
+    for (int32_t value : values)
+    {
+        TEST_ASSERT_EQUAL_INT32(value, unzigzag(zigzag(value)));
+    }
+    TEST_ASSERT_EQUAL_UINT32(1, zigzag(-1));
+    TEST_ASSERT_EQUAL_UINT32(2, zigzag(1));
+}
+
+void test_records_round_trip_across_blocks()
+{
+    std::vector<std::vector<int32_t>> records = make_records(1000, 7);
+    size_t blocks = 0;
+    assert_same(records, decode(encode(records, 60), &blocks));
+    TEST_ASSERT_EQUAL_size_t(17, blocks);
+}
+
+void test_extreme_swings_round_trip()
+{
+    // Deltas that overflow int32 must wrap back exactly
+    std::vector<std::vector<int32_t>> records;
+    const int32_t extremes[] = {INT32_MAX, INT32_MIN, 0, -1, INT32_MAX, INT32_MIN + 1};
+    for (int32_t value : extremes)
+    {
+        records.emplace_back(NUM_FIELDS, value);
+    }
+    assert_same(records, decode(encode(records, 60)));
+}
+
+void test_full_payload_starts_a_new_block()
+{
+    // Deltas of INT32_MIN take the worst-case five bytes per field and fill the payload first
+    std::vector<std::vector<int32_t>> records;
+    for (int i = 0; i < 100; i++)
+    {
+        records.emplace_back(NUM_FIELDS, i % 2 ? INT32_MIN : 0);
+    }
+    std::vector<uint8_t> bytes = encode(records, 1000);
+    size_t blocks = 0;
+    assert_same(records, decode(bytes, &blocks));
+    TEST_ASSERT_EQUAL_size_t((100 + MAX_PAYLOAD / MAX_RECORD_SIZE - 1) / (MAX_PAYLOAD / MAX_RECORD_SIZE), blocks);
+}
+
+void test_damaged_block_is_skipped()
+{
+    std::vector<std::vector<int32_t>> records = make_records(180, 11);
+    std::vector<uint8_t> bytes = encode(records, 60);
+
+    // A flipped bit in the second block's payload loses that block only
+    BlockHeader first;
+    size_t first_size = check_block(bytes.data(), bytes.size(), first);
+    TEST_ASSERT_GREATER_THAN(0, first_size);
+    bytes[first_size + sizeof(BlockHeader) + 5] ^= 0x10;
+
+    size_t blocks = 0;
+    std::vector<std::vector<int32_t>> decoded = decode(bytes, &blocks);
+    TEST_ASSERT_EQUAL_size_t(2, blocks);
+    std::vector<std::vector<int32_t>> expected(records.begin(), records.begin() + 60);
+    expected.insert(expected.end(), records.begin() + 120, records.end());
+    assert_same(expected, decoded);
+}
+
+void test_torn_tail_is_rejected()
+{
+    std::vector<std::vector<int32_t>> records = make_records(120, 13);
+    std::vector<uint8_t> bytes = encode(records, 60);
+
+    // Power lost while the last block was written: every prefix of it is refused
+    BlockHeader header;
+    size_t first_size = check_block(bytes.data(), bytes.size(), header);
+    for (size_t cut = first_size; cut < bytes.size(); cut++)
+    {
+        TEST_ASSERT_EQUAL_size_t(0, check_block(bytes.data() + first_size, cut - first_size, header));
+    }
+    std::vector<uint8_t> torn(bytes.begin(), bytes.end() - 1);
+    assert_same(std::vector<std::vector<int32_t>>(records.begin(), records.begin() + 60), decode(torn));
+}
+
+void test_headers_and_index_paths()
+{
+    FileHeader file = make_file_header(1704067200);
+    TEST_ASSERT_TRUE(is_valid(file));
+    file.num_fields = NUM_FIELDS + 1;
+    TEST_ASSERT_FALSE(is_valid(file));
+    TEST_ASSERT_TRUE(is_valid(make_index_header(60)));
+
+    char path[32];
+    TEST_ASSERT_TRUE(make_index_path("/sd/240315.bin", path, sizeof(path)));
+    TEST_ASSERT_EQUAL_STRING("/sd/240315.idx", path);
+    TEST_ASSERT_TRUE(make_index_path("/sd.d/240315", path, sizeof(path)));
+    TEST_ASSERT_EQUAL_STRING("/sd.d/240315.idx", path);
+    TEST_ASSERT_FALSE(make_index_path("/sd/240315.bin", path, 14));
+    TEST_ASSERT_TRUE(make_index_path("/sd/240315.bin", path, 15));
+}
+
+void test_benchmark_bytes_per_record()
+{
+    const size_t count = 3600;
+    std::vector<std::vector<int32_t>> records = make_records(count, 17);
+    std::vector<uint8_t> bytes = encode(records, 60);
+    assert_same(records, decode(bytes));
+
+    double per_record = static_cast<double>(bytes.size()) / count;
+    TEST_ASSERT_TRUE(per_record < 2 * NUM_FIELDS);
+
+    char message[128];
+    snprintf(message, sizeof(message), "One hour of 1 Hz records: %zu bytes, %.1f bytes per record of %u fields",
+             bytes.size(), per_record, static_cast<unsigned>(NUM_FIELDS));
+    TEST_MESSAGE(message);
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_zigzag_round_trips_edge_values);
+    RUN_TEST(test_records_round_trip_across_blocks);
+    RUN_TEST(test_extreme_swings_round_trip);
+    RUN_TEST(test_full_payload_starts_a_new_block);
+    RUN_TEST(test_damaged_block_is_skipped);
+    RUN_TEST(test_torn_tail_is_rejected);
+    RUN_TEST(test_headers_and_index_paths);
+    RUN_TEST(test_benchmark_bytes_per_record);
+    return UNITY_END();
+}
\ No newline at end of file
@@ -0,0 +1,354 @@
+/**
+ * @brief LogReader range queries over binary and CSV logs written in the
+ * logger's formats: results against a brute-force filter, with and without
+ * the index, a stale index, damaged blocks, early stops, and the reads a
+ * query costs on a day-long log.
+ */
+#include <unity.h>
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <string>
+#include <vector>
+#include "components/log_reader.hpp"
+
+namespace
+{
+    using namespace log_format;
+
+    constexpr uint32_t DAY_START = 1704067200;
+    constexpr uint32_t INDEX_INTERVAL_S = 60;
+
+    char g_directory[] = "/tmp/log_reader_XXXXXX";
+
+    struct Row
+    {
+        int32_t values[NUM_FIELDS];
+    };
+
+    std::vector<Row> g_rows;
+    std::vector<std::string> g_files;
+
+    // One record per second; levels wander like the monitor's do
+    std::vector<Row> make_rows(size_t count)
+    {
+        std::vector<Row> rows(count);
+        uint32_t seed = 5;
+        Row row{};
+        for (size_t f = 1; f < NUM_FIELDS; f++)
+        {
+            row.values[f] = 150000;
+        }
+        for (size_t i = 0; i < count; i++)
+        {
+            row.values[TIMESTAMP] = static_cast<int32_t>(DAY_START + i);
+            for (size_t f = 1; f < NUM_FIELDS; f++)
+            {
+                seed = seed * 1664525u + 1013904223u;
+                row.values[f] += static_cast<int32_t>(seed >> 26) - 32;
+            }
+            row.values[CATEGORY] = (seed >> 8) % 3;
+            rows[i] = row;
+        }
+        return rows;
+    }
+
+    std::string path_for(const char *name)
+    {
+        g_files.push_back(std::string(g_directory) + "/" + name);
+        return g_files.back();
+    }
+
+    void write_index(const std::string &log_path, const std::vector<IndexEntry> &entries)
+    {
+        char index_path[128];
+        make_index_path(log_path.c_str(), index_path, sizeof(index_path));
+        g_files.push_back(index_path);
+        FILE *file = fopen(index_path, "wb");
+        TEST_ASSERT_NOT_NULL(file);
+        IndexHeader header = make_index_header(INDEX_INTERVAL_S);
+        fwrite(&header, sizeof(header), 1, file);
+        fwrite(entries.data(), sizeof(IndexEntry), entries.size(), file);
+        fclose(file);
+    }
+
+    // Like DataLogger with BINARY_FORMAT: a file header, then one block per minute
+    std::string write_binary(const char *name, bool with_index)
+    {
+        std::string path = path_for(name);
+        FILE *file = fopen(path.c_str(), "wb");
+        TEST_ASSERT_NOT_NULL(file);
+        FileHeader header = make_file_header(DAY_START);
+        fwrite(&header, sizeof(header), 1, file);
+
+        static BlockEncoder encoder(60);
+        encoder = BlockEncoder(60);
+        std::vector<IndexEntry> entries;
+        uint32_t last_bucket = UINT32_MAX;
+        auto seal = [&]()
+        {
+            uint32_t bucket = encoder.get_first_timestamp() / INDEX_INTERVAL_S;
+            if (bucket != last_bucket)
+            {
+                entries.push_back({encoder.get_first_timestamp(), static_cast<uint32_t>(ftell(file))});
+                last_bucket = bucket;
+            }
+            size_t size;
+            const uint8_t *block = encoder.finish(size);
+            fwrite(block, 1, size, file);
+        };
+        for (const Row &row : g_rows)
+        {
+            if (!encoder.add(row.values))
+            {
+                seal();
+                encoder.add(row.values);
+            }
+        }
+        seal();
+        fclose(file);
+
+        if (with_index)
+        {
+            write_index(path, entries);
+        }
+        return path;
+    }
+
+    // Like DataLogger's CSV rows, with an index entry at the first row of each minute
+    std::string write_csv(const char *name, bool with_index)
+    {
+        std::string path = path_for(name);
+        FILE *file = fopen(path.c_str(), "wb");
+        TEST_ASSERT_NOT_NULL(file);
+        fputs("timestamp,noise,baseline,category,1min_avg,15min_avg,laeq,lcpeak,1min_l10,1min_l50,1min_l90,1min_max\r\n",
+              file);
+
+        std::vector<IndexEntry> entries;
+        for (const Row &row : g_rows)
+        {
+            const int32_t *v = row.values;
+            uint32_t timestamp = static_cast<uint32_t>(v[TIMESTAMP]);
+            if (timestamp % INDEX_INTERVAL_S == 0)
+            {
+                entries.push_back({timestamp, static_cast<uint32_t>(ftell(file))});
+            }
+            fprintf(file, "%ld,%.2f,%.2f,%d,%.2f,%.2f,%.2f,%.2f,%u,%u,%u,%u\r\n", static_cast<long>(timestamp),
+                    v[NOISE] / 100.0, v[BASELINE] / 100.0, static_cast<int>(v[CATEGORY]), v[ONE_MIN_AVG] / 100.0,
+                    v[FIFTEEN_MIN_AVG] / 100.0, v[LAEQ] / 100.0, v[LCPEAK] / 100.0,
+                    static_cast<unsigned>(v[ONE_MIN_L10]), static_cast<unsigned>(v[ONE_MIN_L50]),
+                    static_cast<unsigned>(v[ONE_MIN_L90]), static_cast<unsigned>(v[ONE_MIN_MAX]));
+        }
+        fclose(file);
+
+        if (with_index)
+        {
+            write_index(path, entries);
+        }
+        return path;
+    }
+
+    struct Collector
+    {
+        std::vector<Row> rows;
+        size_t limit{SIZE_MAX};
+
+        static bool add(void *context, const Record &record)
+        {
+            Collector *collector = static_cast<Collector *>(context);
+            Row row;
+            memcpy(row.values, record, sizeof(row.values));
+            collector->rows.push_back(row);
+            return collector->rows.size() < collector->limit;
+        }
+    };
+
+    // Query and compare with the rows a brute-force filter picks
+    void assert_query(LogReader &reader, uint32_t from, uint32_t to)
+    {
+        Collector collector;
+        size_t matched = reader.query(from, to, Collector::add, &collector);
+
+        std::vector<Row> expected;
+        for (const Row &row : g_rows)
+        {
+            uint32_t timestamp = static_cast<uint32_t>(row.values[TIMESTAMP]);
+            if (timestamp >= from && timestamp < to)
+            {
+                expected.push_back(row);
+            }
+        }
+        TEST_ASSERT_EQUAL_size_t(expected.size(), matched);
+        TEST_ASSERT_EQUAL_size_t(expected.size(), collector.rows.size());
+        for (size_t i = 0; i < expected.size(); i++)
+        {
+            TEST_ASSERT_EQUAL_INT32_ARRAY(expected[i].values, collector.rows[i].values, NUM_FIELDS);
+        }
+    }
+
+    // Ranges at the edges of the day, of blocks and of index buckets, plus random ones
+    void assert_queries(LogReader &reader)
+    {
+        uint32_t end = DAY_START + g_rows.size();
+        const uint32_t ranges[][2] = {{0, DAY_START},
+                                      {DAY_START, DAY_START + 1},
+                                      {DAY_START + 59, DAY_START + 61},
+                                      {DAY_START + 3600, DAY_START + 3660},
+                                      {end - 1, end + 100},
+                                      {end, UINT32_MAX},
+                                      {0, UINT32_MAX}};
+        for (const auto &range : ranges)
+        {
+            assert_query(reader, range[0], range[1]);
+        }
+
+        uint32_t seed = 99;
+        for (int i = 0; i < 40; i++)
+        {
+            seed = seed * 1664525u + 1013904223u;
+            uint32_t from = DAY_START + (seed >> 8) % g_rows.size();
+            seed = seed * 1664525u + 1013904223u;
+            assert_query(reader, from, from + 1 + (seed >> 8) % 900);
+        }
+    }
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_binary_with_index()
+{
+    LogReader reader;
+    TEST_ASSERT_TRUE(reader.open(write_binary("indexed.bin", true).c_str()));
+    TEST_ASSERT_TRUE(reader.is_binary());
+    TEST_ASSERT_TRUE(reader.has_index());
+    assert_queries(reader);
+    TEST_ASSERT_EQUAL_UINT32(0, reader.get_stats().corrupt_skips);
+}
+
+void test_binary_without_index()
+{
+    LogReader reader;
+    TEST_ASSERT_TRUE(reader.open(write_binary("plain.bin", false).c_str()));
+    TEST_ASSERT_FALSE(reader.has_index());
+    assert_queries(reader);
+}
+
+void test_csv_with_and_without_index()
+{
+    LogReader indexed;
+    TEST_ASSERT_TRUE(indexed.open(write_csv("indexed.csv", true).c_str()));
+    TEST_ASSERT_FALSE(indexed.is_binary());
+    TEST_ASSERT_TRUE(indexed.has_index());
+    assert_queries(indexed);
+    TEST_ASSERT_EQUAL_UINT32(0, indexed.get_stats().corrupt_skips);
+
+    LogReader plain;
+    TEST_ASSERT_TRUE(plain.open(write_csv("plain.csv", false).c_str()));
+    assert_queries(plain);
+}
+
+void test_index_past_the_end_of_the_log()
+{
+    // A crash can leave index entries for data that never reached the log
+    std::string path = write_binary("stale.bin", true);
+    TEST_ASSERT_EQUAL_INT(0, truncate(path.c_str(), 5000));
+
+    LogReader reader;
+    TEST_ASSERT_TRUE(reader.open(path.c_str()));
+    Collector collector;
+    size_t matched = reader.query(DAY_START, UINT32_MAX, Collector::add, &collector);
+    TEST_ASSERT_GREATER_THAN(0, matched);
+    TEST_ASSERT_EQUAL_INT32(DAY_START, collector.rows[0].values[TIMESTAMP]);
+    TEST_ASSERT_EQUAL_size_t(0, reader.query(DAY_START + 7200, UINT32_MAX, Collector::add, &collector));
+}
+
+void test_damaged_block_is_skipped()
+{
+    std::string path = write_binary("damaged.bin", false);
+    FILE *file = fopen(path.c_str(), "r+b");
+    fseek(file, sizeof(FileHeader) + 40, SEEK_SET);
+    fputc(0xFF, file);
+    fclose(file);
+
+    LogReader reader;
+    TEST_ASSERT_TRUE(reader.open(path.c_str()));
+    Collector collector;
+    reader.query(DAY_START, DAY_START + 180, Collector::add, &collector);
+    TEST_ASSERT_EQUAL_size_t(120, collector.rows.size());
+    TEST_ASSERT_EQUAL_INT32(DAY_START + 60, collector.rows[0].values[TIMESTAMP]);
+    TEST_ASSERT_EQUAL_UINT32(1, reader.get_stats().corrupt_skips);
+}
+
+void test_callback_stops_the_query()
+{
+    LogReader reader;
+    TEST_ASSERT_TRUE(reader.open(write_binary("stop.bin", true).c_str()));
+    Collector collector;
+    collector.limit = 25;
+    TEST_ASSERT_EQUAL_size_t(25, reader.query(DAY_START + 100, UINT32_MAX, Collector::add, &collector));
+    TEST_ASSERT_EQUAL_INT32(DAY_START + 124, collector.rows.back().values[TIMESTAMP]);
+}
+
+void test_benchmark_one_minute_from_a_day()
+{
+    std::string indexed_path = write_binary("day.bin", true);
+    std::string plain_path = write_binary("day_plain.bin", false);
+
+    LogReader indexed;
+    LogReader plain;
+    TEST_ASSERT_TRUE(indexed.open(indexed_path.c_str()));
+    TEST_ASSERT_TRUE(plain.open(plain_path.c_str()));
+
+    // The last minute of the day is the worst case for a scan
+    uint32_t from = DAY_START + g_rows.size() - 60;
+    Collector collector;
+    const int runs = 20;
+    auto start = std::chrono::steady_clock::now();
+    for (int run = 0; run < runs; run++)
+    {
+        collector.rows.clear();
+        indexed.query(from, from + 60, Collector::add, &collector);
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() / runs;
+    TEST_ASSERT_EQUAL_size_t(60, collector.rows.size());
+    plain.query(from, from + 60, Collector::add, &collector);
+
+    uint32_t indexed_bytes = indexed.get_stats().bytes_read / runs;
+    uint32_t indexed_probes = indexed.get_stats().index_probes / runs;
+    TEST_ASSERT_TRUE(indexed_probes <= 12);
+    TEST_ASSERT_TRUE(indexed_bytes * 10 < plain.get_stats().bytes_read);
+
+    char message[160];
+    snprintf(message, sizeof(message), "Last minute of %zu records: %u bytes read and %u index probes in %.0f us; "
+                                       "%u bytes without the index",
+             g_rows.size(), indexed_bytes, indexed_probes, seconds * 1e6, plain.get_stats().bytes_read);
+    TEST_MESSAGE(message);
+}
+
+int main()
+{
+    if (!mkdtemp(g_directory))
+    {
+        return 1;
+    }
+    g_rows = make_rows(86400);
+
+    UNITY_BEGIN();
+    RUN_TEST(test_binary_with_index);
+    RUN_TEST(test_binary_without_index);
+    RUN_TEST(test_csv_with_and_without_index);
+    RUN_TEST(test_index_past_the_end_of_the_log);
+    RUN_TEST(test_damaged_block_is_skipped);
+    RUN_TEST(test_callback_stops_the_query);
+    RUN_TEST(test_benchmark_one_minute_from_a_day);
+    int failures = UNITY_END();
+
+    for (const std::string &file : g_files)
+    {
+        unlink(file.c_str());
+    }
+    rmdir(g_directory);
+    return failures;
+}
\ No newline at end of file
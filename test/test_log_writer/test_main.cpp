@@ -0,0 +1,151 @@
+/**
+ * @brief LogWriter on host files: the file holds exactly the appended bytes
+ * across flushes and reopens, and appends are all or nothing when the card
+ * stops taking data.
+ */
+#include <unity.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <string>
+#include <vector>
+#include "components/log_writer.hpp"
+
+namespace
+{
+    unsigned long g_now = 0;
+
+    unsigned long fake_clock()
+    {
+        return g_now;
+    }
+
+    char g_directory[] = "/tmp/log_writer_XXXXXX";
+    std::string g_path;
+
+    std::vector<uint8_t> make_bytes(size_t length, uint32_t seed)
+    {
+        std::vector<uint8_t> bytes(length);
+        for (uint8_t &byte : bytes)
+        {
+            seed = seed * 1664525u + 1013904223u;
+            byte = static_cast<uint8_t>(seed >> 24);
+        }
+        return bytes;
+    }
+
+    std::vector<uint8_t> read_file()
+    {
+        std::vector<uint8_t> bytes;
+        FILE *file = fopen(g_path.c_str(), "rb");
+        TEST_ASSERT_NOT_NULL(file);
+        int c;
+        while ((c = fgetc(file)) != EOF)
+        {
+            bytes.push_back(static_cast<uint8_t>(c));
+        }
+        fclose(file);
+        return bytes;
+    }
+}
+
+void setUp()
+{
+    g_now = 0;
+    g_path = std::string(g_directory) + "/log.bin";
+    unlink(g_path.c_str());
+}
+
+void tearDown()
+{
+    unlink(g_path.c_str());
+}
+
+void test_file_holds_appended_bytes_across_reopen()
+{
+    std::vector<uint8_t> expected;
+    for (int session = 0; session < 3; session++)
+    {
+        LogWriter writer(fake_clock);
+        TEST_ASSERT_TRUE(writer.open(g_path.c_str()));
+        TEST_ASSERT_EQUAL_UINT32(expected.size(), writer.size());
+
+        // Records of odd sizes, polled like the logger task does
+        for (uint32_t i = 0; i < 200; i++)
+        {
+            std::vector<uint8_t> record = make_bytes(1 + (i * 37) % 300, session * 1000 + i);
+            TEST_ASSERT_TRUE(writer.append(record.data(), record.size()));
+            expected.insert(expected.end(), record.begin(), record.end());
+            g_now += 100;
+            TEST_ASSERT_TRUE(writer.poll());
+        }
+        TEST_ASSERT_EQUAL_UINT32(0, writer.get_stats().dropped_bytes);
+        TEST_ASSERT_EQUAL_UINT32(0, writer.get_stats().io_errors);
+    }
+
+    std::vector<uint8_t> file = read_file();
+    TEST_ASSERT_EQUAL_size_t(expected.size(), file.size());
+    TEST_ASSERT_EQUAL_MEMORY(expected.data(), file.data(), expected.size());
+}
+
+void test_largest_append_fits_behind_any_tail()
+{
+    LogWriter writer(fake_clock);
+    TEST_ASSERT_TRUE(writer.open(g_path.c_str()));
+    std::vector<uint8_t> large = make_bytes(LogWriter::MAX_APPEND, 1);
+    for (size_t tail = 0; tail < 3 * LogWriter::SECTOR_SIZE; tail += 97)
+    {
+        std::vector<uint8_t> small = make_bytes(tail, 2);
+        TEST_ASSERT_TRUE(writer.append(small.data(), small.size()));
+        TEST_ASSERT_TRUE(writer.append(large.data(), large.size()));
+    }
+    TEST_ASSERT_EQUAL_UINT32(0, writer.get_stats().dropped_bytes);
+}
+
+// /dev/full opens, then fails every write like a card that stopped taking data
+void test_append_is_all_or_nothing_when_writes_fail()
+{
+    LogWriter writer(fake_clock);
+    if (!writer.open("/dev/full"))
+    {
+        TEST_IGNORE_MESSAGE("No /dev/full on this host");
+    }
+
+    // The buffer fills without a write
+    std::vector<uint8_t> record = make_bytes(300, 3);
+    uint32_t accepted = 0;
+    while (writer.size() + record.size() <= LogWriter::BUFFER_SIZE)
+    {
+        TEST_ASSERT_TRUE(writer.append(record.data(), record.size()));
+        accepted += record.size();
+    }
+
+    // The flush that would make room fails: nothing of the record is taken
+    TEST_ASSERT_FALSE(writer.append(record.data(), record.size()));
+    TEST_ASSERT_EQUAL_UINT32(accepted, writer.size());
+    TEST_ASSERT_EQUAL_UINT32(accepted, writer.get_stats().bytes_appended);
+    TEST_ASSERT_EQUAL_UINT32(record.size(), writer.get_stats().dropped_bytes);
+    TEST_ASSERT_GREATER_THAN(0, writer.get_stats().io_errors);
+
+    // What still fits is taken whole
+    size_t room = LogWriter::BUFFER_SIZE - writer.size();
+    TEST_ASSERT_TRUE(writer.append(record.data(), room));
+    TEST_ASSERT_FALSE(writer.append(record.data(), 1));
+    TEST_ASSERT_EQUAL_UINT32(LogWriter::BUFFER_SIZE, writer.size());
+}
+
+int main()
+{
+    if (!mkdtemp(g_directory))
+    {
+        return 1;
+    }
+
+    UNITY_BEGIN();
+    RUN_TEST(test_file_holds_appended_bytes_across_reopen);
+    RUN_TEST(test_largest_append_fits_behind_any_tail);
+    RUN_TEST(test_append_is_all_or_nothing_when_writes_fail);
+    int failures = UNITY_END();
+    rmdir(g_directory);
+    return failures;
+}
\ No newline at end of file
@@ -0,0 +1,305 @@
+/**
+ * @brief OfflineQueue on a host file: FIFO order across reopens, eviction
+ * when full, and recovery from torn header writes, interrupted appends and
+ * damaged files.
+ */
+#include <unity.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <string>
+#include <vector>
+#include "components/offline_queue.hpp"
+
+namespace
+{
+    // The two header copies occupy the first two 32-byte slots of the file
+    constexpr long HEADER_SLOT_SIZE = 32;
+
+    char g_directory[] = "/tmp/offline_queue_XXXXXX";
+    std::string g_path;
+
+    UploadRecord make_record(uint32_t created_at)
+    {
+        UploadRecord record;
+        record.created_at = created_at;
+        record.num_fields = 3;
+        record.fields[0] = static_cast<float>(created_at) * 0.5f;
+        record.fields[2] = 1.0f;
+        record.integer_fields = 1 << 2;
+        return record;
+    }
+
+    void append_range(OfflineQueue &queue, uint32_t first, uint32_t count)
+    {
+        std::vector<UploadRecord> records;
+        for (uint32_t i = 0; i < count; i++)
+        {
+            records.push_back(make_record(first + i));
+        }
+        TEST_ASSERT_TRUE(queue.append(records.data(), records.size()));
+    }
+
+    // Every record in the queue, checked to be the consecutive run starting at `first`
+    void assert_contents(OfflineQueue &queue, uint32_t first, size_t count)
+    {
+        TEST_ASSERT_EQUAL_size_t(count, queue.size());
+        std::vector<UploadRecord> records(count + 1);
+        TEST_ASSERT_EQUAL_size_t(count, queue.peek(records.data(), records.size()));
+        for (size_t i = 0; i < count; i++)
+        {
+            TEST_ASSERT_EQUAL_UINT32(first + i, records[i].created_at);
+            TEST_ASSERT_EQUAL_UINT8(3, records[i].num_fields);
+            TEST_ASSERT_EQUAL_UINT8(1 << 2, records[i].integer_fields);
+            TEST_ASSERT_EQUAL_FLOAT((first + i) * 0.5f, records[i].fields[0]);
+        }
+    }
+
+    // Descriptor the next open() or fopen() will get
+    int next_descriptor()
+    {
+        int descriptor = dup(0);
+        close(descriptor);
+        return descriptor;
+    }
+
+    // Swaps the descriptor for a read-only one on the same file, so writes through it fail
+    int make_read_only(int descriptor)
+    {
+        int saved = dup(descriptor);
+        int read_only = open(g_path.c_str(), O_RDONLY);
+        dup2(read_only, descriptor);
+        close(read_only);
+        return saved;
+    }
+
+    void make_writable(int descriptor, int saved)
+    {
+        dup2(saved, descriptor);
+        close(saved);
+    }
+
+    std::vector<char> read_file()
+    {
+        std::vector<char> bytes;
+        FILE *file = fopen(g_path.c_str(), "rb");
+        TEST_ASSERT_NOT_NULL(file);
+        int c;
+        while ((c = fgetc(file)) != EOF)
+        {
+            bytes.push_back(static_cast<char>(c));
+        }
+        fclose(file);
+        return bytes;
+    }
+
+    void write_at(long offset, const char *bytes, size_t size)
+    {
+        FILE *file = fopen(g_path.c_str(), "r+b");
+        TEST_ASSERT_NOT_NULL(file);
+        fseek(file, offset, SEEK_SET);
+        fwrite(bytes, 1, size, file);
+        fclose(file);
+    }
+}
+
+void setUp()
+{
+    g_path = std::string(g_directory) + "/queue.bin";
+    unlink(g_path.c_str());
+}
+
+void tearDown()
+{
+    unlink(g_path.c_str());
+}
+
+void test_fifo_survives_reopen()
+{
+    {
+        OfflineQueue queue(g_path.c_str(), 100);
+        TEST_ASSERT_TRUE(queue.begin());
+        TEST_ASSERT_TRUE(queue.is_empty());
+        append_range(queue, 1000, 10);
+        append_range(queue, 1010, 5);
+        TEST_ASSERT_TRUE(queue.pop(4));
+        assert_contents(queue, 1004, 11);
+    }
+
+    OfflineQueue queue(g_path.c_str(), 100);
+    TEST_ASSERT_TRUE(queue.begin());
+    assert_contents(queue, 1004, 11);
+    TEST_ASSERT_TRUE(queue.pop(100));
+    TEST_ASSERT_TRUE(queue.is_empty());
+    TEST_ASSERT_EQUAL_UINT32(11, queue.get_stats().removed);
+}
+
+void test_evicts_oldest_when_full_and_wraps()
+{
+    OfflineQueue queue(g_path.c_str(), 8);
+    TEST_ASSERT_TRUE(queue.begin());
+    append_range(queue, 0, 6);
+    append_range(queue, 6, 6);
+    assert_contents(queue, 4, 8);
+    TEST_ASSERT_EQUAL_UINT32(4, queue.get_stats().evicted);
+
+    // Keep the ring going round many times, full after every append
+    for (uint32_t first = 12; first < 500; first += 5)
+    {
+        append_range(queue, first, 5);
+        assert_contents(queue, first - 3, 8);
+        queue.pop(2);
+    }
+    assert_contents(queue, 496, 6);
+
+    // A single append larger than the queue keeps its newest records
+    append_range(queue, 1000, 20);
+    assert_contents(queue, 1012, 8);
+}
+
+void test_torn_header_falls_back_to_previous_copy()
+{
+    {
+        OfflineQueue queue(g_path.c_str(), 16);
+        TEST_ASSERT_TRUE(queue.begin());
+        append_range(queue, 1, 3);
+        queue.pop(1);
+    }
+
+    // Tear the newest copy, written last by pop(): the other copy predates the pop
+    std::vector<char> bytes = read_file();
+    long newest = -1;
+    for (long slot = 0; slot < 2; slot++)
+    {
+        uint32_t sequence;
+        uint32_t other;
+        memcpy(&sequence, &bytes[slot * HEADER_SLOT_SIZE + 12], sizeof(sequence));
+        memcpy(&other, &bytes[(1 - slot) * HEADER_SLOT_SIZE + 12], sizeof(other));
+        if (static_cast<int32_t>(sequence - other) > 0)
+        {
+            newest = slot;
+        }
+    }
+    TEST_ASSERT_TRUE(newest >= 0);
+    const char garbage[16] = {'t', 'o', 'r', 'n'};
+    write_at(newest * HEADER_SLOT_SIZE + 16, garbage, sizeof(garbage));
+
+    // The popped record comes back rather than anything being lost
+    OfflineQueue queue(g_path.c_str(), 16);
+    TEST_ASSERT_TRUE(queue.begin());
+    assert_contents(queue, 1, 3);
+}
+
+void test_interrupted_append_keeps_committed_records()
+{
+    std::vector<char> before;
+    {
+        OfflineQueue queue(g_path.c_str(), 16);
+        TEST_ASSERT_TRUE(queue.begin());
+        append_range(queue, 100, 4);
+        before = read_file();
+        append_range(queue, 104, 6);
+    }
+
+    // Records written, but the power failed before their header was committed
+    write_at(0, before.data(), 2 * HEADER_SLOT_SIZE);
+
+    OfflineQueue queue(g_path.c_str(), 16);
+    TEST_ASSERT_TRUE(queue.begin());
+    assert_contents(queue, 100, 4);
+    append_range(queue, 200, 2);
+    queue.pop(4);
+    assert_contents(queue, 200, 2);
+}
+
+void test_damaged_or_foreign_file_starts_empty()
+{
+    {
+        OfflineQueue queue(g_path.c_str(), 16);
+        TEST_ASSERT_TRUE(queue.begin());
+        append_range(queue, 1, 5);
+    }
+
+    // Another capacity is another layout
+    {
+        OfflineQueue queue(g_path.c_str(), 32);
+        TEST_ASSERT_TRUE(queue.begin());
+        TEST_ASSERT_TRUE(queue.is_empty());
+        append_range(queue, 1, 5);
+    }
+
+    // Both header copies cut off
+    TEST_ASSERT_EQUAL_INT(0, truncate(g_path.c_str(), 20));
+    OfflineQueue queue(g_path.c_str(), 32);
+    TEST_ASSERT_TRUE(queue.begin());
+    TEST_ASSERT_TRUE(queue.is_empty());
+    append_range(queue, 7, 2);
+    assert_contents(queue, 7, 2);
+}
+
+void test_failed_eviction_leaves_queue_unchanged()
+{
+    int descriptor = next_descriptor();
+    {
+        OfflineQueue queue(g_path.c_str(), 8);
+        TEST_ASSERT_TRUE(queue.begin());
+        append_range(queue, 0, 8);
+
+        // The header that releases the oldest slots cannot be written
+        int saved = make_read_only(descriptor);
+        UploadRecord records[20];
+        for (uint32_t i = 0; i < 20; i++)
+        {
+            records[i] = make_record(100 + i);
+        }
+        TEST_ASSERT_FALSE(queue.append(records, 1));
+        TEST_ASSERT_FALSE(queue.append(records, 20));
+        make_writable(descriptor, saved);
+
+        TEST_ASSERT_EQUAL_UINT32(0, queue.get_stats().evicted);
+        TEST_ASSERT_EQUAL_UINT32(8, queue.get_stats().appended);
+        TEST_ASSERT_EQUAL_UINT32(2, queue.get_stats().io_errors);
+        assert_contents(queue, 0, 8);
+
+        // Carries on from the committed state once writes succeed again
+        append_range(queue, 8, 3);
+        assert_contents(queue, 3, 8);
+        TEST_ASSERT_EQUAL_UINT32(3, queue.get_stats().evicted);
+    }
+
+    OfflineQueue queue(g_path.c_str(), 8);
+    TEST_ASSERT_TRUE(queue.begin());
+    assert_contents(queue, 3, 8);
+}
+
+void test_closed_queue_refuses_io()
+{
+    OfflineQueue queue("/nonexistent/dir/queue.bin", 16);
+    TEST_ASSERT_FALSE(queue.begin());
+    UploadRecord record = make_record(1);
+    TEST_ASSERT_FALSE(queue.append(&record, 1));
+    TEST_ASSERT_EQUAL_size_t(0, queue.peek(&record, 1));
+    TEST_ASSERT_FALSE(queue.pop(1));
+}
+
+int main()
+{
+    if (!mkdtemp(g_directory))
+    {
+        return 1;
+    }
+
+    UNITY_BEGIN();
+    RUN_TEST(test_fifo_survives_reopen);
+    RUN_TEST(test_evicts_oldest_when_full_and_wraps);
+    RUN_TEST(test_torn_header_falls_back_to_previous_copy);
+    RUN_TEST(test_interrupted_append_keeps_committed_records);
+    RUN_TEST(test_damaged_or_foreign_file_starts_empty);
+    RUN_TEST(test_failed_eviction_leaves_queue_unchanged);
+    RUN_TEST(test_closed_queue_refuses_io);
+    int failures = UNITY_END();
+    rmdir(g_directory);
+    return failures;
+}
\ No newline at end of file
@@ -0,0 +1,173 @@
+/**
+ * @brief PlotEnvelope: column widths per span, min/max/mean folding, display
+ * order across ring wrap, gaps, and the cost of feeding ten minutes of
+ * samples and reading every column.
+ */
+#include <unity.h>
+#include <chrono>
+#include "components/plot_envelope.hpp"
+
+namespace
+{
+    constexpr uint8_t COLUMNS = PlotEnvelope::COLUMNS;
+
+    // Number of columns holding samples
+    size_t filled_columns(const PlotEnvelope &plot)
+    {
+        size_t filled = 0;
+        for (uint8_t x = 0; x < COLUMNS; x++)
+        {
+            filled += !plot.column(x).is_empty();
+        }
+        return filled;
+    }
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_default_span_follows_config()
+{
+    PlotEnvelope plot;
+    TEST_ASSERT_TRUE(plot.get_span() == PlotEnvelope::DEFAULT_SPAN);
+    TEST_ASSERT_EQUAL_UINT32(config::display::plot::SPAN_S * 1000 / COLUMNS, plot.get_column_ms());
+}
+
+void test_column_width_per_span()
+{
+    PlotEnvelope plot(PlotEnvelope::Span::SECONDS_10);
+    TEST_ASSERT_EQUAL_UINT32(10000 / COLUMNS, plot.get_column_ms());
+    plot.set_span(PlotEnvelope::Span::MINUTE_1);
+    TEST_ASSERT_EQUAL_UINT32(60000 / COLUMNS, plot.get_column_ms());
+    plot.set_span(PlotEnvelope::Span::MINUTES_10);
+    TEST_ASSERT_EQUAL_UINT32(600000 / COLUMNS, plot.get_column_ms());
+}
+
+void test_folds_samples_into_one_column()
+{
+    PlotEnvelope plot(PlotEnvelope::Span::SECONDS_10);
+    const uint16_t values[] = {120, 40, 300, 100};
+    for (uint16_t value : values)
+    {
+        plot.add(value, 5000);
+    }
+
+    // The column being filled is the newest, on the right
+    const PlotEnvelope::Column &column = plot.column(COLUMNS - 1);
+    TEST_ASSERT_EQUAL_UINT16(40, column.min);
+    TEST_ASSERT_EQUAL_UINT16(300, column.max);
+    TEST_ASSERT_EQUAL_UINT16(140, column.mean());
+    TEST_ASSERT_EQUAL_UINT32(4, column.count);
+    TEST_ASSERT_EQUAL_size_t(1, filled_columns(plot));
+}
+
+void test_scrolls_oldest_to_newest_across_wrap()
+{
+    PlotEnvelope plot(PlotEnvelope::Span::SECONDS_10);
+    const uint32_t column_ms = plot.get_column_ms();
+
+    // One sample per column, numbered, for more than two trips around the ring
+    const uint16_t total = 2 * COLUMNS + 37;
+    for (uint16_t i = 0; i < total; i++)
+    {
+        plot.add(i, 1000 + static_cast<unsigned long>(i) * column_ms);
+    }
+
+    TEST_ASSERT_EQUAL_size_t(COLUMNS, filled_columns(plot));
+    for (uint8_t x = 0; x < COLUMNS; x++)
+    {
+        TEST_ASSERT_EQUAL_UINT16(total - COLUMNS + x, plot.column(x).min);
+    }
+}
+
+void test_gaps_stay_empty()
+{
+    PlotEnvelope plot(PlotEnvelope::Span::SECONDS_10);
+    const uint32_t column_ms = plot.get_column_ms();
+    plot.add(10, 0);
+    plot.add(20, 5 * column_ms);
+
+    // Four empty columns between the two samples
+    TEST_ASSERT_EQUAL_UINT16(20, plot.column(COLUMNS - 1).max);
+    for (uint8_t x = COLUMNS - 5; x < COLUMNS - 1; x++)
+    {
+        TEST_ASSERT_TRUE(plot.column(x).is_empty());
+    }
+    TEST_ASSERT_EQUAL_UINT16(10, plot.column(COLUMNS - 6).max);
+
+    // A gap longer than the span leaves only the new sample
+    plot.add(30, 5 * column_ms + 20000);
+    TEST_ASSERT_EQUAL_size_t(1, filled_columns(plot));
+    TEST_ASSERT_EQUAL_UINT16(30, plot.column(COLUMNS - 1).max);
+}
+
+void test_set_span_starts_over()
+{
+    PlotEnvelope plot(PlotEnvelope::Span::SECONDS_10);
+    for (unsigned long t = 0; t < 10000; t += 10)
+    {
+        plot.add(100, t);
+    }
+    TEST_ASSERT_EQUAL_size_t(COLUMNS, filled_columns(plot));
+
+    plot.set_span(PlotEnvelope::Span::MINUTE_1);
+    TEST_ASSERT_EQUAL_size_t(0, filled_columns(plot));
+
+    // The first sample after the change starts the newest column
+    plot.add(7, 10000);
+    TEST_ASSERT_EQUAL_UINT16(7, plot.column(COLUMNS - 1).min);
+}
+
+void test_benchmark_ten_minutes_at_sample_rate()
+{
+    PlotEnvelope plot(PlotEnvelope::Span::MINUTES_10);
+
+    // Ten minutes of the monitor's 10 ms samples, then every column read as a frame would
+    const uint32_t samples = 600000 / config::timing::SAMPLE_INTERVAL;
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < samples; i++)
+    {
+        plot.add(static_cast<uint16_t>(i % 500), static_cast<unsigned long>(i) * config::timing::SAMPLE_INTERVAL);
+    }
+    double add_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    const int frames = 10000;
+    uint32_t checksum = 0;
+    start = std::chrono::steady_clock::now();
+    for (int frame = 0; frame < frames; frame++)
+    {
+        for (uint8_t x = 0; x < COLUMNS; x++)
+        {
+            checksum += plot.column(x).max;
+        }
+    }
+    double read_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // The whole span is covered; only the samples of the column that scrolled out are missing
+    TEST_ASSERT_EQUAL_size_t(COLUMNS, filled_columns(plot));
+    uint32_t counted = 0;
+    for (uint8_t x = 0; x < COLUMNS; x++)
+    {
+        counted += plot.column(x).count;
+    }
+    TEST_ASSERT_TRUE(counted >= samples - (plot.get_column_ms() / config::timing::SAMPLE_INTERVAL + 1));
+    TEST_ASSERT_NOT_EQUAL(0, checksum);
+
+    char message[128];
+    snprintf(message, sizeof(message), "%u samples in %.1f ns each, %u columns read in %.2f us per frame",
+             samples, add_seconds / samples * 1e9, COLUMNS, read_seconds / frames * 1e6);
+    TEST_MESSAGE(message);
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_default_span_follows_config);
+    RUN_TEST(test_column_width_per_span);
+    RUN_TEST(test_folds_samples_into_one_column);
+    RUN_TEST(test_scrolls_oldest_to_newest_across_wrap);
+    RUN_TEST(test_gaps_stay_empty);
+    RUN_TEST(test_set_span_starts_over);
+    RUN_TEST(test_benchmark_ten_minutes_at_sample_rate);
+    return UNITY_END();
+}
\ No newline at end of file
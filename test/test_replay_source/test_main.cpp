@@ -0,0 +1,328 @@
+/**
+ * @brief Block acquisition on the host: ReplaySource over WAV and CSV files,
+ * paced by the virtual clock with a consumer that stalls, and AdcDmaSource
+ * on the simulated I2S ADC, checking block framing, the dropped count and
+ * that timestamps stay in step with the samples across drops.
+ */
+#include <unity.h>
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <vector>
+#include "components/replay_source.hpp"
+#include "components/adc_dma_source.hpp"
+#include "native/native_hal.hpp"
+
+namespace
+{
+    namespace acquisition = config::adc::acquisition;
+
+    constexpr uint32_t RATE_HZ = 16000;
+    constexpr uint32_t BLOCK_MS = acquisition::BLOCK_SIZE * 1000 / RATE_HZ;
+
+    char g_dir[64];
+    char g_path[96];
+
+    int16_t wav_value(uint64_t index)
+    {
+        return static_cast<int16_t>(index * 37 % 65536 - 32768);
+    }
+
+    // What ReplaySource makes of wav_value(index)
+    uint16_t wav_sample(uint64_t index)
+    {
+        return static_cast<uint16_t>((wav_value(index) + 32768) >> 4);
+    }
+
+    // 16-bit mono PCM with a LIST chunk before the data, as recorders write them
+    void write_wav(const char *path, uint32_t samples)
+    {
+        FILE *file = fopen(path, "wb");
+        TEST_ASSERT_NOT_NULL(file);
+        auto le32 = [file](uint32_t value)
+        {
+            const uint8_t bytes[] = {uint8_t(value), uint8_t(value >> 8), uint8_t(value >> 16), uint8_t(value >> 24)};
+            fwrite(bytes, 1, sizeof(bytes), file);
+        };
+        auto le16 = [file](uint16_t value)
+        {
+            const uint8_t bytes[] = {uint8_t(value), uint8_t(value >> 8)};
+            fwrite(bytes, 1, sizeof(bytes), file);
+        };
+
+        fwrite("RIFF", 1, 4, file);
+        le32(4 + 24 + 14 + 8 + samples * 2);
+        fwrite("WAVEfmt ", 1, 8, file);
+        le32(16);
+        le16(1);
+        le16(1);
+        le32(RATE_HZ);
+        le32(RATE_HZ * 2);
+        le16(2);
+        le16(16);
+        fwrite("LIST", 1, 4, file);
+        le32(5);
+        fwrite("INFO\0\0", 1, 6, file); // Odd size, padded
+        fwrite("data", 1, 4, file);
+        le32(samples * 2);
+        for (uint32_t i = 0; i < samples; i++)
+        {
+            le16(static_cast<uint16_t>(wav_value(i)));
+        }
+        fclose(file);
+    }
+
+    uint16_t ramp(uint64_t index)
+    {
+        return static_cast<uint16_t>(index & 0x0FFF);
+    }
+
+    struct Drained
+    {
+        uint32_t blocks{0};
+        bool in_step{true}; // Every timestamp and first sample matches the block's sequence
+    };
+
+    // Collect every block the source has ready, as the acquisition task does
+    template <typename Check>
+    void drain(AudioSource &source, Drained &drained, Check check)
+    {
+        SampleBlock block;
+        while (source.read_block(block))
+        {
+            drained.blocks++;
+            drained.in_step = drained.in_step && check(block);
+        }
+    }
+}
+
+void setUp()
+{
+    strcpy(g_dir, "/tmp/replay_source_XXXXXX");
+    TEST_ASSERT_NOT_NULL(mkdtemp(g_dir));
+    snprintf(g_path, sizeof(g_path), "%s/session.wav", g_dir);
+}
+
+void tearDown()
+{
+    native_hal::set_adc_signal(nullptr);
+    unlink(g_path);
+    char csv[96];
+    snprintf(csv, sizeof(csv), "%s/session.csv", g_dir);
+    unlink(csv);
+    rmdir(g_dir);
+}
+
+void test_wav_replays_as_blocks()
+{
+    // Ten and a half blocks: the last one is short
+    const uint32_t samples = 10 * acquisition::BLOCK_SIZE + acquisition::BLOCK_SIZE / 2;
+    write_wav(g_path, samples);
+    ReplaySource source(g_path);
+    TEST_ASSERT_TRUE(source.begin(8000));
+    TEST_ASSERT_EQUAL_UINT32(RATE_HZ, source.get_sample_rate());
+
+    SampleBlock block;
+    uint32_t index = 0;
+    for (uint32_t n = 0; n < 11; n++)
+    {
+        TEST_ASSERT_TRUE(source.read_block(block));
+        TEST_ASSERT_EQUAL_UINT32(n, block.sequence);
+        TEST_ASSERT_EQUAL_UINT32(n * BLOCK_MS, block.timestamp_ms);
+        TEST_ASSERT_EQUAL_size_t(n < 10 ? acquisition::BLOCK_SIZE : acquisition::BLOCK_SIZE / 2, block.count);
+        for (size_t i = 0; i < block.count; i++)
+        {
+            TEST_ASSERT_EQUAL_UINT16(wav_sample(index++), block.samples[i]);
+        }
+    }
+    TEST_ASSERT_FALSE(source.read_block(block));
+    TEST_ASSERT_TRUE(source.is_finished());
+    TEST_ASSERT_EQUAL_UINT64(samples, source.get_stats().samples_read);
+    TEST_ASSERT_EQUAL_UINT32(0, source.get_stats().blocks_dropped);
+}
+
+void test_csv_replays_clamped_values()
+{
+    snprintf(g_path, sizeof(g_path), "%s/session.csv", g_dir);
+    FILE *file = fopen(g_path, "w");
+    fputs("adc\n5\n-3\n9999\n\n2048\n", file);
+    fclose(file);
+
+    ReplaySource source(g_path);
+    TEST_ASSERT_TRUE(source.begin(RATE_HZ));
+    SampleBlock block;
+    TEST_ASSERT_TRUE(source.read_block(block));
+    const uint16_t expected[] = {5, 0, config::adc::MAX_VALUE, 2048};
+    TEST_ASSERT_EQUAL_size_t(4, block.count);
+    for (size_t i = 0; i < 4; i++)
+    {
+        TEST_ASSERT_EQUAL_UINT16(expected[i], block.samples[i]);
+    }
+    TEST_ASSERT_FALSE(source.read_block(block));
+}
+
+void test_loop_rewinds_to_the_data()
+{
+    write_wav(g_path, 100);
+    ReplaySource source(g_path, true);
+    TEST_ASSERT_TRUE(source.begin(RATE_HZ));
+
+    SampleBlock block;
+    uint32_t index = 0;
+    for (int n = 0; n < 3; n++)
+    {
+        TEST_ASSERT_TRUE(source.read_block(block));
+        TEST_ASSERT_EQUAL_size_t(acquisition::BLOCK_SIZE, block.count);
+        for (size_t i = 0; i < block.count; i++)
+        {
+            TEST_ASSERT_EQUAL_UINT16(wav_sample(index++ % 100), block.samples[i]);
+        }
+    }
+    TEST_ASSERT_FALSE(source.is_finished());
+}
+
+void test_paced_replay_counts_stalled_blocks()
+{
+    write_wav(g_path, 3 * RATE_HZ);
+    ReplaySource source(g_path);
+    source.set_clock(native_hal::now_us);
+    TEST_ASSERT_TRUE(source.begin(RATE_HZ));
+    const uint64_t start_us = native_hal::now_us();
+
+    auto check = [](const SampleBlock &block)
+    {
+        return block.timestamp_ms == block.sequence * BLOCK_MS &&
+               block.samples[0] == wav_sample(uint64_t(block.sequence) * acquisition::BLOCK_SIZE);
+    };
+
+    // A second of keeping up, one block per period
+    Drained drained;
+    for (int i = 0; i < 100; i++)
+    {
+        native_hal::advance_us(BLOCK_MS * 1000);
+        drain(source, drained, check);
+    }
+    TEST_ASSERT_EQUAL_UINT32(100, drained.blocks);
+
+    // 250 ms without reading: 25 blocks fell due, the driver queue kept the newest QUEUED_BLOCKS
+    native_hal::advance_us(250000);
+    drain(source, drained, check);
+    TEST_ASSERT_EQUAL_UINT32(100 + acquisition::QUEUED_BLOCKS, drained.blocks);
+    TEST_ASSERT_EQUAL_UINT32(25 - acquisition::QUEUED_BLOCKS, source.get_stats().blocks_dropped);
+
+    // Then keeping up again until the recording ends
+    while (!source.is_finished())
+    {
+        native_hal::advance_us(BLOCK_MS * 1000);
+        drain(source, drained, check);
+    }
+
+    const AudioSource::Stats &stats = source.get_stats();
+    TEST_ASSERT_TRUE(drained.in_step);
+    TEST_ASSERT_EQUAL_UINT32(3 * RATE_HZ / acquisition::BLOCK_SIZE, stats.blocks_read + stats.blocks_dropped);
+    TEST_ASSERT_EQUAL_UINT32(drained.blocks, stats.blocks_read);
+    TEST_ASSERT_EQUAL_UINT32(3000000 + BLOCK_MS * 1000, native_hal::now_us() - start_us);
+}
+
+void test_dma_source_assembles_blocks()
+{
+    native_hal::set_adc_signal(ramp);
+    AdcDmaSource source;
+    TEST_ASSERT_TRUE(source.begin(RATE_HZ));
+    const unsigned long start_ms = millis();
+
+    // Half a block is read but held back until the block is complete
+    SampleBlock block;
+    native_hal::advance_us(BLOCK_MS * 500);
+    TEST_ASSERT_FALSE(source.read_block(block));
+    native_hal::advance_us(BLOCK_MS * 500);
+    TEST_ASSERT_TRUE(source.read_block(block));
+    TEST_ASSERT_FALSE(source.read_block(block));
+
+    // The channel bits are masked off
+    TEST_ASSERT_EQUAL_size_t(acquisition::BLOCK_SIZE, block.count);
+    TEST_ASSERT_EQUAL_UINT32(0, block.sequence);
+    TEST_ASSERT_EQUAL_UINT32(start_ms, block.timestamp_ms);
+    for (size_t i = 0; i < block.count; i++)
+    {
+        TEST_ASSERT_EQUAL_UINT16(ramp(i), block.samples[i]);
+    }
+}
+
+void test_dma_source_counts_drops_across_stalls()
+{
+    native_hal::set_adc_signal(ramp);
+    AdcDmaSource source;
+    TEST_ASSERT_TRUE(source.begin(RATE_HZ));
+    const unsigned long start_ms = millis();
+
+    auto check = [start_ms](const SampleBlock &block)
+    {
+        return block.timestamp_ms == start_ms + block.sequence * BLOCK_MS &&
+               block.samples[0] == ramp(uint64_t(block.sequence) * acquisition::BLOCK_SIZE);
+    };
+
+    // Stalls that fit the queue, fill it exactly, overflow it, and far exceed the old 8-event queue
+    const uint32_t stalls_ms[] = {40, BLOCK_MS * acquisition::QUEUED_BLOCKS, 75, 200, 1234, 30};
+    uint32_t expected_dropped = 0;
+    Drained drained;
+    for (uint32_t stall_ms : stalls_ms)
+    {
+        for (int i = 0; i < 50; i++)
+        {
+            native_hal::advance_us(BLOCK_MS * 1000);
+            drain(source, drained, check);
+        }
+        native_hal::advance_us(stall_ms * 1000);
+        drain(source, drained, check);
+
+        uint32_t due = stall_ms / BLOCK_MS;
+        expected_dropped += due > acquisition::QUEUED_BLOCKS ? due - acquisition::QUEUED_BLOCKS : 0;
+        TEST_ASSERT_EQUAL_UINT32(expected_dropped, source.get_stats().blocks_dropped);
+    }
+
+    const AudioSource::Stats &stats = source.get_stats();
+    TEST_ASSERT_TRUE(drained.in_step);
+    TEST_ASSERT_EQUAL_UINT32(drained.blocks, stats.blocks_read);
+    TEST_ASSERT_EQUAL_UINT32((millis() - start_ms) / BLOCK_MS, stats.blocks_read + stats.blocks_dropped);
+}
+
+void test_benchmark_unpaced_replay()
+{
+    // A minute of audio drained as fast as the host can read it
+    const uint32_t samples = 60 * RATE_HZ;
+    write_wav(g_path, samples);
+    ReplaySource source(g_path);
+    TEST_ASSERT_TRUE(source.begin(RATE_HZ));
+
+    SampleBlock block;
+    uint32_t blocks = 0;
+    auto start = std::chrono::steady_clock::now();
+    while (source.read_block(block))
+    {
+        blocks++;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    TEST_ASSERT_EQUAL_UINT32(samples / acquisition::BLOCK_SIZE, blocks);
+    TEST_ASSERT_EQUAL_UINT32(0, source.get_stats().blocks_dropped);
+
+    char message[128];
+    snprintf(message, sizeof(message), "%u blocks in %.1f ms: %.1f M samples/s, %.0fx real time",
+             blocks, seconds * 1e3, samples / seconds / 1e6, 60.0 / seconds);
+    TEST_MESSAGE(message);
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_wav_replays_as_blocks);
+    RUN_TEST(test_csv_replays_clamped_values);
+    RUN_TEST(test_loop_rewinds_to_the_data);
+    RUN_TEST(test_paced_replay_counts_stalled_blocks);
+    RUN_TEST(test_dma_source_assembles_blocks);
+    RUN_TEST(test_dma_source_counts_drops_across_stalls);
+    RUN_TEST(test_benchmark_unpaced_replay);
+    return UNITY_END();
+}
\ No newline at end of file
@@ -0,0 +1,197 @@
+/**
+ * @brief SignalProcessor: process_block() against the per-sample path over a
+ * long synthetic recording, and a samples/second benchmark of both paths.
+ */
+#include <unity.h>
+#include <chrono>
+#include <memory>
+#include "components/signal_processor.hpp"
+#include "native/native_hal.hpp"
+
+namespace
+{
+    constexpr size_t BLOCK_SIZE = config::adc::acquisition::BLOCK_SIZE;
+    constexpr unsigned long BLOCK_PERIOD_MS = 10;
+
+    // Envelope-like test signal: a slow level sweep with deterministic noise on top
+    class SyntheticSignal
+    {
+    public:
+        uint16_t next()
+        {
+            m_state = m_state * 1664525u + 1013904223u;
+            int32_t noise = static_cast<int32_t>(m_state >> 24) - 128;
+            int32_t level = 600 + static_cast<int32_t>((m_index++ / 4000) % 2500);
+            int32_t value = level + noise * 3;
+            return static_cast<uint16_t>(value < 0 ? 0 : (value > 4095 ? 4095 : value));
+        }
+
+        void fill(uint16_t *samples, size_t count)
+        {
+            for (size_t i = 0; i < count; i++)
+            {
+                samples[i] = next();
+            }
+        }
+
+    private:
+        uint32_t m_state{12345};
+        uint32_t m_index{0};
+    };
+
+    void assert_same_statistics(const SignalProcessor::Statistics &expected,
+                                const SignalProcessor::Statistics &actual)
+    {
+        TEST_ASSERT_EQUAL_UINT16(expected.min, actual.min);
+        TEST_ASSERT_EQUAL_UINT16(expected.max, actual.max);
+        TEST_ASSERT_EQUAL_MEMORY(&expected.avg, &actual.avg, sizeof(float));
+        TEST_ASSERT_EQUAL_UINT32(expected.samples, actual.samples);
+        TEST_ASSERT_EQUAL_UINT32(expected.last_update, actual.last_update);
+        TEST_ASSERT_EQUAL_UINT16(expected.l10(), actual.l10());
+        TEST_ASSERT_EQUAL_UINT16(expected.l50(), actual.l50());
+        TEST_ASSERT_EQUAL_UINT16(expected.l90(), actual.l90());
+    }
+
+    void assert_same_state(const SignalProcessor &expected, const SignalProcessor &actual)
+    {
+        float expected_value = expected.get_current_value();
+        float actual_value = actual.get_current_value();
+        float expected_baseline = expected.get_baseline();
+        float actual_baseline = actual.get_baseline();
+        TEST_ASSERT_EQUAL_MEMORY(&expected_value, &actual_value, sizeof(float));
+        TEST_ASSERT_EQUAL_MEMORY(&expected_baseline, &actual_baseline, sizeof(float));
+        assert_same_statistics(expected.get_one_min_stats(), actual.get_one_min_stats());
+        assert_same_statistics(expected.get_fifteen_min_stats(), actual.get_fifteen_min_stats());
+        assert_same_statistics(expected.get_daily_stats(), actual.get_daily_stats());
+    }
+
+    // Moves the virtual clock so millis() reads the given time
+    void set_millis(unsigned long ms)
+    {
+        uint64_t target_us = uint64_t(ms) * 1000;
+        if (target_us > native_hal::now_us())
+        {
+            native_hal::advance_us(target_us - native_hal::now_us());
+        }
+    }
+}
+
+void setUp() {}
+void tearDown() {}
+
+// Long enough for the one-minute window and interval to roll over several times
+void test_block_path_matches_sample_path()
+{
+    auto per_sample = std::make_unique<SignalProcessor>();
+    auto per_block = std::make_unique<SignalProcessor>();
+    SyntheticSignal signal;
+    uint16_t block[BLOCK_SIZE];
+
+    unsigned long start_ms = millis();
+    constexpr size_t NUM_BLOCKS = 4 * 60 * 1000 / BLOCK_PERIOD_MS;
+    for (size_t b = 0; b < NUM_BLOCKS; b++)
+    {
+        unsigned long timestamp = start_ms + b * BLOCK_PERIOD_MS;
+        set_millis(timestamp);
+        signal.fill(block, BLOCK_SIZE);
+
+        for (size_t i = 0; i < BLOCK_SIZE; i++)
+        {
+            per_sample->process_sample(block[i]);
+        }
+        per_block->process_block(block, BLOCK_SIZE, timestamp);
+
+        if (b % 1000 == 0)
+        {
+            assert_same_state(*per_sample, *per_block);
+        }
+    }
+    assert_same_state(*per_sample, *per_block);
+    TEST_ASSERT_GREATER_THAN(0, per_block->get_one_min_stats().samples);
+}
+
+void test_empty_block_is_ignored()
+{
+    auto processor = std::make_unique<SignalProcessor>();
+    uint16_t sample = 1000;
+    processor->process_block(&sample, 0, millis());
+    TEST_ASSERT_EQUAL_UINT32(0, processor->get_one_min_stats().samples);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, processor->get_current_value());
+}
+
+void test_exceedance_levels_slide_with_the_window()
+{
+    auto processor = std::make_unique<SignalProcessor>();
+    unsigned long start_ms = millis();
+    start_ms -= start_ms % config::signal_processing::windows::ONE_MIN_MS;
+
+    // A minute at 100, then half a minute at 400, one block peak per 10 ms
+    for (unsigned long t = 0; t < 90000; t += BLOCK_PERIOD_MS)
+    {
+        uint16_t peak = t < 60000 ? 100 : 400;
+        processor->process_block(&peak, 1, start_ms + t);
+    }
+
+    // The minute still holds 100s after the step, which a fresh interval would have dropped
+    const SignalProcessor::Statistics &one_min = processor->get_one_min_stats();
+    TEST_ASSERT_INT_WITHIN(4, 100, one_min.l90());
+    TEST_ASSERT_INT_WITHIN(8, 400, one_min.l10());
+    TEST_ASSERT_EQUAL_UINT16(100, one_min.min);
+
+    // Once the window has passed the step, only the new level is left
+    for (unsigned long t = 90000; t <= 130000; t += BLOCK_PERIOD_MS)
+    {
+        uint16_t peak = 400;
+        processor->process_block(&peak, 1, start_ms + t);
+    }
+    TEST_ASSERT_INT_WITHIN(8, 400, one_min.l90());
+    TEST_ASSERT_INT_WITHIN(4, 100, processor->get_daily_stats().l90());
+}
+
+void test_benchmark_samples_per_second()
+{
+    auto processor = std::make_unique<SignalProcessor>();
+    SyntheticSignal signal;
+    constexpr size_t NUM_BLOCKS = 20000;
+    static uint16_t samples[NUM_BLOCKS][BLOCK_SIZE];
+    for (auto &block : samples)
+    {
+        signal.fill(block, BLOCK_SIZE);
+    }
+    unsigned long start_ms = millis();
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t b = 0; b < NUM_BLOCKS; b++)
+    {
+        set_millis(start_ms + b * BLOCK_PERIOD_MS);
+        for (size_t i = 0; i < BLOCK_SIZE; i++)
+        {
+            processor->process_sample(samples[b][i]);
+        }
+    }
+    double sample_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+    for (size_t b = 0; b < NUM_BLOCKS; b++)
+    {
+        processor->process_block(samples[b], BLOCK_SIZE, start_ms + (NUM_BLOCKS + b) * BLOCK_PERIOD_MS);
+    }
+    double block_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    double total = double(NUM_BLOCKS) * BLOCK_SIZE;
+    char message[128];
+    snprintf(message, sizeof(message), "process_sample: %.1f Msamples/s, process_block: %.1f Msamples/s",
+             total / sample_s / 1e6, total / block_s / 1e6);
+    TEST_MESSAGE(message);
+    TEST_ASSERT_TRUE(block_s > 0 && sample_s > 0);
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_block_path_matches_sample_path);
+    RUN_TEST(test_empty_block_is_ignored);
+    RUN_TEST(test_exceedance_levels_slide_with_the_window);
+    RUN_TEST(test_benchmark_samples_per_second);
+    return UNITY_END();
+}
\ No newline at end of file
@@ -0,0 +1,168 @@
+/**
+ * @brief SlidingWindowAggregator against a brute-force reference that keeps
+ * every value, over more than a day of irregular blocks and idle gaps.
+ */
+#include <unity.h>
+#include <deque>
+#include <math.h>
+#include "components/sliding_window.hpp"
+
+namespace
+{
+    constexpr uint32_t SECOND_MS = config::signal_processing::windows::SECOND_BUCKET_MS;
+    constexpr uint32_t MINUTE_MS = config::signal_processing::windows::ONE_MIN_MS;
+    constexpr uint32_t QUARTER_MS = config::signal_processing::windows::FIFTEEN_MIN_MS;
+    constexpr uint32_t DAY_MS = config::signal_processing::windows::DAILY_MS;
+
+    struct Sample
+    {
+        unsigned long time;
+        float value;
+    };
+
+    /**
+     * Keeps every value. A window built from buckets of `bucket_ms` holds the
+     * open bucket and the closed ones before it, so it starts at the
+     * bucket boundary (window / bucket - 1) buckets before the open one.
+     */
+    class Reference
+    {
+    public:
+        void add(unsigned long time, float value)
+        {
+            m_samples.push_back({time, value});
+            while (!m_samples.empty() && m_samples.front().time + DAY_MS + QUARTER_MS < time)
+            {
+                m_samples.pop_front();
+            }
+        }
+
+        WindowAggregate window(unsigned long now, uint32_t window_ms, uint32_t bucket_ms) const
+        {
+            unsigned long open_start = now - now % bucket_ms;
+            unsigned long span = window_ms - bucket_ms;
+            unsigned long start = open_start > span ? open_start - span : 0;
+            WindowAggregate aggregate;
+            double sum = 0;
+            for (const Sample &sample : m_samples)
+            {
+                if (sample.time >= start)
+                {
+                    aggregate.add(sample.value);
+                    sum += sample.value;
+                }
+            }
+            aggregate.sum = static_cast<float>(sum);
+            return aggregate;
+        }
+
+    private:
+        std::deque<Sample> m_samples;
+    };
+
+    class Random
+    {
+    public:
+        uint32_t next(uint32_t range)
+        {
+            m_state = m_state * 1664525u + 1013904223u;
+            return (m_state >> 8) % range;
+        }
+
+    private:
+        uint32_t m_state{99};
+    };
+
+    void assert_matches(const WindowAggregate &expected, const WindowAggregate &actual)
+    {
+        TEST_ASSERT_EQUAL_UINT32(expected.count, actual.count);
+        if (expected.count == 0)
+        {
+            return;
+        }
+        TEST_ASSERT_EQUAL_FLOAT(expected.min, actual.min);
+        TEST_ASSERT_EQUAL_FLOAT(expected.max, actual.max);
+        // The aggregator sums in float, the reference in double
+        TEST_ASSERT_FLOAT_WITHIN(expected.mean() * 1e-3f, expected.mean(), actual.mean());
+    }
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_empty_windows()
+{
+    SlidingWindowAggregator windows;
+    windows.advance(5000);
+    TEST_ASSERT_EQUAL_UINT32(0, windows.one_minute().count);
+    TEST_ASSERT_EQUAL_UINT32(0, windows.daily().count);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, windows.one_minute().mean());
+}
+
+void test_matches_reference_over_a_day()
+{
+    SlidingWindowAggregator windows;
+    Reference reference;
+    Random random;
+
+    unsigned long now = 123457;
+    unsigned long end = now + DAY_MS + 6 * 3600000UL;
+    uint32_t checks = 0;
+    for (uint32_t block = 0; now < end; block++)
+    {
+        windows.advance(now);
+        for (uint32_t i = random.next(4); i > 0; i--)
+        {
+            float value = 100.0f + random.next(3000);
+            windows.add(value);
+            reference.add(now, value);
+        }
+
+        if (block % 97 == 0)
+        {
+            assert_matches(reference.window(now, MINUTE_MS, SECOND_MS), windows.one_minute());
+            assert_matches(reference.window(now, QUARTER_MS, MINUTE_MS), windows.fifteen_minutes());
+            assert_matches(reference.window(now, DAY_MS, QUARTER_MS), windows.daily());
+            checks++;
+        }
+
+        // Mostly regular blocks, now and then an idle gap past one or more windows
+        uint32_t kind = random.next(20000);
+        now += kind == 0 ? QUARTER_MS + random.next(2 * QUARTER_MS)
+               : kind < 5 ? MINUTE_MS + random.next(2 * MINUTE_MS)
+                          : 100 + random.next(900);
+    }
+    TEST_ASSERT_GREATER_THAN(1000, checks);
+}
+
+void test_values_expire_after_window()
+{
+    SlidingWindowAggregator windows;
+    windows.advance(0);
+    windows.add(3000.0f);
+
+    // Still inside the minute while its second is one of the 59 closed ones
+    windows.advance(59 * SECOND_MS);
+    windows.add(10.0f);
+    TEST_ASSERT_EQUAL_FLOAT(3000.0f, windows.one_minute().max);
+
+    windows.advance(MINUTE_MS);
+    TEST_ASSERT_EQUAL_FLOAT(10.0f, windows.one_minute().max);
+    TEST_ASSERT_EQUAL_FLOAT(3000.0f, windows.fifteen_minutes().max);
+    TEST_ASSERT_EQUAL_UINT32(2, windows.daily().count);
+
+    // A gap longer than a day leaves every window empty
+    windows.advance(MINUTE_MS + DAY_MS + QUARTER_MS);
+    TEST_ASSERT_EQUAL_UINT32(0, windows.one_minute().count);
+    TEST_ASSERT_EQUAL_UINT32(0, windows.fifteen_minutes().count);
+    TEST_ASSERT_EQUAL_UINT32(0, windows.daily().count);
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_empty_windows);
+    RUN_TEST(test_matches_reference_over_a_day);
+    RUN_TEST(test_values_expire_after_window);
+    return UNITY_END();
+}
\ No newline at end of file
@@ -0,0 +1,162 @@
+/**
+ * @brief A/C weighting filters against the IEC 61672-1 analytic curves, and
+ * the SoundLevelMeter calibration against levels worked out from the sensor
+ * figures.
+ */
+#include <unity.h>
+#include <math.h>
+#include <vector>
+#include "components/sound_level_meter.hpp"
+
+namespace
+{
+    constexpr double SAMPLE_RATE_HZ = config::adc::acquisition::SAMPLE_RATE_HZ;
+    constexpr double PI = 3.14159265358979323846;
+
+    // IEC 61672-1 Annex E, normalised to 0dB at 1kHz
+    double ra(double f)
+    {
+        double f2 = f * f;
+        return 12194.0 * 12194.0 * f2 * f2 /
+               ((f2 + 20.6 * 20.6) * sqrt((f2 + 107.7 * 107.7) * (f2 + 737.9 * 737.9)) * (f2 + 12194.0 * 12194.0));
+    }
+
+    double rc(double f)
+    {
+        double f2 = f * f;
+        return 12194.0 * 12194.0 * f2 / ((f2 + 20.6 * 20.6) * (f2 + 12194.0 * 12194.0));
+    }
+
+    double a_weighting_db(double f) { return 20.0 * log10(ra(f) / ra(1000.0)); }
+    double c_weighting_db(double f) { return 20.0 * log10(rc(f) / rc(1000.0)); }
+
+    struct Response
+    {
+        double a_db;
+        double c_db;
+    };
+
+    // Steady-state gain of the meter's filter chain for a unit sine
+    Response measure(double frequency_hz)
+    {
+        weighting::Biquad highpass{weighting::HIGHPASS};
+        weighting::Biquad lowpass{weighting::LOWPASS};
+        weighting::Biquad midband{weighting::MIDBAND};
+
+        // Several seconds so the 20Hz poles have settled, then whole periods
+        const size_t settle = static_cast<size_t>(SAMPLE_RATE_HZ * 4);
+        const size_t measure = static_cast<size_t>(SAMPLE_RATE_HZ * 2);
+        double a_energy = 0;
+        double c_energy = 0;
+        for (size_t n = 0; n < settle + measure; n++)
+        {
+            float x = static_cast<float>(sin(2.0 * PI * frequency_hz * n / SAMPLE_RATE_HZ));
+            float c = lowpass.process(highpass.process(x));
+            float a = midband.process(c) * weighting::A_GAIN;
+            c *= weighting::C_GAIN;
+            if (n >= settle)
+            {
+                a_energy += double(a) * a;
+                c_energy += double(c) * c;
+            }
+        }
+        // A unit sine has an RMS of 1/sqrt(2)
+        return {10.0 * log10(2.0 * a_energy / measure), 10.0 * log10(2.0 * c_energy / measure)};
+    }
+
+    // Within IEC 61672-1 class 2 limits up to 2kHz, looser towards Nyquist at the acquisition rate
+    double tolerance_db(double f)
+    {
+        if (f < 50.0)
+        {
+            return 2.0;
+        }
+        if (f <= 2000.0)
+        {
+            return 0.5;
+        }
+        return f <= SAMPLE_RATE_HZ / 4.0 ? 1.0 : 2.0;
+    }
+
+    std::vector<uint16_t> make_sine(double frequency_hz, double amplitude_counts, double seconds)
+    {
+        std::vector<uint16_t> samples(static_cast<size_t>(SAMPLE_RATE_HZ * seconds));
+        for (size_t n = 0; n < samples.size(); n++)
+        {
+            samples[n] = static_cast<uint16_t>(lround(2048.0 + amplitude_counts *
+                                                                   sin(2.0 * PI * frequency_hz * n / SAMPLE_RATE_HZ)));
+        }
+        return samples;
+    }
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_weighting_is_unity_at_1khz()
+{
+    Response response = measure(1000.0);
+    TEST_ASSERT_FLOAT_WITHIN(0.05f, 0.0f, response.a_db);
+    TEST_ASSERT_FLOAT_WITHIN(0.05f, 0.0f, response.c_db);
+}
+
+void test_weighting_follows_reference_curves()
+{
+    const double frequencies[] = {31.5, 63, 125, 250, 500, 1000, 2000, 3150, 4000, 5000, 6300};
+    for (double f : frequencies)
+    {
+        if (f >= SAMPLE_RATE_HZ / 2.0)
+        {
+            continue;
+        }
+        Response response = measure(f);
+        char message[96];
+        snprintf(message, sizeof(message), "%.1f Hz: A %.2f dB (ref %.2f), C %.2f dB (ref %.2f)", f,
+                 response.a_db, a_weighting_db(f), response.c_db, c_weighting_db(f));
+        TEST_MESSAGE(message);
+        float tolerance = static_cast<float>(tolerance_db(f));
+        TEST_ASSERT_FLOAT_WITHIN_MESSAGE(tolerance, a_weighting_db(f), response.a_db, message);
+        TEST_ASSERT_FLOAT_WITHIN_MESSAGE(tolerance, c_weighting_db(f), response.c_db, message);
+    }
+}
+
+// The sensor figures worked through by hand: 1.1 V reads 4095 counts, the preamp adds 52 dB and
+// the capsule gives -58 dBV/Pa, the middle of its -60 to -56 range. One count is then
+// 268.6 uV at the ADC, 0.6748 uV at the capsule and 0.5360 mPa, or 28.56 dB re 20 uPa.
+void test_calibration_matches_datasheet_figures()
+{
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, 28.56f, SoundLevelMeter::calibration_db());
+}
+
+// A 200-count 1kHz sine is 37.99 mV RMS at the ADC, 95.42 uV RMS at the capsule and
+// 75.80 mPa RMS, so 71.57 dB SPL; its 200-count peak is 74.58 dB
+void test_1khz_sine_reads_calibrated_levels()
+{
+    SoundLevelMeter meter;
+    std::vector<uint16_t> samples = make_sine(1000.0, 200.0, 3.0);
+    meter.process(samples.data(), samples.size());
+    TEST_ASSERT_TRUE(meter.has_levels());
+
+    TEST_ASSERT_FLOAT_WITHIN(0.2f, 71.57f, meter.get_laeq());
+    TEST_ASSERT_FLOAT_WITHIN(0.3f, 74.58f, meter.get_lcpeak());
+}
+
+void test_silence_reads_floor()
+{
+    SoundLevelMeter meter;
+    std::vector<uint16_t> samples(static_cast<size_t>(SAMPLE_RATE_HZ * 2), 2048);
+    meter.process(samples.data(), samples.size());
+    TEST_ASSERT_TRUE(meter.has_levels());
+    TEST_ASSERT_EQUAL_FLOAT(config::signal_processing::levels::FLOOR_DB, meter.get_laeq());
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_weighting_is_unity_at_1khz);
+    RUN_TEST(test_weighting_follows_reference_curves);
+    RUN_TEST(test_calibration_matches_datasheet_figures);
+    RUN_TEST(test_1khz_sine_reads_calibrated_levels);
+    RUN_TEST(test_silence_reads_floor);
+    return UNITY_END();
+}
\ No newline at end of file
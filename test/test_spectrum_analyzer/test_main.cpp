@@ -0,0 +1,167 @@
+/**
+ * @brief SpectrumAnalyzer: tones land in their bands at the calibrated level,
+ * skipped hops are only counted in steady state, and an FFTs/second benchmark
+ * checked against the per-hop time budget.
+ */
+#include <unity.h>
+#include <chrono>
+#include <math.h>
+#include <memory>
+#include <vector>
+#include "components/spectrum_analyzer.hpp"
+#include "components/sound_level_meter.hpp"
+
+namespace
+{
+    constexpr double SAMPLE_RATE_HZ = config::adc::acquisition::SAMPLE_RATE_HZ;
+    constexpr size_t HOP_SIZE = config::signal_processing::spectrum::HOP_SIZE;
+    constexpr double PI = 3.14159265358979323846;
+
+    // A sine around mid-scale, amplitude in ADC counts
+    std::vector<uint16_t> make_tone(double frequency_hz, double amplitude, size_t count)
+    {
+        std::vector<uint16_t> samples(count);
+        for (size_t n = 0; n < count; n++)
+        {
+            samples[n] = static_cast<uint16_t>(lround(2048.0 + amplitude * sin(2.0 * PI * frequency_hz * n / SAMPLE_RATE_HZ)));
+        }
+        return samples;
+    }
+
+    template <size_t N>
+    size_t loudest(const std::array<float, N> &levels)
+    {
+        size_t best = 0;
+        for (size_t b = 1; b < N; b++)
+        {
+            best = levels[b] > levels[best] ? b : best;
+        }
+        return best;
+    }
+
+    // The analyzer keeps its buffers inline, too large for the stack of some hosts
+    std::unique_ptr<SpectrumAnalyzer> analyze_tone(double frequency_hz, double amplitude)
+    {
+        std::unique_ptr<SpectrumAnalyzer> analyzer(new SpectrumAnalyzer());
+        std::vector<uint16_t> tone = make_tone(frequency_hz, amplitude, spectrum::FFT_SIZE);
+        analyzer->push(tone.data(), tone.size());
+        analyzer->analyze();
+        return analyzer;
+    }
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_tone_lands_in_its_octave()
+{
+    // Centre frequencies of some octave bands, and a tone inside each one
+    for (size_t band : {2u, 4u, 5u, 6u})
+    {
+        double frequency_hz = SpectrumAnalyzer::octave_center_hz(band);
+        std::unique_ptr<SpectrumAnalyzer> analyzer = analyze_tone(frequency_hz, 500.0);
+        TEST_ASSERT_TRUE(analyzer->has_spectrum());
+        TEST_ASSERT_EQUAL_UINT32(band, loudest(analyzer->get_octave_levels()));
+    }
+}
+
+void test_tone_lands_in_its_third_octave()
+{
+    std::unique_ptr<SpectrumAnalyzer> analyzer = analyze_tone(1000.0, 500.0);
+    size_t band = loudest(analyzer->get_third_octave_levels());
+    TEST_ASSERT_FLOAT_WITHIN(1.0f, 1000.0f, SpectrumAnalyzer::third_octave_center_hz(band));
+}
+
+void test_band_level_matches_calibration()
+{
+    // A full-band sine of amplitude A has a mean square of A^2 / 2
+    const double amplitude = 500.0;
+    std::unique_ptr<SpectrumAnalyzer> analyzer = analyze_tone(1000.0, amplitude);
+    float expected = 10.0f * log10f(amplitude * amplitude / 2.0) + SoundLevelMeter::calibration_db();
+    float level = analyzer->get_octave_levels()[loudest(analyzer->get_octave_levels())];
+
+    char message[80];
+    snprintf(message, sizeof(message), "1 kHz band: %.2f dB, expected %.2f dB", level, expected);
+    TEST_MESSAGE(message);
+    TEST_ASSERT_FLOAT_WITHIN(0.5f, expected, level);
+}
+
+void test_quiet_input_stays_below_tone()
+{
+    std::unique_ptr<SpectrumAnalyzer> loud = analyze_tone(1000.0, 500.0);
+    std::unique_ptr<SpectrumAnalyzer> quiet = analyze_tone(1000.0, 5.0);
+    size_t band = loudest(loud->get_octave_levels());
+
+    // 40 dB less signal, and block floating point keeps the quiet level accurate
+    TEST_ASSERT_FLOAT_WITHIN(1.0f, 40.0f, loud->get_octave_levels()[band] - quiet->get_octave_levels()[band]);
+}
+
+void test_boot_backlog_is_not_counted_as_skipped()
+{
+    std::unique_ptr<SpectrumAnalyzer> analyzer(new SpectrumAnalyzer());
+    std::vector<uint16_t> tone = make_tone(1000.0, 500.0, HOP_SIZE * 20);
+
+    // Many hops arrive before the first analysis, as while begin() delays
+    analyzer->push(tone.data(), tone.size());
+    TEST_ASSERT_TRUE(analyzer->analyze());
+    TEST_ASSERT_FALSE(analyzer->analyze());
+    TEST_ASSERT_EQUAL_UINT32(0, analyzer->get_stats().frames_skipped);
+    TEST_ASSERT_TRUE(analyzer->is_within_budget());
+
+    // Steady state: one analysis per hop keeps up
+    for (int i = 0; i < 5; i++)
+    {
+        analyzer->push(tone.data(), HOP_SIZE);
+        TEST_ASSERT_TRUE(analyzer->analyze());
+    }
+    TEST_ASSERT_EQUAL_UINT32(0, analyzer->get_stats().frames_skipped);
+
+    // Two hops without an analysis in between lose one frame
+    analyzer->push(tone.data(), HOP_SIZE);
+    analyzer->push(tone.data(), HOP_SIZE);
+    TEST_ASSERT_TRUE(analyzer->analyze());
+    TEST_ASSERT_EQUAL_UINT32(1, analyzer->get_stats().frames_skipped);
+    TEST_ASSERT_EQUAL_UINT32(7, analyzer->get_stats().frames_analyzed);
+    TEST_ASSERT_FALSE(analyzer->is_within_budget());
+}
+
+void test_benchmark_ffts_per_second()
+{
+    std::unique_ptr<SpectrumAnalyzer> analyzer(new SpectrumAnalyzer());
+    std::vector<uint16_t> tone = make_tone(440.0, 800.0, HOP_SIZE * 64);
+
+    const size_t hops = 20000;
+    size_t offset = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < hops; i++)
+    {
+        analyzer->push(tone.data() + offset, HOP_SIZE);
+        offset = (offset + HOP_SIZE) % tone.size();
+        analyzer->analyze();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // The host clock seen by the analyzer is virtual, so time it here
+    double ffts_per_second = analyzer->get_stats().frames_analyzed / seconds;
+    double hop_us = HOP_SIZE * 1e6 / SAMPLE_RATE_HZ;
+    double load_percent = 100.0 * (1e6 / ffts_per_second) / hop_us;
+
+    char message[128];
+    snprintf(message, sizeof(message), "%.0f FFTs/s (%.1f us each), %.2f%% of a %.0f us hop, %.0f FFTs/s needed",
+             ffts_per_second, 1e6 / ffts_per_second, load_percent, hop_us, 1e6 / hop_us);
+    TEST_MESSAGE(message);
+    TEST_ASSERT_EQUAL_UINT32(0, analyzer->get_stats().frames_skipped);
+    TEST_ASSERT_TRUE(load_percent < config::signal_processing::spectrum::MAX_LOAD_PERCENT);
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_tone_lands_in_its_octave);
+    RUN_TEST(test_tone_lands_in_its_third_octave);
+    RUN_TEST(test_band_level_matches_calibration);
+    RUN_TEST(test_quiet_input_stays_below_tone);
+    RUN_TEST(test_boot_backlog_is_not_counted_as_skipped);
+    RUN_TEST(test_benchmark_ffts_per_second);
+    return UNITY_END();
+}
\ No newline at end of file
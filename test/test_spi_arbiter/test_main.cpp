@@ -0,0 +1,200 @@
+/**
+ * @brief SpiArbiter: std::thread SD holders keeping the bus busy against a
+ * display waiter, timeouts, and the wait and busy accounting.
+ */
+#include <unity.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include "components/spi_arbiter.hpp"
+
+namespace
+{
+    using Device = SpiArbiter::Device;
+    using Clock = std::chrono::steady_clock;
+
+    // Long enough that scheduling jitter stays well below one hold
+    constexpr uint32_t HOLD_MS = 20;
+    constexpr uint32_t SLACK_US = 15000;
+
+    void hold_bus(Device device, uint32_t hold_ms)
+    {
+        SpiArbiter::Lease lease(device);
+        std::this_thread::sleep_for(std::chrono::milliseconds(hold_ms));
+    }
+
+    uint64_t since_us(Clock::time_point start)
+    {
+        return std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count();
+    }
+
+    // Spins until the arbiter has counted a contended acquisition for the device
+    void wait_until_contended(Device device, uint32_t contended)
+    {
+        while (SpiArbiter::instance().get_stats(device).contended < contended)
+        {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void setUp()
+{
+    SpiArbiter::instance().reset_stats();
+}
+
+void tearDown() {}
+
+void test_uncontended_lease_is_accounted()
+{
+    SpiArbiter &arbiter = SpiArbiter::instance();
+    Clock::time_point start = Clock::now();
+    hold_bus(Device::SD, HOLD_MS);
+    uint64_t elapsed = since_us(start);
+
+    SpiArbiter::DeviceStats stats = arbiter.get_stats(Device::SD);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.acquisitions);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.contended);
+    TEST_ASSERT_EQUAL_UINT64(0, stats.wait_us);
+    TEST_ASSERT_TRUE(stats.busy_us >= HOLD_MS * 1000 && stats.busy_us <= elapsed);
+    TEST_ASSERT_EQUAL_UINT32(stats.busy_us, stats.max_hold_us);
+    TEST_ASSERT_TRUE(arbiter.get_utilisation_percent(Device::SD) >= 50);
+    TEST_ASSERT_EQUAL_UINT32(0, arbiter.get_stats(Device::DISPLAY).acquisitions);
+}
+
+void test_display_waits_at_most_one_hold()
+{
+    SpiArbiter &arbiter = SpiArbiter::instance();
+    std::atomic<bool> stop{false};
+    std::vector<std::thread> writers;
+    for (int i = 0; i < 3; i++)
+    {
+        // Back-to-back SD chunks from three writers: the bus is never free for long
+        writers.emplace_back([&stop]
+                             {
+                                 while (!stop)
+                                 {
+                                     hold_bus(Device::SD, HOLD_MS);
+                                 }
+                             });
+    }
+
+    constexpr int PUSHES = 20;
+    uint64_t longest_us = 0;
+    for (int i = 0; i < PUSHES; i++)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(HOLD_MS / 4 + i % 7));
+        Clock::time_point start = Clock::now();
+        SpiArbiter::Lease lease(Device::DISPLAY);
+        longest_us = std::max(longest_us, since_us(start));
+        TEST_ASSERT_TRUE(lease.is_held());
+    }
+    stop = true;
+    for (std::thread &writer : writers)
+    {
+        writer.join();
+    }
+
+    // Without the priority the display would queue behind up to three SD holds
+    SpiArbiter::DeviceStats display = arbiter.get_stats(Device::DISPLAY);
+    SpiArbiter::DeviceStats sd = arbiter.get_stats(Device::SD);
+    TEST_ASSERT_EQUAL_UINT32(PUSHES, display.acquisitions);
+    TEST_ASSERT_EQUAL_UINT32(0, display.timeouts);
+    TEST_ASSERT_TRUE(display.contended > 0);
+    TEST_ASSERT_TRUE(display.max_wait_us <= longest_us);
+    TEST_ASSERT_TRUE(longest_us <= HOLD_MS * 1000 + SLACK_US);
+    TEST_ASSERT_TRUE(sd.contended > 0);
+    TEST_ASSERT_TRUE(sd.max_hold_us >= HOLD_MS * 1000);
+    TEST_ASSERT_TRUE(sd.busy_us >= uint64_t(sd.acquisitions) * HOLD_MS * 1000);
+
+    char message[128];
+    snprintf(message, sizeof(message), "display: %u pushes, longest wait %llu us; SD: %u holds of %u ms",
+             static_cast<unsigned>(display.acquisitions), static_cast<unsigned long long>(longest_us),
+             static_cast<unsigned>(sd.acquisitions), static_cast<unsigned>(HOLD_MS));
+    TEST_MESSAGE(message);
+}
+
+void test_timeout_is_counted()
+{
+    SpiArbiter &arbiter = SpiArbiter::instance();
+    std::atomic<bool> held{false};
+    std::thread writer([&held]
+                       {
+                           SpiArbiter::Lease lease(Device::SD);
+                           held = true;
+                           std::this_thread::sleep_for(std::chrono::milliseconds(5 * HOLD_MS));
+                       });
+    while (!held)
+    {
+        std::this_thread::yield();
+    }
+
+    {
+        SpiArbiter::Lease lease(Device::DISPLAY, HOLD_MS);
+        TEST_ASSERT_FALSE(lease.is_held());
+    }
+    SpiArbiter::DeviceStats display = arbiter.get_stats(Device::DISPLAY);
+    TEST_ASSERT_EQUAL_UINT32(1, display.timeouts);
+    TEST_ASSERT_EQUAL_UINT32(1, display.contended);
+    TEST_ASSERT_EQUAL_UINT32(0, display.acquisitions);
+    TEST_ASSERT_EQUAL_UINT64(0, display.busy_us);
+    TEST_ASSERT_TRUE(display.wait_us >= HOLD_MS * 1000);
+    TEST_ASSERT_EQUAL_UINT32(display.wait_us, display.max_wait_us);
+    writer.join();
+
+    // The bus is free again for the next push
+    SpiArbiter::Lease lease(Device::DISPLAY, HOLD_MS);
+    TEST_ASSERT_TRUE(lease.is_held());
+}
+
+void test_sd_proceeds_after_display_times_out()
+{
+    SpiArbiter &arbiter = SpiArbiter::instance();
+    std::atomic<bool> held{false};
+    std::atomic<bool> release{false};
+    std::thread holder([&]
+                       {
+                           SpiArbiter::Lease lease(Device::SD);
+                           held = true;
+                           while (!release)
+                           {
+                               std::this_thread::yield();
+                           }
+                       });
+    while (!held)
+    {
+        std::this_thread::yield();
+    }
+
+    // A display push waiting on the bus, and an SD chunk queued behind it
+    std::atomic<bool> display_held{true};
+    std::thread display([&display_held] { display_held = SpiArbiter::Lease(Device::DISPLAY, HOLD_MS).is_held(); });
+    wait_until_contended(Device::DISPLAY, 1);
+    std::atomic<bool> sd_held{false};
+    std::thread sd([&sd_held] { sd_held = SpiArbiter::Lease(Device::SD, 50 * HOLD_MS).is_held(); });
+    wait_until_contended(Device::SD, 1);
+
+    // Only once the display has given up does the holder free the bus
+    display.join();
+    TEST_ASSERT_FALSE(display_held);
+    release = true;
+    holder.join();
+    sd.join();
+
+    TEST_ASSERT_TRUE(sd_held);
+    SpiArbiter::DeviceStats sd_stats = arbiter.get_stats(Device::SD);
+    TEST_ASSERT_EQUAL_UINT32(2, sd_stats.acquisitions);
+    TEST_ASSERT_EQUAL_UINT32(0, sd_stats.timeouts);
+    TEST_ASSERT_EQUAL_UINT32(1, arbiter.get_stats(Device::DISPLAY).timeouts);
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_uncontended_lease_is_accounted);
+    RUN_TEST(test_display_waits_at_most_one_hold);
+    RUN_TEST(test_timeout_is_counted);
+    RUN_TEST(test_sd_proceeds_after_display_times_out);
+    return UNITY_END();
+}
\ No newline at end of file
@@ -0,0 +1,205 @@
+/**
+ * @brief SpscRing: capacity and counters on one thread, then a producer and
+ * a consumer std::thread hammering the ring, with the throughput reported.
+ */
+#include <unity.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include "components/spsc_ring.hpp"
+
+namespace
+{
+    // Large enough that a torn copy would show up as a checksum mismatch
+    struct Item
+    {
+        uint32_t sequence;
+        uint32_t payload[7];
+        uint32_t checksum;
+
+        static Item make(uint32_t sequence)
+        {
+            Item item{sequence, {}, 0};
+            for (uint32_t i = 0; i < 7; i++)
+            {
+                item.payload[i] = sequence * 2654435761u + i;
+                item.checksum ^= item.payload[i];
+            }
+            return item;
+        }
+
+        bool is_intact() const
+        {
+            uint32_t sum = 0;
+            for (uint32_t word : payload)
+            {
+                sum ^= word;
+            }
+            return sum == checksum && payload[0] == sequence * 2654435761u;
+        }
+    };
+
+    struct StressResult
+    {
+        uint32_t attempted;
+        uint32_t accepted;
+        uint32_t received;
+        uint32_t out_of_order;
+        uint32_t corrupt;
+        double seconds;
+    };
+
+    /**
+     * The producer pushes numbered items as fast as it can, yielding and
+     * retrying a full ring if `retry` is set, dropping the item otherwise; the
+     * consumer checks every item it pops. `consumer_pause` makes it lag.
+     */
+    template <size_t CAPACITY>
+    StressResult run_stress(SpscRing<Item, CAPACITY> &ring, uint32_t items, uint32_t consumer_pause,
+                            bool retry)
+    {
+        StressResult result{};
+        std::atomic<bool> done{false};
+
+        auto start = std::chrono::steady_clock::now();
+        std::thread consumer([&]()
+                             {
+            Item item;
+            int64_t last = -1;
+            for (;;)
+            {
+                bool finished = done.load(std::memory_order_acquire);
+                if (!ring.pop(item))
+                {
+                    if (finished)
+                    {
+                        break;
+                    }
+                    std::this_thread::yield();
+                    continue;
+                }
+                result.received++;
+                result.out_of_order += int64_t(item.sequence) <= last;
+                result.corrupt += !item.is_intact();
+                last = item.sequence;
+                for (volatile uint32_t spin = 0; spin < consumer_pause; spin = spin + 1)
+                {
+                }
+            } });
+
+        std::thread producer([&]()
+                             {
+            for (uint32_t sequence = 0; sequence < items; sequence++)
+            {
+                Item item = Item::make(sequence);
+                result.attempted++;
+                while (!ring.push(item) && retry)
+                {
+                    result.attempted++;
+                    std::this_thread::yield();
+                }
+            }
+            result.accepted = ring.get_stats().pushed;
+            done.store(true, std::memory_order_release); });
+
+        producer.join();
+        consumer.join();
+        result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return result;
+    }
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_fills_to_capacity_and_counts_overflows()
+{
+    SpscRing<uint32_t, 8> ring;
+    for (uint32_t i = 0; i < 8; i++)
+    {
+        TEST_ASSERT_TRUE(ring.push(i));
+    }
+    TEST_ASSERT_FALSE(ring.push(8));
+    TEST_ASSERT_FALSE(ring.push(9));
+    TEST_ASSERT_EQUAL_size_t(8, ring.size());
+
+    auto stats = ring.get_stats();
+    TEST_ASSERT_EQUAL_UINT32(8, stats.pushed);
+    TEST_ASSERT_EQUAL_UINT32(2, stats.overflows);
+    TEST_ASSERT_EQUAL_UINT32(8, stats.high_water);
+
+    uint32_t value;
+    for (uint32_t i = 0; i < 8; i++)
+    {
+        TEST_ASSERT_TRUE(ring.pop(value));
+        TEST_ASSERT_EQUAL_UINT32(i, value);
+    }
+    TEST_ASSERT_FALSE(ring.pop(value));
+    TEST_ASSERT_EQUAL_UINT32(8, ring.get_stats().popped);
+}
+
+void test_wraps_around_many_times()
+{
+    SpscRing<uint32_t, 4> ring;
+    uint32_t value;
+    for (uint32_t i = 0; i < 1000; i++)
+    {
+        TEST_ASSERT_TRUE(ring.push(i));
+        TEST_ASSERT_TRUE(ring.push(i + 1));
+        TEST_ASSERT_TRUE(ring.pop(value));
+        TEST_ASSERT_EQUAL_UINT32(i, value);
+        TEST_ASSERT_TRUE(ring.pop(value));
+        TEST_ASSERT_EQUAL_UINT32(i + 1, value);
+    }
+    TEST_ASSERT_EQUAL_UINT32(2, ring.get_stats().high_water);
+    TEST_ASSERT_EQUAL_UINT32(0, ring.get_stats().overflows);
+}
+
+void test_threads_keeping_up()
+{
+    static SpscRing<Item, 1024> ring;
+    StressResult result = run_stress(ring, 2000000, 0, true);
+
+    // Every item arrives once, in order, intact; every full ring the producer met is counted
+    auto stats = ring.get_stats();
+    TEST_ASSERT_EQUAL_UINT32(0, result.out_of_order);
+    TEST_ASSERT_EQUAL_UINT32(0, result.corrupt);
+    TEST_ASSERT_EQUAL_UINT32(2000000, result.received);
+    TEST_ASSERT_EQUAL_UINT32(result.attempted, stats.pushed + stats.overflows);
+    TEST_ASSERT_EQUAL_UINT32(stats.pushed, stats.popped);
+
+    char message[128];
+    snprintf(message, sizeof(message), "%.1f M items/s through the ring, %u full-ring retries, high water %u of 1024",
+             result.received / result.seconds / 1e6, stats.overflows, stats.high_water);
+    TEST_MESSAGE(message);
+}
+
+void test_threads_with_slow_consumer()
+{
+    static SpscRing<Item, 64> ring;
+    StressResult result = run_stress(ring, 500000, 2000, false);
+
+    // Items are dropped, never reordered or torn, and every drop is counted
+    auto stats = ring.get_stats();
+    TEST_ASSERT_EQUAL_UINT32(0, result.out_of_order);
+    TEST_ASSERT_EQUAL_UINT32(0, result.corrupt);
+    TEST_ASSERT_EQUAL_UINT32(result.accepted, result.received);
+    TEST_ASSERT_EQUAL_UINT32(result.attempted - result.accepted, stats.overflows);
+    TEST_ASSERT_GREATER_THAN(0, stats.overflows);
+    TEST_ASSERT_EQUAL_UINT32(64, stats.high_water);
+
+    char message[128];
+    snprintf(message, sizeof(message), "Slow consumer: %u of %u items delivered, %u overflows",
+             result.received, result.attempted, stats.overflows);
+    TEST_MESSAGE(message);
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_fills_to_capacity_and_counts_overflows);
+    RUN_TEST(test_wraps_around_many_times);
+    RUN_TEST(test_threads_keeping_up);
+    RUN_TEST(test_threads_with_slow_consumer);
+    return UNITY_END();
+}
\ No newline at end of file
@@ -0,0 +1,222 @@
+/**
+ * @brief TaskScheduler on an injected clock: periods, priorities, the late
+ * policies, overruns and clock wrap, and an hour of the monitor's task set
+ * simulated faster than real time.
+ */
+#include <unity.h>
+#include <chrono>
+#include <limits.h>
+#include <vector>
+#include "components/task_scheduler.hpp"
+
+namespace
+{
+    unsigned long g_now = 0;
+
+    unsigned long fake_clock()
+    {
+        return g_now;
+    }
+
+    // Records which task ran and can stall the clock like a slow task would
+    struct Probe
+    {
+        std::vector<int> *log;
+        int id;
+        uint32_t runtime_ms;
+        uint32_t runs;
+    };
+
+    void probe_task(void *context)
+    {
+        Probe *probe = static_cast<Probe *>(context);
+        probe->runs++;
+        if (probe->log)
+        {
+            probe->log->push_back(probe->id);
+        }
+        g_now += probe->runtime_ms;
+    }
+
+    // One pass per millisecond up to and including `end`
+    void run_until(TaskScheduler &scheduler, unsigned long end)
+    {
+        for (;;)
+        {
+            scheduler.run_pending();
+            if (static_cast<long>(end - g_now) <= 0)
+            {
+                break;
+            }
+            g_now++;
+        }
+    }
+
+    TaskScheduler::TaskConfig make_config(uint32_t period_ms, uint8_t priority = 0, uint32_t budget_ms = 0,
+                                          TaskScheduler::Policy policy = TaskScheduler::Policy::SKIP)
+    {
+        return {"probe", period_ms, priority, budget_ms, policy};
+    }
+}
+
+void setUp()
+{
+    g_now = 1000;
+}
+
+void tearDown() {}
+
+void test_runs_once_per_period()
+{
+    TaskScheduler scheduler(fake_clock);
+    Probe fast{nullptr, 0, 0, 0};
+    Probe slow{nullptr, 1, 0, 0};
+    scheduler.add_task(make_config(10), probe_task, &fast);
+    TaskScheduler::TaskId id = scheduler.add_task(make_config(250), probe_task, &slow);
+
+    run_until(scheduler, g_now + 10000);
+    TEST_ASSERT_EQUAL_UINT32(1000, fast.runs);
+    TEST_ASSERT_EQUAL_UINT32(40, slow.runs);
+    TEST_ASSERT_EQUAL_UINT32(0, scheduler.get_stats(id).max_jitter_ms);
+    TEST_ASSERT_EQUAL_UINT32(0, scheduler.get_stats(id).missed_periods);
+}
+
+void test_higher_priority_runs_first()
+{
+    TaskScheduler scheduler(fake_clock);
+    std::vector<int> log;
+    Probe low{&log, 0, 0, 0};
+    Probe high{&log, 1, 0, 0};
+    Probe middle{&log, 2, 0, 0};
+    scheduler.add_task(make_config(100, 0), probe_task, &low);
+    scheduler.add_task(make_config(100, 5), probe_task, &high);
+    scheduler.add_task(make_config(100, 2), probe_task, &middle);
+
+    g_now += 100;
+    scheduler.run_pending();
+    TEST_ASSERT_EQUAL_size_t(3, log.size());
+    TEST_ASSERT_EQUAL_INT(1, log[0]);
+    TEST_ASSERT_EQUAL_INT(2, log[1]);
+    TEST_ASSERT_EQUAL_INT(0, log[2]);
+}
+
+void test_skip_drops_missed_periods_and_keeps_phase()
+{
+    TaskScheduler scheduler(fake_clock);
+    Probe periodic{nullptr, 0, 0, 0};
+    Probe stall{nullptr, 1, 350, 0};
+    TaskScheduler::TaskId id = scheduler.add_task(make_config(100, 0), probe_task, &periodic);
+    scheduler.add_task(make_config(1000, 1), probe_task, &stall);
+
+    // The stall 1000 ms in makes the periodic task 350 ms late: three periods are dropped
+    run_until(scheduler, g_now + 1000);
+    const TaskScheduler::TaskStats &stats = scheduler.get_stats(id);
+    TEST_ASSERT_EQUAL_UINT32(1, stall.runs);
+    TEST_ASSERT_EQUAL_UINT32(3, stats.missed_periods);
+    TEST_ASSERT_EQUAL_UINT32(350, stats.max_jitter_ms);
+    TEST_ASSERT_EQUAL_UINT32(10, stats.runs);
+
+    // Back on the original phase, 1400 ms after the start
+    TEST_ASSERT_EQUAL_UINT32(50, scheduler.time_until_next());
+}
+
+void test_catch_up_replays_one_period_per_pass()
+{
+    TaskScheduler scheduler(fake_clock);
+    Probe periodic{nullptr, 0, 0, 0};
+    TaskScheduler::TaskId id = scheduler.add_task(
+        make_config(100, 0, 0, TaskScheduler::Policy::CATCH_UP), probe_task, &periodic);
+
+    g_now += 450;
+    scheduler.run_pending();
+    TEST_ASSERT_EQUAL_UINT32(1, periodic.runs);
+    for (int pass = 0; pass < 10; pass++)
+    {
+        scheduler.run_pending();
+    }
+    TEST_ASSERT_EQUAL_UINT32(4, periodic.runs);
+    TEST_ASSERT_EQUAL_UINT32(0, scheduler.get_stats(id).missed_periods);
+    TEST_ASSERT_EQUAL_UINT32(50, scheduler.time_until_next());
+}
+
+void test_counts_overruns_against_budget()
+{
+    TaskScheduler scheduler(fake_clock);
+    Probe slow{nullptr, 0, 8, 0};
+    TaskScheduler::TaskId id = scheduler.add_task(make_config(100, 0, 5), probe_task, &slow);
+
+    run_until(scheduler, g_now + 1000);
+    const TaskScheduler::TaskStats &stats = scheduler.get_stats(id);
+    TEST_ASSERT_EQUAL_UINT32(stats.runs, stats.overruns);
+    TEST_ASSERT_EQUAL_UINT32(8, stats.max_runtime_ms);
+}
+
+void test_deadlines_survive_clock_wrap()
+{
+    g_now = ULONG_MAX - 500;
+    TaskScheduler scheduler(fake_clock);
+    Probe periodic{nullptr, 0, 0, 0};
+    TaskScheduler::TaskId id = scheduler.add_task(make_config(100), probe_task, &periodic);
+
+    run_until(scheduler, g_now + 2000);
+    TEST_ASSERT_EQUAL_UINT32(20, periodic.runs);
+    TEST_ASSERT_EQUAL_UINT32(0, scheduler.get_stats(id).max_jitter_ms);
+}
+
+void test_rejects_tasks_past_capacity()
+{
+    TaskScheduler scheduler(fake_clock);
+    Probe probe{nullptr, 0, 0, 0};
+    for (size_t i = 0; i < config::scheduler::MAX_TASKS; i++)
+    {
+        TEST_ASSERT_NOT_EQUAL(TaskScheduler::INVALID_TASK, scheduler.add_task(make_config(10), probe_task, &probe));
+    }
+    TEST_ASSERT_EQUAL(TaskScheduler::INVALID_TASK, scheduler.add_task(make_config(10), probe_task, &probe));
+    TEST_ASSERT_EQUAL(TaskScheduler::INVALID_TASK, scheduler.add_task(make_config(0), probe_task, &probe));
+}
+
+void test_benchmark_simulated_hour()
+{
+    // The periods the noise monitor registers, as stubs
+    TaskScheduler scheduler(fake_clock);
+    Probe probes[] = {{nullptr, 0, 0, 0}, {nullptr, 1, 0, 0}, {nullptr, 2, 0, 0}, {nullptr, 3, 0, 0},
+                      {nullptr, 4, 0, 0}, {nullptr, 5, 0, 0}, {nullptr, 6, 0, 0}};
+    const uint32_t periods[] = {config::timing::ALERT_INTERVAL, config::timing::LED_UPDATE_INTERVAL,
+                                config::timing::DISPLAY_INTERVAL, config::logging::RECORD_INTERVAL_MS,
+                                config::thingspeak::upload::SAMPLE_INTERVAL_MS, config::timing::WIFI_INTERVAL,
+                                config::timing::SPECTRUM_LOG_INTERVAL};
+    for (size_t i = 0; i < 7; i++)
+    {
+        scheduler.add_task(make_config(periods[i], static_cast<uint8_t>(7 - i)), probe_task, &probes[i]);
+    }
+
+    const unsigned long hour_ms = 3600000;
+    auto start = std::chrono::steady_clock::now();
+    run_until(scheduler, g_now + hour_ms);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    for (size_t i = 0; i < 7; i++)
+    {
+        TEST_ASSERT_EQUAL_UINT32(hour_ms / periods[i], probes[i].runs);
+        TEST_ASSERT_EQUAL_UINT32(0, scheduler.get_stats(static_cast<TaskScheduler::TaskId>(i)).max_jitter_ms);
+    }
+
+    char message[96];
+    snprintf(message, sizeof(message), "One hour of 1 ms passes in %.3f s (%.0fx real time)", seconds,
+             3600.0 / seconds);
+    TEST_MESSAGE(message);
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_runs_once_per_period);
+    RUN_TEST(test_higher_priority_runs_first);
+    RUN_TEST(test_skip_drops_missed_periods_and_keeps_phase);
+    RUN_TEST(test_catch_up_replays_one_period_per_pass);
+    RUN_TEST(test_counts_overruns_against_budget);
+    RUN_TEST(test_deadlines_survive_clock_wrap);
+    RUN_TEST(test_rejects_tasks_past_capacity);
+    RUN_TEST(test_benchmark_simulated_hour);
+    return UNITY_END();
+}
\ No newline at end of file
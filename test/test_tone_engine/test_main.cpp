@@ -0,0 +1,172 @@
+/**
+ * @brief ToneEngine step timing against a mock output on a fake clock, and
+ * the AlertManager's alert pattern on the virtual clock of the native build.
+ */
+#include <unity.h>
+#include <vector>
+#include "components/tone_engine.hpp"
+#include "components/alert_manager.hpp"
+#include "native/native_hal.hpp"
+
+namespace
+{
+    unsigned long g_now = 0;
+
+    unsigned long fake_clock()
+    {
+        return g_now;
+    }
+
+    struct ToneChange
+    {
+        unsigned long time;
+        uint16_t frequency_hz;
+    };
+
+    class MockToneOutput : public ToneOutput
+    {
+    public:
+        bool begin() override { return true; }
+        void set_tone(uint16_t frequency_hz) override { changes.push_back({g_now, frequency_hz}); }
+
+        std::vector<ToneChange> changes;
+    };
+
+    constexpr ToneStep STEPS[] = {{1000, 100}, {0, 50}, {2000, 30}};
+    constexpr TonePattern PATTERN = make_tone_pattern(STEPS, 2);
+
+    void run_engine(ToneEngine &engine, unsigned long end, uint32_t step_ms)
+    {
+        while (g_now < end)
+        {
+            g_now += step_ms;
+            engine.update();
+        }
+    }
+}
+
+void setUp()
+{
+    g_now = 5000;
+}
+
+void tearDown() {}
+
+void test_steps_switch_on_their_boundaries()
+{
+    MockToneOutput output;
+    ToneEngine engine(output, fake_clock);
+    engine.play(PATTERN);
+    run_engine(engine, g_now + 1000, 1);
+
+    // Two repeats of three steps, then silence when the pattern ends
+    const ToneChange expected[] = {{5000, 1000}, {5100, 0}, {5150, 2000}, {5180, 1000},
+                                   {5280, 0}, {5330, 2000}, {5360, 0}};
+    TEST_ASSERT_EQUAL_size_t(7, output.changes.size());
+    for (size_t i = 0; i < 7; i++)
+    {
+        TEST_ASSERT_EQUAL_UINT32(expected[i].time, output.changes[i].time);
+        TEST_ASSERT_EQUAL_UINT16(expected[i].frequency_hz, output.changes[i].frequency_hz);
+    }
+    TEST_ASSERT_FALSE(engine.is_playing());
+}
+
+void test_late_updates_do_not_stretch_the_pattern()
+{
+    MockToneOutput output;
+    ToneEngine engine(output, fake_clock);
+    engine.play(PATTERN);
+
+    // Coarse updates come late, but the pattern still ends 360 ms after it started
+    run_engine(engine, g_now + 1000, 45);
+    TEST_ASSERT_FALSE(engine.is_playing());
+    unsigned long end = output.changes.back().time;
+    TEST_ASSERT_EQUAL_UINT16(0, output.changes.back().frequency_hz);
+    TEST_ASSERT_TRUE(end >= 5360 && end < 5360 + 45);
+
+    // The 30 ms step, shorter than the update period, is skipped rather than delaying the next
+    size_t short_steps = 0;
+    for (const ToneChange &change : output.changes)
+    {
+        short_steps += change.frequency_hz == 2000;
+    }
+    TEST_ASSERT_TRUE(short_steps < 2);
+}
+
+void test_stop_and_replace()
+{
+    MockToneOutput output;
+    ToneEngine engine(output, fake_clock);
+    engine.play(PATTERN);
+    g_now += 20;
+    engine.play(PATTERN);
+    TEST_ASSERT_TRUE(engine.is_playing());
+
+    // The replacement restarts the timing
+    g_now += 99;
+    engine.update();
+    TEST_ASSERT_EQUAL_UINT16(1000, output.changes.back().frequency_hz);
+    g_now += 1;
+    engine.update();
+    TEST_ASSERT_EQUAL_UINT16(0, output.changes.back().frequency_hz);
+
+    engine.stop();
+    TEST_ASSERT_FALSE(engine.is_playing());
+    size_t count = output.changes.size();
+    run_engine(engine, g_now + 500, 1);
+    TEST_ASSERT_EQUAL_size_t(count, output.changes.size());
+}
+
+void test_empty_pattern_silences()
+{
+    MockToneOutput output;
+    ToneEngine engine(output, fake_clock);
+    constexpr TonePattern silent = make_tone_pattern(STEPS, 0);
+    engine.play(silent);
+    TEST_ASSERT_FALSE(engine.is_playing());
+    TEST_ASSERT_EQUAL_size_t(1, output.changes.size());
+    TEST_ASSERT_EQUAL_UINT16(0, output.changes[0].frequency_hz);
+}
+
+void test_alert_sounds_after_sustained_elevation()
+{
+    AlertManager alerts;
+    alerts.begin();
+    SignalFrame frame;
+    frame.category = SignalProcessor::NoiseLevel::ELEVATED;
+
+    // Alert state machine at its scheduler period, on the native virtual clock
+    const uint32_t step_ms = config::timing::ALERT_INTERVAL;
+    uint32_t elapsed_ms = 0;
+    while (!alerts.is_sounding() && elapsed_ms < 2 * config::alert::ELEVATED_THRESHOLD_MS)
+    {
+        native_hal::advance_us(step_ms * 1000);
+        elapsed_ms += step_ms;
+        alerts.update(frame);
+    }
+    TEST_ASSERT_TRUE(alerts.is_sounding());
+    TEST_ASSERT_INT_WITHIN(step_ms, config::alert::ELEVATED_THRESHOLD_MS + step_ms, elapsed_ms);
+
+    // The pattern plays ALERT_BEEPS beeps and gaps, then falls silent again
+    frame.category = SignalProcessor::NoiseLevel::OK;
+    const uint32_t pattern_ms = config::alert::ALERT_BEEPS * (config::alert::BEEP_TONE_MS + config::alert::BEEP_GAP_MS);
+    uint32_t sounding_ms = 0;
+    while (alerts.is_sounding() && sounding_ms < 2 * pattern_ms)
+    {
+        native_hal::advance_us(step_ms * 1000);
+        sounding_ms += step_ms;
+        alerts.update(frame);
+    }
+    TEST_ASSERT_EQUAL_UINT32(pattern_ms, sounding_ms);
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_steps_switch_on_their_boundaries);
+    RUN_TEST(test_late_updates_do_not_stretch_the_pattern);
+    RUN_TEST(test_stop_and_replace);
+    RUN_TEST(test_empty_pattern_silences);
+    RUN_TEST(test_alert_sounds_after_sustained_elevation);
+    return UNITY_END();
+}
\ No newline at end of file
@@ -0,0 +1,153 @@
+/**
+ * @brief UploadClient against the simulated server of the native build: the
+ * handshake and keep-alive counters, stale connection retries and failures.
+ */
+#include <unity.h>
+#include "components/upload_client.hpp"
+#include "native/native_hal.hpp"
+
+namespace
+{
+    constexpr uint32_t HANDSHAKE_MS = 350;
+
+    UploadRecord make_record(uint32_t created_at)
+    {
+        UploadRecord record;
+        record.created_at = created_at;
+        record.num_fields = 3;
+        record.fields[0] = 812.0f;
+        return record;
+    }
+
+    int post_one(UploadClient &client, uint32_t created_at)
+    {
+        UploadRecord record = make_record(created_at);
+        return client.post_batch(&record, 1);
+    }
+}
+
+void setUp()
+{
+    native_hal::set_server_reachable(true);
+    native_hal::set_handshake_ms(HANDSHAKE_MS);
+    native_hal::set_http_status(HTTP_CODE_OK);
+}
+
+void tearDown()
+{
+    native_hal::set_server_reachable(false);
+}
+
+void test_handshakes_once_and_reuses_the_connection()
+{
+    UploadClient client;
+    TEST_ASSERT_TRUE(client.begin("123456", "KEY"));
+
+    for (uint32_t i = 0; i < 10; i++)
+    {
+        TEST_ASSERT_EQUAL_INT(HTTP_CODE_OK, post_one(client, 1704067200 + i));
+    }
+
+    const UploadClient::ConnectionStats &stats = client.get_stats();
+    TEST_ASSERT_EQUAL_UINT32(10, stats.requests);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.handshakes);
+    TEST_ASSERT_EQUAL_UINT32(9, stats.reused);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.stale_retries);
+    TEST_ASSERT_EQUAL_UINT32(HANDSHAKE_MS, stats.last_connect_ms);
+    TEST_ASSERT_EQUAL_UINT32(HANDSHAKE_MS, stats.max_connect_ms);
+}
+
+void test_stale_connection_retries_on_a_fresh_one()
+{
+    UploadClient client;
+    client.begin("123456", "KEY");
+    post_one(client, 1);
+
+    // The server closed the idle connection; the request still goes through, once more
+    native_hal::set_handshake_ms(2 * HANDSHAKE_MS);
+    native_hal::drop_server_connections();
+    TEST_ASSERT_EQUAL_INT(HTTP_CODE_OK, post_one(client, 2));
+
+    const UploadClient::ConnectionStats &stats = client.get_stats();
+    TEST_ASSERT_EQUAL_UINT32(3, stats.requests);
+    TEST_ASSERT_EQUAL_UINT32(2, stats.handshakes);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.reused);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.stale_retries);
+    TEST_ASSERT_EQUAL_UINT32(2 * HANDSHAKE_MS, stats.last_connect_ms);
+    TEST_ASSERT_EQUAL_UINT32(2 * HANDSHAKE_MS, stats.max_connect_ms);
+
+    // And the new connection is kept alive in turn
+    post_one(client, 3);
+    TEST_ASSERT_EQUAL_UINT32(2, stats.handshakes);
+    TEST_ASSERT_EQUAL_UINT32(2, stats.reused);
+}
+
+void test_http_error_keeps_the_connection()
+{
+    UploadClient client;
+    client.begin("123456", "KEY");
+
+    // The server answered, so the connection is still good for the retry
+    native_hal::set_http_status(503);
+    TEST_ASSERT_EQUAL_INT(503, post_one(client, 1));
+    native_hal::set_http_status(HTTP_CODE_OK);
+    TEST_ASSERT_EQUAL_INT(HTTP_CODE_OK, post_one(client, 1));
+
+    TEST_ASSERT_EQUAL_UINT32(1, client.get_stats().handshakes);
+    TEST_ASSERT_EQUAL_UINT32(1, client.get_stats().reused);
+}
+
+void test_unreachable_server_fails_without_a_handshake()
+{
+    UploadClient client;
+    client.begin("123456", "KEY");
+    native_hal::set_server_reachable(false);
+
+    TEST_ASSERT_EQUAL_INT(HTTPC_ERROR_CONNECTION_REFUSED, post_one(client, 1));
+    const UploadClient::ConnectionStats &stats = client.get_stats();
+    TEST_ASSERT_EQUAL_UINT32(0, stats.requests);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.handshakes);
+
+    // A stale connection that cannot be replaced fails once, after the one retry
+    native_hal::set_server_reachable(true);
+    post_one(client, 2);
+    native_hal::drop_server_connections();
+    native_hal::set_server_reachable(false);
+    TEST_ASSERT_EQUAL_INT(HTTPC_ERROR_CONNECTION_REFUSED, post_one(client, 3));
+    TEST_ASSERT_EQUAL_UINT32(2, stats.requests);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.handshakes);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.stale_retries);
+}
+
+void test_oversized_batch_is_rejected_before_connecting()
+{
+    UploadClient client;
+    client.begin("123456", "KEY");
+
+    static UploadRecord records[config::thingspeak::upload::BULK_LIMIT];
+    for (UploadRecord &record : records)
+    {
+        record = make_record(1704067200);
+        record.num_fields = config::thingspeak::MAX_FIELDS;
+    }
+    TEST_ASSERT_EQUAL_INT(HTTP_CODE_PAYLOAD_TOO_LARGE, client.post_batch(records, config::thingspeak::upload::BULK_LIMIT));
+    TEST_ASSERT_EQUAL_UINT32(0, client.get_stats().handshakes);
+}
+
+void test_long_path_is_rejected()
+{
+    UploadClient client;
+    TEST_ASSERT_FALSE(client.begin("12345678901234567890123456789012345678901234567890", "KEY"));
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_handshakes_once_and_reuses_the_connection);
+    RUN_TEST(test_stale_connection_retries_on_a_fresh_one);
+    RUN_TEST(test_http_error_keeps_the_connection);
+    RUN_TEST(test_unreachable_server_fails_without_a_handshake);
+    RUN_TEST(test_oversized_batch_is_rejected_before_connecting);
+    RUN_TEST(test_long_path_is_rejected);
+    return UNITY_END();
+}
\ No newline at end of file
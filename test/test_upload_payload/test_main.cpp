@@ -0,0 +1,274 @@
+/**
+ * @brief ThingSpeak bulk_update bodies and paths: the exact bytes, escaping,
+ * values JSON cannot carry, buffers that are too small, and the time and heap
+ * a full request costs.
+ */
+#include <unity.h>
+#include <chrono>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <new>
+#include <string>
+#include <vector>
+#include "components/upload_payload.hpp"
+
+namespace
+{
+    uint64_t g_allocations = 0;
+    uint64_t g_allocated_bytes = 0;
+
+    UploadRecord make_record(uint32_t created_at, float noise, float baseline, float category)
+    {
+        UploadRecord record;
+        record.created_at = created_at;
+        record.num_fields = 3;
+        record.fields[0] = noise;
+        record.fields[1] = baseline;
+        record.fields[2] = category;
+        record.integer_fields = 1 << 2;
+        return record;
+    }
+
+    /*
+     * Baseline for the benchmark: the shape of the path upload_payload replaced.
+     * ArduinoJson is no longer a dependency, so this models it with the standard
+     * library: a heap-backed document with a copied key and value per member,
+     * serialised into a heap string, and the URL concatenated per request. Pool
+     * sizes and number formatting differ from ArduinoJson's.
+     */
+    struct BaselineMember
+    {
+        std::string key;
+        std::string text;
+        double number;
+    };
+
+    std::string build_baseline_request(const UploadRecord *records, size_t count, const char *write_api_key,
+                                       std::string &url)
+    {
+        url = std::string(config::thingspeak::ENDPOINT) + "/channels/" +
+              std::string(config::thingspeak::NOISE_CHANNEL_ID) + "/bulk_update.json";
+
+        std::vector<std::vector<BaselineMember>> updates;
+        for (size_t i = 0; i < count; i++)
+        {
+            std::vector<BaselineMember> update;
+            time_t created_at = records[i].created_at;
+            struct tm timeinfo;
+            localtime_r(&created_at, &timeinfo);
+            char timestamp[30];
+            strftime(timestamp, sizeof(timestamp), "%Y-%m-%d %H:%M:%S", &timeinfo);
+            update.push_back({"created_at", timestamp, 0});
+            for (uint8_t f = 0; f < records[i].num_fields; f++)
+            {
+                char key[12];
+                snprintf(key, sizeof(key), "field%u", f + 1);
+                update.push_back({key, "", records[i].fields[f]});
+            }
+            updates.push_back(std::move(update));
+        }
+
+        std::string body = std::string("{\"write_api_key\":\"") + write_api_key + "\",\"updates\":[";
+        for (size_t i = 0; i < updates.size(); i++)
+        {
+            body += i ? ",{" : "{";
+            for (size_t m = 0; m < updates[i].size(); m++)
+            {
+                const BaselineMember &member = updates[i][m];
+                char number[32];
+                snprintf(number, sizeof(number), "%.9g", member.number);
+                body += (m ? ",\"" : "\"") + member.key + "\":";
+                body += member.text.empty() ? std::string(number) : "\"" + member.text + "\"";
+            }
+            body += "}";
+        }
+        body += "]}";
+        return body;
+    }
+}
+
+// Counts every heap allocation made through new in the test binary
+void *operator new(size_t size)
+{
+    g_allocations++;
+    g_allocated_bytes += size;
+    if (void *memory = malloc(size))
+    {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *memory) noexcept
+{
+    free(memory);
+}
+
+void operator delete(void *memory, size_t) noexcept
+{
+    free(memory);
+}
+
+void setUp()
+{
+    // created_at is local time; pin the zone so the expected text holds anywhere
+    setenv("TZ", "UTC0", 1);
+    tzset();
+}
+
+void tearDown() {}
+
+void test_builds_bulk_update_body()
+{
+    UploadRecord records[] = {make_record(1704067200, 812.25f, 790.5f, 1.0f),
+                              make_record(1704067205, 1024.0f, 791.0f, 2.0f)};
+    char buffer[512];
+    size_t length = upload_payload::build_bulk_update(records, 2, "KEY123", buffer, sizeof(buffer));
+
+    const char *expected =
+        "{\"write_api_key\":\"KEY123\",\"updates\":["
+        "{\"created_at\":\"2024-01-01 00:00:00\",\"field1\":812.25,\"field2\":790.50,\"field3\":1},"
+        "{\"created_at\":\"2024-01-01 00:00:05\",\"field1\":1024.00,\"field2\":791.00,\"field3\":2}]}";
+    TEST_ASSERT_EQUAL_STRING(expected, buffer);
+    TEST_ASSERT_EQUAL_size_t(strlen(expected), length);
+}
+
+void test_empty_batch_has_empty_updates()
+{
+    char buffer[128];
+    size_t length = upload_payload::build_bulk_update(nullptr, 0, "KEY", buffer, sizeof(buffer));
+    TEST_ASSERT_EQUAL_STRING("{\"write_api_key\":\"KEY\",\"updates\":[]}", buffer);
+    TEST_ASSERT_EQUAL_size_t(strlen(buffer), length);
+}
+
+void test_escapes_key_and_writes_null_for_non_finite()
+{
+    UploadRecord record = make_record(0, NAN, INFINITY, -INFINITY);
+    char buffer[256];
+    upload_payload::build_bulk_update(&record, 1, "a\"b\\c\n", buffer, sizeof(buffer));
+    TEST_ASSERT_EQUAL_STRING("{\"write_api_key\":\"a\\\"b\\\\c\",\"updates\":["
+                             "{\"created_at\":\"1970-01-01 00:00:00\",\"field1\":null,\"field2\":null,\"field3\":null}]}",
+                             buffer);
+}
+
+void test_too_small_buffer_returns_zero()
+{
+    UploadRecord record = make_record(1704067200, 1.0f, 2.0f, 3.0f);
+    char full[256];
+    size_t length = upload_payload::build_bulk_update(&record, 1, "KEY", full, sizeof(full));
+    TEST_ASSERT_GREATER_THAN(0, length);
+
+    // Every size short of the body plus its terminator fails cleanly
+    char buffer[256];
+    for (size_t size = 1; size <= length; size++)
+    {
+        memset(buffer, 'x', sizeof(buffer));
+        TEST_ASSERT_EQUAL_size_t(0, upload_payload::build_bulk_update(&record, 1, "KEY", buffer, size));
+        TEST_ASSERT_EQUAL('x', buffer[size]);
+    }
+    TEST_ASSERT_EQUAL_size_t(length, upload_payload::build_bulk_update(&record, 1, "KEY", buffer, length + 1));
+    TEST_ASSERT_EQUAL_size_t(0, upload_payload::build_bulk_update(&record, 1, "KEY", buffer, 0));
+}
+
+void test_full_backlog_batch_fits_payload_buffer()
+{
+    // The largest request the worker sends: a replayed batch of the monitor's records at full scale
+    UploadRecord records[config::thingspeak::upload::BACKLOG_BATCH];
+    for (UploadRecord &record : records)
+    {
+        record = make_record(1704067200, 4095.0f, 4095.0f, 3.0f);
+    }
+    static char buffer[config::thingspeak::upload::PAYLOAD_BUFFER_SIZE];
+    size_t length = upload_payload::build_bulk_update(records, config::thingspeak::upload::BACKLOG_BATCH,
+                                                      config::thingspeak::NOISE_API_KEY, buffer, sizeof(buffer));
+    TEST_ASSERT_GREATER_THAN(0, length);
+}
+
+void test_integer_fields_are_rounded()
+{
+    UploadRecord record = make_record(0, 2.5f, -0.5f, 2.6f);
+    record.integer_fields = 0x07;
+    char buffer[256];
+    upload_payload::build_bulk_update(&record, 1, "KEY", buffer, sizeof(buffer));
+    TEST_ASSERT_NOT_NULL(strstr(buffer, "\"field1\":3,\"field2\":-1,\"field3\":3}"));
+}
+
+void test_builds_path()
+{
+    char buffer[64];
+    size_t length = upload_payload::build_bulk_update_path("123456", buffer, sizeof(buffer));
+    TEST_ASSERT_EQUAL_STRING("/channels/123456/bulk_update.json", buffer);
+    TEST_ASSERT_EQUAL_size_t(strlen(buffer), length);
+    TEST_ASSERT_EQUAL_size_t(0, upload_payload::build_bulk_update_path("123456", buffer, 10));
+}
+
+void test_benchmark_full_backlog_batch()
+{
+    UploadRecord records[config::thingspeak::upload::BACKLOG_BATCH];
+    for (size_t i = 0; i < config::thingspeak::upload::BACKLOG_BATCH; i++)
+    {
+        records[i] = make_record(1704067200 + 5 * i, 812.25f + i, 790.5f, 1.0f);
+    }
+    static char buffer[config::thingspeak::upload::PAYLOAD_BUFFER_SIZE];
+    const int runs = 2000;
+
+    size_t length = 0;
+    uint64_t allocations_before = g_allocations;
+    uint64_t bytes_before = g_allocated_bytes;
+    auto start = std::chrono::steady_clock::now();
+    for (int run = 0; run < runs; run++)
+    {
+        length = upload_payload::build_bulk_update(records, config::thingspeak::upload::BACKLOG_BATCH,
+                                                   config::thingspeak::NOISE_API_KEY, buffer, sizeof(buffer));
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    uint64_t allocations = g_allocations - allocations_before;
+    uint64_t bytes = g_allocated_bytes - bytes_before;
+
+    size_t baseline_length = 0;
+    allocations_before = g_allocations;
+    bytes_before = g_allocated_bytes;
+    start = std::chrono::steady_clock::now();
+    for (int run = 0; run < runs; run++)
+    {
+        std::string url;
+        baseline_length = build_baseline_request(records, config::thingspeak::upload::BACKLOG_BATCH,
+                                                 config::thingspeak::NOISE_API_KEY, url)
+                              .size();
+    }
+    double baseline_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    uint64_t baseline_allocations = (g_allocations - allocations_before) / runs;
+    uint64_t baseline_bytes = (g_allocated_bytes - bytes_before) / runs;
+
+    // Built straight into the request buffer
+    TEST_ASSERT_GREATER_THAN(0, length);
+    TEST_ASSERT_EQUAL_UINT64(0, allocations);
+    TEST_ASSERT_EQUAL_UINT64(0, bytes);
+    TEST_ASSERT_GREATER_THAN(0, baseline_allocations);
+
+    char message[160];
+    snprintf(message, sizeof(message), "upload_payload: %zu-byte body for %zu records in %.1f us, %llu bytes allocated",
+             length, config::thingspeak::upload::BACKLOG_BATCH, seconds / runs * 1e6,
+             static_cast<unsigned long long>(bytes));
+    TEST_MESSAGE(message);
+    snprintf(message, sizeof(message), "baseline: %zu-byte body in %.1f us, %llu allocations, %llu bytes allocated",
+             baseline_length, baseline_seconds / runs * 1e6, static_cast<unsigned long long>(baseline_allocations),
+             static_cast<unsigned long long>(baseline_bytes));
+    TEST_MESSAGE(message);
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_builds_bulk_update_body);
+    RUN_TEST(test_empty_batch_has_empty_updates);
+    RUN_TEST(test_escapes_key_and_writes_null_for_non_finite);
+    RUN_TEST(test_too_small_buffer_returns_zero);
+    RUN_TEST(test_full_backlog_batch_fits_payload_buffer);
+    RUN_TEST(test_integer_fields_are_rounded);
+    RUN_TEST(test_builds_path);
+    RUN_TEST(test_benchmark_full_backlog_batch);
+    return UNITY_END();
+}
\ No newline at end of file
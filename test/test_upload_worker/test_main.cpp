@@ -0,0 +1,255 @@
+/**
+ * @brief UploadWorker driven by a stub transport on a fake clock: batching,
+ * request spacing, backoff and give-up rules, and the counters with the
+ * producer and the worker on separate threads.
+ */
+#include <unity.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "components/upload_worker.hpp"
+
+namespace
+{
+    namespace upload = config::thingspeak::upload;
+
+    std::atomic<unsigned long> g_now{0};
+
+    unsigned long fake_clock()
+    {
+        return g_now.load(std::memory_order_relaxed);
+    }
+
+    struct Request
+    {
+        unsigned long time;
+        size_t count;
+        uint32_t first_created_at;
+    };
+
+    // Answers with scripted statuses, then 200, and records every request
+    struct StubTransport
+    {
+        std::vector<int> statuses;
+        size_t next{0};
+        std::vector<Request> requests;
+
+        static int send(void *context, const UploadRecord *records, size_t count)
+        {
+            StubTransport *stub = static_cast<StubTransport *>(context);
+            stub->requests.push_back({fake_clock(), count, records[0].created_at});
+            return stub->next < stub->statuses.size() ? stub->statuses[stub->next++] : 200;
+        }
+    };
+
+    UploadRecord make_record(uint32_t created_at)
+    {
+        UploadRecord record;
+        record.created_at = created_at;
+        record.num_fields = 3;
+        record.fields[0] = 1.0f;
+        return record;
+    }
+
+    // Poll like the worker task: sleep for what poll() asks, capped so enqueues interleave
+    void run_worker(UploadWorker &worker, unsigned long end)
+    {
+        while (g_now < end)
+        {
+            uint32_t wait = worker.poll();
+            g_now += wait == 0 ? 1 : std::min<uint32_t>(wait, static_cast<uint32_t>(end - g_now));
+        }
+    }
+}
+
+void setUp()
+{
+    g_now = 100000;
+}
+
+void tearDown() {}
+
+void test_collects_until_flush_interval()
+{
+    StubTransport stub;
+    UploadWorker worker(StubTransport::send, &stub, fake_clock, 1);
+
+    // One point per sample interval; the first waits a whole flush interval
+    for (uint32_t i = 0; i < upload::FLUSH_INTERVAL_MS / upload::SAMPLE_INTERVAL_MS; i++)
+    {
+        TEST_ASSERT_TRUE(worker.enqueue(make_record(i)));
+        run_worker(worker, g_now + upload::SAMPLE_INTERVAL_MS);
+        TEST_ASSERT_EQUAL_size_t(0, stub.requests.size());
+        TEST_ASSERT_TRUE(worker.get_state() == UploadWorker::State::COLLECTING);
+    }
+    run_worker(worker, g_now + 1);
+
+    TEST_ASSERT_EQUAL_size_t(1, stub.requests.size());
+    TEST_ASSERT_EQUAL_size_t(6, stub.requests[0].count);
+    UploadWorker::Stats stats = worker.get_stats();
+    TEST_ASSERT_EQUAL_UINT32(6, stats.enqueued);
+    TEST_ASSERT_EQUAL_UINT32(6, stats.records_sent);
+    TEST_ASSERT_EQUAL_UINT32(upload::FLUSH_INTERVAL_MS, stats.max_latency_ms);
+    TEST_ASSERT_EQUAL_UINT32(UploadWorker::WAIT_FOREVER, worker.poll());
+}
+
+void test_full_batches_keep_request_spacing()
+{
+    StubTransport stub;
+    UploadWorker worker(StubTransport::send, &stub, fake_clock, 1);
+    for (uint32_t i = 0; i < 2 * upload::MAX_BATCH; i++)
+    {
+        worker.enqueue(make_record(i));
+    }
+    run_worker(worker, g_now + 60000);
+
+    // A full batch goes out at once, the next one a minimum request interval later
+    TEST_ASSERT_EQUAL_size_t(2, stub.requests.size());
+    TEST_ASSERT_EQUAL_size_t(upload::MAX_BATCH, stub.requests[0].count);
+    TEST_ASSERT_EQUAL_UINT32(100000, stub.requests[0].time);
+    TEST_ASSERT_EQUAL_UINT32(upload::MIN_REQUEST_INTERVAL_MS, stub.requests[1].time - stub.requests[0].time);
+    TEST_ASSERT_EQUAL_UINT32(upload::MAX_BATCH, stub.requests[1].first_created_at);
+}
+
+void test_transient_errors_back_off_exponentially()
+{
+    StubTransport stub;
+    stub.statuses = {-1, 503, -1, 408};
+    UploadWorker worker(StubTransport::send, &stub, fake_clock, 1234);
+    for (uint32_t i = 0; i < upload::MAX_BATCH; i++)
+    {
+        worker.enqueue(make_record(i));
+    }
+    run_worker(worker, g_now + 600000);
+
+    // Attempt n waits between half and all of RETRY_BASE_MS * 2^(n-1)
+    TEST_ASSERT_EQUAL_size_t(5, stub.requests.size());
+    for (size_t n = 1; n < stub.requests.size(); n++)
+    {
+        uint32_t nominal = upload::RETRY_BASE_MS << (n - 1);
+        uint32_t delay = stub.requests[n].time - stub.requests[n - 1].time;
+        TEST_ASSERT_TRUE(delay >= nominal / 2 && delay <= nominal);
+    }
+
+    UploadWorker::Stats stats = worker.get_stats();
+    TEST_ASSERT_EQUAL_UINT32(4, stats.failed_attempts);
+    TEST_ASSERT_EQUAL_UINT32(upload::MAX_BATCH, stats.records_sent);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.dropped_failed);
+}
+
+void test_gives_up_after_max_attempts()
+{
+    StubTransport stub;
+    stub.statuses.assign(upload::MAX_ATTEMPTS, 500);
+    UploadWorker worker(StubTransport::send, &stub, fake_clock, 1);
+    worker.enqueue(make_record(1));
+    run_worker(worker, g_now + 3600000);
+
+    UploadWorker::Stats stats = worker.get_stats();
+    TEST_ASSERT_EQUAL_size_t(upload::MAX_ATTEMPTS, stub.requests.size());
+    TEST_ASSERT_EQUAL_UINT32(1, stats.dropped_failed);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.records_sent);
+    TEST_ASSERT_EQUAL_size_t(0, worker.get_queue_depth());
+}
+
+void test_rate_limit_waits_and_does_not_count_as_failure()
+{
+    StubTransport stub;
+    stub.statuses = {429, 429};
+    UploadWorker worker(StubTransport::send, &stub, fake_clock, 1);
+    worker.enqueue(make_record(1));
+    run_worker(worker, g_now + 3600000);
+
+    TEST_ASSERT_EQUAL_size_t(3, stub.requests.size());
+    TEST_ASSERT_TRUE(stub.requests[1].time - stub.requests[0].time >= upload::RATE_LIMIT_BACKOFF_MS);
+    TEST_ASSERT_TRUE(stub.requests[2].time - stub.requests[1].time >= upload::RATE_LIMIT_BACKOFF_MS);
+    UploadWorker::Stats stats = worker.get_stats();
+    TEST_ASSERT_EQUAL_UINT32(2, stats.rate_limited);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.failed_attempts);
+    TEST_ASSERT_EQUAL_UINT32(1, stats.records_sent);
+}
+
+void test_permanent_error_drops_batch()
+{
+    StubTransport stub;
+    stub.statuses = {400};
+    UploadWorker worker(StubTransport::send, &stub, fake_clock, 1);
+    for (uint32_t i = 0; i < upload::MAX_BATCH; i++)
+    {
+        worker.enqueue(make_record(i));
+    }
+    run_worker(worker, g_now + 3600000);
+
+    TEST_ASSERT_EQUAL_size_t(1, stub.requests.size());
+    TEST_ASSERT_EQUAL_UINT32(upload::MAX_BATCH, worker.get_stats().dropped_failed);
+}
+
+void test_full_queue_rejects_and_counts()
+{
+    StubTransport stub;
+    UploadWorker worker(StubTransport::send, &stub, fake_clock, 1);
+    for (uint32_t i = 0; i < upload::QUEUE_SIZE + 6; i++)
+    {
+        TEST_ASSERT_EQUAL(i < upload::QUEUE_SIZE, worker.enqueue(make_record(i)));
+    }
+    UploadWorker::Stats stats = worker.get_stats();
+    TEST_ASSERT_EQUAL_UINT32(upload::QUEUE_SIZE, stats.enqueued);
+    TEST_ASSERT_EQUAL_UINT32(6, stats.dropped_full);
+}
+
+// enqueue() on one thread and poll() on another, as on the device
+void test_counters_consistent_across_threads()
+{
+    StubTransport stub;
+    UploadWorker worker(StubTransport::send, &stub, fake_clock, 1);
+    const uint32_t produced = 20000;
+    std::atomic<bool> done{false};
+
+    std::thread producer([&]()
+                         {
+        for (uint32_t i = 0; i < produced; i++)
+        {
+            worker.enqueue(make_record(i));
+            if (i % 16 == 0)
+            {
+                std::this_thread::yield();
+            }
+        }
+        done = true; });
+
+    std::thread consumer([&]()
+                         {
+        // Every poll moves the clock past the request spacing
+        while (!done || worker.get_queue_depth() > 0)
+        {
+            g_now += upload::MIN_REQUEST_INTERVAL_MS;
+            worker.poll();
+            std::this_thread::yield();
+        } });
+
+    producer.join();
+    consumer.join();
+
+    UploadWorker::Stats stats = worker.get_stats();
+    TEST_ASSERT_EQUAL_UINT32(produced, stats.enqueued + stats.dropped_full);
+    TEST_ASSERT_EQUAL_UINT32(stats.enqueued, stats.records_sent);
+
+    char message[96];
+    snprintf(message, sizeof(message), "%u enqueued, %u dropped, %u batches", stats.enqueued,
+             stats.dropped_full, stats.batches_sent);
+    TEST_MESSAGE(message);
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_collects_until_flush_interval);
+    RUN_TEST(test_full_batches_keep_request_spacing);
+    RUN_TEST(test_transient_errors_back_off_exponentially);
+    RUN_TEST(test_gives_up_after_max_attempts);
+    RUN_TEST(test_rate_limit_waits_and_does_not_count_as_failure);
+    RUN_TEST(test_permanent_error_drops_batch);
+    RUN_TEST(test_full_queue_rejects_and_counts);
+    RUN_TEST(test_counters_consistent_across_threads);
+    return UNITY_END();
+}
\ No newline at end of file
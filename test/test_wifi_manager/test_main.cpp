@@ -0,0 +1,194 @@
+/**
+ * @brief WiFiManager driven by WiFi events on the virtual clock: connects,
+ * link loss, rejected and timed-out attempts with their backoff, stale
+ * events, and events raised on another thread while update() runs.
+ */
+#include <unity.h>
+#include <thread>
+#include "components/wifi_manager.hpp"
+#include "config/config.h"
+#include "native/native_hal.hpp"
+
+namespace
+{
+    using wifi::WiFiManager;
+    using State = WiFiManager::State;
+
+    WiFiManager &manager()
+    {
+        return WiFiManager::instance();
+    }
+
+    void advance_ms(uint32_t ms)
+    {
+        native_hal::advance_us(ms * 1000ULL);
+    }
+
+    // The manager is a singleton: bring it back to a fresh connection between tests
+    void connect()
+    {
+        for (int i = 0; i < 4 && manager().get_state() != State::CONNECTING; i++)
+        {
+            if (manager().get_state() == State::CONNECTED)
+            {
+                WiFi.raise_event(ARDUINO_EVENT_WIFI_STA_DISCONNECTED);
+            }
+            manager().update();
+        }
+        WiFi.raise_event(ARDUINO_EVENT_WIFI_STA_GOT_IP);
+        manager().update();
+        TEST_ASSERT_TRUE(manager().get_state() == State::CONNECTED);
+    }
+}
+
+void setUp() {}
+void tearDown() {}
+
+void test_connects_when_the_address_arrives()
+{
+    TEST_ASSERT_TRUE(manager().init());
+    TEST_ASSERT_TRUE(manager().get_state() == State::CONNECTING);
+    TEST_ASSERT_EQUAL_UINT32(1, manager().get_stats().attempts);
+
+    // The event only raises a flag; update() applies it
+    advance_ms(1200);
+    WiFi.raise_event(ARDUINO_EVENT_WIFI_STA_GOT_IP);
+    TEST_ASSERT_TRUE(manager().get_state() == State::CONNECTING);
+    TEST_ASSERT_FALSE(manager().ensure_connected());
+
+    advance_ms(250);
+    manager().update();
+    TEST_ASSERT_TRUE(manager().get_state() == State::CONNECTED);
+    TEST_ASSERT_TRUE(manager().ensure_connected());
+    TEST_ASSERT_EQUAL_UINT32(1, manager().get_stats().connects);
+    TEST_ASSERT_EQUAL_UINT32(1200, manager().get_stats().last_connect_ms);
+}
+
+void test_link_loss_reconnects()
+{
+    connect();
+    WiFiManager::Stats before = manager().get_stats();
+
+    // The upload path sees the drop at once, the state on the next update
+    WiFi.raise_event(ARDUINO_EVENT_WIFI_STA_DISCONNECTED);
+    TEST_ASSERT_FALSE(manager().ensure_connected());
+    manager().update();
+    TEST_ASSERT_TRUE(manager().get_state() == State::IDLE);
+    TEST_ASSERT_EQUAL_UINT32(before.disconnects + 1, manager().get_stats().disconnects);
+
+    manager().update();
+    TEST_ASSERT_TRUE(manager().get_state() == State::CONNECTING);
+    WiFi.raise_event(ARDUINO_EVENT_WIFI_STA_GOT_IP);
+    manager().update();
+    TEST_ASSERT_TRUE(manager().ensure_connected());
+    TEST_ASSERT_EQUAL_UINT32(before.attempts + 1, manager().get_stats().attempts);
+    TEST_ASSERT_EQUAL_UINT32(before.connects, manager().get_stats().reconnects);
+}
+
+void test_stale_events_do_not_fail_the_next_attempt()
+{
+    connect();
+    WiFi.raise_event(ARDUINO_EVENT_WIFI_STA_DISCONNECTED);
+    manager().update();
+
+    // Late events from the old link, delivered before the new attempt starts
+    WiFi.raise_event(ARDUINO_EVENT_WIFI_STA_DISCONNECTED);
+    WiFi.raise_event(ARDUINO_EVENT_WIFI_STA_GOT_IP);
+    manager().update();
+    TEST_ASSERT_TRUE(manager().get_state() == State::CONNECTING);
+
+    advance_ms(250);
+    manager().update();
+    TEST_ASSERT_TRUE(manager().get_state() == State::CONNECTING);
+    TEST_ASSERT_FALSE(manager().ensure_connected());
+}
+
+void test_failed_attempts_back_off_exponentially()
+{
+    connect();
+    WiFi.raise_event(ARDUINO_EVENT_WIFI_STA_DISCONNECTED);
+    manager().update();
+    manager().update();
+    TEST_ASSERT_TRUE(manager().get_state() == State::CONNECTING);
+
+    // Rejected, then timed out: each failure doubles the wait before the next attempt
+    for (uint32_t failure = 0; failure < config::wifi::MAX_FAST_ATTEMPTS; failure++)
+    {
+        if (failure % 2 == 0)
+        {
+            WiFi.raise_event(ARDUINO_EVENT_WIFI_STA_DISCONNECTED);
+        }
+        else
+        {
+            advance_ms(config::wifi::CONNECT_TIMEOUT_MS);
+        }
+        manager().update();
+        TEST_ASSERT_TRUE(manager().get_state() ==
+                         (failure + 1 < config::wifi::MAX_FAST_ATTEMPTS ? State::BACKOFF : State::FAILED));
+
+        uint32_t delay = config::wifi::RETRY_BASE_MS << failure;
+        advance_ms(delay - 1);
+        manager().update();
+        TEST_ASSERT_TRUE(manager().get_state() != State::CONNECTING);
+        advance_ms(1);
+        manager().update();
+        TEST_ASSERT_TRUE(manager().get_state() == State::CONNECTING);
+    }
+
+    // A connect resets the backoff
+    WiFi.raise_event(ARDUINO_EVENT_WIFI_STA_GOT_IP);
+    manager().update();
+    TEST_ASSERT_TRUE(manager().get_state() == State::CONNECTED);
+    WiFi.raise_event(ARDUINO_EVENT_WIFI_STA_DISCONNECTED);
+    manager().update();
+    manager().update();
+    WiFi.raise_event(ARDUINO_EVENT_WIFI_STA_DISCONNECTED);
+    manager().update();
+    advance_ms(config::wifi::RETRY_BASE_MS);
+    manager().update();
+    TEST_ASSERT_TRUE(manager().get_state() == State::CONNECTING);
+}
+
+// Events on their own thread, as on the device; the clock stands still so only update() writes state
+void test_events_from_another_thread()
+{
+    connect();
+    const uint32_t flaps = 20000;
+
+    std::thread events([]()
+                       {
+        for (uint32_t i = 0; i < flaps; i++)
+        {
+            WiFi.raise_event(ARDUINO_EVENT_WIFI_STA_DISCONNECTED);
+            WiFi.raise_event(ARDUINO_EVENT_WIFI_STA_GOT_IP);
+            if (i % 16 == 0)
+            {
+                std::this_thread::yield();
+            }
+        } });
+
+    for (uint32_t i = 0; i < flaps; i++)
+    {
+        manager().update();
+    }
+    events.join();
+    manager().update();
+    manager().update();
+
+    // Every connect but the current link was followed by exactly one counted loss
+    const WiFiManager::Stats &stats = manager().get_stats();
+    uint32_t connected = manager().get_state() == State::CONNECTED;
+    TEST_ASSERT_EQUAL_UINT32(stats.connects - connected, stats.disconnects);
+    TEST_ASSERT_EQUAL_UINT32(stats.connects - 1, stats.reconnects);
+}
+
+int main()
+{
+    UNITY_BEGIN();
+    RUN_TEST(test_connects_when_the_address_arrives);
+    RUN_TEST(test_link_loss_reconnects);
+    RUN_TEST(test_stale_events_do_not_fail_the_next_attempt);
+    RUN_TEST(test_failed_attempts_back_off_exponentially);
+    RUN_TEST(test_events_from_another_thread);
+    return UNITY_END();
+}
\ No newline at end of file
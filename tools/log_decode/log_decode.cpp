@@ -0,0 +1,398 @@
+/**
+ * @brief Host tool: decode binary noise logs (log_format.hpp) to CSV or columns.
+ *
+ * Build:  g++ -O2 -std=c++17 -I../../src/components log_decode.cpp \
+ *            ../../src/components/log_reader.cpp ../../src/components/spi_arbiter.cpp \
+ *            -o log_decode -pthread
+ * Usage:  log_decode [-f csv|columns] [-o output] [--from T] [--to T] FILE...
+ *
+ * csv      One row per record with the same columns as the text log, to
+ *          stdout or the -o file.
+ * columns  One raw little-endian int32 file per field in the -o directory,
+ *          plus schema.csv with each column's scale (value = stored / scale).
+ *
+ * Corrupted or torn blocks are skipped by scanning for the next valid block.
+ *
+ * --from/--to (Unix time, end exclusive) select a time range through the
+ * .idx file next to each log, reading only the blocks in range. In this mode
+ * CSV logs are accepted as input too.
+ */
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include "log_format.hpp"
+#include "log_reader.hpp"
+
+namespace
+{
+    using namespace log_format;
+
+    struct Totals
+    {
+        uint64_t bytes{0};
+        uint64_t blocks{0};
+        uint64_t records{0};
+        uint64_t skipped_bytes{0};
+    };
+
+    /**
+     * @brief Buffered output that formats fixed-point numbers without printf.
+     */
+    class CsvSink
+    {
+    public:
+        explicit CsvSink(FILE *out) : m_out(out) { m_buffer.reserve(BUFFER_SIZE + 256); }
+        ~CsvSink() { flush(); }
+
+        void header()
+        {
+            for (size_t f = 0; f < NUM_FIELDS; f++)
+            {
+                append(FIELDS[f].name, strlen(FIELDS[f].name));
+                put(f + 1 < NUM_FIELDS ? ',' : '\n');
+            }
+        }
+
+        void record(const Record &record)
+        {
+            for (size_t f = 0; f < NUM_FIELDS; f++)
+            {
+                number(record[f], FIELDS[f].scale);
+                put(f + 1 < NUM_FIELDS ? ',' : '\n');
+            }
+            if (m_buffer.size() >= BUFFER_SIZE)
+            {
+                flush();
+            }
+        }
+
+        void flush()
+        {
+            fwrite(m_buffer.data(), 1, m_buffer.size(), m_out);
+            m_buffer.clear();
+        }
+
+    private:
+        static constexpr size_t BUFFER_SIZE = 1 << 20;
+
+        FILE *m_out;
+        std::string m_buffer;
+
+        void put(char c) { m_buffer.push_back(c); }
+        void append(const char *text, size_t length) { m_buffer.append(text, length); }
+
+        void digits(uint64_t value, int min_digits)
+        {
+            char text[24];
+            int n = 0;
+            do
+            {
+                text[n++] = static_cast<char>('0' + value % 10);
+                value /= 10;
+            } while (value || n < min_digits);
+            while (n)
+            {
+                put(text[--n]);
+            }
+        }
+
+        // Scales are 1 or a power of ten, printed with as many decimals
+        void number(int32_t value, int32_t scale)
+        {
+            int64_t v = value;
+            if (v < 0)
+            {
+                put('-');
+                v = -v;
+            }
+            digits(static_cast<uint64_t>(v / scale), 1);
+            if (scale > 1)
+            {
+                int decimals = 0;
+                for (int32_t s = scale; s > 1; s /= 10)
+                {
+                    decimals++;
+                }
+                put('.');
+                digits(static_cast<uint64_t>(v % scale), decimals);
+            }
+        }
+    };
+
+    /**
+     * @brief One raw int32 file per field.
+     */
+    class ColumnSink
+    {
+    public:
+        explicit ColumnSink(const std::string &directory) : m_directory(directory)
+        {
+            for (size_t f = 0; f < NUM_FIELDS; f++)
+            {
+                std::string path = directory + "/" + FIELDS[f].name + ".i32";
+                m_files[f] = fopen(path.c_str(), "wb");
+                if (!m_files[f])
+                {
+                    fprintf(stderr, "Cannot create %s\n", path.c_str());
+                    m_ok = false;
+                }
+            }
+        }
+
+        ~ColumnSink()
+        {
+            for (size_t f = 0; f < NUM_FIELDS; f++)
+            {
+                if (m_files[f])
+                {
+                    flush(f);
+                    fclose(m_files[f]);
+                }
+            }
+
+            std::string path = m_directory + "/schema.csv";
+            if (FILE *schema = fopen(path.c_str(), "w"))
+            {
+                fprintf(schema, "column,file,type,scale,rows\n");
+                for (size_t f = 0; f < NUM_FIELDS; f++)
+                {
+                    fprintf(schema, "%s,%s.i32,int32le,%d,%llu\n", FIELDS[f].name, FIELDS[f].name,
+                            FIELDS[f].scale, static_cast<unsigned long long>(m_rows));
+                }
+                fclose(schema);
+            }
+        }
+
+        bool is_ok() const { return m_ok; }
+
+        void record(const Record &record)
+        {
+            for (size_t f = 0; f < NUM_FIELDS; f++)
+            {
+                m_columns[f].push_back(record[f]);
+                if (m_columns[f].size() == CHUNK_ROWS)
+                {
+                    flush(f);
+                }
+            }
+            m_rows++;
+        }
+
+    private:
+        static constexpr size_t CHUNK_ROWS = 1 << 16;
+
+        std::string m_directory;
+        FILE *m_files[NUM_FIELDS]{};
+        std::vector<int32_t> m_columns[NUM_FIELDS];
+        uint64_t m_rows{0};
+        bool m_ok{true};
+
+        void flush(size_t field)
+        {
+            fwrite(m_columns[field].data(), sizeof(int32_t), m_columns[field].size(), m_files[field]);
+            m_columns[field].clear();
+        }
+    };
+
+    bool read_file(const char *path, std::vector<uint8_t> &data)
+    {
+        FILE *file = fopen(path, "rb");
+        if (!file)
+        {
+            return false;
+        }
+        fseek(file, 0, SEEK_END);
+        long length = ftell(file);
+        fseek(file, 0, SEEK_SET);
+        data.resize(length > 0 ? static_cast<size_t>(length) : 0);
+        bool ok = length >= 0 && fread(data.data(), 1, data.size(), file) == data.size();
+        fclose(file);
+        return ok;
+    }
+
+    /**
+     * @brief Decode every intact block of one file.
+     * @param path The log file.
+     * @param sink Receives each record.
+     * @param totals Updated with what was read.
+     * @return False if the file cannot be read or is not a binary log.
+     */
+    template <typename Sink>
+    bool decode_file(const char *path, Sink &sink, Totals &totals)
+    {
+        std::vector<uint8_t> data;
+        if (!read_file(path, data))
+        {
+            fprintf(stderr, "%s: cannot read\n", path);
+            return false;
+        }
+
+        FileHeader file_header;
+        if (data.size() < sizeof(file_header) ||
+            (memcpy(&file_header, data.data(), sizeof(file_header)), !is_valid(file_header)))
+        {
+            fprintf(stderr, "%s: not a version %u binary log\n", path, VERSION);
+            return false;
+        }
+        totals.bytes += data.size();
+
+        const uint8_t *begin = data.data();
+        const uint8_t *end = begin + data.size();
+        const uint8_t *pos = begin + file_header.header_size;
+        const uint8_t magic[2] = {BLOCK_MAGIC & 0xFF, BLOCK_MAGIC >> 8};
+
+        while (pos < end)
+        {
+            BlockHeader header;
+            size_t size = check_block(pos, end - pos, header);
+            if (size == 0)
+            {
+                // Resynchronise on the next block marker
+                const uint8_t *next = pos + 1;
+                while (next + 1 < end && !(next[0] == magic[0] && next[1] == magic[1]))
+                {
+                    next++;
+                }
+                next = next + 1 < end ? next : end;
+                totals.skipped_bytes += next - pos;
+                pos = next;
+                continue;
+            }
+
+            BlockDecoder decoder(pos, header);
+            Record record;
+            while (decoder.next(record))
+            {
+                sink.record(record);
+                totals.records++;
+            }
+            totals.blocks++;
+            pos += size;
+        }
+        return true;
+    }
+
+    template <typename Sink>
+    bool query_file(const char *path, uint32_t from, uint32_t to, Sink &sink, Totals &totals)
+    {
+        LogReader reader;
+        if (!reader.open(path))
+        {
+            fprintf(stderr, "%s: cannot read\n", path);
+            return false;
+        }
+        if (!reader.has_index())
+        {
+            fprintf(stderr, "%s: no index, scanning the whole log\n", path);
+        }
+
+        auto deliver = [](void *context, const Record &record)
+        {
+            static_cast<Sink *>(context)->record(record);
+            return true;
+        };
+        totals.records += reader.query(from, to, deliver, &sink);
+
+        const LogReader::Stats &stats = reader.get_stats();
+        totals.bytes += stats.bytes_read;
+        fprintf(stderr, "%s: %u index probes, %u of %u records scanned matched\n", path,
+                stats.index_probes, stats.records_matched, stats.records_scanned);
+        return true;
+    }
+
+    void usage()
+    {
+        fprintf(stderr, "usage: log_decode [-f csv|columns] [-o output] [--from T] [--to T] FILE...\n");
+    }
+}
+
+int main(int argc, char **argv)
+{
+    std::string format = "csv";
+    std::string output;
+    std::vector<const char *> inputs;
+    uint32_t from = 0;
+    uint32_t to = UINT32_MAX;
+    bool ranged = false;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (!strcmp(argv[i], "-f") && i + 1 < argc)
+        {
+            format = argv[++i];
+        }
+        else if (!strcmp(argv[i], "-o") && i + 1 < argc)
+        {
+            output = argv[++i];
+        }
+        else if ((!strcmp(argv[i], "--from") || !strcmp(argv[i], "--to")) && i + 1 < argc)
+        {
+            uint32_t &bound = argv[i][2] == 'f' ? from : to;
+            bound = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+            ranged = true;
+        }
+        else if (argv[i][0] == '-')
+        {
+            usage();
+            return 2;
+        }
+        else
+        {
+            inputs.push_back(argv[i]);
+        }
+    }
+    if (inputs.empty() || (format != "csv" && format != "columns") ||
+        (format == "columns" && output.empty()))
+    {
+        usage();
+        return 2;
+    }
+
+    Totals totals;
+    bool ok = true;
+    auto start = std::chrono::steady_clock::now();
+
+    if (format == "csv")
+    {
+        FILE *out = output.empty() ? stdout : fopen(output.c_str(), "wb");
+        if (!out)
+        {
+            fprintf(stderr, "Cannot create %s\n", output.c_str());
+            return 1;
+        }
+        {
+            CsvSink sink(out);
+            sink.header();
+            for (const char *input : inputs)
+            {
+                ok &= ranged ? query_file(input, from, to, sink, totals) : decode_file(input, sink, totals);
+            }
+        }
+        if (out != stdout)
+        {
+            fclose(out);
+        }
+    }
+    else
+    {
+        ColumnSink sink(output);
+        if (!sink.is_ok())
+        {
+            return 1;
+        }
+        for (const char *input : inputs)
+        {
+            ok &= ranged ? query_file(input, from, to, sink, totals) : decode_file(input, sink, totals);
+        }
+    }
+
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    fprintf(stderr, "%llu records in %llu blocks, %llu bytes skipped, %.1f MB/s\n",
+            static_cast<unsigned long long>(totals.records), static_cast<unsigned long long>(totals.blocks),
+            static_cast<unsigned long long>(totals.skipped_bytes),
+            seconds > 0 ? totals.bytes / seconds / 1e6 : 0.0);
+    return ok ? 0 : 1;
+}
\ No newline at end of file